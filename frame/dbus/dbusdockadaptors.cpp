@@ -74,6 +74,9 @@ DBusDockAdaptors::DBusDockAdaptors(WindowManager* parent)
     : QDBusAbstractAdaptor(parent)
     , m_gsettings(Utils::SettingsPtr("com.deepin.dde.dock.mainwindow", QByteArray(), this))
     , m_windowManager(parent)
+    , m_iconCache([ this ](PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType) {
+        return renderSettingIcon(plugin, colorType);
+    })
 {
     connect(parent, &WindowManager::panelGeometryChanged, this, [ = ] {
         emit DBusDockAdaptors::geometryChanged(geometry());
@@ -113,6 +116,17 @@ DBusDockAdaptors::DBusDockAdaptors(WindowManager* parent)
         }
     });
 
+    // 图标缓存只在主题变化和插件更新图标时失效
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, [ this ] {
+        m_iconCache.invalidateAll();
+    });
+    connect(QuickSettingController::instance(), &QuickSettingController::pluginUpdated, this, [ this ](PluginsItemInterface *itemInter) {
+        m_iconCache.invalidate(itemInter);
+    });
+    connect(QuickSettingController::instance(), &QuickSettingController::pluginRemoved, this, [ this ](PluginsItemInterface *itemInter) {
+        m_iconCache.invalidate(itemInter);
+    });
+
     registerPluginInfoMetaType();
 }
 
@@ -183,23 +197,8 @@ DockItemInfos DBusDockAdaptors::plugins()
         info.itemKey = plugin->pluginName();
         info.settingKey = DOCK_QUICK_PLUGINS;
         info.visible = quickSettingKeys.contains(info.itemKey);
-        QSize pixmapSize;
-        QIcon lightIcon = getSettingIcon(plugin, pixmapSize, DGuiApplicationHelper::ColorType::LightType);
-        if (!lightIcon.isNull()) {
-            QBuffer buffer(&info.iconLight);
-            if (buffer.open(QIODevice::WriteOnly)) {
-                QPixmap pixmap = lightIcon.pixmap(pixmapSize);
-                pixmap.save(&buffer, "png");
-            }
-        }
-        QIcon darkIcon = getSettingIcon(plugin, pixmapSize, DGuiApplicationHelper::ColorType::DarkType);
-        if (!darkIcon.isNull()) {
-            QBuffer buffer(&info.iconDark);
-            if (buffer.open(QIODevice::WriteOnly)) {
-                QPixmap pixmap = darkIcon.pixmap(pixmapSize);
-                pixmap.save(&buffer, "png");
-            }
-        }
+        info.iconLight = m_iconCache.iconData(plugin, DGuiApplicationHelper::ColorType::LightType);
+        info.iconDark = m_iconCache.iconData(plugin, DGuiApplicationHelper::ColorType::DarkType);
         pluginInfos << info;
     }
 
@@ -377,3 +376,20 @@ QIcon DBusDockAdaptors::getSettingIcon(PluginsItemInterface *plugin, QSize &pixm
 
     return icon;
 }
+
+QByteArray DBusDockAdaptors::renderSettingIcon(PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType) const
+{
+    QByteArray iconData;
+    QSize pixmapSize;
+    QIcon icon = getSettingIcon(plugin, pixmapSize, colorType);
+    if (icon.isNull())
+        return iconData;
+
+    QBuffer buffer(&iconData);
+    if (buffer.open(QIODevice::WriteOnly)) {
+        QPixmap pixmap = icon.pixmap(pixmapSize);
+        pixmap.save(&buffer, "png");
+    }
+
+    return iconData;
+}
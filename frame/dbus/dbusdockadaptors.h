@@ -23,6 +23,7 @@
 #define DBUSDOCKADAPTORS_H
 
 #include "mainwindow.h"
+#include "pluginiconcache.h"
 
 #include <QtDBus/QtDBus>
 #include <QDBusArgument>
@@ -138,10 +139,12 @@ private:
     bool isPluginValid(const QString &name);
     QList<PluginsItemInterface *> localPlugins() const;
     QIcon getSettingIcon(PluginsItemInterface *plugin, QSize &pixmapSize, DGuiApplicationHelper::ColorType colorType) const;
+    QByteArray renderSettingIcon(PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType) const;
 
 private:
     QGSettings *m_gsettings;
     WindowManager *m_windowManager;
+    PluginIconCache m_iconCache;
 };
 
 #endif //DBUSDOCKADAPTORS
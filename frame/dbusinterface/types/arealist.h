@@ -16,7 +16,7 @@ struct MonitRect {
     int x2;
     int y2;
 
-    bool operator ==(const MonitRect& rect);
+    bool operator ==(const MonitRect& rect) const;
 };
 
 typedef QList<MonitRect> AreaList;
@@ -64,6 +64,17 @@ QScreen *DisplayManager::screenAt(const QPoint &pos) const
     return nullptr;
 }
 
+/**
+ * @brief DisplayManager::screenAtByScaled
+ * @param pos 实际像素坐标
+ * @return 屏幕区域按缩放比例换算成实际像素后，包含pos的屏幕
+ */
+QScreen *DisplayManager::screenAtByScaled(const QPoint &pos) const
+{
+    const int index = m_topology.screenAt(pos);
+    return index < 0 ? nullptr : m_screens.value(index);
+}
+
 /**
  * @brief DisplayManager::primary
  * @return 主屏幕名称
@@ -109,7 +120,13 @@ int DisplayManager::screenRawHeight() const
  */
 bool DisplayManager::canDock(QScreen *s, Position pos) const
 {
-    return s ? m_screenPositionMap[s].value(pos) : false;
+    // 拓扑中的序号和m_screens一致，按指针查找，不用每次比较屏幕名称
+    return m_topology.canDock(m_screens.indexOf(s), pos);
+}
+
+const ScreenTopology &DisplayManager::topology() const
+{
+    return m_topology;
 }
 
 /**判断屏幕是否为复制模式的依据，第一个屏幕的X和Y值是否和其他的屏幕的X和Y值相等
@@ -140,116 +157,18 @@ bool DisplayManager::isCopyMode()
  */
 void DisplayManager::updateScreenDockInfo()
 {
-    // TODO 目前仅仅支持双屏，如果超过双屏，会出现异常，这里可以考虑做成通用的处理规则
-
-    // 先清除原先的数据，然后再更新
-    m_screenPositionMap.clear();
-
-    if (m_screens.isEmpty())
-        return;
-
-    // reset map
+    QList<ScreenTopology::ScreenInfo> infos;
     for (auto s : m_screens) {
-        QMap <Position, bool> map;
-        map.insert(Position::Top, true);
-        map.insert(Position::Bottom, true);
-        map.insert(Position::Left, true);
-        map.insert(Position::Right, true);
-        m_screenPositionMap.insert(s, map);
+        ScreenTopology::ScreenInfo info;
+        info.name = s->name();
+        info.geometry = s->geometry();
+        info.devicePixelRatio = s->devicePixelRatio();
+        info.primary = (s == qApp->primaryScreen());
+        infos << info;
     }
 
-    // 仅显示在主屏时的处理
-    if (m_onlyInPrimary) {
-        for (auto s : m_screens) {
-            if (s != qApp->primaryScreen()) {
-                QMap <Position, bool> map;
-                map.insert(Position::Top, false);
-                map.insert(Position::Bottom, false);
-                map.insert(Position::Left, false);
-                map.insert(Position::Right, false);
-                m_screenPositionMap.insert(s, map);
-            }
-        }
-        return;
-    }
-
-    if (m_screens.size() == 1) {
-        return;
-    }
-
-    // 适配多个屏幕的情况
-    for(auto s : m_screens) {
-        QList<QScreen *> otherScreens = m_screens;
-        otherScreens.removeAll(s);
-        for (auto other : otherScreens) {
-            QRect ourRect = QRect(s->geometry().topLeft(), s->geometry().size() * s->devicePixelRatio());
-            int ourBottom = ourRect.top() + ourRect.height();
-            int ourTop = ourRect.top();
-            int ourLeft = ourRect.left();
-            int ourRight = ourRect.left() + ourRect.width();
-            QPoint ourLeftBottom = QPoint(ourLeft, ourBottom);
-            QPoint ourRightBottom = QPoint(ourRight, ourBottom);
-            QPoint ourRightTop = QPoint(ourRight, ourTop);
-
-            QRect otherRect = QRect(other->geometry().topLeft(), other->geometry().size() * other->devicePixelRatio());
-            int otherBottom = otherRect.top() + otherRect.height();
-            int otherTop = otherRect.top();
-            int otherLeft = otherRect.left();
-            int otherRight = otherRect.left() + otherRect.width();
-            QPoint otherLeftBottom = QPoint(otherLeft, otherBottom);
-            QPoint otherLeftTop = QPoint(otherLeft, otherTop);
-            QPoint otherRightTop = QPoint(otherRight, otherTop);
-
-            /*
-                     * 上下拼接，our屏幕左右移动。
-                     * our屏幕从other屏幕对角的左上侧向右移动，至other屏幕对角的右上侧位置
-              ---------                                   ---------
-              |       |                                   |       |
-              |  our  |           ======>>>>>             |  our  |
-              |       |                                   |       |
-              ---------------                       ---------------
-                    |       |                       |       |
-                    | other |                       | other |
-                    |       |                       |       |
-                    ---------                       ---------
-            */
-            // 上下拼接
-            if (ourBottom == otherTop
-                    && (ourRight >= otherLeft)
-                    && (ourLeft <= otherRight)) {
-                // 排除对角排列
-                if (ourLeftBottom == otherRightTop
-                        || ourRightBottom == otherLeftTop)
-                    continue;
-                m_screenPositionMap[s][Position::Bottom] = false;
-                m_screenPositionMap[other][Position::Top] = false;
-            }
-
-            /*
-                     * 左右拼接，our屏幕上下移动。
-                     * our屏幕从other屏幕对角的左上侧向下移动，至other屏幕对角的最左下侧位置
-              ---------                                          ---------
-              |       |                                          |       |
-              |  our  |              ======>>>>>        ---------| other |
-              |       |--------                         |        |       |
-              --------|       |                         |  our   |--------
-                      | other |                         |        |
-                      |       |                         ----------
-                      ---------
-            */
-            // 左右拼接
-            if (otherLeft == ourRight
-                    && (ourTop <= otherBottom)
-                    && (ourBottom >= otherTop)) {
-                // 排除对角排列
-                if (ourRightTop == otherLeftBottom
-                        || ourRightBottom == otherLeftTop)
-                    continue;
-                m_screenPositionMap[s][Position::Right] = false;
-                m_screenPositionMap[other][Position::Left] = false;
-            }
-        }
-    }
+    // 和其他屏幕拼接的边不允许停靠，仅显示在主屏时其他屏幕都不允许停靠
+    m_topology.build(infos, m_onlyInPrimary);
 }
 
 /**
@@ -311,7 +230,11 @@ void DisplayManager::dockInfoChanged()
     updateScreenDockInfo();
 
 #ifdef QT_DEBUG
-    qInfo() << m_screenPositionMap;
+    for (int i = 0; i < m_topology.count(); ++i) {
+        qInfo() << m_topology.name(i) << m_topology.rect(i)
+                << m_topology.canDock(i, Position::Top) << m_topology.canDock(i, Position::Right)
+                << m_topology.canDock(i, Position::Bottom) << m_topology.canDock(i, Position::Left);
+    }
 #endif
 
     Q_EMIT screenInfoChanged();
@@ -10,6 +10,7 @@
 
 #include "singleton.h"
 #include "constants.h"
+#include "screentopology.h"
 #include "org_deepin_dde_display1.h"
 
 using DisplayInter = org::deepin::dde::Display1;
@@ -29,10 +30,12 @@ public:
     QList<QScreen *> screens() const;
     QScreen *screen(const QString &screenName) const;
     QScreen *screenAt(const QPoint &pos) const;
+    QScreen *screenAtByScaled(const QPoint &pos) const;
     QString primary() const;
     int screenRawWidth() const;
     int screenRawHeight() const;
     bool canDock(QScreen *s, Position pos) const;
+    const ScreenTopology &topology() const;
     bool isCopyMode();
 
 private:
@@ -49,7 +52,7 @@ Q_SIGNALS:
 
 private:
     QList<QScreen *> m_screens;
-    QMap<QScreen *, QMap<Position, bool>> m_screenPositionMap;
+    ScreenTopology m_topology;                  // 屏幕拼接关系，序号和m_screens一致
     const QGSettings *m_gsettings;              // 多屏配置控制
     bool m_onlyInPrimary;
 };
@@ -0,0 +1,271 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "screentopology.h"
+
+#include <QMultiHash>
+
+#include <algorithm>
+
+using namespace Dock;
+
+void ScreenTopology::IntervalIndex::build(const QVector<int> &lows, const QVector<int> &highs, const QVector<int> &ids, bool closed)
+{
+    coords = lows + highs;
+    std::sort(coords.begin(), coords.end());
+    coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+
+    // 单元0为第一个端点之前，2i+1为端点coords[i]，2i+2为coords[i]和coords[i+1]之间
+    cells.clear();
+    cells.resize(coords.size() * 2 + 1);
+
+    for (int k = 0; k < ids.size(); ++k) {
+        const int low = int(std::lower_bound(coords.begin(), coords.end(), lows[k]) - coords.begin());
+        const int high = int(std::lower_bound(coords.begin(), coords.end(), highs[k]) - coords.begin());
+        for (int i = low; i <= high; ++i) {
+            if (i < high || closed)
+                cells[2 * i + 1] << ids[k];
+            if (i < high)
+                cells[2 * i + 2] << ids[k];
+        }
+    }
+}
+
+int ScreenTopology::IntervalIndex::cell(int value) const
+{
+    const int i = int(std::lower_bound(coords.begin(), coords.end(), value) - coords.begin());
+    if (i < coords.size() && coords[i] == value)
+        return 2 * i + 1;
+
+    return 2 * i;
+}
+
+const QVector<int> &ScreenTopology::IntervalIndex::at(int value) const
+{
+    return cells[cell(value)];
+}
+
+ScreenTopology::ScreenTopology()
+{
+    build(QList<ScreenInfo>());
+}
+
+/**
+ * @brief ScreenTopology::build 根据屏幕信息重新建立拼接关系和索引
+ * @param screens 屏幕信息
+ * @param onlyPrimary 任务栏是否只允许显示在主屏上
+ */
+void ScreenTopology::build(const QList<ScreenInfo> &screens, bool onlyPrimary)
+{
+    m_screens = screens.toVector();
+    m_rects.clear();
+    m_nameIndex.clear();
+    for (int i = 0; i < m_screens.size(); ++i) {
+        const ScreenInfo &info = m_screens[i];
+        m_rects << QRect(info.geometry.topLeft(), info.geometry.size() * info.devicePixelRatio);
+        if (!m_nameIndex.contains(info.name))
+            m_nameIndex.insert(info.name, i);
+    }
+
+    buildAdjacency();
+
+    for (int pos = Top; pos <= Left; ++pos) {
+        m_dockable[pos].fill(false, m_screens.size());
+        m_firstDockable[pos] = -1;
+        for (int i = 0; i < m_screens.size(); ++i) {
+            // 和其他屏幕拼接的边不能停靠任务栏
+            m_dockable[pos][i] = onlyPrimary ? m_screens[i].primary : m_neighbours[pos][i].isEmpty();
+            if (m_dockable[pos][i] && m_firstDockable[pos] < 0)
+                m_firstDockable[pos] = i;
+        }
+    }
+
+    QVector<int> lows, highs, ids;
+    for (int i = 0; i < m_rects.size(); ++i) {
+        lows << m_rects[i].x();
+        highs << m_rects[i].x() + m_rects[i].width();
+        ids << i;
+    }
+    m_xIndex.build(lows, highs, ids, false);
+
+    m_yIndexes.clear();
+    m_yIndexes.resize(m_xIndex.cells.size());
+    for (int c = 0; c < m_xIndex.cells.size(); ++c) {
+        lows.clear();
+        highs.clear();
+        for (int i : m_xIndex.cells[c]) {
+            lows << m_rects[i].y();
+            highs << m_rects[i].y() + m_rects[i].height();
+        }
+        m_yIndexes[c].build(lows, highs, m_xIndex.cells[c], false);
+    }
+
+    for (int pos = Top; pos <= Left; ++pos) {
+        const bool horizontal = (pos == Top || pos == Bottom);
+        lows.clear();
+        highs.clear();
+        ids.clear();
+        for (int i = 0; i < m_rects.size(); ++i) {
+            if (!m_dockable[pos][i])
+                continue;
+
+            const QRect &r = m_rects[i];
+            lows << (horizontal ? r.x() : r.y());
+            highs << (horizontal ? r.x() + r.width() : r.y() + r.height());
+            ids << i;
+        }
+        m_bandIndex[pos].build(lows, highs, ids, true);
+    }
+}
+
+int ScreenTopology::count() const
+{
+    return m_screens.size();
+}
+
+int ScreenTopology::indexOf(const QString &name) const
+{
+    return m_nameIndex.value(name, -1);
+}
+
+QString ScreenTopology::name(int index) const
+{
+    return (index >= 0 && index < m_screens.size()) ? m_screens[index].name : QString();
+}
+
+/**
+ * @brief ScreenTopology::rect
+ * @return 屏幕的实际像素区域(左上角坐标不变，大小乘以缩放比例)
+ */
+QRect ScreenTopology::rect(int index) const
+{
+    return (index >= 0 && index < m_rects.size()) ? m_rects[index] : QRect();
+}
+
+/**
+ * @brief ScreenTopology::neighbours
+ * @return 和index屏幕的edge边共享一段边界的屏幕
+ */
+QList<int> ScreenTopology::neighbours(int index, Position edge) const
+{
+    return (index >= 0 && index < m_screens.size()) ? m_neighbours[edge][index] : QList<int>();
+}
+
+bool ScreenTopology::canDock(int index, Position pos) const
+{
+    return (index >= 0 && index < m_screens.size()) ? m_dockable[pos][index] : false;
+}
+
+int ScreenTopology::firstDockable(Position pos) const
+{
+    return m_firstDockable[pos];
+}
+
+/**
+ * @brief ScreenTopology::screenAt
+ * @param point 实际像素坐标
+ * @return 包含此坐标的屏幕序号，没有时返回-1
+ */
+int ScreenTopology::screenAt(const QPoint &point) const
+{
+    const int column = m_xIndex.cell(point.x());
+    const QVector<int> &ids = m_yIndexes[column].at(point.y());
+    return ids.isEmpty() ? -1 : ids.first();
+}
+
+bool ScreenTopology::onScreenEdge(int index, const QPoint &point) const
+{
+    if (index < 0 || index >= m_rects.size())
+        return false;
+
+    const QRect &rect = m_rects[index];
+
+    // 除了要判断鼠标的x坐标和当前区域的位置外，还需要判断当前的坐标的y坐标是否在任务栏的区域内
+    // 因为有如下场景：任务栏在左侧，双屏幕屏幕上下拼接，此时鼠标沿着最左侧x=0的位置移动到另外一个屏幕
+    // 如果不判断y坐标的话，此时就认为鼠标在当前任务栏的边缘，导致任务栏在这种状况下没有跟随鼠标
+    if ((rect.x() == point.x() || rect.x() + rect.width() == point.x())
+            && point.y() >= rect.top() && point.y() <= rect.bottom()) {
+        return true;
+    }
+
+    // 同上，不过此时屏幕是左右拼接，任务栏位于上方或者下方
+    if ((rect.y() == point.y() || rect.y() + rect.height() == point.y())
+            && point.x() >= rect.left() && point.x() <= rect.right()) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief ScreenTopology::isCursorOut 判断鼠标是否离开了任务栏所在的区域
+ * @param point 实际像素坐标
+ * @param pos 任务栏位置
+ * @param dockSize 任务栏实际像素大小
+ * @return 沿任务栏方向找到第一个可停靠的屏幕，坐标不在此屏幕的任务栏区域内时返回true
+ */
+bool ScreenTopology::isCursorOut(const QPoint &point, Position pos, int dockSize) const
+{
+    const bool horizontal = (pos == Top || pos == Bottom);
+    const QVector<int> &ids = m_bandIndex[pos].at(horizontal ? point.x() : point.y());
+    if (ids.isEmpty())
+        return false;
+
+    const QRect &r = m_rects[ids.first()];
+    switch (pos) {
+    case Top:
+        return (point.y() > (r.y() + dockSize) || point.y() < r.y());
+    case Bottom:
+        return (point.y() < (r.y() + r.height() - dockSize) || point.y() > (r.y() + r.height()));
+    case Left:
+        return (point.x() > (r.x() + dockSize) || point.x() < r.x());
+    case Right:
+        return (point.x() < (r.x() + r.width() - dockSize) || point.x() > (r.x() + r.width()));
+    }
+
+    return false;
+}
+
+/**
+ * @brief ScreenTopology::buildAdjacency 建立屏幕之间共享边的邻接关系
+ * 按边所在的坐标分组，只比较坐标相同的边，两条边重叠的长度大于0才认为相邻(对角排列不算)
+ */
+void ScreenTopology::buildAdjacency()
+{
+    for (int pos = Top; pos <= Left; ++pos) {
+        m_neighbours[pos].clear();
+        m_neighbours[pos].resize(m_rects.size());
+    }
+
+    QMultiHash<int, int> topEdges;
+    QMultiHash<int, int> leftEdges;
+    for (int i = 0; i < m_rects.size(); ++i) {
+        topEdges.insert(m_rects[i].y(), i);
+        leftEdges.insert(m_rects[i].x(), i);
+    }
+
+    for (int i = 0; i < m_rects.size(); ++i) {
+        const QRect &our = m_rects[i];
+
+        // 上下拼接
+        for (int j : topEdges.values(our.y() + our.height())) {
+            const QRect &other = m_rects[j];
+            if (j == i || qMin(our.x() + our.width(), other.x() + other.width()) - qMax(our.x(), other.x()) <= 0)
+                continue;
+
+            m_neighbours[Bottom][i] << j;
+            m_neighbours[Top][j] << i;
+        }
+
+        // 左右拼接
+        for (int j : leftEdges.values(our.x() + our.width())) {
+            const QRect &other = m_rects[j];
+            if (j == i || qMin(our.y() + our.height(), other.y() + other.height()) - qMax(our.y(), other.y()) <= 0)
+                continue;
+
+            m_neighbours[Right][i] << j;
+            m_neighbours[Left][j] << i;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef SCREENTOPOLOGY_H
+#define SCREENTOPOLOGY_H
+
+#include "constants.h"
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief ScreenTopology 多屏幕的拼接关系
+ * 屏幕变化时根据实际像素大小的屏幕区域建立一次共享边的邻接关系和区间索引，
+ * 之后判断是否可以停靠、坐标所在屏幕、鼠标是否离开任务栏区域都只需要二分查找
+ * 屏幕序号和构建时传入的顺序一致
+ */
+class ScreenTopology
+{
+public:
+    struct ScreenInfo {
+        QString name;
+        QRect geometry;                 // QScreen::geometry()，大小是缩放后的逻辑大小
+        qreal devicePixelRatio = 1.0;
+        bool primary = false;
+    };
+
+    ScreenTopology();
+
+    void build(const QList<ScreenInfo> &screens, bool onlyPrimary = false);
+
+    int count() const;
+    int indexOf(const QString &name) const;
+    QString name(int index) const;
+    QRect rect(int index) const;
+    QList<int> neighbours(int index, Dock::Position edge) const;
+
+    bool canDock(int index, Dock::Position pos) const;
+    int firstDockable(Dock::Position pos) const;
+    int screenAt(const QPoint &point) const;
+    bool onScreenEdge(int index, const QPoint &point) const;
+    bool isCursorOut(const QPoint &point, Dock::Position pos, int dockSize) const;
+
+private:
+    // 把坐标轴按所有区间端点切分成若干单元，每个单元记录覆盖它的区间(按序号排列)
+    struct IntervalIndex {
+        QVector<int> coords;
+        QVector<QVector<int>> cells;
+
+        void build(const QVector<int> &lows, const QVector<int> &highs, const QVector<int> &ids, bool closed);
+        int cell(int value) const;
+        const QVector<int> &at(int value) const;
+    };
+
+    void buildAdjacency();
+
+private:
+    QVector<ScreenInfo> m_screens;
+    QVector<QRect> m_rects;
+    QHash<QString, int> m_nameIndex;
+    QVector<QList<int>> m_neighbours[4];    // 按Dock::Position索引，每条边相邻的屏幕
+    QVector<bool> m_dockable[4];
+    int m_firstDockable[4];
+
+    IntervalIndex m_xIndex;                 // 按横坐标切分，每一列再按纵坐标建立索引
+    QVector<IntervalIndex> m_yIndexes;
+    IntervalIndex m_bandIndex[4];           // 可停靠屏幕沿任务栏方向的区间
+};
+
+#endif // SCREENTOPOLOGY_H
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "dragfeedback.h"
+
+#include <QCoreApplication>
+#include <QCursor>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWidget>
+
+/**
+ * @brief DragImageWidget 显示拖动图标的窗口，绘制时不再做其他计算
+ */
+class DragImageWidget : public QWidget
+{
+public:
+    void setPixmap(const QPixmap &pixmap)
+    {
+        m_pixmap = pixmap;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        painter.drawPixmap(QPoint(0, 0), m_pixmap);
+    }
+
+private:
+    QPixmap m_pixmap;
+};
+
+DragFeedback::DragFeedback(QObject *parent)
+    : QObject(parent)
+    , m_imageWidget(new DragImageWidget)
+    , m_started(false)
+    , m_wakeupCount(0)
+    , m_moveCount(0)
+    , m_shapeCount(0)
+{
+    m_imageWidget->setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowDoesNotAcceptFocus);
+    m_imageWidget->setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+DragFeedback::~DragFeedback()
+{
+    stop();
+    m_imageWidget->deleteLater();
+}
+
+/**
+ * @brief DragFeedback::setPixmap 设置拖动的图标
+ * @param pixmap 图标
+ * @param size 窗口的大小，大小变化时才重新计算圆角的形状
+ */
+void DragFeedback::setPixmap(const QPixmap &pixmap, const QSize &size)
+{
+    if (m_imageWidget->size() != size || m_shape.isNull()) {
+        m_imageWidget->setFixedSize(size);
+        updateShape();
+    }
+
+    m_imageWidget->setPixmap(pixmap);
+    m_imageWidget->show();
+    m_imageWidget->raise();
+}
+
+void DragFeedback::setPositionFunction(const PositionFunction &position)
+{
+    m_position = position;
+}
+
+void DragFeedback::setWindowFlags(Qt::WindowFlags flags)
+{
+    if (m_imageWidget->windowFlags() == flags)
+        return;
+
+    // 修改窗口属性会隐藏窗口，由setPixmap重新显示
+    m_imageWidget->setWindowFlags(flags);
+}
+
+QWidget *DragFeedback::widget() const
+{
+    return m_imageWidget;
+}
+
+/**
+ * @brief DragFeedback::start 开始跟随鼠标
+ * 拖动开始之后QDrag会在应用上安装自己的事件过滤器并处理掉鼠标移动事件，
+ * 因此在拖动的事件循环中重新安装一次，保证先于QDrag收到鼠标移动事件
+ */
+void DragFeedback::start()
+{
+    if (m_started)
+        return;
+
+    m_started = true;
+    m_wakeupCount = 0;
+    m_moveCount = 0;
+    m_elapsed.start();
+    qApp->installEventFilter(this);
+    QMetaObject::invokeMethod(this, [ this ] {
+        if (m_started)
+            qApp->installEventFilter(this);
+    }, Qt::QueuedConnection);
+
+    updatePosition(QCursor::pos());
+}
+
+void DragFeedback::stop()
+{
+    if (!m_started)
+        return;
+
+    m_started = false;
+    qApp->removeEventFilter(this);
+}
+
+void DragFeedback::updatePosition(const QPoint &globalPos)
+{
+    const QPoint pos = m_position ? m_position(globalPos) : globalPos;
+    if (m_imageWidget->pos() == pos)
+        return;
+
+    m_imageWidget->move(pos);
+    ++m_moveCount;
+}
+
+int DragFeedback::wakeupCount() const
+{
+    return m_wakeupCount;
+}
+
+int DragFeedback::moveCount() const
+{
+    return m_moveCount;
+}
+
+int DragFeedback::shapeCount() const
+{
+    return m_shapeCount;
+}
+
+/**
+ * @brief DragFeedback::wakeupsPerSecond 开始拖动以来平均每秒处理鼠标移动的次数
+ */
+qreal DragFeedback::wakeupsPerSecond() const
+{
+    if (!m_elapsed.isValid())
+        return 0;
+
+    return m_wakeupCount * 1000.0 / qMax<qint64>(1, m_elapsed.elapsed());
+}
+
+bool DragFeedback::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::MouseMove:
+    case QEvent::DragMove: {
+        const QPoint globalPos = (event->type() == QEvent::MouseMove) ? static_cast<QMouseEvent *>(event)->globalPos() : QCursor::pos();
+        // 同一个事件会依次发送给各级父控件，只处理一次
+        if (m_wakeupCount > 0 && globalPos == m_lastPos)
+            break;
+
+        m_lastPos = globalPos;
+        ++m_wakeupCount;
+        updatePosition(globalPos);
+        break;
+    }
+    default:
+        break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+/**
+ * @brief DragFeedback::updateShape 计算圆角的形状，只在窗口大小变化时调用
+ */
+void DragFeedback::updateShape()
+{
+    QBitmap radiusMask(m_imageWidget->size());
+    radiusMask.fill();
+    QPainter radiusPainter(&radiusMask);
+    radiusPainter.setPen(Qt::NoPen);
+    radiusPainter.setBrush(Qt::black);
+    radiusPainter.setRenderHint(QPainter::Antialiasing);
+    radiusPainter.drawRoundedRect(radiusMask.rect(), 8, 8);
+    radiusPainter.end();
+
+    m_shape = radiusMask;
+    m_imageWidget->setMask(m_shape);
+    ++m_shapeCount;
+}
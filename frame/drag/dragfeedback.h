@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DRAGFEEDBACK_H
+#define DRAGFEEDBACK_H
+
+#include <QObject>
+#include <QBitmap>
+#include <QElapsedTimer>
+#include <QPixmap>
+
+#include <functional>
+
+class QWidget;
+class DragImageWidget;
+
+/**
+ * @brief DragFeedback 拖动时跟随鼠标的图标窗口
+ * 只在收到鼠标移动事件时移动窗口，鼠标静止时不会被唤醒；
+ * 圆角的形状只在图标变化时计算一次，绘制时直接绘制图标
+ */
+class DragFeedback : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 根据鼠标的全局坐标计算窗口的位置
+    typedef std::function<QPoint(const QPoint &)> PositionFunction;
+
+    explicit DragFeedback(QObject *parent = nullptr);
+    ~DragFeedback() override;
+
+    void setPixmap(const QPixmap &pixmap, const QSize &size);
+    void setPositionFunction(const PositionFunction &position);
+    void setWindowFlags(Qt::WindowFlags flags);
+    QWidget *widget() const;
+
+    void start();
+    void stop();
+    void updatePosition(const QPoint &globalPos);
+
+    int wakeupCount() const;
+    int moveCount() const;
+    int shapeCount() const;
+    qreal wakeupsPerSecond() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void updateShape();
+
+private:
+    DragImageWidget *m_imageWidget;
+    PositionFunction m_position;
+    QBitmap m_shape;
+    QPoint m_lastPos;
+    bool m_started;
+
+    QElapsedTimer m_elapsed;
+    int m_wakeupCount;      // 处理的鼠标移动事件
+    int m_moveCount;        // 窗口实际移动的次数
+    int m_shapeCount;       // 计算形状的次数
+};
+
+#endif // DRAGFEEDBACK_H
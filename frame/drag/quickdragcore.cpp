@@ -3,16 +3,10 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "quickdragcore.h"
+#include "dragfeedback.h"
 
-#include <QWidget>
-#include <QTimer>
-#include <QPainter>
-#include <QPainterPath>
-#include <QBitmap>
-#include <QEvent>
+#include <QCursor>
 #include <QDebug>
-#include <QCoreApplication>
-#include <QDragEnterEvent>
 #include <QGuiApplication>
 
 QuickPluginMimeData::QuickPluginMimeData(PluginsItemInterface *item, QDrag *drag)
@@ -42,24 +36,18 @@ QDrag *QuickPluginMimeData::drag() const
  */
 QuickIconDrag::QuickIconDrag(QObject *dragSource, const QPixmap &pixmap)
     : QDrag(dragSource)
-    , m_imageWidget(new QWidget)
-    , m_timer(new QTimer(this))
+    , m_feedback(new DragFeedback(this))
     , m_sourcePixmap(pixmap)
     , m_hotPoint(QPoint(0, 0))
 {
-    m_timer->setInterval(10);
-    connect(m_timer, &QTimer::timeout, this, &QuickIconDrag::onDragMove);
-    m_timer->start();
-
-    m_imageWidget->setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowDoesNotAcceptFocus);
-    m_imageWidget->setAttribute(Qt::WA_TransparentForMouseEvents);
-    m_imageWidget->installEventFilter(this);
+    m_feedback->setPositionFunction([ this ](const QPoint &mousePos) { return currentPoint(mousePos); });
     useSourcePixmap();
+    // 图标只在鼠标移动时跟随，不再定时查询鼠标位置
+    m_feedback->start();
 }
 
 QuickIconDrag::~QuickIconDrag()
 {
-    m_imageWidget->deleteLater();
 }
 
 void QuickIconDrag::updatePixmap(QPixmap pixmap)
@@ -69,75 +57,26 @@ void QuickIconDrag::updatePixmap(QPixmap pixmap)
 
     m_pixmap = pixmap;
     m_useSourcePixmap = false;
-    m_imageWidget->setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowDoesNotAcceptFocus | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint);
-    m_imageWidget->setFixedSize(pixmap.size());
-    m_imageWidget->show();
-    m_imageWidget->raise();
-    m_imageWidget->update();
+    m_feedback->setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowDoesNotAcceptFocus | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint);
+    m_feedback->setPixmap(pixmap, pixmap.size());
+    m_feedback->updatePosition(QCursor::pos());
 }
 
 void QuickIconDrag::useSourcePixmap()
 {
     m_useSourcePixmap = true;
-    m_imageWidget->setFixedSize(m_sourcePixmap.size() / qApp->devicePixelRatio());
-    m_imageWidget->show();
-    m_imageWidget->raise();
-    m_imageWidget->update();
+    m_feedback->setPixmap(m_sourcePixmap, m_sourcePixmap.size() / qApp->devicePixelRatio());
+    m_feedback->updatePosition(QCursor::pos());
 }
 
 void QuickIconDrag::setDragHotPot(QPoint point)
 {
     m_hotPoint = point;
-    m_imageWidget->update();
-}
-
-bool QuickIconDrag::eventFilter(QObject *watched, QEvent *event)
-{
-    if (watched == m_imageWidget) {
-        switch (event->type()) {
-        case QEvent::Paint: {
-            QPixmap pixmap = m_useSourcePixmap ? m_sourcePixmap : m_pixmap;
-            QPainter painter(m_imageWidget);
-            painter.drawPixmap(QPoint(0, 0), pixmap);
-
-            QPixmap pixmapMask(m_imageWidget->size());
-            pixmapMask.fill(Qt::transparent);
-            QPainter painterMask(&pixmapMask);
-            QPainterPath path;
-            path.addRoundedRect(pixmapMask.rect(), 8, 8);
-            painterMask.fillPath(path, Qt::white);
-            painterMask.setRenderHint(QPainter::Antialiasing, true);
-            painterMask.setCompositionMode(QPainter::CompositionMode_Source);
-            painterMask.drawPixmap(0, 0, pixmap);
-            painterMask.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-            QColor maskColor(Qt::black);
-            maskColor.setAlpha(150);
-            painterMask.fillRect(pixmapMask.rect(), maskColor);
-            painterMask.end();
-
-            // 绘制圆角
-            QBitmap radiusMask(m_imageWidget->size());
-            radiusMask.fill();
-            QPainter radiusPainter(&radiusMask);
-            radiusPainter.setPen(Qt::NoPen);
-            radiusPainter.setBrush(Qt::black);
-            radiusPainter.setRenderHint(QPainter::Antialiasing);
-            radiusPainter.drawRoundedRect(radiusMask.rect(), 8, 8);
-            m_imageWidget->setMask(radiusMask);
-
-            painter.end();
-            break;
-        }
-        default:
-            break;
-        }
-    }
-    return QDrag::eventFilter(watched, event);
+    m_feedback->updatePosition(QCursor::pos());
 }
 
-QPoint QuickIconDrag::currentPoint() const
+QPoint QuickIconDrag::currentPoint(const QPoint &mousePos) const
 {
-    QPoint mousePos = QCursor::pos();
     if (m_useSourcePixmap)
         return mousePos - m_hotPoint;
 
@@ -145,8 +84,3 @@ QPoint QuickIconDrag::currentPoint() const
     return (mousePos - QPoint(pixmapSize.width() * (m_hotPoint.x() / m_sourcePixmap.width())
                               , pixmapSize.height() * (m_hotPoint.y() / m_sourcePixmap.height())));
 }
-
-void QuickIconDrag::onDragMove()
-{
-    m_imageWidget->move(currentPoint());
-}
@@ -10,7 +10,7 @@
 #include <QPixmap>
 
 class PluginsItemInterface;
-class QTimer;
+class DragFeedback;
 
 class QuickPluginMimeData : public QMimeData
 {
@@ -39,15 +39,10 @@ public:
     void setDragHotPot(QPoint point);
 
 protected:
-    bool eventFilter(QObject *watched, QEvent *event) override;
-    QPoint currentPoint() const;
-
-private Q_SLOTS:
-    void onDragMove();
+    QPoint currentPoint(const QPoint &mousePos) const;
 
 private:
-    QWidget *m_imageWidget;
-    QTimer *m_timer;
+    DragFeedback *m_feedback;
     QPixmap m_sourcePixmap;
     QPixmap m_pixmap;
     QPoint m_hotPoint;
@@ -10,6 +10,7 @@
 #include "taskmanager/xcbutils.h"
 #include "utils.h"
 #include "imageutil.h"
+#include "xcb_connection.h"
 
 #include <DStyle>
 
@@ -19,7 +20,6 @@
 #include <X11/Xatom.h>
 #include <sys/shm.h>
 
-#include <QX11Info>
 #include <QPainter>
 #include <QVBoxLayout>
 #include <QSizeF>
@@ -29,6 +29,9 @@
 #include <QDBusInterface>
 #include <QDBusReply>
 
+// 每个请求按窗口预览计数一次
+#define SNAPSHOT_REQUEST(...) XcbConnection::instance()->call(XcbConnection::Snapshot, __VA_ARGS__)
+
 struct SHMInfo {
     long shmid;
     long width;
@@ -136,7 +139,7 @@ void AppSnapshot::closeWindow() const
     if (Utils::IS_WAYLAND_DISPLAY) {
         TaskManager::instance()->closeWindow(static_cast<uint>(m_wid));
     } else {
-        const auto display = QX11Info::display();
+        Display *display = XcbConnection::instance()->display();
         if (!display) {
             qWarning() << "Error: get display failed!";
             return;
@@ -147,14 +150,14 @@ void AppSnapshot::closeWindow() const
         memset(&e, 0, sizeof(e));
         e.xclient.type = ClientMessage;
         e.xclient.window = m_wid;
-        e.xclient.message_type = XInternAtom(display, "WM_PROTOCOLS", true);
+        e.xclient.message_type = SNAPSHOT_REQUEST(XInternAtom, display, "WM_PROTOCOLS", true);
         e.xclient.format = 32;
-        e.xclient.data.l[0] = XInternAtom(display, "WM_DELETE_WINDOW", false);
+        e.xclient.data.l[0] = SNAPSHOT_REQUEST(XInternAtom, display, "WM_DELETE_WINDOW", false);
         e.xclient.data.l[1] = CurrentTime;
 
         Q_EMIT requestCloseAppSnapshot();
 
-        XSendEvent(display, m_wid, false, NoEventMask, &e);
+        SNAPSHOT_REQUEST(XSendEvent, display, m_wid, false, NoEventMask, &e);
         XFlush(display);
     }
 }
@@ -337,13 +340,13 @@ void AppSnapshot::resizeEvent(QResizeEvent *event)
 
 SHMInfo *AppSnapshot::getImageDSHM()
 {
-    const auto display = Utils::IS_WAYLAND_DISPLAY ? XOpenDisplay(nullptr) : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (!display) {
         qWarning() << "Error: get display failed!";
         return nullptr;
     }
 
-    Atom atom_prop = XInternAtom(display, "_DEEPIN_DXCB_SHM_INFO", true);
+    Atom atom_prop = SNAPSHOT_REQUEST(XInternAtom, display, "_DEEPIN_DXCB_SHM_INFO", true);
     if (!atom_prop) {
         return nullptr;
     }
@@ -354,9 +357,9 @@ SHMInfo *AppSnapshot::getImageDSHM()
     unsigned long bytes_after_return_deepin_shm;
     unsigned char *prop_return_deepin_shm;
 
-    XGetWindowProperty(display, m_wid, atom_prop, 0, 32 * 9, false, AnyPropertyType,
-                       &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
-                       &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
+    SNAPSHOT_REQUEST(XGetWindowProperty, display, m_wid, atom_prop, 0, 32 * 9, false, AnyPropertyType,
+                     &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
+                     &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
 
     //qDebug() << actual_type_return_deepin_shm << actual_format_return_deepin_shm << nitems_return_deepin_shm << bytes_after_return_deepin_shm << prop_return_deepin_shm;
 
@@ -365,7 +368,7 @@ SHMInfo *AppSnapshot::getImageDSHM()
 
 XImage *AppSnapshot::getImageXlib()
 {
-    const auto display = Utils::IS_WAYLAND_DISPLAY ? XOpenDisplay(nullptr) : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (!display) {
         qWarning() << "Error: get display failed!";
         return nullptr;
@@ -374,25 +377,25 @@ XImage *AppSnapshot::getImageXlib()
     Window unused_window;
     int unused_int;
     unsigned unused_uint, w, h;
-    XGetGeometry(display, m_wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
-    return XGetImage(display, m_wid, 0, 0, w, h, AllPlanes, ZPixmap);
+    SNAPSHOT_REQUEST(XGetGeometry, display, m_wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
+    return SNAPSHOT_REQUEST(XGetImage, display, m_wid, 0, 0, w, h, AllPlanes, ZPixmap);
 }
 
 QRect AppSnapshot::rectRemovedShadow(const QImage &qimage, unsigned char *prop_to_return_gtk)
 {
-    const auto display = Utils::IS_WAYLAND_DISPLAY ? XOpenDisplay(nullptr) : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (!display) {
         qWarning() << "Error: get display failed!";
         return QRect();
     }
 
-    const Atom gtk_frame_extents = XInternAtom(display, "_GTK_FRAME_EXTENTS", true);
+    const Atom gtk_frame_extents = SNAPSHOT_REQUEST(XInternAtom, display, "_GTK_FRAME_EXTENTS", true);
     Atom actual_type_return_gtk;
     int actual_format_return_gtk;
     unsigned long n_items_return_gtk;
     unsigned long bytes_after_return_gtk;
 
-    const auto r = XGetWindowProperty(display, m_wid, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
+    const auto r = SNAPSHOT_REQUEST(XGetWindowProperty, display, m_wid, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
                                       &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
     if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
         qDebug() << "remove shadow frame...";
@@ -419,17 +422,17 @@ void AppSnapshot::getWindowState()
 
     m_isWidowHidden = false;
 
-    const auto display = Utils::IS_WAYLAND_DISPLAY ? XOpenDisplay(nullptr) : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (!display) {
         qWarning() << "Error: get display failed!";
         return;
     }
-    Atom atom_prop = XInternAtom(display, "_NET_WM_STATE", true);
+    Atom atom_prop = SNAPSHOT_REQUEST(XInternAtom, display, "_NET_WM_STATE", true);
     if (!atom_prop) {
         return;
     }
 
-    Status status = XGetWindowProperty(display, m_wid, atom_prop, 0, LONG_MAX, False, AnyPropertyType, &actual_type, &actual_format, &num_items, &bytes_after, &properties);
+    Status status = SNAPSHOT_REQUEST(XGetWindowProperty, display, m_wid, atom_prop, 0, LONG_MAX, False, AnyPropertyType, &actual_type, &actual_format, &num_items, &bytes_after, &properties);
     if (status != Success) {
         qDebug() << "Fail to get window state";
         return;
@@ -437,7 +440,7 @@ void AppSnapshot::getWindowState()
 
     Atom *atoms = reinterpret_cast<Atom *>(properties);
     for (i = 0; i < num_items; ++i) {
-        const char *atomName = XGetAtomName(display, atoms[i]);
+        const char *atomName = SNAPSHOT_REQUEST(XGetAtomName, display, atoms[i]);
 
         if (strcmp(atomName, "_NET_WM_STATE_HIDDEN") == 0) {
             m_isWidowHidden = true;
@@ -11,6 +11,7 @@
 #include "dockapplication.h"
 #include "traymainwindow.h"
 #include "windowmanager.h"
+#include "xcb_connection.h"
 
 #include <QDir>
 #include <QStandardPaths>
@@ -30,6 +31,8 @@
 #include <sys/stat.h>
 #include <signal.h>
 
+#include <X11/Xlib.h>
+
 DWIDGET_USE_NAMESPACE
 #ifdef DCORE_NAMESPACE
 DCORE_USE_NAMESPACE
@@ -148,6 +151,9 @@ bool IsSaveMode()
 
 int main(int argc, char *argv[])
 {
+    // 任务栏的X事件线程和主线程共用一个Xlib连接，XInitThreads必须在Qt打开连接之前调用
+    XInitThreads();
+
     QString currentDesktop = QString(getenv("XDG_CURRENT_DESKTOP"));
     if (currentDesktop.compare("DDE", Qt::CaseInsensitive) == 0 ||
         currentDesktop.compare("deepin", Qt::CaseInsensitive) == 0) {
@@ -232,6 +238,9 @@ int main(int argc, char *argv[])
     QDBusConnection::sessionBus().registerService("org.deepin.dde.daemon.Dock1");
     QDBusConnection::sessionBus().registerObject("/org/deepin/dde/daemon/Dock1", "org.deepin.dde.daemon.Dock1", &windowManager);
 
+    // 各模块X请求数的统计，用于排查X流量
+    XcbConnection::instance()->registerOnBus(QDBusConnection::sessionBus());
+
     // 当任务栏以-r参数启动时，设置CANSHOW未false，之后调用launch不显示任务栏
     qApp->setProperty("CANSHOW", !parser.isSet(runOption));
 
@@ -54,6 +54,7 @@ const QString frontendWindowWmClass     = "dde-dock";
 const QString ddeLauncherWMClass        = "dde-launcher";
 
 const int smartHideTimerDelay           = 400;
+const int activeWindowChangeDelay       = 200;
 const int configureNotifyDelay          = 100;
 
 const int bestIconSize                  = 48;
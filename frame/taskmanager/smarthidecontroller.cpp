@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "smarthidecontroller.h"
+
+#include <QDebug>
+#include <QTimer>
+
+SmartHideController::SmartHideController(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_hideMode(Dock::HideMode::KeepShowing)
+    , m_hideState(Dock::HideState::Unknown)
+    , m_preventAutoHide(false)
+    , m_delay(400)
+    , m_decisionCount(0)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &SmartHideController::onTimerExpired);
+}
+
+void SmartHideController::setDecider(const Decider &decider)
+{
+    m_decider = decider;
+}
+
+void SmartHideController::setDelay(int msec)
+{
+    m_delay = msec;
+}
+
+void SmartHideController::setHideMode(Dock::HideMode mode)
+{
+    m_hideMode = mode;
+}
+
+/**
+ * @brief SmartHideController::setPreventAutoHide 启动器、弹出窗口等显示时任务栏一直显示
+ */
+void SmartHideController::setPreventAutoHide(bool prevent)
+{
+    m_preventAutoHide = prevent;
+}
+
+Dock::HideState SmartHideController::hideState() const
+{
+    return m_hideState;
+}
+
+/**
+ * @brief SmartHideController::resetHideState 直接修改记录的隐藏状态，不发送信号
+ */
+void SmartHideController::resetHideState(Dock::HideState state)
+{
+    m_hideState = state;
+}
+
+void SmartHideController::setHideState(Dock::HideState state)
+{
+    if (state == Dock::HideState::Unknown) {
+        qInfo() << "setPropHideState: unknown mode";
+        return;
+    }
+
+    if (state != m_hideState) {
+        qDebug() << "current hide state: " << m_hideState;
+        m_hideState = state;
+        Q_EMIT hideStateChanged(m_hideState);
+    }
+}
+
+int SmartHideController::decisionCount() const
+{
+    return m_decisionCount;
+}
+
+bool SmartHideController::isPending() const
+{
+    return m_timer->isActive();
+}
+
+/**
+ * @brief SmartHideController::updateHideState 更新任务栏隐藏状态
+ * @param delay 智能隐藏模式下是否延时判断
+ */
+void SmartHideController::updateHideState(bool delay)
+{
+    if (m_preventAutoHide) {
+        setHideState(Dock::HideState::Show);
+        return;
+    }
+
+    switch (m_hideMode) {
+    case Dock::HideMode::KeepShowing:
+        setHideState(Dock::HideState::Show);
+        break;
+    case Dock::HideMode::KeepHidden:
+        setHideState(Dock::HideState::Hide);
+        break;
+    case Dock::HideMode::SmartHide:
+        qInfo() << "reset smart hide mode timer " << delay;
+        m_timer->start(delay ? m_delay : 0);
+        break;
+    }
+}
+
+/**
+ * @brief SmartHideController::onTimerExpired 设置智能隐藏
+ */
+void SmartHideController::onTimerExpired()
+{
+    ++m_decisionCount;
+    Dock::HideState state = (m_decider && m_decider()) ? Dock::HideState::Hide : Dock::HideState::Show;
+    qInfo() << "smartHideModeTimerExpired, should hide ? " << int(state);
+    setHideState(state);
+}
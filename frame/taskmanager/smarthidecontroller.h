@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SMARTHIDECONTROLLER_H
+#define SMARTHIDECONTROLLER_H
+
+#include "constants.h"
+
+#include <QObject>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief SmartHideController 任务栏隐藏状态的判断
+ * 根据隐藏模式决定任务栏显示或隐藏，智能隐藏模式下窗口变化时延时判断，短时间内的多次变化只判断一次，
+ * 具体是否和窗口重叠由外部设置的判断方法决定，不依赖窗口管理和X服务器，方便回放窗口事件进行测试
+ */
+class SmartHideController : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 智能隐藏模式下任务栏是否应该隐藏
+    typedef std::function<bool()> Decider;
+
+    explicit SmartHideController(QObject *parent = nullptr);
+
+    void setDecider(const Decider &decider);
+    void setDelay(int msec);
+    void setHideMode(Dock::HideMode mode);
+    void setPreventAutoHide(bool prevent);
+
+    Dock::HideState hideState() const;
+    void resetHideState(Dock::HideState state);
+    void setHideState(Dock::HideState state);
+
+    int decisionCount() const;
+    // 智能隐藏模式下是否有等待中的判断
+    bool isPending() const;
+
+Q_SIGNALS:
+    void hideStateChanged(int);
+
+public Q_SLOTS:
+    void updateHideState(bool delay);
+
+private Q_SLOTS:
+    void onTimerExpired();
+
+private:
+    QTimer *m_timer;
+    Decider m_decider;
+    Dock::HideMode m_hideMode;
+    Dock::HideState m_hideState;
+    bool m_preventAutoHide;
+    int m_delay;
+    int m_decisionCount;
+};
+
+#endif // SMARTHIDECONTROLLER_H
@@ -15,6 +15,7 @@
 #include "windowinfomap.h"
 #include "windowidentify.h"
 #include "waylandmanager.h"
+#include "smarthidecontroller.h"
 #include "windowinfobase.h"
 #include "dbusutil.h"
 #include "org_deepin_dde_kwayland_plasmawindow.h"
@@ -50,9 +51,18 @@ bool shouldShowEntry(Entry *entry)
 }
 
 TaskManager::TaskManager(QObject *parent)
+ : TaskManager(nullptr, parent)
+{
+}
+
+/**
+ * @brief TaskManager::TaskManager
+ * @param source 读取窗口属性，为空时按会话类型初始化；指定时按X11处理，不启动事件线程，
+ * 由调用者调用X11Manager的事件处理函数投递事件，用于回放测试
+ */
+TaskManager::TaskManager(WindowSource *source, QObject *parent)
  : m_showRecent(DockSettings::instance()->showRecent())
  , m_entriesSum(0)
- , m_hideState(HideState::Unknown)
  , m_ddeLauncherVisible(false)
  , m_trayGridWidgetVisible(false)
  , m_popupVisible(false)
@@ -64,7 +74,10 @@ TaskManager::TaskManager(QObject *parent)
 {
     qRegisterMetaType<WindowInfoMap>("WindowInfoMap");
     qRegisterMetaType<uint32_t>("uint32_t");
-    if (isWaylandSession()) {
+    if (source) {
+        m_isWayland = false;
+        m_x11Manager = new X11Manager(this, source);
+    } else if (isWaylandSession()) {
         m_isWayland = true;
         m_waylandManager = new WaylandManager(this);
         m_dbusHandler->listenWaylandWMSignals();
@@ -75,22 +88,25 @@ TaskManager::TaskManager(QObject *parent)
         qFatal("Unknown XDG_SESSION_TYPE '%s'", sessionType().constData());
     }
 
+    // 初始化智能隐藏
+    m_smartHide = new SmartHideController(this);
+    m_smartHide->setDelay(smartHideTimerDelay);
+    m_smartHide->setDecider([ this ] { return shouldHideOnSmartHideMode(); });
+    connect(m_smartHide, &SmartHideController::hideStateChanged, this, &TaskManager::hideStateChanged);
+
     initSettings();
     initEntries();
 
-    // 初始化智能隐藏定时器
-    m_smartHideTimer = new QTimer(this);
-    m_smartHideTimer->setSingleShot(true);
-    connect(m_smartHideTimer, &QTimer::timeout, this, &TaskManager::smartHideModeTimerExpired);
-
     if (!m_isWayland) {
-        std::thread thread([&] {
-            // Xlib方式
-            m_x11Manager->listenXEventUseXlib();
-            // XCB方式
-            //listenXEventUseXCB();
-        });
-        thread.detach();
+        if (!source) {
+            std::thread thread([&] {
+                // Xlib方式
+                m_x11Manager->listenXEventUseXlib();
+                // XCB方式
+                //listenXEventUseXCB();
+            });
+            thread.detach();
+        }
         m_x11Manager->listenRootWindowXEvent();
         connect(m_x11Manager, &X11Manager::requestUpdateHideState, this, &TaskManager::updateHideState);
         connect(m_x11Manager, &X11Manager::requestHandleActiveWindowChange, this, &TaskManager::handleActiveWindowChanged);
@@ -251,7 +267,7 @@ bool TaskManager::shouldShowOnDock(WindowInfoBase *info)
         bool isReg = m_x11Manager->findWindowByXid(winId);
         bool isContainedInClientList = m_clientList.indexOf(winId) != -1;
         bool shouldSkip = info->shouldSkip();
-        bool isGood = XCB->isGoodWindow(winId);
+        bool isGood = m_x11Manager->windowSource()->isGoodWindow(winId);
         qInfo() << "shouldShowOnDock X11: isReg:" << isReg << " isContainedInClientList:" << isContainedInClientList << " shouldSkip:" << shouldSkip << " isGood:" << isGood;
 
        return isReg && isContainedInClientList && isGood && !shouldSkip;
@@ -346,7 +362,7 @@ void TaskManager::presentWindows(QList<uint> windows)
  */
 HideMode TaskManager::getDockHideMode()
 {
-    return SETTING->getHideMode();
+    return m_hideMode;
 }
 
 /**
@@ -626,16 +642,6 @@ void TaskManager::removePluginSettings(QString pluginName, QStringList settingke
     SETTING->removePluginSettings(pluginName, settingkeys);
 }
 
-/**
- * @brief TaskManager::smartHideModeTimerExpired 设置智能隐藏
- */
-void TaskManager::smartHideModeTimerExpired()
-{
-    HideState state = shouldHideOnSmartHideMode() ? HideState::Hide : HideState::Show;
-    qInfo() << "smartHideModeTimerExpired, should hide ? " << int(state);
-    setPropHideState(state);
-}
-
 /**
  * @brief TaskManager::initSettings 初始化配置
  */
@@ -643,7 +649,9 @@ void TaskManager::initSettings()
 {
     qInfo() << "init dock settings";
     m_forceQuitAppStatus = SETTING->getForceQuitAppMode();
+    m_hideMode = SETTING->getHideMode();
     connect(SETTING, &DockSettings::hideModeChanged, this, [ this ](HideMode mode) {
+        m_hideMode = mode;
         this->updateHideState(false);
     });
     connect(SETTING, &DockSettings::forceQuitAppChanged, this, [ this ](ForceQuitAppMode mode) {
@@ -715,7 +723,7 @@ void TaskManager::initClientList()
         m_dbusHandler->loadClientList();
     } else {
         QList<XWindow> clients;
-        for (auto c : XCB->instance()->getClientList())
+        for (auto c : m_x11Manager->windowSource()->getClientList())
             clients.push_back(c);
 
         // 依次注册窗口
@@ -748,66 +756,6 @@ WindowInfoK *TaskManager::findWindowByXidK(XWindow xid)
     return m_waylandManager->findWindowByXid(xid);
 }
 
-/**
- * @brief TaskManager::isWindowDockOverlapX 判断X环境下窗口和任务栏是否重叠
- * @param xid
- * @return
- * 计算重叠条件：
- * 1 窗口类型非桌面desktop
- * 2 窗口透明度非0
- * 3 窗口显示在当前工作区域
- * 4 窗口和任务栏rect存在重叠区域
- */
-bool TaskManager::isWindowDockOverlapX(XWindow xid)
-{
-    // 检查窗口类型
-    auto desktopType = XCB->getAtom("_NET_WM_WINDOW_TYPE_DESKTOP");
-    for (auto ty : XCB->getWMWindoType(xid)) {
-        if (ty == desktopType) {
-            // 不处理桌面窗口属性
-            return false;
-        }
-    }
-
-    // TODO 检查窗口透明度
-    // 检查窗口是否显示
-    auto wmHiddenType = XCB->getAtom("_NET_WM_STATE_HIDDEN");
-    for (auto ty : XCB->getWMState(xid)) {
-        if (ty == wmHiddenType) {
-            // 不处理隐藏的窗口属性
-            return false;
-        }
-    }
-
-    // 检查窗口是否在当前工作区
-    uint32_t wmDesktop = XCB->getWMDesktop(xid);
-    uint32_t currentDesktop = XCB->getCurrentWMDesktop();
-    if (wmDesktop != currentDesktop) {
-        qInfo() << "isWindowDockOverlapX: wmDesktop:" << wmDesktop << " is not equal to currentDesktop:" << currentDesktop;
-        return false;
-    }
-
-    // 检查窗口和任务栏窗口是否存在重叠
-    auto winRect = XCB->getWindowGeometry(xid);
-    return hasInterSectionX(winRect, m_frontendWindowRect);
-}
-
-/**
- * @brief TaskManager::hasInterSectionX 检查窗口重叠区域
- * @param windowRect 活动窗口
- * @param dockRect  任务栏窗口
- * @return
- */
-bool TaskManager::hasInterSectionX(const Geometry &windowRect, QRect dockRect)
-{
-    int ltX = std::max(int(windowRect.x), dockRect.x());
-    int ltY = std::max(int(windowRect.y), dockRect.y());
-    int rbX = std::min(windowRect.x + windowRect.width, dockRect.x() + dockRect.width());
-    int rbY = std::min(windowRect.y + windowRect.height, dockRect.y() + dockRect.height());
-
-    return (ltX < rbX) && (ltY < rbY);
-}
-
 /**
  * @brief TaskManager::isWindowDockOverlapK 判断Wayland环境下窗口和任务栏是否重叠
  * @param info
@@ -880,121 +828,22 @@ bool TaskManager::shouldHideOnSmartHideMode()
     if (!m_activeWindow || m_ddeLauncherVisible || m_trayGridWidgetVisible || m_popupVisible)
         return false;
 
-    if (!m_isWayland) {
-        XWindow activeWinId = m_activeWindow->getXid();
-
-        // dde launcher is invisible, but it is still active window
-        WMClass winClass = XCB->getWMClass(activeWinId);
-        if (winClass.instanceName.size() > 0 && winClass.instanceName.c_str() == ddeLauncherWMClass) {
-            qInfo() << "shouldHideOnSmartHideMode: active window is dde launcher";
-            return false;
-        }
-
-        QVector<XWindow> list = getActiveWinGroup(activeWinId);
-        for (XWindow xid : list) {
-            if (isWindowDockOverlapX(xid)) {
-                qInfo() << "shouldHideOnSmartHideMode: window has overlap";
-                return true;
-            }
-        }
-        return false;
-    }
+    // 窗口状态由X11Manager根据窗口事件维护，这里只做内存中的区域判断，不再访问X服务器
+    if (!m_isWayland)
+        return m_x11Manager->windowStateIndex()->shouldHide(m_activeWindow->getXid(), m_frontendWindowRect);
 
     return isWindowDockOverlapK(m_activeWindow);
 }
 
-/**
- * @brief TaskManager::getActiveWinGroup
- * @param xid
- * @return
- */
-QVector<XWindow> TaskManager::getActiveWinGroup(XWindow xid)
-{
-    QVector<XWindow> ret;
-    ret.push_back(xid);
-
-    std::list<XWindow> winList = XCB->getClientListStacking();
-    if (winList.empty()
-            || !std::any_of(winList.begin(), winList.end(), [&](XWindow id) { return id == xid;}) // not found active window in clientListStacking"
-        ||  *winList.begin() == 0) // root window
-        return ret;
-
-    uint32_t apid = XCB->getWMPid(xid);
-    XWindow aleaderWin = XCB->getWMClientLeader(xid);
-    for (auto winId : winList) {
-        if (winId == xid)
-            break;
-
-        uint32_t pid = XCB->getWMPid(winId);
-        // same pid
-        if (apid != 0 && pid == apid) {
-            // ok
-            ret.push_back(winId);
-            continue;
-        }
-
-        WMClass wmClass = XCB->getWMClass(winId);
-        // same wmclass
-        if (wmClass.className.size() > 0 && wmClass.className.c_str() == frontendWindowWmClass) {
-            // skip over fronted window
-            continue;
-        }
-
-        uint32_t leaderWin = XCB->getWMClientLeader(winId);
-        // same leaderWin
-        if (aleaderWin != 0 && aleaderWin == leaderWin) {
-            // ok
-            ret.push_back(winId);
-            continue;
-        }
-
-        // above window
-        XWindow aboveWinId = 0;
-        for (auto iter = winList.begin(); iter != winList.end(); iter++) {
-            if (*iter == winId) {
-                aboveWinId = *++iter;
-                break;
-            }
-        }
-
-        if (aboveWinId == 0)
-            continue;
-
-        XWindow aboveWinTransientFor = XCB->getWMTransientFor(aboveWinId);
-        if (aboveWinTransientFor != 0 && aboveWinTransientFor == winId) {
-            // ok
-            ret.push_back(winId);
-            continue;
-        }
-    }
-
-    return ret;
-}
-
 /**
  * @brief TaskManager::updateHideState 更新任务栏隐藏状态
  * @param delay
  */
 void TaskManager::updateHideState(bool delay)
 {
-    if (preventDockAutoHide()) {
-        setPropHideState(HideState::Show);
-        return;
-    }
-
-    HideMode mode = SETTING->getHideMode();
-    switch (mode) {
-    case HideMode::KeepShowing:
-        setPropHideState(HideState::Show);
-        break;
-    case HideMode::KeepHidden:
-        setPropHideState(HideState::Hide);
-        break;
-    case HideMode::SmartHide:
-        qInfo() << "reset smart hide mode timer " << delay;
-        m_smartHideTimer->start(delay ? smartHideTimerDelay : 0);
-        break;
-    }
+    m_smartHide->setPreventAutoHide(preventDockAutoHide());
+    m_smartHide->setHideMode(m_hideMode);
+    m_smartHide->updateHideState(delay);
 }
 
 /**
@@ -1003,16 +852,7 @@ void TaskManager::updateHideState(bool delay)
  */
 void TaskManager::setPropHideState(HideState state)
 {
-    if (state == HideState::Unknown) {
-        qInfo() << "setPropHideState: unknown mode";
-        return;
-    }
-
-    if (state != m_hideState) {
-        qDebug() << "current hide state: " << m_hideState;
-        m_hideState = state;
-        Q_EMIT hideStateChanged(m_hideState);
-    }
+    m_smartHide->setHideState(state);
 }
 
 /**
@@ -1166,7 +1006,7 @@ void TaskManager::handleActiveWindowChanged(WindowInfoBase *info)
     m_activeWindow = info;
     XWindow winId = m_activeWindow->getXid();
     m_entries->handleActiveWindowChanged(winId);
-    QTimer::singleShot(200, std::bind(&TaskManager::updateHideState, this, true));
+    QTimer::singleShot(activeWindowChangeDelay, std::bind(&TaskManager::updateHideState, this, true));
 }
 
 /**
@@ -1264,7 +1104,7 @@ void TaskManager::removeAppEntry(Entry *entry)
  */
 void TaskManager::handleWindowGeometryChanged()
 {
-    if (SETTING->getHideMode() == HideMode::SmartHide)
+    if (m_hideMode == HideMode::SmartHide)
         return;
 
     updateHideState(false);
@@ -1449,7 +1289,7 @@ QList<Entry*> TaskManager::getEntries()
  */
 HideMode TaskManager::getHideMode()
 {
-    return SETTING->getHideMode();
+    return m_hideMode;
 }
 
 /**
@@ -1467,7 +1307,7 @@ void TaskManager::setHideMode(HideMode mode)
  */
 HideState TaskManager::getHideState()
 {
-    return m_hideState;
+    return m_smartHide->hideState();
 }
 
 /**
@@ -1476,7 +1316,7 @@ HideState TaskManager::getHideState()
  */
 void TaskManager::setHideState(HideState state)
 {
-    m_hideState = state;
+    m_smartHide->resetHideState(state);
 }
 
 /**
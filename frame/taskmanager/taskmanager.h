@@ -14,12 +14,16 @@
 #include <QMutex>
 #include <QObject>
 
+#include <atomic>
+
 class WindowIdentify;
 class DBusHandler;
 class WaylandManager;
 class X11Manager;
 class WindowInfoK;
 class WindowInfoX;
+class SmartHideController;
+class WindowSource;
 
 using PlasmaWindow = org::deepin::dde::kwayland1::PlasmaWindow;
 
@@ -144,11 +148,11 @@ Q_SIGNALS:
 public Q_SLOTS:
     void updateHideState(bool delay);
     void handleActiveWindowChanged(WindowInfoBase *info);
-    void smartHideModeTimerExpired();
     void attachOrDetachWindow(WindowInfoBase *info);
 
 private:
     explicit TaskManager(QObject *parent = nullptr);
+    explicit TaskManager(WindowSource *source, QObject *parent = nullptr);
     ~TaskManager();
     void initSettings();
     void initEntries();
@@ -156,13 +160,10 @@ private:
     void initClientList();
     WindowInfoX *findWindowByXidX(XWindow xid);
     WindowInfoK *findWindowByXidK(XWindow xid);
-    bool isWindowDockOverlapX(XWindow xid);
-    bool hasInterSectionX(const Geometry &windowRect, QRect dockRect);
     bool isWindowDockOverlapK(WindowInfoBase *info);
     bool hasInterSectionK(const DockRect &windowRect, QRect dockRect);
     Entry *getDockedEntryByDesktopFile(const QString &desktopFile);
     bool shouldHideOnSmartHideMode();
-    QVector<XWindow> getActiveWinGroup(XWindow xid);
     void updateRecentApps();
 
 private:
@@ -176,9 +177,9 @@ private:
     int m_entriesSum; // 累计打开的应用数量
 
     QString m_wmName; // 窗管名称
-    HideState m_hideState;    // 记录任务栏隐藏状态
     QRect m_frontendWindowRect;    // 前端任务栏大小, 用于智能隐藏时判断窗口是否重合
     ForceQuitAppMode m_forceQuitAppStatus; // 强制退出应用状态
+    std::atomic<HideMode> m_hideMode; // 隐藏模式，主线程修改，事件线程处理ConfigureNotify时也会读取
     bool m_ddeLauncherVisible;
     bool m_trayGridWidgetVisible;
     bool m_popupVisible;
@@ -188,7 +189,7 @@ private:
     WaylandManager *m_waylandManager; // wayland窗口管理
     WindowIdentify *m_windowIdentify; // 窗口识别
 
-    QTimer *m_smartHideTimer; // 任务栏智能隐藏定时器
+    SmartHideController *m_smartHide; // 任务栏隐藏状态判断
     DBusHandler *m_dbusHandler;   // 处理dbus交互
     WindowInfoBase *m_activeWindow;// 记录当前活跃窗口信息
     WindowInfoBase *m_activeWindowOld;// 记录前一个活跃窗口信息
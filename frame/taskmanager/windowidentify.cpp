@@ -368,7 +368,7 @@ AppInfo *WindowIdentify::identifyWindowByFlatpakAppID(TaskManager *_taskmanager,
 AppInfo *WindowIdentify::identifyWindowByCrxId(TaskManager *_taskmanager, WindowInfoX *winInfo, QString &innerId)
 {
     AppInfo *ret = nullptr;
-    WMClass wmClass = XCB->getWMClass(winInfo->getXid());
+    WMClass wmClass = winInfo->getWindowSource()->getWMClass(winInfo->getXid());
     QString className, instanceName;
     className.append(wmClass.className.c_str());
     instanceName.append(wmClass.instanceName.c_str());
@@ -22,8 +22,9 @@
 
 #define XCB XCBUtils::instance()
 
-WindowInfoX::WindowInfoX(XWindow _xid, QObject *parent)
+WindowInfoX::WindowInfoX(XWindow _xid, WindowSource *source, QObject *parent)
  : WindowInfoBase (parent)
+ , m_source(source)
  , m_x(0)
  , m_y(0)
  , m_width(0)
@@ -53,21 +54,21 @@ bool WindowInfoX::shouldSkip()
         return true;
 
     for (auto atom : m_wmWindowType) {
-        if (atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_DIALOG") && !isActionMinimizeAllowed())
+        if (atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_DIALOG") && !isActionMinimizeAllowed())
             return true;
 
-        if (atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_UTILITY")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_COMBO")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_DESKTOP") // 桌面属性窗口
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_DND")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_DOCK")    // 任务栏属性窗口
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_DROPDOWN_MENU")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_MENU")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_NOTIFICATION")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_POPUP_MENU")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_SPLASH")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_TOOLBAR")
-        || atom == XCB->getAtom("_NET_WM_WINDOW_TYPE_TOOLTIP"))
+        if (atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_UTILITY")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_COMBO")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_DESKTOP") // 桌面属性窗口
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_DND")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_DOCK")    // 任务栏属性窗口
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_DROPDOWN_MENU")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_MENU")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_NOTIFICATION")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_POPUP_MENU")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_SPLASH")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_TOOLBAR")
+        || atom == m_source->getAtom("_NET_WM_WINDOW_TYPE_TOOLTIP"))
             return true; 
     }
 
@@ -97,7 +98,7 @@ void WindowInfoX::minimize()
 
 bool WindowInfoX::isMinimized()
 {
-    return containAtom(m_wmState, XCB->getAtom("_NET_WM_STATE_HIDDEN"));
+    return containAtom(m_wmState, m_source->getAtom("_NET_WM_STATE_HIDDEN"));
 }
 
 int64_t WindowInfoX::getCreatedTime()
@@ -123,7 +124,7 @@ bool WindowInfoX::allowClose()
         return true;
 
     for (auto action : m_wmAllowedActions) {
-        if (action == XCB->getAtom("_NET_WM_ACTION_CLOSE")) {
+        if (action == m_source->getAtom("_NET_WM_ACTION_CLOSE")) {
             return true;
         }
     }
@@ -202,6 +203,11 @@ WMClass WindowInfoX::getWMClass()
     return m_wmClass;
 }
 
+WindowSource *WindowInfoX::getWindowSource()
+{
+    return m_source;
+}
+
 QString WindowInfoX::getWMName()
 {
     return m_wmName;
@@ -229,15 +235,14 @@ void WindowInfoX::setGtkAppId(QString _gtkAppId)
 
 void WindowInfoX::updateMotifWmHints()
 {
-    // get from XCB
-    m_motifWmHints = XCB->getWindowMotifWMHints(xid);
+    m_motifWmHints = m_source->getWindowMotifWMHints(xid);
 }
 
 // XEmbed info
 // 一般 tray icon 会带有 _XEMBED_INFO 属性
 void WindowInfoX::updateHasXEmbedInfo()
 {
-    m_hasXEmbedInfo = XCB->hasXEmbedInfo(xid);
+    m_hasXEmbedInfo = m_source->hasXEmbedInfo(xid);
 }
 
 /**
@@ -296,7 +301,7 @@ QString WindowInfoX::genInnerId(WindowInfoX *winInfo)
 void WindowInfoX::updateWmWindowType()
 {
     m_wmWindowType.clear();
-    for (auto ty : XCB->getWMWindoType(xid)) {
+    for (auto ty : m_source->getWMWindoType(xid)) {
         m_wmWindowType.push_back(ty);
     }
 }
@@ -305,7 +310,7 @@ void WindowInfoX::updateWmWindowType()
 void WindowInfoX::updateWmAllowedActions()
 {
     m_wmAllowedActions.clear();
-    for (auto action : XCB->getWMAllowedActions(xid)) {
+    for (auto action : m_source->getWMAllowedActions(xid)) {
         m_wmAllowedActions.push_back(action);
     }
 }
@@ -313,19 +318,19 @@ void WindowInfoX::updateWmAllowedActions()
 void WindowInfoX::updateWmState()
 {
     m_wmState.clear();
-    for (auto a : XCB->getWMState(xid)) {
+    for (auto a : m_source->getWMState(xid)) {
         m_wmState.push_back(a);
     }
 }
 
 void WindowInfoX::updateWmClass()
 {
-    m_wmClass = XCB->getWMClass(xid);
+    m_wmClass = m_source->getWMClass(xid);
 }
 
 void WindowInfoX::updateWmName()
 {
-    auto name = XCB->getWMName(xid);
+    auto name = m_source->getWMName(xid);
     if (!name.empty())
         m_wmName = name.c_str();
 
@@ -339,7 +344,7 @@ void WindowInfoX::updateIcon()
 
 void WindowInfoX::updateHasWmTransientFor()
 {
-    if (XCB->getWMTransientFor(xid) == 1)
+    if (m_source->getWMTransientFor(xid) == 1)
         m_hasWMTransientFor = true;
 }
 
@@ -360,7 +365,7 @@ void WindowInfoX::update()
 
 QString WindowInfoX::getIconFromWindow()
 {
-    WMIcon icon = XCB->getWMIcon(xid);
+    WMIcon icon = m_source->getWMIcon(xid);
 
     // invalid icon
     if (icon.width == 0) {
@@ -383,22 +388,22 @@ QString WindowInfoX::getIconFromWindow()
 
 bool WindowInfoX::isActionMinimizeAllowed()
 {
-    return containAtom(m_wmAllowedActions, XCB->getAtom("_NET_WM_ACTION_MINIMIZE"));
+    return containAtom(m_wmAllowedActions, m_source->getAtom("_NET_WM_ACTION_MINIMIZE"));
 }
 
 bool WindowInfoX::hasWmStateDemandsAttention()
 {
-    return containAtom(m_wmState, XCB->getAtom("_NET_WM_STATE_DEMANDS_ATTENTION"));
+    return containAtom(m_wmState, m_source->getAtom("_NET_WM_STATE_DEMANDS_ATTENTION"));
 }
 
 bool WindowInfoX::hasWmStateSkipTaskBar()
 {
-    return containAtom(m_wmState, XCB->getAtom("_NET_WM_STATE_SKIP_TASKBAR"));
+    return containAtom(m_wmState, m_source->getAtom("_NET_WM_STATE_SKIP_TASKBAR"));
 }
 
 bool WindowInfoX::hasWmStateModal()
 {
-    return containAtom(m_wmState, XCB->getAtom("_NET_WM_STATE_MODAL"));
+    return containAtom(m_wmState, m_source->getAtom("_NET_WM_STATE_MODAL"));
 }
 
 bool WindowInfoX::isValidModal()
@@ -424,12 +429,12 @@ bool WindowInfoX::shouldSkipWithWMClass()
 void WindowInfoX::updateProcessInfo()
 {
     XWindow winId = xid;
-    pid = XCB->getWMPid(winId);
+    pid = m_source->getWMPid(winId);
     qInfo() << "updateProcessInfo: pid=" << pid;
     m_processInfo.reset(new ProcessInfo(pid));
     if (!m_processInfo->isValid()) {
         // try WM_COMMAND
-        auto wmComand = XCB->getWMCommand(winId);
+        auto wmComand = m_source->getWMCommand(winId);
         if (wmComand.size() > 0) {
             QStringList cmds;
             std::transform(wmComand.begin(), wmComand.end(), std::back_inserter(cmds), [=] (std::string cmd){ return QString::fromStdString(cmd);});
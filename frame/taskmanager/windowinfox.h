@@ -7,6 +7,7 @@
 
 #include "windowinfobase.h"
 #include "xcbutils.h"
+#include "windowsource.h"
 
 #include <QVector>
 #include <qobject.h>
@@ -19,7 +20,7 @@ class WindowInfoX: public WindowInfoBase
 {
     Q_OBJECT
 public:
-    WindowInfoX(XWindow _xid = 0, QObject *parent = nullptr);
+    WindowInfoX(XWindow _xid = 0, WindowSource *source = XCBWindowSource::instance(), QObject *parent = nullptr);
     virtual ~WindowInfoX() override;
 
     virtual bool shouldSkip() override;
@@ -43,6 +44,7 @@ public:
     QString getFlatpakAppId();
     QString getWmRole();
     WMClass getWMClass();
+    WindowSource *getWindowSource();
     QString getWMName();
     void updateProcessInfo();
     bool getUpdateCalled();
@@ -73,6 +75,7 @@ private:
     bool shouldSkipWithWMClass();
 
 private:
+    WindowSource *m_source;     // 读取窗口属性
     int16_t m_x;
     int16_t m_y;
     uint16_t m_width;
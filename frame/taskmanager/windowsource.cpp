@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowsource.h"
+
+#define XCB XCBUtils::instance()
+
+XWindow XCBWindowSource::getRootWindow()
+{
+    return XCB->getRootWindow();
+}
+
+XCBAtom XCBWindowSource::getAtom(const char *name)
+{
+    return XCB->getAtom(name);
+}
+
+XWindow XCBWindowSource::getActiveWindow()
+{
+    return XCB->getActiveWindow();
+}
+
+std::list<XWindow> XCBWindowSource::getClientList()
+{
+    return XCB->getClientList();
+}
+
+std::list<XWindow> XCBWindowSource::getClientListStacking()
+{
+    return XCB->getClientListStacking();
+}
+
+uint32_t XCBWindowSource::getCurrentWMDesktop()
+{
+    return XCB->getCurrentWMDesktop();
+}
+
+bool XCBWindowSource::isGoodWindow(XWindow xid)
+{
+    return XCB->isGoodWindow(xid);
+}
+
+Geometry XCBWindowSource::getWindowGeometry(XWindow xid)
+{
+    return XCB->getWindowGeometry(xid);
+}
+
+std::vector<XCBAtom> XCBWindowSource::getWMState(XWindow xid)
+{
+    return XCB->getWMState(xid);
+}
+
+std::vector<XCBAtom> XCBWindowSource::getWMWindoType(XWindow xid)
+{
+    return XCB->getWMWindoType(xid);
+}
+
+std::vector<XCBAtom> XCBWindowSource::getWMAllowedActions(XWindow xid)
+{
+    return XCB->getWMAllowedActions(xid);
+}
+
+uint32_t XCBWindowSource::getWMDesktop(XWindow xid)
+{
+    return XCB->getWMDesktop(xid);
+}
+
+XWindow XCBWindowSource::getWMTransientFor(XWindow xid)
+{
+    return XCB->getWMTransientFor(xid);
+}
+
+XWindow XCBWindowSource::getWMClientLeader(XWindow xid)
+{
+    return XCB->getWMClientLeader(xid);
+}
+
+uint32_t XCBWindowSource::getWMPid(XWindow xid)
+{
+    return XCB->getWMPid(xid);
+}
+
+WMClass XCBWindowSource::getWMClass(XWindow xid)
+{
+    return XCB->getWMClass(xid);
+}
+
+std::string XCBWindowSource::getWMName(XWindow xid)
+{
+    return XCB->getWMName(xid);
+}
+
+std::vector<std::string> XCBWindowSource::getWMCommand(XWindow xid)
+{
+    return XCB->getWMCommand(xid);
+}
+
+WMIcon XCBWindowSource::getWMIcon(XWindow xid)
+{
+    return XCB->getWMIcon(xid);
+}
+
+MotifWMHints XCBWindowSource::getWindowMotifWMHints(XWindow xid)
+{
+    return XCB->getWindowMotifWMHints(xid);
+}
+
+bool XCBWindowSource::hasXEmbedInfo(XWindow xid)
+{
+    return XCB->hasXEmbedInfo(xid);
+}
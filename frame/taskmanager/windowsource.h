@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWSOURCE_H
+#define WINDOWSOURCE_H
+
+#include "xcbutils.h"
+
+/**
+ * @brief WindowSource 窗口和根窗口属性的查询接口
+ * X11Manager、WindowInfoX处理窗口事件时通过这个接口读取属性，默认由XCBWindowSource向X服务器查询，
+ * 回放测试中替换成按脚本返回属性的实现；激活、最小化、关闭窗口这些操作不经过这个接口
+ */
+class WindowSource
+{
+public:
+    virtual ~WindowSource() {}
+
+    // 根窗口
+    virtual XWindow getRootWindow() = 0;
+    virtual XCBAtom getAtom(const char *name) = 0;
+    virtual XWindow getActiveWindow() = 0;
+    virtual std::list<XWindow> getClientList() = 0;
+    virtual std::list<XWindow> getClientListStacking() = 0;
+    virtual uint32_t getCurrentWMDesktop() = 0;
+
+    // 客户窗口
+    virtual bool isGoodWindow(XWindow xid) = 0;
+    virtual Geometry getWindowGeometry(XWindow xid) = 0;
+    virtual std::vector<XCBAtom> getWMState(XWindow xid) = 0;
+    virtual std::vector<XCBAtom> getWMWindoType(XWindow xid) = 0;
+    virtual std::vector<XCBAtom> getWMAllowedActions(XWindow xid) = 0;
+    virtual uint32_t getWMDesktop(XWindow xid) = 0;
+    virtual XWindow getWMTransientFor(XWindow xid) = 0;
+    virtual XWindow getWMClientLeader(XWindow xid) = 0;
+    virtual uint32_t getWMPid(XWindow xid) = 0;
+    virtual WMClass getWMClass(XWindow xid) = 0;
+    virtual std::string getWMName(XWindow xid) = 0;
+    virtual std::vector<std::string> getWMCommand(XWindow xid) = 0;
+    virtual WMIcon getWMIcon(XWindow xid) = 0;
+    virtual MotifWMHints getWindowMotifWMHints(XWindow xid) = 0;
+    virtual bool hasXEmbedInfo(XWindow xid) = 0;
+};
+
+/**
+ * @brief XCBWindowSource 通过XCBUtils向X服务器查询
+ */
+class XCBWindowSource : public WindowSource
+{
+public:
+    static XCBWindowSource *instance() {
+        static XCBWindowSource instance;
+        return &instance;
+    }
+
+    XWindow getRootWindow() override;
+    XCBAtom getAtom(const char *name) override;
+    XWindow getActiveWindow() override;
+    std::list<XWindow> getClientList() override;
+    std::list<XWindow> getClientListStacking() override;
+    uint32_t getCurrentWMDesktop() override;
+
+    bool isGoodWindow(XWindow xid) override;
+    Geometry getWindowGeometry(XWindow xid) override;
+    std::vector<XCBAtom> getWMState(XWindow xid) override;
+    std::vector<XCBAtom> getWMWindoType(XWindow xid) override;
+    std::vector<XCBAtom> getWMAllowedActions(XWindow xid) override;
+    uint32_t getWMDesktop(XWindow xid) override;
+    XWindow getWMTransientFor(XWindow xid) override;
+    XWindow getWMClientLeader(XWindow xid) override;
+    uint32_t getWMPid(XWindow xid) override;
+    WMClass getWMClass(XWindow xid) override;
+    std::string getWMName(XWindow xid) override;
+    std::vector<std::string> getWMCommand(XWindow xid) override;
+    WMIcon getWMIcon(XWindow xid) override;
+    MotifWMHints getWindowMotifWMHints(XWindow xid) override;
+    bool hasXEmbedInfo(XWindow xid) override;
+
+private:
+    XCBWindowSource() {}
+};
+
+#endif // WINDOWSOURCE_H
@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowstateindex.h"
+#include "common.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+WindowStateIndex::WindowStateIndex()
+    : m_currentDesktop(0)
+{
+}
+
+void WindowStateIndex::updateWindow(XWindow xid, const WindowState &state)
+{
+    QWriteLocker locker(&m_lock);
+    m_windows.insert(xid, state);
+}
+
+void WindowStateIndex::removeWindow(XWindow xid)
+{
+    QWriteLocker locker(&m_lock);
+    m_windows.remove(xid);
+}
+
+void WindowStateIndex::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_windows.clear();
+    m_stacking.clear();
+}
+
+void WindowStateIndex::setGeometry(XWindow xid, const Geometry &geometry)
+{
+    updateField(xid, [ & ](WindowState &state) { state.geometry = geometry; });
+}
+
+void WindowStateIndex::setDesktopType(XWindow xid, bool isDesktopType)
+{
+    updateField(xid, [ & ](WindowState &state) { state.isDesktopType = isDesktopType; });
+}
+
+void WindowStateIndex::setHidden(XWindow xid, bool isHidden)
+{
+    updateField(xid, [ & ](WindowState &state) { state.isHidden = isHidden; });
+}
+
+void WindowStateIndex::setDesktop(XWindow xid, uint32_t desktop)
+{
+    updateField(xid, [ & ](WindowState &state) { state.desktop = desktop; });
+}
+
+void WindowStateIndex::setTransientFor(XWindow xid, XWindow transientFor)
+{
+    updateField(xid, [ & ](WindowState &state) { state.transientFor = transientFor; });
+}
+
+void WindowStateIndex::setClientLeader(XWindow xid, XWindow clientLeader)
+{
+    updateField(xid, [ & ](WindowState &state) { state.clientLeader = clientLeader; });
+}
+
+void WindowStateIndex::setPid(XWindow xid, uint32_t pid)
+{
+    updateField(xid, [ & ](WindowState &state) { state.pid = pid; });
+}
+
+void WindowStateIndex::setWMClass(XWindow xid, const QString &instanceName, const QString &className)
+{
+    updateField(xid, [ & ](WindowState &state) {
+        state.instanceName = instanceName;
+        state.className = className;
+    });
+}
+
+void WindowStateIndex::setCurrentDesktop(uint32_t desktop)
+{
+    QWriteLocker locker(&m_lock);
+    m_currentDesktop = desktop;
+}
+
+uint32_t WindowStateIndex::currentDesktop() const
+{
+    QReadLocker locker(&m_lock);
+    return m_currentDesktop;
+}
+
+void WindowStateIndex::setStacking(const QVector<XWindow> &stacking)
+{
+    QWriteLocker locker(&m_lock);
+    m_stacking = stacking;
+}
+
+bool WindowStateIndex::contains(XWindow xid) const
+{
+    QReadLocker locker(&m_lock);
+    return m_windows.contains(xid);
+}
+
+WindowState WindowStateIndex::window(XWindow xid) const
+{
+    QReadLocker locker(&m_lock);
+    return m_windows.value(xid);
+}
+
+int WindowStateIndex::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_windows.size();
+}
+
+QVector<XWindow> WindowStateIndex::activeWindowGroup(XWindow xid) const
+{
+    QReadLocker locker(&m_lock);
+    return activeWindowGroupLocked(xid);
+}
+
+bool WindowStateIndex::isWindowDockOverlap(XWindow xid, const QRect &dockRect) const
+{
+    QReadLocker locker(&m_lock);
+    return isWindowDockOverlapLocked(xid, dockRect);
+}
+
+bool WindowStateIndex::shouldHide(XWindow activeXid, const QRect &dockRect) const
+{
+    QReadLocker locker(&m_lock);
+
+    // dde launcher is invisible, but it is still active window
+    auto activeIt = m_windows.constFind(activeXid);
+    if (activeIt != m_windows.constEnd() && activeIt->instanceName == ddeLauncherWMClass) {
+        qInfo() << "shouldHideOnSmartHideMode: active window is dde launcher";
+        return false;
+    }
+
+    const QVector<XWindow> list = activeWindowGroupLocked(activeXid);
+    for (XWindow xid : list) {
+        if (isWindowDockOverlapLocked(xid, dockRect)) {
+            qInfo() << "shouldHideOnSmartHideMode: window has overlap";
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief WindowStateIndex::hasInterSection 检查窗口重叠区域
+ * @param windowRect 活动窗口
+ * @param dockRect  任务栏窗口
+ * @return
+ */
+bool WindowStateIndex::hasInterSection(const Geometry &windowRect, const QRect &dockRect)
+{
+    int ltX = std::max(int(windowRect.x), dockRect.x());
+    int ltY = std::max(int(windowRect.y), dockRect.y());
+    int rbX = std::min(windowRect.x + windowRect.width, dockRect.x() + dockRect.width());
+    int rbY = std::min(windowRect.y + windowRect.height, dockRect.y() + dockRect.height());
+
+    return (ltX < rbX) && (ltY < rbY);
+}
+
+QVector<XWindow> WindowStateIndex::activeWindowGroupLocked(XWindow xid) const
+{
+    QVector<XWindow> ret;
+    ret.push_back(xid);
+
+    if (m_stacking.isEmpty()
+            || !m_stacking.contains(xid) // not found active window in clientListStacking
+            || m_stacking.first() == 0) // root window
+        return ret;
+
+    const WindowState active = m_windows.value(xid);
+    for (int i = 0; i < m_stacking.size(); ++i) {
+        const XWindow winId = m_stacking.at(i);
+        if (winId == xid)
+            break;
+
+        const WindowState state = m_windows.value(winId);
+        // same pid
+        if (active.pid != 0 && state.pid == active.pid) {
+            ret.push_back(winId);
+            continue;
+        }
+
+        // skip over fronted window
+        if (state.className == frontendWindowWmClass)
+            continue;
+
+        // same leaderWin
+        if (active.clientLeader != 0 && active.clientLeader == state.clientLeader) {
+            ret.push_back(winId);
+            continue;
+        }
+
+        // above window
+        if (i + 1 >= m_stacking.size())
+            continue;
+
+        const XWindow aboveWinId = m_stacking.at(i + 1);
+        auto aboveIt = m_windows.constFind(aboveWinId);
+        if (aboveIt != m_windows.constEnd() && aboveIt->transientFor != 0 && aboveIt->transientFor == winId)
+            ret.push_back(winId);
+    }
+
+    return ret;
+}
+
+/**
+ * 计算重叠条件：
+ * 1 窗口类型非桌面desktop
+ * 2 窗口显示在当前工作区域
+ * 3 窗口和任务栏rect存在重叠区域
+ */
+bool WindowStateIndex::isWindowDockOverlapLocked(XWindow xid, const QRect &dockRect) const
+{
+    auto it = m_windows.constFind(xid);
+    if (it == m_windows.constEnd())
+        return false;
+
+    // 不处理桌面窗口和隐藏的窗口
+    if (it->isDesktopType || it->isHidden)
+        return false;
+
+    if (it->desktop != m_currentDesktop) {
+        qInfo() << "isWindowDockOverlapX: wmDesktop:" << it->desktop << " is not equal to currentDesktop:" << m_currentDesktop;
+        return false;
+    }
+
+    return hasInterSection(it->geometry, dockRect);
+}
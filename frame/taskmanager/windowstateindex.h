@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWSTATEINDEX_H
+#define WINDOWSTATEINDEX_H
+
+#include "xcbutils.h"
+
+#include <QHash>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include <QReadWriteLock>
+
+// 智能隐藏判断需要的窗口状态
+struct WindowState
+{
+    Geometry geometry = {0, 0, 0, 0};
+    bool isDesktopType = false;     // _NET_WM_WINDOW_TYPE包含_NET_WM_WINDOW_TYPE_DESKTOP
+    bool isHidden = false;          // _NET_WM_STATE包含_NET_WM_STATE_HIDDEN
+    uint32_t desktop = 0;           // _NET_WM_DESKTOP
+    XWindow transientFor = 0;       // WM_TRANSIENT_FOR
+    XWindow clientLeader = 0;       // WM_CLIENT_LEADER
+    uint32_t pid = 0;               // _NET_WM_PID
+    QString instanceName;           // WM_CLASS
+    QString className;
+};
+
+/**
+ * @brief WindowStateIndex 顶层窗口状态的内存索引
+ * 由X11Manager在窗口注册时查询一次，之后根据ConfigureNotify/PropertyNotify事件更新，
+ * 智能隐藏判断只读取索引，不再向X服务器查询。事件在Xlib线程中处理，判断在主线程中进行，因此需要加锁
+ */
+class WindowStateIndex
+{
+public:
+    WindowStateIndex();
+
+    void updateWindow(XWindow xid, const WindowState &state);
+    void removeWindow(XWindow xid);
+    void clear();
+
+    void setGeometry(XWindow xid, const Geometry &geometry);
+    void setDesktopType(XWindow xid, bool isDesktopType);
+    void setHidden(XWindow xid, bool isHidden);
+    void setDesktop(XWindow xid, uint32_t desktop);
+    void setTransientFor(XWindow xid, XWindow transientFor);
+    void setClientLeader(XWindow xid, XWindow clientLeader);
+    void setPid(XWindow xid, uint32_t pid);
+    void setWMClass(XWindow xid, const QString &instanceName, const QString &className);
+
+    void setCurrentDesktop(uint32_t desktop);
+    uint32_t currentDesktop() const;
+    // _NET_CLIENT_LIST_STACKING，从下到上
+    void setStacking(const QVector<XWindow> &stacking);
+
+    bool contains(XWindow xid) const;
+    WindowState window(XWindow xid) const;
+    int size() const;
+
+    // 活动窗口和与它同组(同进程、同leader、有瞬态子窗口在其上)的窗口
+    QVector<XWindow> activeWindowGroup(XWindow xid) const;
+    bool isWindowDockOverlap(XWindow xid, const QRect &dockRect) const;
+    // 智能隐藏模式下任务栏是否应该隐藏
+    bool shouldHide(XWindow activeXid, const QRect &dockRect) const;
+
+    static bool hasInterSection(const Geometry &windowRect, const QRect &dockRect);
+
+private:
+    // 只更新已经在索引中的窗口，未注册窗口的事件直接忽略
+    template<typename Func>
+    void updateField(XWindow xid, Func func)
+    {
+        QWriteLocker locker(&m_lock);
+        auto it = m_windows.find(xid);
+        if (it != m_windows.end())
+            func(*it);
+    }
+
+    QVector<XWindow> activeWindowGroupLocked(XWindow xid) const;
+    bool isWindowDockOverlapLocked(XWindow xid, const QRect &dockRect) const;
+
+private:
+    mutable QReadWriteLock m_lock;
+    QHash<XWindow, WindowState> m_windows;
+    QVector<XWindow> m_stacking;
+    uint32_t m_currentDesktop;
+};
+
+#endif // WINDOWSTATEINDEX_H
@@ -9,6 +9,8 @@
 #include <QDebug>
 #include <QTimer>
 
+#include <algorithm>
+
 /*
  *  使用Xlib监听X Events
  *  使用XCB接口与X进行交互
@@ -19,29 +21,41 @@
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <X11/Xproto.h>
+#include <X11/Xlib-xcb.h>
 
 #define XCB XCBUtils::instance()
 
-X11Manager::X11Manager(TaskManager *_taskmanager, QObject *parent)
+/**
+ * @brief X11Manager::X11Manager
+ * @param source 读取窗口属性，为空时向X服务器查询并打开事件线程使用的连接；
+ * 指定时不打开连接，由调用者调用对应的事件处理函数投递事件
+ */
+X11Manager::X11Manager(TaskManager *_taskmanager, WindowSource *source, QObject *parent)
     : QObject(parent)
     , m_taskmanager(_taskmanager)
+    , m_source(source ? source : XCBWindowSource::instance())
     , m_mutex(QMutex(QMutex::NonRecursive))
+    , m_display(nullptr)
     , m_listenXEvent(true)
 {
-    m_rootWindow = XCB->getRootWindow();
+    m_rootWindow = m_source->getRootWindow();
+    if (source)
+        return;
+
+    // 事件线程阻塞在XNextEvent上读取事件，需要独立的连接，不能复用XcbConnection；
+    // 主线程注册窗口时也在这个连接上选择事件，依赖main()中最先调用的XInitThreads
+    m_display = XOpenDisplay(nullptr);
 }
 
 void X11Manager::listenXEventUseXlib()
 {
 
-    Display *dpy;
+    Display *dpy = m_display;
     int screen;
-    char *displayname = nullptr;
     Window w;
     XSetWindowAttributes attr;
     XWindowAttributes wattr;
 
-    dpy = XOpenDisplay (displayname);
     if (!dpy) {
         exit (1);
     }
@@ -97,7 +111,9 @@ void X11Manager::listenXEventUseXlib()
             XMapEvent *eM = (XMapEvent *)(&event);
             // qDebug() << "MapNotify windowId=" << eM->window;
 
-            handleMapNotifyEvent(XWindow(eM->window));
+            // 只处理根窗口上的MapNotify，已注册的客户窗口自身的MapNotify不重复识别窗口
+            if (XWindow(eM->event) == m_rootWindow)
+                handleMapNotifyEvent(XWindow(eM->window));
             break;
         }
         case ConfigureNotify: {
@@ -127,6 +143,7 @@ void X11Manager::listenXEventUseXlib()
     }
 
     XCloseDisplay (dpy);
+    m_display = nullptr;
 }
 
 void X11Manager::listenXEventUseXCB()
@@ -166,12 +183,13 @@ WindowInfoX *X11Manager::registerWindow(XWindow xid)
             break;
         }
 
-        WindowInfoX *winInfo = new WindowInfoX(xid);
+        WindowInfoX *winInfo = new WindowInfoX(xid, m_source);
         if (!winInfo)
             break;
 
         listenWindowXEvent(winInfo);
         m_windowInfoMap[xid] = winInfo;
+        m_windowStateIndex.updateWindow(xid, queryWindowState(xid));
         ret = winInfo;
     } while (0);
 
@@ -184,6 +202,7 @@ void X11Manager::unregisterWindow(XWindow xid)
     qInfo() << "unregisterWindow: windowId=" << xid;
     if (m_windowInfoMap.find(xid) != m_windowInfoMap.end()) {
         m_windowInfoMap.remove(xid);
+        m_windowStateIndex.removeWindow(xid);
     }
 }
 
@@ -199,7 +218,7 @@ WindowInfoX *X11Manager::findWindowByXid(XWindow xid)
 void X11Manager::handleClientListChanged()
 {
     QSet<XWindow> newClientList, oldClientList, addClientList, rmClientList;
-    for (auto atom : XCB->getClientList())
+    for (auto atom : m_source->getClientList())
         newClientList.insert(atom);
 
     for (auto atom : m_taskmanager->getClientList())
@@ -212,14 +231,14 @@ void X11Manager::handleClientListChanged()
     // 处理新增窗口
     for (auto xid : addClientList) {
         WindowInfoX *info = registerWindow(xid);
-        if (!XCB->isGoodWindow(xid))
+        if (!m_source->isGoodWindow(xid))
             continue;
 
-        uint32_t pid = XCB->getWMPid(xid);
-        WMClass wmClass = XCB->getWMClass(xid);
-        QString wmName(XCB->getWMName(xid).c_str());
+        uint32_t pid = m_source->getWMPid(xid);
+        WMClass wmClass = m_source->getWMClass(xid);
+        QString wmName(m_source->getWMName(xid).c_str());
         if (pid != 0 || (wmClass.className.size() > 0 && wmClass.instanceName.size() > 0)
-                || wmName.size() > 0 || XCB->getWMCommand(xid).size() > 0) {
+                || wmName.size() > 0 || m_source->getWMCommand(xid).size() > 0) {
 
             if (info) {
                 Q_EMIT requestAttachOrDetachWindow(info);
@@ -245,17 +264,20 @@ void X11Manager::handleClientListChanged()
 
 void X11Manager::handleActiveWindowChangedX()
 {
-    XWindow active = XCB->getActiveWindow();
+    XWindow active = m_source->getActiveWindow();
     WindowInfoX *info = findWindowByXid(active);
     if (info) {
+        // 被窗管重新设置父窗口的窗口移动时不一定能收到ConfigureNotify，活动窗口变化(包括松开鼠标)时重新同步位置
+        m_windowStateIndex.setGeometry(active, m_source->getWindowGeometry(active));
         Q_EMIT requestHandleActiveWindowChange(info);
     }
 }
 
 void X11Manager::listenRootWindowXEvent()
 {
-    uint32_t eventMask = EventMask::XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY;
-    XCB->registerEvents(m_rootWindow, eventMask);
+    // 根窗口的事件由事件线程在自己的连接上选择(listenXEventUseXlib)
+    m_windowStateIndex.setCurrentDesktop(m_source->getCurrentWMDesktop());
+    updateStacking();
     handleActiveWindowChangedX();
     handleClientListChanged();
 }
@@ -266,21 +288,34 @@ void X11Manager::listenRootWindowXEvent()
  */
 void X11Manager::listenWindowXEvent(WindowInfoX *winInfo)
 {
-    uint32_t eventMask = EventMask::XCB_EVENT_MASK_PROPERTY_CHANGE | EventMask::XCB_EVENT_MASK_STRUCTURE_NOTIFY | EventMask::XCB_EVENT_MASK_VISIBILITY_CHANGE;
-    XCB->registerEvents(winInfo->getXid(), eventMask);
+    // 事件掩码只对选择事件的连接有效，需要在事件线程读取的连接上选择，
+    // 否则收不到客户窗口的_NET_WM_STATE、_NET_WM_DESKTOP等属性变化和客户窗口自身的ConfigureNotify
+    if (!m_display)
+        return;
+
+    // 窗口可能已经销毁，使用带检查的请求，BadWindow错误由这里丢弃，不会交给进程的Xlib错误处理函数
+    xcb_connection_t *conn = XGetXCBConnection(m_display);
+    const uint32_t eventMask = XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_VISIBILITY_CHANGE;
+    xcb_void_cookie_t cookie = xcb_change_window_attributes_checked(conn, winInfo->getXid(), XCB_CW_EVENT_MASK, &eventMask);
+    free(xcb_request_check(conn, cookie));
 }
 
 void X11Manager::handleRootWindowPropertyNotifyEvent(XCBAtom atom)
 {
-    if (atom == XCB->getAtom("_NET_CLIENT_LIST")) {
+    if (atom == m_source->getAtom("_NET_CLIENT_LIST")) {
         // 窗口列表改变
         handleClientListChanged();
-    } else if (atom == XCB->getAtom("_NET_ACTIVE_WINDOW")) {
+    } else if (atom == m_source->getAtom("_NET_ACTIVE_WINDOW")) {
         // 活动窗口改变
         handleActiveWindowChangedX();
-    } else if (atom == XCB->getAtom("_NET_SHOWING_DESKTOP")) {
+    } else if (atom == m_source->getAtom("_NET_SHOWING_DESKTOP")) {
         // 更新任务栏隐藏状态
         Q_EMIT requestUpdateHideState(false);
+    } else if (atom == m_source->getAtom("_NET_CLIENT_LIST_STACKING")) {
+        // 窗口层叠顺序改变
+        updateStacking();
+    } else if (atom == m_source->getAtom("_NET_CURRENT_DESKTOP")) {
+        m_windowStateIndex.setCurrentDesktop(m_source->getCurrentWMDesktop());
     }
 }
 
@@ -315,7 +350,12 @@ void X11Manager::handleMapNotifyEvent(XWindow xid)
 void X11Manager::handleConfigureNotifyEvent(XWindow xid, int x, int y, int width, int height)
 {
     WindowInfoX *winInfo = findWindowByXid(xid);
-    if (!winInfo || m_taskmanager->getDockHideMode() != HideMode::SmartHide)
+    if (!winInfo)
+        return;
+
+    // 直接使用事件中的几何信息，不再向X服务器查询；活动窗口变化时会重新同步一次位置
+    m_windowStateIndex.setGeometry(xid, Geometry{ int16_t(x), int16_t(y), uint16_t(width), uint16_t(height) });
+    if (m_taskmanager->getDockHideMode() != HideMode::SmartHide)
         return;
 
     WMClass wmClass = winInfo->getWMClass();
@@ -337,35 +377,37 @@ void X11Manager::handlePropertyNotifyEvent(XWindow xid, XCBAtom atom)
     if (!winInfo)
         return;
 
+    updateWindowState(xid, atom);
+
     QString newInnerId;
     bool needAttachOrDetach = false;
-    if (atom == XCB->getAtom("_NET_WM_STATE")) {
+    if (atom == m_source->getAtom("_NET_WM_STATE")) {
         winInfo->updateWmState();
         needAttachOrDetach = true;
-    } else if (atom == XCB->getAtom("_GTK_APPLICATION_ID")) {
+    } else if (atom == m_source->getAtom("_GTK_APPLICATION_ID")) {
         QString gtkAppId;
         winInfo->setGtkAppId(gtkAppId);
         newInnerId = winInfo->genInnerId(winInfo);
-    } else if (atom == XCB->getAtom("_NET_WM_PID")) {
+    } else if (atom == m_source->getAtom("_NET_WM_PID")) {
         winInfo->updateProcessInfo();
         newInnerId = winInfo->genInnerId(winInfo);
-    } else if (atom == XCB->getAtom("_NET_WM_NAME")) {
+    } else if (atom == m_source->getAtom("_NET_WM_NAME")) {
         winInfo->updateWmName();
         newInnerId = winInfo->genInnerId(winInfo);
-    } else if (atom == XCB->getAtom("_NET_WM_ICON")) {
+    } else if (atom == m_source->getAtom("_NET_WM_ICON")) {
         winInfo->updateIcon();
-    } else if (atom == XCB->getAtom("_NET_WM_ALLOWED_ACTIONS")) {
+    } else if (atom == m_source->getAtom("_NET_WM_ALLOWED_ACTIONS")) {
         winInfo->updateWmAllowedActions();
-    } else if (atom == XCB->getAtom("_MOTIF_WM_HINTS")) {
+    } else if (atom == m_source->getAtom("_MOTIF_WM_HINTS")) {
         winInfo->updateMotifWmHints();
     } else if (atom == XCB_ATOM_WM_CLASS) {
         winInfo->updateWmClass();
         newInnerId = winInfo->genInnerId(winInfo);
         needAttachOrDetach = true;
-    } else if (atom == XCB->getAtom("_XEMBED_INFO")) {
+    } else if (atom == m_source->getAtom("_XEMBED_INFO")) {
         winInfo->updateHasXEmbedInfo();
         needAttachOrDetach = true;
-    } else if (atom == XCB->getAtom("_NET_WM_WINDOW_TYPE")) {
+    } else if (atom == m_source->getAtom("_NET_WM_WINDOW_TYPE")) {
         winInfo->updateWmWindowType();
         needAttachOrDetach = true;
     } else if (atom == XCB_ATOM_WM_TRANSIENT_FOR) {
@@ -388,18 +430,18 @@ void X11Manager::handlePropertyNotifyEvent(XWindow xid, XCBAtom atom)
     if (!entry)
         return;
 
-    if (atom == XCB->getAtom("_NET_WM_STATE")) {
+    if (atom == m_source->getAtom("_NET_WM_STATE")) {
         // entry->updateExportWindowInfos();
-    } else if (atom == XCB->getAtom("_NET_WM_ICON")) {
+    } else if (atom == m_source->getAtom("_NET_WM_ICON")) {
         if (entry->getCurrentWindowInfo() == winInfo) {
             entry->updateIcon();
         }
-    } else if (atom == XCB->getAtom("_NET_WM_NAME")) {
+    } else if (atom == m_source->getAtom("_NET_WM_NAME")) {
         if (entry->getCurrentWindowInfo() == winInfo) {
             entry->updateName();
         }
         // entry->updateExportWindowInfos();
-    } else if (atom == XCB->getAtom("_NET_WM_ALLOWED_ACTIONS")) {
+    } else if (atom == m_source->getAtom("_NET_WM_ALLOWED_ACTIONS")) {
         entry->updateMenu();
     }
 }
@@ -453,3 +495,73 @@ void X11Manager::delWindowLastConfigureEvent(XWindow xid)
         item.second->deleteLater();
     }
 }
+
+WindowStateIndex *X11Manager::windowStateIndex()
+{
+    return &m_windowStateIndex;
+}
+
+WindowSource *X11Manager::windowSource()
+{
+    return m_source;
+}
+
+static bool containsAtom(const std::vector<XCBAtom> &atoms, XCBAtom atom)
+{
+    return std::find(atoms.begin(), atoms.end(), atom) != atoms.end();
+}
+
+/**
+ * @brief X11Manager::queryWindowState 注册窗口时查询智能隐藏需要的窗口状态，之后由事件更新
+ * @param xid
+ * @return
+ */
+WindowState X11Manager::queryWindowState(XWindow xid)
+{
+    WindowState state;
+    state.geometry = m_source->getWindowGeometry(xid);
+    state.isDesktopType = containsAtom(m_source->getWMWindoType(xid), m_source->getAtom("_NET_WM_WINDOW_TYPE_DESKTOP"));
+    state.isHidden = containsAtom(m_source->getWMState(xid), m_source->getAtom("_NET_WM_STATE_HIDDEN"));
+    state.desktop = m_source->getWMDesktop(xid);
+    state.transientFor = m_source->getWMTransientFor(xid);
+    state.clientLeader = m_source->getWMClientLeader(xid);
+    state.pid = m_source->getWMPid(xid);
+    WMClass wmClass = m_source->getWMClass(xid);
+    state.instanceName = QString::fromStdString(wmClass.instanceName);
+    state.className = QString::fromStdString(wmClass.className);
+    return state;
+}
+
+void X11Manager::updateStacking()
+{
+    QVector<XWindow> stacking;
+    for (XWindow xid : m_source->getClientListStacking())
+        stacking.push_back(xid);
+
+    m_windowStateIndex.setStacking(stacking);
+}
+
+/**
+ * @brief X11Manager::updateWindowState 窗口属性变化时只更新对应的字段
+ * @param xid
+ * @param atom
+ */
+void X11Manager::updateWindowState(XWindow xid, XCBAtom atom)
+{
+    if (atom == m_source->getAtom("_NET_WM_STATE")) {
+        m_windowStateIndex.setHidden(xid, containsAtom(m_source->getWMState(xid), m_source->getAtom("_NET_WM_STATE_HIDDEN")));
+    } else if (atom == m_source->getAtom("_NET_WM_WINDOW_TYPE")) {
+        m_windowStateIndex.setDesktopType(xid, containsAtom(m_source->getWMWindoType(xid), m_source->getAtom("_NET_WM_WINDOW_TYPE_DESKTOP")));
+    } else if (atom == m_source->getAtom("_NET_WM_DESKTOP")) {
+        m_windowStateIndex.setDesktop(xid, m_source->getWMDesktop(xid));
+    } else if (atom == XCB_ATOM_WM_TRANSIENT_FOR) {
+        m_windowStateIndex.setTransientFor(xid, m_source->getWMTransientFor(xid));
+    } else if (atom == m_source->getAtom("WM_CLIENT_LEADER")) {
+        m_windowStateIndex.setClientLeader(xid, m_source->getWMClientLeader(xid));
+    } else if (atom == m_source->getAtom("_NET_WM_PID")) {
+        m_windowStateIndex.setPid(xid, m_source->getWMPid(xid));
+    } else if (atom == XCB_ATOM_WM_CLASS) {
+        WMClass wmClass = m_source->getWMClass(xid);
+        m_windowStateIndex.setWMClass(xid, QString::fromStdString(wmClass.instanceName), QString::fromStdString(wmClass.className));
+    }
+}
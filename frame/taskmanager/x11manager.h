@@ -7,6 +7,8 @@
 
 #include "windowinfox.h"
 #include "xcbutils.h"
+#include "windowsource.h"
+#include "windowstateindex.h"
 
 #include <QObject>
 #include <QMap>
@@ -14,12 +16,13 @@
 #include <QTimer>
 
 class TaskManager;
+typedef struct _XDisplay Display;
 
 class X11Manager : public QObject
 {
     Q_OBJECT
 public:
-    explicit X11Manager(TaskManager *_taskmanager, QObject *parent = nullptr);
+    explicit X11Manager(TaskManager *_taskmanager, WindowSource *source = nullptr, QObject *parent = nullptr);
 
     WindowInfoX *findWindowByXid(XWindow xid);
     WindowInfoX *registerWindow(XWindow xid);
@@ -41,6 +44,9 @@ public:
     void listenXEventUseXlib();
     void listenXEventUseXCB();
 
+    WindowStateIndex *windowStateIndex();
+    WindowSource *windowSource();
+
 Q_SIGNALS:
     void requestUpdateHideState(bool delay);
     void requestHandleActiveWindowChange(WindowInfoBase *info);
@@ -51,13 +57,20 @@ private:
     QPair<ConfigureEvent*, QTimer*> getWindowLastConfigureEvent(XWindow xid);
     void delWindowLastConfigureEvent(XWindow xid);
 
+    WindowState queryWindowState(XWindow xid);
+    void updateWindowState(XWindow xid, XCBAtom atom);
+    void updateStacking();
+
 private:
     QMap<XWindow, WindowInfoX *> m_windowInfoMap;
     TaskManager *m_taskmanager;
+    WindowSource *m_source;                                                       // 读取窗口属性
     QMap<XWindow, QPair<ConfigureEvent*, QTimer*>> m_windowLastConfigureEventMap; // 手动回收ConfigureEvent和QTimer
     QMutex m_mutex;
     XWindow m_rootWindow;                                                         // 根窗口
+    Display *m_display;                                                           // 事件线程读取事件的Xlib连接
     bool m_listenXEvent;                                                          // 监听X事件
+    WindowStateIndex m_windowStateIndex;                                          // 智能隐藏使用的窗口状态
 };
 
 #endif // X11MANAGER_H
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "xcbutils.h"
+#include "xcb_connection.h"
 
 #include <cstdint>
 #include <utility>
@@ -14,10 +15,15 @@
 #include <X11/Xlib.h>
 #include <X11/extensions/XRes.h>
 
+// 每个请求按任务栏窗口管理计数一次
+#define XCB_REQUEST(...) XcbConnection::instance()->call(XcbConnection::TaskManager, __VA_ARGS__)
+
 XCBUtils::XCBUtils()
 {
-    m_connect = xcb_connect(nullptr, &m_screenNum); // nullptr表示默认使用环境变量$DISPLAY获取屏幕
-    if (xcb_connection_has_error(m_connect)) {
+    // 复用进程内唯一的X连接，不再单独建立连接
+    m_connect = XcbConnection::instance()->connection();
+    m_screenNum = XcbConnection::instance()->screenNumber();
+    if (!m_connect || xcb_connection_has_error(m_connect)) {
         std::cout << "XCBUtils: init xcb_connect error" << std::endl;
         return;
     }
@@ -30,10 +36,8 @@ XCBUtils::XCBUtils()
 
 XCBUtils::~XCBUtils()
 {
-    if (m_connect) {
-        xcb_disconnect(m_connect);    // 关闭连接并释放
-        m_connect = nullptr;
-    }
+    // 连接由XcbConnection管理，此处无需关闭
+    m_connect = nullptr;
 }
 
 XWindow XCBUtils::allocId()
@@ -48,18 +52,18 @@ void XCBUtils::flush()
 
 void XCBUtils::killClientChecked(XWindow xid)
 {
-    xcb_kill_client_checked(m_connect, xid);
+    XCB_REQUEST(xcb_kill_client_checked, m_connect, xid);
 }
 
 xcb_get_property_reply_t *XCBUtils::getPropertyValueReply(XWindow xid, XCBAtom property, XCBAtom type)
 {
-    xcb_get_property_cookie_t cookie = xcb_get_property(m_connect,
-                                                        0,
-                                                        xid,
-                                                        property,
-                                                        type,
-                                                        0,
-                                                        MAXLEN);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_get_property, m_connect,
+                                                   0,
+                                                   xid,
+                                                   property,
+                                                   type,
+                                                   0,
+                                                   MAXLEN);
     return xcb_get_property_reply(m_connect, cookie, nullptr);
 }
 
@@ -78,23 +82,16 @@ void *XCBUtils::getPropertyValue(XWindow xid, XCBAtom property, XCBAtom type)
 
 std::string XCBUtils::getUTF8PropertyStr(XWindow xid, XCBAtom property)
 {
-    std::string ret;
-    xcb_get_property_reply_t *reply = getPropertyValueReply(xid, property, m_ewmh.UTF8_STRING);
-    if (reply) {
-        ret = getUTF8StrFromReply(reply);
-        free(reply);
-    }
-    return ret;
+    XcbReply<xcb_get_property_reply_t> reply(getPropertyValueReply(xid, property, m_ewmh.UTF8_STRING));
+    return getUTF8StrFromReply(reply.get());
 }
 
 XCBAtom XCBUtils::getAtom(const char *name)
 {
     XCBAtom ret = m_atomCache.getVal(name);
     if (ret == ATOMNONE) {
-        xcb_intern_atom_cookie_t cookie = xcb_intern_atom(m_connect, false, strlen(name), name);
-        std::shared_ptr<xcb_intern_atom_reply_t> reply(xcb_intern_atom_reply(m_connect, cookie, nullptr), [=](xcb_intern_atom_reply_t* reply){
-            free(reply);}
-        );
+        xcb_intern_atom_cookie_t cookie = XCB_REQUEST(xcb_intern_atom, m_connect, false, strlen(name), name);
+        XcbReply<xcb_intern_atom_reply_t> reply(xcb_intern_atom_reply(m_connect, cookie, nullptr));
         if (reply) {
             m_atomCache.store(name, xcb_atom_t(reply->atom));
             ret = reply->atom;
@@ -108,15 +105,14 @@ std::string XCBUtils::getAtomName(XCBAtom atom)
 {
     std::string ret = m_atomCache.getName(atom);
     if (ret.empty()) {
-        xcb_get_atom_name_cookie_t cookie = xcb_get_atom_name(m_connect, atom);
-        std::shared_ptr<xcb_get_atom_name_reply_t> reply(
-            xcb_get_atom_name_reply(m_connect, cookie, nullptr),
-            [=](xcb_get_atom_name_reply_t* reply) {free(reply);});
+        xcb_get_atom_name_cookie_t cookie = XCB_REQUEST(xcb_get_atom_name, m_connect, atom);
+        XcbReply<xcb_get_atom_name_reply_t> reply(xcb_get_atom_name_reply(m_connect, cookie, nullptr));
         if (reply) {
-            char *name = xcb_get_atom_name_name(reply.get());
+            // 返回的名称不以'\0'结尾，需要按长度截取
+            const char *name = xcb_get_atom_name_name(reply.get());
             if (name) {
-                m_atomCache.store(name, atom);
-                ret = name;
+                ret.assign(name, xcb_get_atom_name_name_length(reply.get()));
+                m_atomCache.store(ret, atom);
             }
         }
     }
@@ -126,11 +122,8 @@ std::string XCBUtils::getAtomName(XCBAtom atom)
 
 Geometry XCBUtils::getWindowGeometry(XWindow xid)
 {
-    xcb_get_geometry_cookie_t cookie = xcb_get_geometry(m_connect, xcb_drawable_t(xid));
-    std::shared_ptr<xcb_get_geometry_reply_t> reply(
-        xcb_get_geometry_reply(m_connect, cookie, nullptr),
-        [=](xcb_get_geometry_reply_t* reply){free(reply);}
-    );
+    xcb_get_geometry_cookie_t cookie = XCB_REQUEST(xcb_get_geometry, m_connect, xcb_drawable_t(xid));
+    XcbReply<xcb_get_geometry_reply_t> reply(xcb_get_geometry_reply(m_connect, cookie, nullptr));
     if (!reply) {
         std::cout << xid << " getWindowGeometry err" << std::endl;
         return Geometry();
@@ -147,11 +140,10 @@ Geometry XCBUtils::getWindowGeometry(XWindow xid)
         return Geometry();
 
     xcb_screen_iterator_t xcbScreenIterator = xcb_setup_roots_iterator(xcbSetup);
-    std::shared_ptr<xcb_translate_coordinates_reply_t> translateReply(
-        xcb_translate_coordinates_reply(m_connect, 
-            xcb_translate_coordinates(m_connect, xid, xcbScreenIterator.data->root, 0, 0),
-            nullptr),
-        [=](xcb_translate_coordinates_reply_t* translateReply){free(translateReply);});
+    XcbReply<xcb_translate_coordinates_reply_t> translateReply(
+        xcb_translate_coordinates_reply(m_connect,
+            XCB_REQUEST(xcb_translate_coordinates, m_connect, xid, xcbScreenIterator.data->root, 0, 0),
+            nullptr));
 
     if (translateReply) {
         ret.x = translateReply->dst_x;
@@ -159,8 +151,7 @@ Geometry XCBUtils::getWindowGeometry(XWindow xid)
     }
 
     XWindow dWin = getDecorativeWindow(xid);
-    reply.reset(xcb_get_geometry_reply(m_connect, xcb_get_geometry(m_connect, xcb_drawable_t(dWin)), nullptr),
-                [=](xcb_get_geometry_reply_t* reply){free(reply);});
+    reply.reset(xcb_get_geometry_reply(m_connect, XCB_REQUEST(xcb_get_geometry, m_connect, xcb_drawable_t(dWin)), nullptr));
     if (!reply)
         return ret;
 
@@ -186,11 +177,8 @@ XWindow XCBUtils::getDecorativeWindow(XWindow xid)
 {
     XWindow winId = xid;
     for (int i = 0; i < 10; i++) {
-        xcb_query_tree_cookie_t cookie = xcb_query_tree(m_connect, winId);
-        std::shared_ptr<xcb_query_tree_reply_t> reply(
-            xcb_query_tree_reply(m_connect, cookie, nullptr),
-            [=](xcb_query_tree_reply_t* reply){free(reply);}
-        );
+        xcb_query_tree_cookie_t cookie = XCB_REQUEST(xcb_query_tree, m_connect, winId);
+        XcbReply<xcb_query_tree_reply_t> reply(xcb_query_tree_reply(m_connect, cookie, nullptr));
         if (!reply) return 0;
         if (reply->root == reply->parent) return winId;
 
@@ -203,15 +191,12 @@ XWindow XCBUtils::getDecorativeWindow(XWindow xid)
 WindowFrameExtents XCBUtils::getWindowFrameExtents(XWindow xid)
 {
     xcb_atom_t perp = getAtom("_NET_FRAME_EXTENTS");
-    xcb_get_property_cookie_t cookie = xcb_get_property(m_connect, false, xid, perp, XCB_ATOM_CARDINAL, 0, 4);
-    std::shared_ptr<xcb_get_property_reply_t> reply(
-        xcb_get_property_reply(m_connect, cookie, nullptr),
-        [=](xcb_get_property_reply_t* reply){free(reply);}
-    );
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_get_property, m_connect, false, xid, perp, XCB_ATOM_CARDINAL, 0, 4);
+    XcbReply<xcb_get_property_reply_t> reply(xcb_get_property_reply(m_connect, cookie, nullptr));
     if (!reply || reply->format == 0) {
         perp = getAtom("_GTK_FRAME_EXTENTS");
-        cookie = xcb_get_property(m_connect, false, xid, perp, XCB_ATOM_CARDINAL, 0, 4);
-        reply.reset(xcb_get_property_reply(m_connect, cookie, nullptr), [=](xcb_get_property_reply_t* reply){free(reply);});
+        cookie = XCB_REQUEST(xcb_get_property, m_connect, false, xid, perp, XCB_ATOM_CARDINAL, 0, 4);
+        reply.reset(xcb_get_property_reply(m_connect, cookie, nullptr));
         if (!reply)
             return WindowFrameExtents();
     }
@@ -231,7 +216,7 @@ WindowFrameExtents XCBUtils::getWindowFrameExtents(XWindow xid)
 XWindow XCBUtils::getActiveWindow()
 {
     XWindow ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_active_window(&m_ewmh, m_screenNum);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_active_window, &m_ewmh, m_screenNum);
     if (!xcb_ewmh_get_active_window_reply(&m_ewmh, cookie, &ret, nullptr)) {
         std::cout << "getActiveWindow error" << std::endl;
     }
@@ -241,24 +226,24 @@ XWindow XCBUtils::getActiveWindow()
 
 void XCBUtils::setActiveWindow(XWindow xid)
 {
-    xcb_ewmh_set_active_window(&m_ewmh, m_screenNum, xid);
+    XCB_REQUEST(xcb_ewmh_set_active_window, &m_ewmh, m_screenNum, xid);
 }
 
 void XCBUtils::changeActiveWindow(XWindow newActiveXid)
 {
-    xcb_ewmh_request_change_active_window(&m_ewmh, m_screenNum, newActiveXid, XCB_EWMH_CLIENT_SOURCE_TYPE_OTHER, XCB_CURRENT_TIME, XCB_WINDOW_NONE);
+    XCB_REQUEST(xcb_ewmh_request_change_active_window, &m_ewmh, m_screenNum, newActiveXid, XCB_EWMH_CLIENT_SOURCE_TYPE_OTHER, XCB_CURRENT_TIME, XCB_WINDOW_NONE);
     flush();
 }
 
 void XCBUtils::restackWindow(XWindow xid)
 {
-    xcb_ewmh_request_restack_window(&m_ewmh, m_screenNum, xid, 0, XCB_STACK_MODE_ABOVE);
+    XCB_REQUEST(xcb_ewmh_request_restack_window, &m_ewmh, m_screenNum, xid, 0, XCB_STACK_MODE_ABOVE);
 }
 
 std::list<XWindow> XCBUtils::getClientList()
 {
     std::list<XWindow> ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_client_list(&m_ewmh, m_screenNum);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_client_list, &m_ewmh, m_screenNum);
     xcb_ewmh_get_windows_reply_t reply;
     if (xcb_ewmh_get_client_list_reply(&m_ewmh, cookie, &reply, nullptr)) {
         for (uint32_t i = 0; i < reply.windows_len; i++) {
@@ -276,7 +261,7 @@ std::list<XWindow> XCBUtils::getClientList()
 std::list<XWindow> XCBUtils::getClientListStacking()
 {
     std::list<XWindow> ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_client_list_stacking(&m_ewmh, m_screenNum);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_client_list_stacking, &m_ewmh, m_screenNum);
     xcb_ewmh_get_windows_reply_t reply;
     if (xcb_ewmh_get_client_list_stacking_reply(&m_ewmh, cookie, &reply, nullptr)) {
         for (uint32_t i = 0; i < reply.windows_len; i++) {
@@ -294,7 +279,7 @@ std::list<XWindow> XCBUtils::getClientListStacking()
 std::vector<XCBAtom> XCBUtils::getWMState(XWindow xid)
 {
     std::vector<XCBAtom> ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_state(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_state, &m_ewmh, xid);
     xcb_ewmh_get_atoms_reply_t reply; // a list of Atom
     if (xcb_ewmh_get_wm_state_reply(&m_ewmh, cookie, &reply, nullptr)) {
         for (uint32_t i = 0; i < reply.atoms_len; i++) {
@@ -312,7 +297,7 @@ std::vector<XCBAtom> XCBUtils::getWMState(XWindow xid)
 std::vector<XCBAtom> XCBUtils::getWMWindoType(XWindow xid)
 {
     std::vector<XCBAtom> ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_window_type(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_window_type, &m_ewmh, xid);
     xcb_ewmh_get_atoms_reply_t reply; // a list of Atom
     if (xcb_ewmh_get_wm_window_type_reply(&m_ewmh, cookie, &reply, nullptr)) {
         for (uint32_t i = 0; i < reply.atoms_len; i++) {
@@ -330,7 +315,7 @@ std::vector<XCBAtom> XCBUtils::getWMWindoType(XWindow xid)
 std::vector<XCBAtom> XCBUtils::getWMAllowedActions(XWindow xid)
 {
     std::vector<XCBAtom> ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_allowed_actions(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_allowed_actions, &m_ewmh, xid);
     xcb_ewmh_get_atoms_reply_t reply;   // a list of Atoms
     if (xcb_ewmh_get_wm_allowed_actions_reply(&m_ewmh, cookie, &reply, nullptr)) {
         for (uint32_t i = 0; i < reply.atoms_len; i++) {
@@ -352,13 +337,13 @@ void XCBUtils::setWMAllowedActions(XWindow xid, std::vector<XCBAtom> actions)
         list[i] = actions[i];
     }
 
-    xcb_ewmh_set_wm_allowed_actions(&m_ewmh, xid, actions.size(), list);
+    XCB_REQUEST(xcb_ewmh_set_wm_allowed_actions, &m_ewmh, xid, actions.size(), list);
 }
 
 std::string XCBUtils::getWMName(XWindow xid)
 {
     std::string ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_name(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_name, &m_ewmh, xid);
     xcb_ewmh_get_utf8_strings_reply_t reply;
     if (xcb_ewmh_get_wm_name_reply(&m_ewmh, cookie, &reply, nullptr)) {
         ret.assign(reply.strings, reply.strings_len);
@@ -380,18 +365,21 @@ uint32_t XCBUtils::getWMPid(XWindow xid)
         .mask = XRES_CLIENT_ID_PID_MASK,
     };
 
-    std::shared_ptr<Display> dpy = {
-        XOpenDisplay(nullptr),
-        [](Display *p){ XCloseDisplay(p); },
-    };
+    // 使用共享的Display，避免每查询一个窗口都新建一次X连接
+    Display *dpy = XcbConnection::instance()->display();
+    if (!dpy)
+        return -1;
 
-    long num_ids;
-    XResClientIdValue *client_ids;
-    XResQueryClientIds(dpy.get(),
-                       1,
-                       &spec,
-                       &num_ids,
-                       &client_ids);
+    long num_ids = 0;
+    XResClientIdValue *client_ids = nullptr;
+    if (XCB_REQUEST(XResQueryClientIds, dpy,
+                    1,
+                    &spec,
+                    &num_ids,
+                    &client_ids) != Success) {
+        XcbConnection::instance()->traceError(XcbConnection::TaskManager, nullptr);
+        return -1;
+    }
 
     pid_t pid = -1;
     for (long i = 0; i < num_ids; i++) {
@@ -408,7 +396,7 @@ uint32_t XCBUtils::getWMPid(XWindow xid)
 std::string XCBUtils::getWMIconName(XWindow xid)
 {
     std::string ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_icon_name(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_icon_name, &m_ewmh, xid);
     xcb_ewmh_get_utf8_strings_reply_t reply;
     if (!xcb_ewmh_get_wm_icon_name_reply(&m_ewmh, cookie, &reply, nullptr)) {
         std::cout << xid << " getWMIconName error" << std::endl;
@@ -422,14 +410,14 @@ std::string XCBUtils::getWMIconName(XWindow xid)
 WMIcon XCBUtils::getWMIcon(XWindow xid)
 {
     WMIcon wmIcon{};
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_icon(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_icon, &m_ewmh, xid);
     xcb_ewmh_get_wm_icon_reply_t reply;
     xcb_generic_error_t* error;
 
     auto ret = xcb_ewmh_get_wm_icon_reply(&m_ewmh, cookie, &reply, &error);
 
     if (error) {
-        std::cout << "failed to get wm icon" << error->error_code;
+        XcbConnection::instance()->traceError(XcbConnection::TaskManager, error);
         std::free(error);
         return wmIcon;
     }
@@ -473,22 +461,23 @@ XWindow XCBUtils::getWMClientLeader(XWindow xid)
 {
     XWindow ret = 0;
     XCBAtom atom = getAtom("WM_CLIENT_LEADER");
-    void *value = getPropertyValue(xid, atom, XCB_ATOM_INTEGER);
-    if (value) {
-        ret = *(XWindow*)(value);
+    // 直接读取reply中的值，getPropertyValue返回时reply已经释放
+    XcbReply<xcb_get_property_reply_t> reply(getPropertyValueReply(xid, atom, XCB_ATOM_INTEGER));
+    if (reply && xcb_get_property_value_length(reply.get()) >= int(sizeof(XWindow))) {
+        ret = *static_cast<XWindow *>(xcb_get_property_value(reply.get()));
     }
     return ret;
 }
 
 void XCBUtils::requestCloseWindow(XWindow xid, uint32_t timestamp)
 {
-    xcb_ewmh_request_close_window(&m_ewmh, m_screenNum, xid, timestamp, XCB_EWMH_CLIENT_SOURCE_TYPE_OTHER);
+    XCB_REQUEST(xcb_ewmh_request_close_window, &m_ewmh, m_screenNum, xid, timestamp, XCB_EWMH_CLIENT_SOURCE_TYPE_OTHER);
 }
 
 uint32_t XCBUtils::getWMDesktop(XWindow xid)
 {
     uint32_t ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_desktop(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_desktop, &m_ewmh, xid);
     if (!xcb_ewmh_get_wm_desktop_reply(&m_ewmh, cookie, &ret, nullptr)) {
         std::cout << xid << " getWMDesktop error" << std::endl;
     }
@@ -498,23 +487,23 @@ uint32_t XCBUtils::getWMDesktop(XWindow xid)
 
 void XCBUtils::setWMDesktop(XWindow xid, uint32_t desktop)
 {
-    xcb_ewmh_set_wm_desktop(&m_ewmh, xid, desktop);
+    XCB_REQUEST(xcb_ewmh_set_wm_desktop, &m_ewmh, xid, desktop);
 }
 
 void XCBUtils::setCurrentWMDesktop(uint32_t desktop)
 {
-    xcb_ewmh_set_current_desktop(&m_ewmh, m_screenNum, desktop);
+    XCB_REQUEST(xcb_ewmh_set_current_desktop, &m_ewmh, m_screenNum, desktop);
 }
 
 void XCBUtils::changeCurrentDesktop(uint32_t newDesktop, uint32_t timestamp)
 {
-    xcb_ewmh_request_change_current_desktop(&m_ewmh, m_screenNum, newDesktop, timestamp);
+    XCB_REQUEST(xcb_ewmh_request_change_current_desktop, &m_ewmh, m_screenNum, newDesktop, timestamp);
 }
 
 uint32_t XCBUtils::getCurrentWMDesktop()
 {
     uint32_t ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_current_desktop(&m_ewmh, m_screenNum);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_current_desktop, &m_ewmh, m_screenNum);
     if (!xcb_ewmh_get_current_desktop_reply(&m_ewmh, cookie, &ret, nullptr)) {
         std::cout << "getCurrentWMDesktop error" << std::endl;
     }
@@ -524,29 +513,25 @@ uint32_t XCBUtils::getCurrentWMDesktop()
 
 bool XCBUtils::isGoodWindow(XWindow xid)
 {
-    bool ret = false;
-    xcb_get_geometry_cookie_t cookie = xcb_get_geometry(m_connect, xid);
-    xcb_generic_error_t **errStore = nullptr;
-    xcb_get_geometry_reply_t *reply = xcb_get_geometry_reply(m_connect, cookie, errStore);
-    if (reply) {
-        // 正常获取窗口geometry则判定为good
-        if (!errStore) {
-            ret = true;
-        } else {
-            free(errStore);
-        }
-
-        free(reply);
+    xcb_get_geometry_cookie_t cookie = XCB_REQUEST(xcb_get_geometry, m_connect, xid);
+    xcb_generic_error_t *error = nullptr;
+    XcbReply<xcb_get_geometry_reply_t> reply(xcb_get_geometry_reply(m_connect, cookie, &error));
+    if (error) {
+        XcbConnection::instance()->traceError(XcbConnection::TaskManager, error);
+        free(error);
+        return false;
     }
-    return ret;
+
+    // 正常获取窗口geometry则判定为good
+    return reply != nullptr;
 }
 
 // TODO XCB下无_MOTIF_WM_HINTS属性
 MotifWMHints XCBUtils::getWindowMotifWMHints(XWindow xid)
 {
     XCBAtom atomWmHints = getAtom("_MOTIF_WM_HINTS");
-    xcb_get_property_cookie_t cookie = xcb_get_property(m_connect, false, xid, atomWmHints, atomWmHints, 0, 5);
-    std::unique_ptr<xcb_get_property_reply_t> reply(xcb_get_property_reply(m_connect, cookie, nullptr));
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_get_property, m_connect, false, xid, atomWmHints, atomWmHints, 0, 5);
+    XcbReply<xcb_get_property_reply_t> reply(xcb_get_property_reply(m_connect, cookie, nullptr));
     if (!reply || reply->format != 32 || reply->value_len != 5)
         return MotifWMHints{0, 0, 0, 0, 0};
 
@@ -570,7 +555,7 @@ bool XCBUtils::hasXEmbedInfo(XWindow xid)
 XWindow XCBUtils::getWMTransientFor(XWindow xid)
 {
     XWindow ret;
-    xcb_get_property_cookie_t cookie = xcb_icccm_get_wm_transient_for(m_connect, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_icccm_get_wm_transient_for, m_connect, xid);
     if (!xcb_icccm_get_wm_transient_for_reply(m_connect, cookie, &ret, nullptr)) {
         std::cout << xid << " getWMTransientFor error" << std::endl;
     }
@@ -581,7 +566,7 @@ XWindow XCBUtils::getWMTransientFor(XWindow xid)
 uint32_t XCBUtils::getWMUserTime(XWindow xid)
 {
     uint32_t ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_user_time(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_user_time, &m_ewmh, xid);
     if (!xcb_ewmh_get_wm_user_time_reply(&m_ewmh, cookie, &ret, nullptr)) {
         std::cout << xid << " getWMUserTime error" << std::endl;
     }
@@ -592,7 +577,7 @@ uint32_t XCBUtils::getWMUserTime(XWindow xid)
 int XCBUtils::getWMUserTimeWindow(XWindow xid)
 {
     XCBAtom ret;
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_user_time_window(&m_ewmh, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_ewmh_get_wm_user_time_window, &m_ewmh, xid);
     if (!xcb_ewmh_get_wm_user_time_window_reply(&m_ewmh, cookie, &ret, nullptr)) {
         std::cout << xid << " getWMUserTimeWindow error" << std::endl;
     }
@@ -603,7 +588,7 @@ int XCBUtils::getWMUserTimeWindow(XWindow xid)
 WMClass XCBUtils::getWMClass(XWindow xid)
 {
     WMClass ret;
-    xcb_get_property_cookie_t cookie = xcb_icccm_get_wm_class(m_connect, xid);
+    xcb_get_property_cookie_t cookie = XCB_REQUEST(xcb_icccm_get_wm_class, m_connect, xid);
     xcb_icccm_get_wm_class_reply_t reply;
     reply.instance_name = nullptr;
     reply.class_name = nullptr;
@@ -626,13 +611,13 @@ void XCBUtils::minimizeWindow(XWindow xid)
     uint32_t data[2];
     data[0] = XCB_ICCCM_WM_STATE_ICONIC;
     data[1] = XCB_NONE;
-    xcb_ewmh_send_client_message(m_connect, xid, getRootWindow(),getAtom("WM_CHANGE_STATE"), 2, data);
+    XCB_REQUEST(xcb_ewmh_send_client_message, m_connect, xid, getRootWindow(),getAtom("WM_CHANGE_STATE"), 2, data);
     flush();
 }
 
 void XCBUtils::maxmizeWindow(XWindow xid)
 {
-    xcb_ewmh_request_change_wm_state(&m_ewmh
+    XCB_REQUEST(xcb_ewmh_request_change_wm_state, &m_ewmh
                                      , m_screenNum
                                      , xid
                                      , XCB_EWMH_WM_STATE_ADD
@@ -644,14 +629,8 @@ void XCBUtils::maxmizeWindow(XWindow xid)
 // TODO
 std::vector<std::string> XCBUtils::getWMCommand(XWindow xid)
 {
-    std::vector<std::string> ret;
-    xcb_get_property_reply_t *reply = getPropertyValueReply(xid, XCB_ATOM_WM_COMMAND, m_ewmh.UTF8_STRING);
-    if (reply) {
-        ret = getUTF8StrsFromReply(reply);
-        free(reply);
-    }
-
-    return ret;
+    XcbReply<xcb_get_property_reply_t> reply(getPropertyValueReply(xid, XCB_ATOM_WM_COMMAND, m_ewmh.UTF8_STRING));
+    return getUTF8StrsFromReply(reply.get());
 }
 
 std::string XCBUtils::getUTF8StrFromReply(xcb_get_property_reply_t *reply)
@@ -711,22 +690,6 @@ XWindow XCBUtils::getRootWindow()
     return rootWindow;
 }
 
-void XCBUtils::registerEvents(XWindow xid, uint32_t eventMask)
-{
-    uint32_t value[1] = {eventMask};
-    xcb_void_cookie_t cookie = xcb_change_window_attributes_checked(m_connect,
-                                                                    xid,
-                                                                    XCB_CW_EVENT_MASK,
-                                                                    &value);
-    flush();
-
-    xcb_generic_error_t *error = xcb_request_check(m_connect, cookie);
-    if (error != nullptr) {
-        std::cout << "window " << xid << "registerEvents error" << std::endl;
-    }
-}
-
-
 AtomCache::AtomCache()
 {
 }
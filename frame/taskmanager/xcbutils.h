@@ -258,9 +258,6 @@ public:
     // 获取根窗口
     XWindow getRootWindow();
 
-    // 注册事件
-    void registerEvents(XWindow xid, uint32_t eventMask);
-
 private:
     XWindow getDecorativeWindow(XWindow xid);
     WindowFrameExtents getWindowFrameExtents(XWindow xid);
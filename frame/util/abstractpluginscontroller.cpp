@@ -15,14 +15,6 @@
 #include <QDir>
 #include <QMapIterator>
 
-static const QStringList CompatiblePluginApiList {
-    "1.1.1",
-    "1.2",
-    "1.2.1",
-    "1.2.2",
-    DOCK_PLUGIN_API_VERSION
-};
-
 AbstractPluginsController::AbstractPluginsController(QObject *parent)
     : QObject(parent)
     , m_pluginManager(nullptr)
@@ -50,7 +42,8 @@ void AbstractPluginsController::startLoader(PluginLoader *loader)
         pair.second = nullptr;
         m_pluginLoadMap.insert(pair, false);
     });
-    connect(loader, &PluginLoader::pluginFound, this, &AbstractPluginsController::loadPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginLoaded, this, &AbstractPluginsController::loadPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginLoadFailed, this, &AbstractPluginsController::rejectPlugin, Qt::QueuedConnection);
 
     int delay = Utils::SettingValue("com.deepin.dde.dock", "/com/deepin/dde/dock/", "delay-plugins-time", 0).toInt();
     QTimer::singleShot(delay, loader, [ = ] { loader->start(QThread::LowestPriority); });
@@ -74,20 +67,10 @@ void AbstractPluginsController::positionChanged()
         inter->positionChanged(position);
 }
 
-void AbstractPluginsController::loadPlugin(const QString &pluginFile)
+void AbstractPluginsController::loadPlugin(const QString &pluginFile, QPluginLoader *pluginLoader)
 {
-    QPluginLoader *pluginLoader = new QPluginLoader(pluginFile, this);
-    const QJsonObject &meta = pluginLoader->metaData().value("MetaData").toObject();
-    const QString &pluginApi = meta.value("api").toString();
-    bool pluginIsValid = true;
-    if (pluginApi.isEmpty() || !CompatiblePluginApiList.contains(pluginApi)) {
-        qDebug() << objectName()
-                 << "plugin api version not matched! expect versions:" << CompatiblePluginApiList
-                 << ", got version:" << pluginApi
-                 << ", the plugin file is:" << pluginFile;
-
-        pluginIsValid = false;
-    }
+    // 插件的动态链接和版本校验已经在PluginLoader的工作线程中完成，这里只创建插件实例
+    pluginLoader->setParent(this);
 
     PluginsItemInterface *interface = qobject_cast<PluginsItemInterface *>(pluginLoader->instance());
     if (!interface) {
@@ -96,17 +79,7 @@ void AbstractPluginsController::loadPlugin(const QString &pluginFile)
         pluginLoader->unload();
         pluginLoader->deleteLater();
 
-        pluginIsValid = false;
-    }
-
-    if (!pluginIsValid) {
-        for (auto &pair : m_pluginLoadMap.keys()) {
-            if (pair.first == pluginFile) {
-                m_pluginLoadMap.remove(pair);
-            }
-        }
-        QString notifyMessage(tr("The plugin %1 is not compatible with the system."));
-        Dtk::Core::DUtil::DNotifySender(notifyMessage.arg(QFileInfo(pluginFile).fileName())).appIcon("dialog-warning").call();
+        rejectPlugin(pluginFile);
         return;
     }
 
@@ -140,6 +113,17 @@ void AbstractPluginsController::loadPlugin(const QString &pluginFile)
     QMetaObject::invokeMethod(this, std::bind(&AbstractPluginsController::initPlugin, this, interface), Qt::QueuedConnection);
 }
 
+void AbstractPluginsController::rejectPlugin(const QString &pluginFile)
+{
+    for (auto &pair : m_pluginLoadMap.keys()) {
+        if (pair.first == pluginFile) {
+            m_pluginLoadMap.remove(pair);
+        }
+    }
+    QString notifyMessage(tr("The plugin %1 is not compatible with the system."));
+    Dtk::Core::DUtil::DNotifySender(notifyMessage.arg(QFileInfo(pluginFile).fileName())).appIcon("dialog-warning").call();
+}
+
 void AbstractPluginsController::initPlugin(PluginsItemInterface *interface)
 {
     if (!interface)
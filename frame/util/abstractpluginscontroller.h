@@ -51,7 +51,8 @@ protected Q_SLOTS:
 private slots:
     void displayModeChanged();
     void positionChanged();
-    void loadPlugin(const QString &pluginFile);
+    void loadPlugin(const QString &pluginFile, QPluginLoader *pluginLoader);
+    void rejectPlugin(const QString &pluginFile);
     void initPlugin(PluginsItemInterface *interface);
 
 private:
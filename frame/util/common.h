@@ -29,6 +29,9 @@ const QString keyShowMultiWindow      = "Show_MultiWindow";
 const QString keyQuickTrayName       = "Dock_Quick_Tray_Name";
 const QString keyShowWindowName      = "Dock_Show_Window_Name";
 const QString keyQuickPlugins        = "Dock_Quick_Plugins";
+const QString keyPluginCallBudget    = "Plugin_Call_Budget";
+const QString keyIsolatedPlugins     = "Isolated_Plugins";
+const QString keyLocalEdgeTrigger    = "Local_Edge_Trigger";
 
 const QString scratchDir = QDir::homePath() + "/.local/dock/scratch/";
 
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "displaystatepipeline.h"
+
+#include <QTimer>
+
+DisplayStatePipeline::DisplayStatePipeline(QObject *parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))
+    , m_outputs(OutputCount)
+    , m_suppressedCount(0)
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, &QTimer::timeout, this, static_cast<void (DisplayStatePipeline::*)()>(&DisplayStatePipeline::flush));
+}
+
+/**
+ * @brief DisplayStatePipeline::setOutput 设置输出
+ * @param output 输出
+ * @param dependencies 输出依赖的输入
+ * @param update 输入变化后推送输出的函数
+ */
+void DisplayStatePipeline::setOutput(Output output, Inputs dependencies, const std::function<void()> &update)
+{
+    m_outputs[output].dependencies = dependencies;
+    m_outputs[output].update = update;
+}
+
+/**
+ * @brief DisplayStatePipeline::setInput 更新输入，值发生变化时依赖它的输出在延时之后推送
+ * 值没有变化时不推送，记录被忽略的次数
+ */
+void DisplayStatePipeline::setInput(Input input, const QVariant &value)
+{
+    auto it = m_inputs.find(input);
+    if (it != m_inputs.end() && it.value() == value) {
+        for (const OutputState &state : m_outputs) {
+            if (state.dependencies.testFlag(input))
+                ++m_suppressedCount;
+        }
+        return;
+    }
+
+    m_inputs.insert(input, value);
+    markDirty(input);
+}
+
+QVariant DisplayStatePipeline::input(Input input) const
+{
+    return m_inputs.value(input);
+}
+
+/**
+ * @brief DisplayStatePipeline::setDelay 输入变化后延时推送，期间的多次变化合并成一次
+ */
+void DisplayStatePipeline::setDelay(int msec)
+{
+    m_flushTimer->setInterval(msec);
+}
+
+/**
+ * @brief DisplayStatePipeline::invalidate 所有输出都需要重新推送，用于初始化
+ */
+void DisplayStatePipeline::invalidate()
+{
+    markDirty(Inputs(QFlag(~0)));
+}
+
+/**
+ * @brief DisplayStatePipeline::flush 立即按顺序推送所有需要更新的输出
+ */
+void DisplayStatePipeline::flush()
+{
+    m_flushTimer->stop();
+
+    // 推送时可能会更新输入(例如任务栏所在的屏幕)，后面的输出在本次一起推送，前面的输出由重新启动的定时器推送
+    for (int i = 0; i < OutputCount; ++i)
+        flush(Output(i));
+}
+
+void DisplayStatePipeline::flush(Output output)
+{
+    OutputState &state = m_outputs[output];
+    if (!state.dirty)
+        return;
+
+    state.dirty = false;
+    ++state.pushCount;
+    if (state.update)
+        state.update();
+}
+
+bool DisplayStatePipeline::isDirty(Output output) const
+{
+    return m_outputs[output].dirty;
+}
+
+int DisplayStatePipeline::pushCount(Output output) const
+{
+    return m_outputs[output].pushCount;
+}
+
+/**
+ * @brief DisplayStatePipeline::suppressedCount
+ * @return 输入没有变化，没有推送给依赖它的输出的次数
+ */
+int DisplayStatePipeline::suppressedCount() const
+{
+    return m_suppressedCount;
+}
+
+void DisplayStatePipeline::markDirty(Inputs inputs)
+{
+    bool changed = false;
+    for (OutputState &state : m_outputs) {
+        if (state.dependencies & inputs) {
+            state.dirty = true;
+            changed = true;
+        }
+    }
+
+    if (changed)
+        m_flushTimer->start();
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DISPLAYSTATEPIPELINE_H
+#define DISPLAYSTATEPIPELINE_H
+
+#include <QObject>
+#include <QMap>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief DisplayStatePipeline 任务栏显示状态的更新流程
+ * 屏幕区域、缩放、主屏、任务栏大小、位置、模式等作为输入，每个输出(通知后端、通知窗管、更新监听区域等)声明依赖的输入，
+ * 只有依赖的输入真正发生变化时才会重新计算并推送，输入没有变化的更新请求直接忽略
+ */
+class DisplayStatePipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Input {
+        Screens         = 0x01,     // 所有屏幕的名称和实际像素区域
+        DeviceRatio     = 0x02,     // 全局缩放比例
+        Primary         = 0x04,     // 主屏
+        DockSize        = 0x08,     // 时尚模式和高效模式下任务栏的大小
+        DockPosition    = 0x10,
+        DockHideMode    = 0x20,
+        DockDisplayMode = 0x40,
+        DockedScreen    = 0x80,     // 任务栏当前所在的屏幕
+    };
+    typedef QFlags<Input> Inputs;
+
+    // 推送的顺序和定义的顺序一致
+    enum Output {
+        TryHide = 0,                // 检查是否需要隐藏任务栏
+        ResetScreen,                // 检查任务栏所在屏幕是否允许停靠
+        UpdateRegion,               // 更新监听区域
+        NotifyFrontend,             // 通知后端任务栏区域
+        NotifyWindowManager,        // 通知窗管任务栏预留区域
+        OutputCount
+    };
+
+    explicit DisplayStatePipeline(QObject *parent = nullptr);
+
+    void setOutput(Output output, Inputs dependencies, const std::function<void()> &update);
+    void setInput(Input input, const QVariant &value);
+    QVariant input(Input input) const;
+
+    void setDelay(int msec);
+    void invalidate();
+    void flush();
+    void flush(Output output);
+
+    bool isDirty(Output output) const;
+    int pushCount(Output output) const;
+    int suppressedCount() const;
+
+private:
+    void markDirty(Inputs inputs);
+
+private:
+    struct OutputState {
+        Inputs dependencies;
+        std::function<void()> update;
+        bool dirty = false;
+        int pushCount = 0;
+    };
+
+    QTimer *m_flushTimer;
+    QVector<OutputState> m_outputs;
+    QMap<Input, QVariant> m_inputs;
+    int m_suppressedCount;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(DisplayStatePipeline::Inputs)
+
+#endif // DISPLAYSTATEPIPELINE_H
@@ -0,0 +1,285 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "dockanimationcontroller.h"
+
+#include <QDBusConnection>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScreen>
+#include <QVariantAnimation>
+
+#define DBUS_PATH "/org/deepin/dde/Dock1/Animations"
+
+static QRect interpolate(const QRect &from, const QRect &to, qreal progress)
+{
+    return QRect(qRound(from.x() + (to.x() - from.x()) * progress),
+                 qRound(from.y() + (to.y() - from.y()) * progress),
+                 qRound(from.width() + (to.width() - from.width()) * progress),
+                 qRound(from.height() + (to.height() - from.height()) * progress));
+}
+
+DockAnimationController::DockAnimationController(QObject *parent)
+    : QObject(parent)
+    , m_clock(new QVariantAnimation(this))
+    , m_stageIndex(-1)
+    , m_frameInterval(16)
+    , m_historySize(20)
+    , m_serial(0)
+    , m_lastFrame(0)
+{
+    // 默认按主屏刷新率计算一帧的时间
+    QScreen *screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+    if (refreshRate > 0)
+        m_frameInterval = qMax(1, qRound(1000 / refreshRate));
+
+    m_clock->setStartValue(0.0);
+    m_clock->setEndValue(1.0);
+    m_clock->setEasingCurve(QEasingCurve::InOutCubic);
+
+    connect(m_clock, &QVariantAnimation::valueChanged, this, [ this ](const QVariant &value) {
+        onFrame(value.toReal());
+    });
+    connect(m_clock, &QVariantAnimation::finished, this, &DockAnimationController::onStageFinished);
+}
+
+void DockAnimationController::setFrameInterval(int msec)
+{
+    m_frameInterval = qMax(1, msec);
+}
+
+void DockAnimationController::setHistorySize(int size)
+{
+    m_historySize = qMax(0, size);
+    while (m_history.size() > m_historySize)
+        m_history.removeFirst();
+}
+
+/**
+ * @brief DockAnimationController::play 依次执行各个阶段的动画，全部结束之后调用finished
+ * 正在执行的动画被打断时，剩下的帧不再执行，但是还没有调用的结束回调会先依次调用，保证使用方的状态(动画标记、任务栏位置等)得到更新
+ * @param name 动画的名称，记录在统计数据中
+ */
+void DockAnimationController::play(const QString &name, const QList<Stage> &stages, const std::function<void()> &finished)
+{
+    const bool running = isRunning();
+    flushInterrupted();
+    if (stages.isEmpty()) {
+        if (running)
+            Q_EMIT runningChanged(false);
+        return;
+    }
+
+    ++m_serial;
+    m_stages = stages;
+    m_finished = finished;
+    m_stageIndex = 0;
+
+    m_current = Stats();
+    m_current.name = name;
+    for (const Stage &stage : m_stages)
+        m_current.duration += stage.duration;
+
+    m_elapsed.start();
+    m_lastFrame = -1;
+    if (!running)
+        Q_EMIT runningChanged(true);
+    startStage();
+}
+
+/**
+ * @brief DockAnimationController::finish 停止正在执行的动画，立即调用还没有调用的结束回调
+ * 用于开始新的动画之前先结束上一次动画，使上一次动画的回调不会覆盖新动画设置的状态
+ */
+void DockAnimationController::finish()
+{
+    if (m_stageIndex < 0)
+        return;
+
+    flushInterrupted();
+    Q_EMIT runningChanged(false);
+}
+
+/**
+ * @brief DockAnimationController::stop 停止正在执行的动画，不再调用结束的回调
+ */
+void DockAnimationController::stop()
+{
+    if (m_stageIndex < 0)
+        return;
+
+    interrupt();
+    Q_EMIT runningChanged(false);
+}
+
+bool DockAnimationController::isRunning() const
+{
+    return m_stageIndex >= 0;
+}
+
+QList<DockAnimationController::Stats> DockAnimationController::history() const
+{
+    return m_history;
+}
+
+bool DockAnimationController::registerOnBus(QDBusConnection connection)
+{
+    return connection.registerObject(DBUS_PATH, this, QDBusConnection::ExportScriptableSlots);
+}
+
+/**
+ * @brief DockAnimationController::Statistics 最近若干次动画的帧间隔和丢帧统计
+ */
+QString DockAnimationController::Statistics() const
+{
+    QJsonArray animations;
+    for (const Stats &stats : m_history) {
+        QJsonArray intervals;
+        for (int interval : stats.intervals)
+            intervals << interval;
+
+        QJsonObject animation;
+        animation["name"] = stats.name;
+        animation["duration"] = stats.duration;
+        animation["elapsed"] = stats.elapsed;
+        animation["frames"] = stats.frames;
+        animation["missedFrames"] = stats.missedFrames;
+        animation["maxInterval"] = stats.maxInterval;
+        animation["interrupted"] = stats.interrupted;
+        animation["intervals"] = intervals;
+        animations << animation;
+    }
+
+    QJsonObject statistics;
+    statistics["frameInterval"] = m_frameInterval;
+    statistics["animations"] = animations;
+    return QString::fromUtf8(QJsonDocument(statistics).toJson(QJsonDocument::Compact));
+}
+
+void DockAnimationController::Reset()
+{
+    m_history.clear();
+}
+
+/**
+ * @brief DockAnimationController::interrupt 停止正在执行的动画
+ * @return 还没有调用的结束回调，按原本的顺序排列
+ */
+QList<std::function<void()>> DockAnimationController::interrupt()
+{
+    QList<std::function<void()>> callbacks;
+    if (m_stageIndex < 0)
+        return callbacks;
+
+    for (int i = m_stageIndex; i < m_stages.size(); ++i) {
+        if (m_stages.at(i).finished)
+            callbacks << m_stages.at(i).finished;
+    }
+    if (m_finished)
+        callbacks << m_finished;
+
+    m_stageIndex = -1;
+    m_clock->stop();
+    record(true);
+    m_stages.clear();
+    m_finished = nullptr;
+    return callbacks;
+}
+
+void DockAnimationController::flushInterrupted()
+{
+    // 回调中可能又开始了新的动画，一并打断
+    while (isRunning()) {
+        for (const std::function<void()> &callback : interrupt())
+            callback();
+    }
+}
+
+void DockAnimationController::startStage()
+{
+    // 时长为0的阶段不经过动画时钟直接结束，避免在时钟自己的finished信号中重新启动时钟
+    if (m_stages.at(m_stageIndex).duration <= 0) {
+        onStageFinished();
+        return;
+    }
+
+    m_clock->setDuration(m_stages.at(m_stageIndex).duration);
+    m_clock->start();
+}
+
+void DockAnimationController::onFrame(qreal progress)
+{
+    if (m_stageIndex < 0)
+        return;
+
+    const qint64 now = m_elapsed.elapsed();
+    if (m_lastFrame >= 0) {
+        const int interval = int(now - m_lastFrame);
+        m_current.intervals << interval;
+        m_current.maxInterval = qMax(m_current.maxInterval, interval);
+        // 按四舍五入计算这段间隔跨过了几帧
+        m_current.missedFrames += qMax(0, (interval + m_frameInterval / 2) / m_frameInterval - 1);
+    }
+    m_lastFrame = now;
+    ++m_current.frames;
+
+    for (const Track &track : m_stages.at(m_stageIndex).tracks)
+        track.update(interpolate(track.start, track.end, progress));
+}
+
+void DockAnimationController::onStageFinished()
+{
+    if (m_stageIndex < 0)
+        return;
+
+    const Stage stage = m_stages.at(m_stageIndex);
+    for (const Track &track : stage.tracks)
+        track.update(track.end);
+
+    if (m_stageIndex + 1 < m_stages.size()) {
+        // 回调中可能停止或者重新开始动画，此时不再继续执行下一个阶段
+        const int serial = m_serial;
+        if (stage.finished)
+            stage.finished();
+        if (serial != m_serial || m_stageIndex < 0)
+            return;
+
+        ++m_stageIndex;
+        startStage();
+        return;
+    }
+
+    // 先结束本次动画再回调，回调中可以开始新的动画
+    const std::function<void()> finished = m_finished;
+    m_stageIndex = -1;
+    m_stages.clear();
+    m_finished = nullptr;
+    record(false);
+    Q_EMIT runningChanged(false);
+
+    if (stage.finished)
+        stage.finished();
+    if (finished)
+        finished();
+}
+
+void DockAnimationController::record(bool interrupted)
+{
+    m_current.elapsed = int(m_elapsed.elapsed());
+    m_current.interrupted = interrupted;
+    if (m_current.missedFrames > 0)
+        qDebug() << "dock animation" << m_current.name << "missed" << m_current.missedFrames << "frames, max interval:"
+                 << m_current.maxInterval << "ms, elapsed:" << m_current.elapsed << "ms";
+
+    if (m_historySize <= 0)
+        return;
+
+    m_history << m_current;
+    while (m_history.size() > m_historySize)
+        m_history.removeFirst();
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DOCKANIMATIONCONTROLLER_H
+#define DOCKANIMATIONCONTROLLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QRect>
+#include <QVector>
+
+#include <functional>
+
+class QVariantAnimation;
+class QDBusConnection;
+
+/**
+ * @brief DockAnimationController 任务栏显示、隐藏、切换位置的动画
+ * 所有任务栏窗口共用一个常驻的动画时钟，每一帧按同一个进度计算各个窗口的位置，不再每次创建和销毁动画组；
+ * 同时记录每一帧的间隔和丢帧数，保留最近若干次动画的统计数据，用来衡量动画的卡顿情况，
+ * 统计数据通过DBus接口org.deepin.dde.Dock1.Animations提供给调试工具
+ */
+class DockAnimationController : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.Dock1.Animations")
+
+public:
+    // 一个窗口的动画，每一帧调用update更新窗口位置，结束时以end调用一次
+    struct Track {
+        QRect start;
+        QRect end;
+        std::function<void(const QRect &)> update;
+
+        bool isValid() const { return bool(update); }
+    };
+
+    // 同时执行的一组窗口动画，多个阶段依次执行
+    struct Stage {
+        QList<Track> tracks;
+        int duration = 0;
+        std::function<void()> finished;
+    };
+
+    struct Stats {
+        QString name;
+        int duration = 0;           // 预计的时长
+        int elapsed = 0;            // 实际的时长
+        int frames = 0;
+        int missedFrames = 0;       // 超过一帧的时间才绘制的帧数
+        int maxInterval = 0;
+        bool interrupted = false;   // 没有播放完就被停止
+        QVector<int> intervals;     // 每一帧和上一帧的间隔(毫秒)
+    };
+
+    explicit DockAnimationController(QObject *parent = nullptr);
+
+    void setFrameInterval(int msec);
+    void setHistorySize(int size);
+
+    void play(const QString &name, const QList<Stage> &stages, const std::function<void()> &finished = nullptr);
+    void finish();
+    void stop();
+
+    bool isRunning() const;
+    QList<Stats> history() const;
+
+    bool registerOnBus(QDBusConnection connection);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString Statistics() const;
+    Q_SCRIPTABLE void Reset();
+
+Q_SIGNALS:
+    void runningChanged(bool running);
+
+private:
+    QList<std::function<void()>> interrupt();
+    void flushInterrupted();
+    void startStage();
+    void onFrame(qreal progress);
+    void onStageFinished();
+    void record(bool interrupted);
+
+private:
+    QVariantAnimation *m_clock;
+    QList<Stage> m_stages;
+    std::function<void()> m_finished;
+    int m_stageIndex;
+    int m_frameInterval;
+    int m_historySize;
+    int m_serial;
+
+    QElapsedTimer m_elapsed;
+    qint64 m_lastFrame;
+    Stats m_current;
+    QList<Stats> m_history;
+};
+
+#endif // DOCKANIMATIONCONTROLLER_H
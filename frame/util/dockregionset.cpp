@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "dockregionset.h"
+
+#include <QDebug>
+
+DockRegionSet::DockRegionSet(RegionMonitor *monitor)
+    : m_monitor(monitor)
+    , m_position(Dock::Bottom)
+    , m_registeredFlags(0)
+{
+    for (int i = 0; i < RegionCount; ++i) {
+        m_thickness[i] = 0;
+        m_dirty[i] = true;
+    }
+}
+
+void DockRegionSet::setScreens(const QList<QRect> &screenRects)
+{
+    if (m_screenRects == screenRects)
+        return;
+
+    m_screenRects = screenRects;
+    markAllDirty();
+}
+
+void DockRegionSet::setPosition(Dock::Position position)
+{
+    if (m_position == position)
+        return;
+
+    m_position = position;
+    markAllDirty();
+}
+
+void DockRegionSet::setThickness(Region region, int thickness)
+{
+    if (m_thickness[region] == thickness)
+        return;
+
+    m_thickness[region] = thickness;
+    m_dirty[region] = true;
+}
+
+QList<MonitRect> DockRegionSet::areas(Region region) const
+{
+    return m_areas[region];
+}
+
+QString DockRegionSet::key(Region region) const
+{
+    return m_keys[region];
+}
+
+int DockRegionSet::commit(int flags)
+{
+    // 监听的事件类型变化时所有区域都需要重新注册
+    if (m_registeredFlags != flags) {
+        m_registeredFlags = flags;
+        for (int i = 0; i < RegionCount; ++i)
+            m_registeredAreas[i].clear();
+    }
+
+    int calls = 0;
+    for (int i = 0; i < RegionCount; ++i) {
+        if (m_dirty[i]) {
+            m_areas[i] = edgeAreas(m_screenRects, m_position, m_thickness[i]);
+            m_dirty[i] = false;
+        }
+
+        if (!m_keys[i].isEmpty() && m_registeredAreas[i] == m_areas[i])
+            continue;
+
+        if (!m_keys[i].isEmpty()) {
+            m_monitor->unregisterArea(m_keys[i]);
+            m_keys[i].clear();
+            ++calls;
+        }
+
+        m_registeredAreas[i] = m_areas[i];
+        if (m_areas[i].isEmpty())
+            continue;
+
+        m_keys[i] = m_monitor->registerAreas(m_areas[i], flags);
+        ++calls;
+#ifdef QT_DEBUG
+        for (const MonitRect &rect : m_areas[i])
+            qDebug() << "监听区域" << i << ":" << rect.x1 << rect.y1 << rect.x2 << rect.y2;
+#endif
+    }
+
+    return calls;
+}
+
+void DockRegionSet::reset()
+{
+    for (int i = 0; i < RegionCount; ++i) {
+        m_keys[i].clear();
+        m_registeredAreas[i].clear();
+    }
+}
+
+/**
+ * @brief DockRegionSet::edgeAreas 计算每个屏幕指定边缘上一定宽度的区域
+ * @param screenRects 屏幕区域
+ * @param position 任务栏位置
+ * @param thickness 区域宽度
+ * @return 去掉重复(复制模式)之后的区域
+ */
+QList<MonitRect> DockRegionSet::edgeAreas(const QList<QRect> &screenRects, Dock::Position position, int thickness)
+{
+    QList<MonitRect> areas;
+    for (const QRect &screenRect : screenRects) {
+        MonitRect rect;
+        rect.x1 = screenRect.x();
+        rect.y1 = screenRect.y();
+        rect.x2 = screenRect.x() + screenRect.width();
+        rect.y2 = screenRect.y() + screenRect.height();
+
+        switch (position) {
+        case Dock::Top:
+            rect.y2 = rect.y1 + thickness;
+            break;
+        case Dock::Bottom:
+            rect.y1 = rect.y2 - thickness;
+            break;
+        case Dock::Left:
+            rect.x2 = rect.x1 + thickness;
+            break;
+        case Dock::Right:
+            rect.x1 = rect.x2 - thickness;
+            break;
+        }
+
+        if (!areas.contains(rect))
+            areas << rect;
+    }
+
+    return areas;
+}
+
+void DockRegionSet::markAllDirty()
+{
+    for (int i = 0; i < RegionCount; ++i)
+        m_dirty[i] = true;
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef DOCKREGIONSET_H
+#define DOCKREGIONSET_H
+
+#include "constants.h"
+#include "regionmonitor.h"
+
+#include <QList>
+#include <QRect>
+
+/**
+ * @brief DockRegionSet 任务栏需要监听的三组屏幕边缘区域
+ * 区域只在屏幕布局、任务栏位置或者区域宽度变化时重新计算，
+ * 提交时和已经注册的区域比较，只有发生变化的那一组区域才会注销并重新注册
+ */
+class DockRegionSet
+{
+public:
+    enum Region {
+        Monitor = 0,    // 唤起任务栏区域
+        Extral,         // 任务栏区域，鼠标离开后隐藏任务栏
+        Touch,          // 触屏唤起任务栏区域
+        RegionCount
+    };
+
+    explicit DockRegionSet(RegionMonitor *monitor);
+
+    // 可以停靠任务栏的屏幕区域，已经换算成实际像素
+    void setScreens(const QList<QRect> &screenRects);
+    void setPosition(Dock::Position position);
+    void setThickness(Region region, int thickness);
+
+    QList<MonitRect> areas(Region region) const;
+    QString key(Region region) const;
+
+    // 注册有变化的区域，返回注册和注销的调用次数
+    int commit(int flags);
+    // 监听服务重新启动后已经注册的区域都失效了，清除记录，下次提交时全部重新注册
+    void reset();
+
+    static QList<MonitRect> edgeAreas(const QList<QRect> &screenRects, Dock::Position position, int thickness);
+
+private:
+    void markAllDirty();
+
+private:
+    RegionMonitor *m_monitor;
+    QList<QRect> m_screenRects;
+    Dock::Position m_position;
+    int m_thickness[RegionCount];
+    bool m_dirty[RegionCount];
+
+    QList<MonitRect> m_areas[RegionCount];
+    QList<MonitRect> m_registeredAreas[RegionCount];
+    QString m_keys[RegionCount];
+    int m_registeredFlags;
+};
+
+#endif // DOCKREGIONSET_H
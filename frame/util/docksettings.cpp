@@ -5,9 +5,11 @@
 #include "docksettings.h"
 #include "settings.h"
 #include "common.h"
+#include "pluginsettingsstore.h"
 
 #include <DConfig>
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -18,12 +20,22 @@ DCORE_USE_NAMESPACE
 DockSettings::DockSettings(QObject *parent)
  : QObject (parent)
  , m_dockSettings(Settings::ConfigPtr(configDock))
+ , m_pluginSettings(new PluginSettingsStore([ this ] {
+        return m_dockSettings ? m_dockSettings->value(keyPluginSettings).toString() : QString();
+    }, [ this ](const QString &jsonStr) {
+        if (m_dockSettings)
+            m_dockSettings->setValue(keyPluginSettings, jsonStr);
+    }, this))
 {
     init();
 }
 
 void DockSettings::init()
 {
+    // 退出前写入还未写入的插件配置
+    if (qApp)
+        connect(qApp, &QCoreApplication::aboutToQuit, m_pluginSettings, &PluginSettingsStore::flush);
+
     // 绑定属性
     if (m_dockSettings) {
             connect(m_dockSettings, &DConfig::valueChanged, this, [&] (const QString &key) {
@@ -49,6 +61,10 @@ void DockSettings::init()
                     Q_EMIT windowSizeFashionChanged(m_dockSettings->value(keyWindowSizeFashion, 48).toUInt());
                 } else if ( key == keyWindowSizeEfficient) {
                     Q_EMIT windowSizeEfficientChanged(m_dockSettings->value(keyWindowSizeEfficient, 40).toUInt());
+                } else if (key == keyPluginSettings) {
+                    m_pluginSettings->reload();
+                } else if (key == keyPluginCallBudget) {
+                    Q_EMIT pluginCallBudgetChanged(getPluginCallBudget());
                 }
             });
     }
@@ -291,98 +307,57 @@ bool DockSettings::showMultiWindow() const
     return m_dockSettings->value(keyShowMultiWindow).toBool();
 }
 
-QString DockSettings::getPluginSettings()
+uint DockSettings::getPluginCallBudget()
 {
-    QString ret;
+    uint budget = 100;
     if (m_dockSettings) {
-        ret = m_dockSettings->value(keyPluginSettings).toString();
+        budget = m_dockSettings->value(keyPluginCallBudget, budget).toUInt();
     }
-
-    qInfo() << "getpluginsettings:" << ret;
-    return ret;
+    return budget;
 }
 
-void DockSettings::setPluginSettings(QString jsonStr)
+QStringList DockSettings::getIsolatedPlugins()
 {
-    if (jsonStr.isEmpty())
-        return;
+    if (!m_dockSettings)
+        return QStringList();
 
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyPluginSettings, jsonStr);
-    }
+    return m_dockSettings->value(keyIsolatedPlugins).toStringList();
 }
 
-void DockSettings::mergePluginSettings(QString jsonStr)
+bool DockSettings::getLocalEdgeTrigger()
 {
-    QString origin = getPluginSettings();
-    QJsonObject originSettings = plguinSettingsStrToObj(origin);
-    QJsonObject needMergeSettings = plguinSettingsStrToObj(jsonStr);
-    for (auto pluginsIt = needMergeSettings.begin(); pluginsIt != needMergeSettings.end(); pluginsIt++) {
-        const QString &pluginName = pluginsIt.key();
-        const QJsonObject &needMergeSettingsObj = pluginsIt.value().toObject();
-        QJsonObject originSettingsObj = originSettings.value(pluginName).toObject();
-        for (auto settingsIt = needMergeSettingsObj.begin(); settingsIt != needMergeSettingsObj.end(); settingsIt++) {
-            originSettingsObj.insert(settingsIt.key(), settingsIt.value());
-        }
+    if (!m_dockSettings)
+        return true;
 
-        // 重写plugin对应的设置
-        originSettings.remove(pluginName);
-        originSettings.insert(pluginName, originSettingsObj);
-    }
+    return m_dockSettings->value(keyLocalEdgeTrigger, true).toBool();
+}
 
-    setPluginSettings(QJsonDocument(originSettings).toJson(QJsonDocument::JsonFormat::Compact));
+PluginSettingsStore *DockSettings::pluginSettings() const
+{
+    return m_pluginSettings;
 }
 
-void DockSettings::removePluginSettings(QString pluginName, QStringList settingkeys)
+QString DockSettings::getPluginSettings()
 {
-    if (pluginName.isEmpty())
-        return;
+    return m_pluginSettings->toJson();
+}
 
-    QString origin = getPluginSettings();
-    QJsonObject originSettings = plguinSettingsStrToObj(origin);
-    if (settingkeys.size() == 0) {
-        originSettings.remove(pluginName);
-    } else {
-        for (auto pluginsIt = originSettings.begin(); pluginsIt != originSettings.end(); pluginsIt++) {
-            const QString &pluginName = pluginsIt.key();
-            if (pluginName != pluginName)
-                continue;
-
-            QJsonObject originSettingsObj = originSettings.value(pluginName).toObject();
-            for (const auto &key : settingkeys) {
-                originSettingsObj.remove(key);
-            }
-
-            // 重写plugin对应的设置
-            originSettings.remove(pluginName);
-            originSettings.insert(pluginName, originSettingsObj);
-        }
-    }
+void DockSettings::setPluginSettings(QString jsonStr)
+{
+    if (jsonStr.isEmpty())
+        return;
 
-    setPluginSettings(QJsonDocument(originSettings).toJson(QJsonDocument::JsonFormat::Compact));
+    m_pluginSettings->reset(PluginSettingsStore::parse(jsonStr));
 }
 
-// 借鉴自dde-dock
-QJsonObject DockSettings::plguinSettingsStrToObj(QString jsonStr)
+void DockSettings::mergePluginSettings(QString jsonStr)
 {
-    QJsonObject ret;
-    const QJsonObject &pluginSettingsObject = QJsonDocument::fromJson(jsonStr.toLocal8Bit()).object();
-    if (pluginSettingsObject.isEmpty()) {
-        return ret;
-    }
-
-    for (auto pluginsIt = pluginSettingsObject.constBegin(); pluginsIt != pluginSettingsObject.constEnd(); ++pluginsIt) {
-        const QString &pluginName = pluginsIt.key();
-        const QJsonObject &settingsObject = pluginsIt.value().toObject();
-        QJsonObject newSettingsObject = ret.value(pluginName).toObject();
-        for (auto settingsIt = settingsObject.constBegin(); settingsIt != settingsObject.constEnd(); ++settingsIt) {
-            newSettingsObject.insert(settingsIt.key(), settingsIt.value());
-        }
-        // TODO: remove not exists key-values
-        ret.insert(pluginName, newSettingsObject);
-    }
+    m_pluginSettings->merge(PluginSettingsStore::parse(jsonStr));
+}
 
-    return ret;
+void DockSettings::removePluginSettings(QString pluginName, QStringList settingkeys)
+{
+    m_pluginSettings->remove(pluginName, settingkeys);
 }
 
 QStringList DockSettings::getQuickPlugins()
@@ -163,6 +163,7 @@ public:
 };
 
 class Settings;
+class PluginSettingsStore;
 namespace Dtk {
 namespace Core {
 class DConfig;
@@ -226,12 +227,16 @@ public:
     void setShowMultiWindow(bool showMultiWindow);
     bool showMultiWindow() const;
 
+    uint getPluginCallBudget();
+    QStringList getIsolatedPlugins();
+    bool getLocalEdgeTrigger();
+
     // plugin settings
+    PluginSettingsStore *pluginSettings() const;
     QString getPluginSettings();
     void setPluginSettings(QString jsonStr);
     void mergePluginSettings(QString jsonStr);
     void removePluginSettings(QString pluginName, QStringList settingkeys);
-    QJsonObject plguinSettingsStrToObj(QString jsonStr);
 
 Q_SIGNALS:
     // 隐藏模式改变
@@ -256,6 +261,8 @@ Q_SIGNALS:
     void windowSizeFashionChanged(uint size);
     // 高效模式dock尺寸改变
     void windowSizeEfficientChanged(uint size);
+    // 插件单次调用的耗时上限改变
+    void pluginCallBudgetChanged(uint msec);
 
 private:
     DockSettings(QObject *paret = nullptr);
@@ -266,6 +273,7 @@ private:
 
 private:
     DConfig *m_dockSettings;
+    PluginSettingsStore *m_pluginSettings;
 };
 
 #endif // DOCKSETTINGS_H
@@ -0,0 +1,355 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "edgetriggerengine.h"
+
+#include <QDebug>
+#include <QSocketNotifier>
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/extensions/XIproto.h>
+
+static quint64 packPosition(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+static void recordCallback(XPointer closure, XRecordInterceptData *data)
+{
+    if (data->category == XRecordFromServer && data->data) {
+        const xEvent *event = reinterpret_cast<const xEvent *>(data->data);
+        XRecordPointerSource *source = reinterpret_cast<XRecordPointerSource *>(closure);
+        const int type = event->u.u.type & 0x7f;
+        if (type >= LASTEvent) {
+            // XInput扩展的设备事件，只用来判断随后的核心事件来自哪个设备
+            const deviceKeyButtonPointer *deviceEvent = reinterpret_cast<const deviceKeyButtonPointer *>(data->data);
+            source->handleDeviceEvent(deviceEvent->deviceid & DEVICE_BITS);
+        } else {
+            source->handleRecordEvent(type, event->u.u.detail,
+                                      event->u.keyButtonPointer.rootX, event->u.keyButtonPointer.rootY);
+        }
+    }
+
+    XRecordFreeData(data);
+}
+
+XRecordPointerSource::XRecordPointerSource(QObject *parent)
+    : QObject(parent)
+    , m_controlDisplay(nullptr)
+    , m_dataDisplay(nullptr)
+    , m_context(0)
+    , m_xiOpcode(0)
+    , m_xiEventBase(0)
+    , m_controlNotifier(nullptr)
+    , m_touchEvent(false)
+    , m_motionPending(false)
+    , m_position(0)
+{
+    for (std::atomic<quint8> &kind : m_deviceKinds)
+        kind = OtherDevice;
+}
+
+XRecordPointerSource::~XRecordPointerSource()
+{
+    stop();
+}
+
+bool XRecordPointerSource::start()
+{
+    if (m_context)
+        return true;
+
+    // XRecordEnableContext会一直阻塞读取数据，需要和控制用的连接分开
+    m_controlDisplay = XOpenDisplay(nullptr);
+    m_dataDisplay = XOpenDisplay(nullptr);
+    int major = 0, minor = 0;
+    if (!m_controlDisplay || !m_dataDisplay || !XRecordQueryVersion(m_controlDisplay, &major, &minor)) {
+        qWarning() << "XRecord extension is not available";
+        stop();
+        return false;
+    }
+
+    queryTouchDevices();
+
+    XRecordRange *ranges[2] = { XRecordAllocRange(), XRecordAllocRange() };
+    if (!ranges[0] || !ranges[1]) {
+        XFree(ranges[0]);
+        XFree(ranges[1]);
+        stop();
+        return false;
+    }
+
+    ranges[0]->device_events.first = ButtonPress;
+    ranges[0]->device_events.last = MotionNotify;
+    // 服务器先记录slave设备的XInput事件，再记录master设备的核心事件，据此过滤触摸屏模拟的鼠标移动；
+    // 启动后才接入的触摸屏也要能区分，支持XInput 2.2时始终记录设备事件
+    const int rangeCount = m_xiEventBase ? 2 : 1;
+    ranges[1]->device_events.first = m_xiEventBase + XI_DeviceButtonPress;
+    ranges[1]->device_events.last = m_xiEventBase + XI_DeviceMotionNotify;
+    XRecordClientSpec clients = XRecordAllClients;
+    m_context = XRecordCreateContext(m_controlDisplay, 0, &clients, 1, ranges, rangeCount);
+    XFree(ranges[0]);
+    XFree(ranges[1]);
+    if (!m_context) {
+        qWarning() << "failed to create XRecord context";
+        stop();
+        return false;
+    }
+
+    XSync(m_controlDisplay, False);
+    if (m_xiEventBase) {
+        m_controlNotifier = new QSocketNotifier(ConnectionNumber(m_controlDisplay), QSocketNotifier::Read, this);
+        connect(m_controlNotifier, &QSocketNotifier::activated, this, &XRecordPointerSource::handleControlEvents);
+        // XSync时已经读到缓冲区中的事件不会触发通知
+        handleControlEvents();
+    }
+
+    m_thread = std::thread([ this ] {
+        XRecordEnableContext(m_dataDisplay, m_context, recordCallback, reinterpret_cast<XPointer>(this));
+    });
+
+    return true;
+}
+
+void XRecordPointerSource::stop()
+{
+    delete m_controlNotifier;
+    m_controlNotifier = nullptr;
+
+    if (m_context) {
+        XRecordDisableContext(m_controlDisplay, m_context);
+        XFlush(m_controlDisplay);
+        if (m_thread.joinable())
+            m_thread.join();
+
+        XRecordFreeContext(m_controlDisplay, m_context);
+        m_context = 0;
+    }
+
+    if (m_dataDisplay) {
+        XCloseDisplay(m_dataDisplay);
+        m_dataDisplay = nullptr;
+    }
+
+    if (m_controlDisplay) {
+        XCloseDisplay(m_controlDisplay);
+        m_controlDisplay = nullptr;
+    }
+}
+
+void XRecordPointerSource::handleRecordEvent(int type, int detail, int x, int y)
+{
+    switch (type) {
+    case MotionNotify:
+        // 有移动事件时认为是鼠标，触摸时不能清除按下的状态
+        if (m_touchEvent)
+            break;
+
+        m_position = packPosition(x, y);
+        // 主线程还没有处理上一次的位置时不再重复投递
+        if (!m_motionPending.exchange(true))
+            QMetaObject::invokeMethod(this, &XRecordPointerSource::flushMotion, Qt::QueuedConnection);
+        break;
+    case ButtonPress:
+    case ButtonRelease:
+        QMetaObject::invokeMethod(this, [ = ] {
+            Q_EMIT button(detail, type == ButtonPress, x, y);
+        }, Qt::QueuedConnection);
+        break;
+    default:
+        break;
+    }
+}
+
+void XRecordPointerSource::handleDeviceEvent(int deviceId)
+{
+    // master设备的事件和核心事件一起记录，不能说明事件来源
+    const quint8 kind = m_deviceKinds[deviceId & 0x7f].load(std::memory_order_relaxed);
+    if (kind != MasterDevice)
+        m_touchEvent = kind == TouchDevice;
+}
+
+void XRecordPointerSource::flushMotion()
+{
+    m_motionPending = false;
+    const quint64 position = m_position;
+    Q_EMIT motion(int(qint32(position >> 32)), int(qint32(position & 0xffffffff)));
+}
+
+/**
+ * @brief XRecordPointerSource::queryTouchDevices 查询触摸屏设备，启动时和设备变化时在主线程中调用
+ * 不支持XInput 2.2时不区分触摸屏，和之前一样处理所有的移动事件
+ */
+void XRecordPointerSource::queryTouchDevices()
+{
+    if (!m_xiEventBase) {
+        int eventBase = 0, errorBase = 0;
+        if (!XQueryExtension(m_controlDisplay, "XInputExtension", &m_xiOpcode, &eventBase, &errorBase))
+            return;
+
+        int major = 2, minor = 2;
+        if (XIQueryVersion(m_controlDisplay, &major, &minor) != Success || major * 100 + minor < 202)
+            return;
+
+        // 监听设备的插拔和类型变化，事件在控制连接上读取
+        unsigned char mask[XIMaskLen(XI_LASTEVENT)] = { 0 };
+        XISetMask(mask, XI_HierarchyChanged);
+        XISetMask(mask, XI_DeviceChanged);
+        XIEventMask eventMask;
+        eventMask.deviceid = XIAllDevices;
+        eventMask.mask_len = sizeof(mask);
+        eventMask.mask = mask;
+        XISelectEvents(m_controlDisplay, DefaultRootWindow(m_controlDisplay), &eventMask, 1);
+
+        m_xiEventBase = eventBase;
+    }
+
+    QSet<int> masterDevices;
+    QSet<int> touchDevices;
+    int count = 0;
+    XIDeviceInfo *devices = XIQueryDevice(m_controlDisplay, XIAllDevices, &count);
+    for (int i = 0; i < count; ++i) {
+        const XIDeviceInfo &device = devices[i];
+        if (device.use == XIMasterPointer || device.use == XIMasterKeyboard) {
+            masterDevices << device.deviceid;
+            continue;
+        }
+
+        for (int j = 0; j < device.num_classes; ++j) {
+            if (device.classes[j]->type == XITouchClass
+                    && reinterpret_cast<XITouchClassInfo *>(device.classes[j])->mode == XIDirectTouch)
+                touchDevices << device.deviceid;
+        }
+    }
+    XIFreeDeviceInfo(devices);
+
+    setDevices(masterDevices, touchDevices);
+}
+
+void XRecordPointerSource::setDevices(const QSet<int> &masterDevices, const QSet<int> &touchDevices)
+{
+    for (int deviceId = 0; deviceId < int(m_deviceKinds.size()); ++deviceId) {
+        DeviceKind kind = OtherDevice;
+        if (masterDevices.contains(deviceId))
+            kind = MasterDevice;
+        else if (touchDevices.contains(deviceId))
+            kind = TouchDevice;
+        m_deviceKinds[deviceId].store(kind, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief XRecordPointerSource::handleControlEvents 读取控制连接上的XInput事件
+ * 设备插拔或者设备本身变化时重新查询触摸屏，slave切换引起的变化不需要处理
+ */
+void XRecordPointerSource::handleControlEvents()
+{
+    bool devicesChanged = false;
+    while (XPending(m_controlDisplay)) {
+        XEvent event;
+        XNextEvent(m_controlDisplay, &event);
+        XGenericEventCookie *cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != m_xiOpcode || !XGetEventData(m_controlDisplay, cookie))
+            continue;
+
+        if (cookie->evtype == XI_HierarchyChanged)
+            devicesChanged = true;
+        else if (cookie->evtype == XI_DeviceChanged)
+            devicesChanged |= reinterpret_cast<XIDeviceChangedEvent *>(cookie->data)->reason == XIDeviceChange;
+
+        XFreeEventData(m_controlDisplay, cookie);
+    }
+
+    if (devicesChanged)
+        queryTouchDevices();
+}
+
+EdgeTriggerEngine::EdgeTriggerEngine(QObject *parent)
+    : RegionMonitor(parent)
+    , m_serial(0)
+    , m_pointerSource(nullptr)
+{
+}
+
+QString EdgeTriggerEngine::registerAreas(const QList<MonitRect> &areas, int flags)
+{
+    const QString key = QString("edge-%1").arg(++m_serial);
+    AreaSet areaSet;
+    areaSet.areas = areas;
+    areaSet.flags = flags;
+    m_areaSets.insert(key, areaSet);
+    return key;
+}
+
+bool EdgeTriggerEngine::unregisterArea(const QString &key)
+{
+    return m_areaSets.remove(key) > 0;
+}
+
+bool EdgeTriggerEngine::listenPointer()
+{
+    if (m_pointerSource)
+        return true;
+
+    m_pointerSource = new XRecordPointerSource(this);
+    if (!m_pointerSource->start()) {
+        delete m_pointerSource;
+        m_pointerSource = nullptr;
+        return false;
+    }
+
+    connect(m_pointerSource, &XRecordPointerSource::motion, this, &EdgeTriggerEngine::handleMotion);
+    connect(m_pointerSource, &XRecordPointerSource::button, this, &EdgeTriggerEngine::handleButton);
+    return true;
+}
+
+void EdgeTriggerEngine::handleMotion(int x, int y)
+{
+    // 处理信号时可能会重新注册区域，先复制一份key
+    const QStringList keys = m_areaSets.keys();
+    for (const QString &key : keys) {
+        auto it = m_areaSets.find(key);
+        if (it == m_areaSets.end() || !(it->flags & Motion))
+            continue;
+
+        if (contains(it->areas, x, y)) {
+            if (!it->inside) {
+                it->inside = true;
+                Q_EMIT cursorInto(x, y, key);
+            }
+            Q_EMIT cursorMove(x, y, key);
+        } else if (it->inside) {
+            it->inside = false;
+            Q_EMIT cursorOut(x, y, key);
+        }
+    }
+}
+
+void EdgeTriggerEngine::handleButton(int button, bool press, int x, int y)
+{
+    const QStringList keys = m_areaSets.keys();
+    for (const QString &key : keys) {
+        auto it = m_areaSets.constFind(key);
+        if (it == m_areaSets.constEnd() || !(it->flags & Button) || !contains(it->areas, x, y))
+            continue;
+
+        if (press)
+            Q_EMIT buttonPress(button, x, y, key);
+        else
+            Q_EMIT buttonRelease(button, x, y, key);
+    }
+}
+
+bool EdgeTriggerEngine::contains(const QList<MonitRect> &areas, int x, int y)
+{
+    for (const MonitRect &rect : areas) {
+        if (x >= rect.x1 && x <= rect.x2 && y >= rect.y1 && y <= rect.y2)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef EDGETRIGGERENGINE_H
+#define EDGETRIGGERENGINE_H
+
+#include "regionmonitor.h"
+
+#include <QMap>
+#include <QSet>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+class QSocketNotifier;
+typedef struct _XDisplay Display;
+
+/**
+ * @brief XRecordPointerSource 使用XRecord扩展记录所有客户端的鼠标移动和按键事件
+ * 事件在单独的线程中读取，连续的移动事件只把最新的位置交给主线程，按键事件逐个通知；
+ * 和XEventMonitor服务一样，触摸屏只通知按下和松开，不通知触摸模拟的鼠标移动
+ */
+class XRecordPointerSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit XRecordPointerSource(QObject *parent = nullptr);
+    ~XRecordPointerSource() override;
+
+    // X服务器不支持XRecord扩展时返回false
+    bool start();
+    void stop();
+
+    // 在XRecord线程中调用
+    void handleRecordEvent(int type, int detail, int x, int y);
+    void handleDeviceEvent(int deviceId);
+
+Q_SIGNALS:
+    void motion(int x, int y);
+    void button(int button, bool press, int x, int y);
+
+private:
+    void flushMotion();
+    void queryTouchDevices();
+    void setDevices(const QSet<int> &masterDevices, const QSet<int> &touchDevices);
+    void handleControlEvents();
+
+private:
+    Display *m_controlDisplay;
+    Display *m_dataDisplay;
+    unsigned long m_context;
+    std::thread m_thread;
+
+    enum DeviceKind : quint8 {
+        OtherDevice,
+        MasterDevice,
+        TouchDevice,                    // 触摸屏的slave设备
+    };
+
+    int m_xiOpcode;
+    int m_xiEventBase;                  // XInput扩展的事件基数，不支持时为0
+    QSocketNotifier *m_controlNotifier; // 设备插拔或变化时在主线程中重新查询触摸屏
+    // 按设备id保存设备类型，主线程更新，XRecord线程读取
+    std::array<std::atomic<quint8>, 128> m_deviceKinds;
+    bool m_touchEvent;                  // XRecord线程中使用，当前的核心事件是否由触摸屏产生
+
+    std::atomic<bool> m_motionPending;
+    std::atomic<quint64> m_position;    // x和y打包保存，主线程读到的总是同一次移动的位置
+};
+
+/**
+ * @brief EdgeTriggerEngine 在任务栏进程内判断鼠标是否进入注册的区域
+ * 和org.deepin.dde.XEventMonitor1服务的判断规则一致，省去了每个事件经过D-Bus转发的开销
+ */
+class EdgeTriggerEngine : public RegionMonitor
+{
+    Q_OBJECT
+
+public:
+    explicit EdgeTriggerEngine(QObject *parent = nullptr);
+
+    QString registerAreas(const QList<MonitRect> &areas, int flags) override;
+    bool unregisterArea(const QString &key) override;
+
+    // 开始监听鼠标事件，X服务器不支持时返回false
+    bool listenPointer();
+
+public Q_SLOTS:
+    void handleMotion(int x, int y);
+    void handleButton(int button, bool press, int x, int y);
+
+private:
+    struct AreaSet {
+        QList<MonitRect> areas;
+        int flags = 0;
+        bool inside = false;
+    };
+
+    static bool contains(const QList<MonitRect> &areas, int x, int y);
+
+private:
+    QMap<QString, AreaSet> m_areaSets;
+    int m_serial;
+    XRecordPointerSource *m_pointerSource;
+};
+
+#endif // EDGETRIGGERENGINE_H
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "geometrytransaction.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimer>
+
+GeometryTransaction::GeometryTransaction(QObject *parent)
+    : QObject(parent)
+    , m_frameTimer(new QTimer(this))
+    , m_idleTimer(new QTimer(this))
+    , m_active(false)
+    , m_pending(false)
+    , m_changed(false)
+    , m_size(0)
+    , m_applyCount(0)
+    , m_commitCount(0)
+{
+    // 默认按主屏刷新率计算一帧的时间
+    QScreen *screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+    m_frameTimer->setInterval(refreshRate > 0 ? qMax(1, int(1000 / refreshRate)) : 16);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &GeometryTransaction::applyPending);
+
+    // 拖拽中鼠标停住不动时也没有更新，超时不能太短
+    m_idleTimer->setInterval(3000);
+    m_idleTimer->setSingleShot(true);
+    connect(m_idleTimer, &QTimer::timeout, this, &GeometryTransaction::onIdleTimeout);
+}
+
+void GeometryTransaction::setApplyFunction(const Function &apply)
+{
+    m_apply = apply;
+}
+
+void GeometryTransaction::setCommitFunction(const Function &commit)
+{
+    m_commit = commit;
+}
+
+void GeometryTransaction::setFrameInterval(int msec)
+{
+    m_frameTimer->setInterval(msec);
+}
+
+/**
+ * @brief GeometryTransaction::setIdleTimeout 事务中超过这个时间没有更新时自动结束
+ */
+void GeometryTransaction::setIdleTimeout(int msec)
+{
+    m_idleTimer->setInterval(msec);
+}
+
+bool GeometryTransaction::isActive() const
+{
+    return m_active;
+}
+
+int GeometryTransaction::size() const
+{
+    return m_size;
+}
+
+int GeometryTransaction::applyCount() const
+{
+    return m_applyCount;
+}
+
+int GeometryTransaction::commitCount() const
+{
+    return m_commitCount;
+}
+
+void GeometryTransaction::begin()
+{
+    if (m_active)
+        return;
+
+    m_active = true;
+    m_pending = false;
+    m_changed = false;
+    m_idleTimer->start();
+}
+
+/**
+ * @brief GeometryTransaction::update 更新任务栏大小
+ * 事务中只记录最新的大小，下一帧统一更新窗口；不在事务中时立即更新并提交
+ */
+void GeometryTransaction::update(int size)
+{
+    if (!m_active) {
+        m_size = size;
+        m_pending = true;
+        applyPending();
+        ++m_commitCount;
+        if (m_commit)
+            m_commit(m_size);
+        return;
+    }
+
+    m_idleTimer->start();
+
+    // 和上一次的大小相同时不需要更新
+    if (m_changed && m_size == size)
+        return;
+
+    m_size = size;
+    m_pending = true;
+    m_changed = true;
+
+    // 同一帧内的多次变化只更新一次
+    if (!m_frameTimer->isActive())
+        m_frameTimer->start();
+}
+
+/**
+ * @brief GeometryTransaction::end 结束事务，把最后的大小更新到窗口并提交一次
+ */
+void GeometryTransaction::end()
+{
+    if (!m_active)
+        return;
+
+    m_frameTimer->stop();
+    m_idleTimer->stop();
+    applyPending();
+
+    // 窗口更新完成之后再结束事务，避免更新窗口时被当做拖拽结束
+    m_active = false;
+    if (!m_changed)
+        return;
+
+    m_changed = false;
+    ++m_commitCount;
+    if (m_commit)
+        m_commit(m_size);
+}
+
+void GeometryTransaction::applyPending()
+{
+    if (!m_pending)
+        return;
+
+    m_pending = false;
+    ++m_applyCount;
+    if (m_apply)
+        m_apply(m_size);
+}
+
+void GeometryTransaction::onIdleTimeout()
+{
+    if (!m_active)
+        return;
+
+    Q_EMIT idleTimeout();
+    end();
+}
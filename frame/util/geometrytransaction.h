@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef GEOMETRYTRANSACTION_H
+#define GEOMETRYTRANSACTION_H
+
+#include <QObject>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief GeometryTransaction 拖拽调整任务栏大小时的更新事务
+ * 拖拽过程中的大小变化合并到每一帧只更新一次窗口(apply)，
+ * 通知后端、窗管、更新监听区域这些外部调用(commit)只在拖拽结束时进行一次；
+ * 没有收到拖拽结束(例如鼠标释放事件丢失)时，一段时间没有更新后自动结束
+ */
+class GeometryTransaction : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<void(int)> Function;
+
+    explicit GeometryTransaction(QObject *parent = nullptr);
+
+    void setApplyFunction(const Function &apply);
+    void setCommitFunction(const Function &commit);
+    void setFrameInterval(int msec);
+    void setIdleTimeout(int msec);
+
+    bool isActive() const;
+    int size() const;
+    int applyCount() const;
+    int commitCount() const;
+
+Q_SIGNALS:
+    // 事务因为长时间没有更新而自动结束，在结束(提交)之前发出
+    void idleTimeout();
+
+public Q_SLOTS:
+    void begin();
+    void update(int size);
+    void end();
+
+private Q_SLOTS:
+    void applyPending();
+    void onIdleTimeout();
+
+private:
+    QTimer *m_frameTimer;
+    QTimer *m_idleTimer;
+    Function m_apply;
+    Function m_commit;
+    bool m_active;
+    bool m_pending;     // 有还没有更新到窗口的大小
+    bool m_changed;     // 本次事务中大小有变化，结束时需要提交
+    int m_size;
+    int m_applyCount;
+    int m_commitCount;
+};
+
+#endif // GEOMETRYTRANSACTION_H
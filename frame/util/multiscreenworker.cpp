@@ -16,6 +16,8 @@
 #include "dockitemmanager.h"
 #include "dockscreen.h"
 #include "docksettings.h"
+#include "edgetriggerengine.h"
+#include "displaystatepipeline.h"
 
 #include <QWidget>
 #include <QScreen>
@@ -43,12 +45,11 @@ const double DEFAULTOPACITY = 0.4;
 
 MultiScreenWorker::MultiScreenWorker(QObject *parent)
     : QObject(parent)
-    , m_eventInter(new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus(), this))
-    , m_extralEventInter(new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus(), this))
-    , m_touchEventInter(new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus(), this))
+    , m_regionMonitor(createRegionMonitor())
+    , m_regionSet(new DockRegionSet(m_regionMonitor))
     , m_launcherInter(new DBusLuncher(launcherService, launcherPath, QDBusConnection::sessionBus(), this))
     , m_appearanceInter(new Appearance("org.deepin.dde.Appearance1", "/org/deepin/dde/Appearance1", QDBusConnection::sessionBus(), this))
-    , m_monitorUpdateTimer(new QTimer(this))
+    , m_displayState(new DisplayStatePipeline(this))
     , m_delayWakeTimer(new QTimer(this))
     , m_position(Dock::Position(-1))
     , m_hideMode(Dock::HideMode(-1))
@@ -68,10 +69,13 @@ MultiScreenWorker::~MultiScreenWorker()
 
 void MultiScreenWorker::updateDaemonDockSize(const int &dockSize)
 {
-    if (m_displayMode == Dock::DisplayMode::Fashion)
-        DockSettings::instance()->setWindowSizeFashion(dockSize);
-    else
-        DockSettings::instance()->setWindowSizeEfficient(dockSize);
+    if (m_dockSizeWriter)
+        m_dockSizeWriter(dockSize);
+}
+
+void MultiScreenWorker::setDockSizeWriter(const DockSizeWriter &writer)
+{
+    m_dockSizeWriter = writer;
 }
 
 /**
@@ -101,7 +105,7 @@ void MultiScreenWorker::onAutoHideChanged(const bool autoHide)
 
 void MultiScreenWorker::onRegionMonitorChanged(int x, int y, const QString &key)
 {
-    if (m_registerKey != key || testState(MousePress))
+    if (m_regionSet->key(DockRegionSet::Monitor) != key || testState(MousePress))
         return;
 
     if (m_hideMode == HideMode::KeepHidden) {
@@ -119,11 +123,11 @@ void MultiScreenWorker::onExtralRegionMonitorChanged(int x, int y, const QString
     Q_UNUSED(y);
     Q_UNUSED(key);
 
-    if (m_extralRegisterKey != key || testState(MousePress))
+    if (m_regionSet->key(DockRegionSet::Extral) != key || testState(MousePress))
         return;
 
     // FIXME:每次都要重置一下，是因为qt中的QScreen类缺少nameChanged信号，后面会给上游提交patch修复
-    DOCK_SCREEN->updateDockedScreen(getValidScreen(position()));
+    updateDockedScreen(getValidScreen(position()));
 
     // 鼠标移动到任务栏界面之外，停止计时器（延时2秒改变任务栏所在屏幕）
     m_delayWakeTimer->stop();
@@ -140,38 +144,19 @@ void MultiScreenWorker::onExtralRegionMonitorChanged(int x, int y, const QString
     }
 }
 
-void MultiScreenWorker::updateDisplay()
-{
-    tryToHideDock();
-    //1、屏幕停靠信息，
-    //2、任务栏当前显示在哪个屏幕也需要更新
-    //3、任务栏高度或宽度调整的拖拽区域，
-    //4、通知窗管的任务栏显示区域信息，
-    //5、通知后端的任务栏显示区域信息
-    if (DIS_INS->screens().size() == 0) {
-        qWarning() << "No Screen Can Display.";
-        return;
-    }
-
-    // 更新所在屏幕
-    resetDockScreen();
-    // 通知后端
-    Q_EMIT requestUpdateFrontendGeometry();
-    // 通知窗管
-    Q_EMIT requestNotifyWindowManager();
-}
-
 void MultiScreenWorker::onWindowSizeChanged(uint value)
 {
     Q_UNUSED(value);
 
-    m_monitorUpdateTimer->start();
+    m_displayState->setInput(DisplayStatePipeline::DockSize, QVariantList { m_windowFashionSize, m_windowEfficientSize });
 }
 
 void MultiScreenWorker::onPrimaryScreenChanged()
 {
     // 先更新主屏信息
     DOCK_SCREEN->updatePrimary(DIS_INS->primary());
+    // 之前没有所在屏幕时会停靠到主屏
+    m_displayState->setInput(DisplayStatePipeline::DockedScreen, DOCK_SCREEN->current());
 
     // 无效值
     if (DIS_INS->screenRawHeight() == 0 || DIS_INS->screenRawWidth() == 0) {
@@ -180,7 +165,7 @@ void MultiScreenWorker::onPrimaryScreenChanged()
         return;
     }
 
-    m_monitorUpdateTimer->start();
+    m_displayState->setInput(DisplayStatePipeline::Primary, DIS_INS->primary());
 }
 
 void MultiScreenWorker::onPositionChanged(int position)
@@ -193,6 +178,7 @@ void MultiScreenWorker::onPositionChanged(int position)
 #endif
     m_position = static_cast<Position>(position);
     DockItem::setDockPosition(m_position);
+    m_displayState->setInput(DisplayStatePipeline::DockPosition, int(m_position));
 
     if (m_hideMode == HideMode::KeepHidden || (m_hideMode == HideMode::SmartHide && m_hideState == HideState::Hide)) {
         // 这种情况切换位置,任务栏不需要显示
@@ -202,9 +188,9 @@ void MultiScreenWorker::onPositionChanged(int position)
         // 子窗口来更新当前的位置的信息
         Q_EMIT requestPlayAnimation(DOCK_SCREEN->current(), lastPos, Dock::AniAction::Hide, false, true);
         // 更新当前屏幕信息,下次显示从目标屏幕显示
-        DOCK_SCREEN->updateDockedScreen(getValidScreen(m_position));
+        updateDockedScreen(getValidScreen(m_position));
         // 需要更新frontendWindowRect接口数据，否则会造成HideState属性值不变
-        Q_EMIT requestUpdateFrontendGeometry();
+        m_displayState->flush(DisplayStatePipeline::NotifyFrontend);
         Q_EMIT positionChanged(m_position);
     } else {
         // 一直显示的模式才需要显示
@@ -222,8 +208,9 @@ void MultiScreenWorker::onDisplayModeChanged(int displayMode)
     m_displayMode = static_cast<DisplayMode>(displayMode);
 
     emit displayModeChanged(m_displayMode);
-    emit requestUpdateFrontendGeometry();
-    emit requestNotifyWindowManager();
+    m_displayState->setInput(DisplayStatePipeline::DockDisplayMode, int(m_displayMode));
+    m_displayState->flush(DisplayStatePipeline::NotifyFrontend);
+    m_displayState->flush(DisplayStatePipeline::NotifyWindowManager);
 }
 
 void MultiScreenWorker::onHideModeChanged(int hideMode)
@@ -242,8 +229,9 @@ void MultiScreenWorker::onHideModeChanged(int hideMode)
         Q_EMIT requestPlayAnimation(DOCK_SCREEN->current(), m_position, Dock::AniAction::Hide);
     }
 
-    emit requestUpdateFrontendGeometry();
-    emit requestNotifyWindowManager();
+    m_displayState->setInput(DisplayStatePipeline::DockHideMode, int(m_hideMode));
+    m_displayState->flush(DisplayStatePipeline::NotifyFrontend);
+    m_displayState->flush(DisplayStatePipeline::NotifyWindowManager);
 }
 
 void MultiScreenWorker::onHideStateChanged(int state)
@@ -260,7 +248,7 @@ void MultiScreenWorker::onHideStateChanged(int state)
     const QString currentScreen = DOCK_SCREEN->current();
     QScreen *curScreen = DIS_INS->screen(currentScreen);
     if (!DIS_INS->canDock(curScreen, m_position)) {
-        DOCK_SCREEN->updateDockedScreen(getValidScreen(m_position));
+        updateDockedScreen(getValidScreen(m_position));
     }
 
     qInfo() << "hidestate change:" << m_hideMode << m_hideState;
@@ -292,189 +280,36 @@ void MultiScreenWorker::onOpacityChanged(const double value)
  */
 void MultiScreenWorker::onRequestUpdateRegionMonitor()
 {
-    if (!m_registerKey.isEmpty()) {
-#ifdef QT_DEBUG
-        bool ret = m_eventInter->UnregisterArea(m_registerKey);
-        qDebug() << "取消唤起区域监听:" << ret;
-#else
-        m_eventInter->UnregisterArea(m_registerKey);
-#endif
-        m_registerKey.clear();
-    }
-
-    if (!m_extralRegisterKey.isEmpty()) {
-#ifdef QT_DEBUG
-        bool ret = m_extralEventInter->UnregisterArea(m_extralRegisterKey);
-        qDebug() << "取消任务栏外部区域监听:" << ret;
-#else
-        m_extralEventInter->UnregisterArea(m_extralRegisterKey);
-#endif
-        m_extralRegisterKey.clear();
-    }
-
-    if (!m_touchRegisterKey.isEmpty()) {
-        m_touchEventInter->UnregisterArea(m_touchRegisterKey);
-        m_touchRegisterKey.clear();
-    }
-
     const static int flags = Motion | Button | Key;
     const static int monitorHeight = static_cast<int>(15 * qApp->devicePixelRatio());
     // 后端认为的任务栏大小(无缩放因素影响)
     const int realDockSize = int((m_displayMode == DisplayMode::Fashion ? m_windowFashionSize + 20 : m_windowEfficientSize) * qApp->devicePixelRatio());
+    // 触屏监控高度固定调整为最大任务栏高度100+任务栏与屏幕边缘间距
+    const int monitHeight = 100 + WINDOWMARGIN * qApp->devicePixelRatio();
 
-    // 任务栏唤起区域
-    m_monitorRectList.clear();
+    QList<QRect> screenRects;
     for (auto s : DIS_INS->screens()) {
         // 屏幕此位置不可停靠时,不用监听这块区域
         if (!DIS_INS->canDock(s, m_position))
             continue;
 
-        MonitRect monitorRect;
         QRect screenRect = s->geometry();
         screenRect.setSize(screenRect.size() * s->devicePixelRatio());
-
-        switch (m_position) {
-        case Top: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + monitorHeight;
-        }
-            break;
-        case Bottom: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y() + screenRect.height() - monitorHeight;
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Left: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + monitorHeight;
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Right: {
-            monitorRect.x1 = screenRect.x() + screenRect.width() - monitorHeight;
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        }
-
-        if (!m_monitorRectList.contains(monitorRect)) {
-            m_monitorRectList << monitorRect;
-#ifdef QT_DEBUG
-            qDebug() << "监听区域：" << monitorRect.x1 << monitorRect.y1 << monitorRect.x2 << monitorRect.y2;
-#endif
-        }
+        screenRects << screenRect;
     }
 
-    m_extralRectList.clear();
-    for (auto s : DIS_INS->screens()) {
-        // 屏幕此位置不可停靠时,不用监听这块区域
-        if (!DIS_INS->canDock(s, m_position))
-            continue;
-
-        MonitRect monitorRect;
-        QRect screenRect = s->geometry();
-        screenRect.setSize(screenRect.size() * s->devicePixelRatio());
-
-        switch (m_position) {
-        case Top: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + realDockSize;
-        }
-            break;
-        case Bottom: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y() + screenRect.height() - realDockSize;
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Left: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + realDockSize;
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Right: {
-            monitorRect.x1 = screenRect.x() + screenRect.width() - realDockSize;
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        }
+    m_regionSet->setScreens(screenRects);
+    m_regionSet->setPosition(m_position);
+    m_regionSet->setThickness(DockRegionSet::Monitor, monitorHeight);
+    m_regionSet->setThickness(DockRegionSet::Extral, realDockSize);
+    m_regionSet->setThickness(DockRegionSet::Touch, monitHeight);
 
-        if (!m_extralRectList.contains(monitorRect)) {
-            m_extralRectList << monitorRect;
+    // 只注销和注册区域有变化的那部分
 #ifdef QT_DEBUG
-            qDebug() << "任务栏内部区域：" << monitorRect.x1 << monitorRect.y1 << monitorRect.x2 << monitorRect.y2;
+    qDebug() << "更新监听区域，调用次数:" << m_regionSet->commit(flags);
+#else
+    m_regionSet->commit(flags);
 #endif
-        }
-    }
-
-    // 触屏监控高度固定调整为最大任务栏高度100+任务栏与屏幕边缘间距
-    const int monitHeight = 100 + WINDOWMARGIN * qApp->devicePixelRatio();
-
-    // 任务栏触屏唤起区域
-    m_touchRectList.clear();
-    for (auto s : DIS_INS->screens()) {
-        // 屏幕此位置不可停靠时,不用监听这块区域
-        if (!DIS_INS->canDock(s, m_position))
-            continue;
-
-        MonitRect monitorRect;
-        QRect screenRect = s->geometry();
-        screenRect.setSize(screenRect.size() * s->devicePixelRatio());
-
-        switch (m_position) {
-        case Top: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + monitHeight;
-        }
-            break;
-        case Bottom: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y() + screenRect.height() - monitHeight;
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Left: {
-            monitorRect.x1 = screenRect.x();
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + monitHeight;
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        case Right: {
-            monitorRect.x1 = screenRect.x() + screenRect.width() - monitHeight;
-            monitorRect.y1 = screenRect.y();
-            monitorRect.x2 = screenRect.x() + screenRect.width();
-            monitorRect.y2 = screenRect.y() + screenRect.height();
-        }
-            break;
-        }
-
-        if (!m_touchRectList.contains(monitorRect)) {
-            m_touchRectList << monitorRect;
-        }
-
-    }
-
-    m_registerKey = m_eventInter->RegisterAreas(m_monitorRectList, flags);
-    m_extralRegisterKey = m_extralEventInter->RegisterAreas(m_extralRectList, flags);
-    m_touchRegisterKey = m_touchEventInter->RegisterAreas(m_touchRectList, flags);
 }
 
 /**
@@ -503,7 +338,7 @@ void MultiScreenWorker::onRequestUpdatePosition(const Position &fromPos, const P
     qInfo() << "request change pos from: " << fromPos << " to: " << toPos;
     // 更新要切换到的屏幕
     if (!DIS_INS->canDock(DIS_INS->screen(DOCK_SCREEN->current()), m_position))
-        DOCK_SCREEN->updateDockedScreen(getValidScreen(m_position));
+        updateDockedScreen(getValidScreen(m_position));
 
     qInfo() << "update allow screen: " << DOCK_SCREEN->current();
 
@@ -513,12 +348,11 @@ void MultiScreenWorker::onRequestUpdatePosition(const Position &fromPos, const P
 
 void MultiScreenWorker::onRequestUpdateMonitorInfo()
 {
-    resetDockScreen();
+    updateScreenInputs();
 
-    // 只需要在屏幕信息变化的时候更新，其他时间不需要更新
-    onRequestUpdateRegionMonitor();
-
-    m_monitorUpdateTimer->start();
+    // 屏幕信息真正变化时立即更新所在屏幕和监听区域，通知后端和窗管等屏幕信息稳定之后再进行
+    m_displayState->flush(DisplayStatePipeline::ResetScreen);
+    m_displayState->flush(DisplayStatePipeline::UpdateRegion);
 }
 
 void MultiScreenWorker::onRequestDelayShowDock()
@@ -534,7 +368,7 @@ void MultiScreenWorker::onRequestDelayShowDock()
         return;
     }
 
-    DOCK_SCREEN->updateDockedScreen(m_delayScreen);
+    updateDockedScreen(m_delayScreen);
 
     // 检查当前屏幕的当前位置是否允许显示,不允许需要更新显示信息(这里应该在函数外部就处理好,不应该走到这里)
     // 检查边缘是否允许停靠
@@ -550,9 +384,6 @@ void MultiScreenWorker::onRequestDelayShowDock()
 
 void MultiScreenWorker::initMembers()
 {
-    m_monitorUpdateTimer->setInterval(1000);
-    m_monitorUpdateTimer->setSingleShot(true);
-
     m_delayWakeTimer->setSingleShot(true);
 
     m_windowFashionSize = int(DockSettings::instance()->getWindowSizeFashion() * qApp->devicePixelRatio());
@@ -560,8 +391,15 @@ void MultiScreenWorker::initMembers()
 
     setStates(LauncherDisplay, m_launcherInter->isValid() ? m_launcherInter->visible() : false);
 
-    // init check
-    checkXEventMonitorService();
+    m_dockSizeWriter = [ this ](int dockSize) {
+        if (m_displayMode == Dock::DisplayMode::Fashion)
+            DockSettings::instance()->setWindowSizeFashion(dockSize);
+        else
+            DockSettings::instance()->setWindowSizeEfficient(dockSize);
+    };
+
+    initRegionMonitorConnection();
+    initDisplayState();
 }
 
 void MultiScreenWorker::initConnection()
@@ -577,9 +415,6 @@ void MultiScreenWorker::initConnection()
 
     connect(m_delayWakeTimer, &QTimer::timeout, this, &MultiScreenWorker::onRequestDelayShowDock);
 
-    // 刷新所有显示的内容，布局，方向，大小，位置等
-    connect(m_monitorUpdateTimer, &QTimer::timeout, this, &MultiScreenWorker::updateDisplay);
-
     connect(DockSettings::instance(), &DockSettings::windowSizeEfficientChanged, this, [=]( uint size){ m_windowEfficientSize = size; });
     connect(DockSettings::instance(), &DockSettings::windowSizeFashionChanged, this, [=]( uint size){ m_windowFashionSize = size; });
 
@@ -611,11 +446,81 @@ void MultiScreenWorker::initDockMode()
  */
 void MultiScreenWorker::initDisplayData()
 {
+    updateScreenInputs();
+    // 所有输出都要推送一次，通知后端和窗管延时进行
+    m_displayState->invalidate();
+
     //3\初始化监视区域
-    onRequestUpdateRegionMonitor();
+    m_displayState->flush(DisplayStatePipeline::UpdateRegion);
 
     //4\初始化任务栏停靠屏幕
-    resetDockScreen();
+    m_displayState->flush(DisplayStatePipeline::ResetScreen);
+}
+
+/**
+ * @brief initDisplayState
+ * 设置每个输出依赖的输入，只有这些输入变化时才会推送
+ */
+void MultiScreenWorker::initDisplayState()
+{
+    typedef DisplayStatePipeline Pipeline;
+
+    // 等待屏幕信息稳定之后再推送，期间的多次变化合并成一次
+    m_displayState->setDelay(1000);
+
+    m_displayState->setOutput(Pipeline::TryHide, Pipeline::Screens | Pipeline::DeviceRatio | Pipeline::Primary | Pipeline::DockSize, [ this ] {
+        tryToHideDock();
+    });
+    m_displayState->setOutput(Pipeline::ResetScreen, Pipeline::Screens | Pipeline::DeviceRatio | Pipeline::Primary | Pipeline::DockSize, [ this ] {
+        if (DIS_INS->screens().size() == 0) {
+            qWarning() << "No Screen Can Display.";
+            return;
+        }
+
+        resetDockScreen();
+    });
+    m_displayState->setOutput(Pipeline::UpdateRegion, Pipeline::Screens | Pipeline::DeviceRatio | Pipeline::DockSize
+                              | Pipeline::DockPosition | Pipeline::DockDisplayMode, [ this ] {
+        onRequestUpdateRegionMonitor();
+    });
+
+    const Pipeline::Inputs geometryInputs = Pipeline::Screens | Pipeline::DeviceRatio | Pipeline::DockSize | Pipeline::DockPosition
+            | Pipeline::DockHideMode | Pipeline::DockDisplayMode | Pipeline::DockedScreen;
+    m_displayState->setOutput(Pipeline::NotifyFrontend, geometryInputs, [ this ] {
+        Q_EMIT requestUpdateFrontendGeometry();
+    });
+    // 非主屏时不挤占应用，主屏变化也需要通知窗管
+    m_displayState->setOutput(Pipeline::NotifyWindowManager, geometryInputs | Pipeline::Primary, [ this ] {
+        Q_EMIT requestNotifyWindowManager();
+    });
+
+    m_displayState->setInput(Pipeline::DockSize, QVariantList { m_windowFashionSize, m_windowEfficientSize });
+}
+
+/**
+ * @brief updateScreenInputs
+ * 屏幕区域、缩放比例、主屏以及屏幕是否允许停靠作为输入
+ */
+void MultiScreenWorker::updateScreenInputs()
+{
+    const ScreenTopology &topology = DIS_INS->topology();
+    QVariantList screens;
+    for (int i = 0; i < topology.count(); ++i) {
+        int dockable = 0;
+        for (int pos = Top; pos <= Left; ++pos)
+            dockable |= (topology.canDock(i, Position(pos)) << pos);
+
+        screens << topology.name(i) << topology.rect(i) << dockable;
+    }
+
+    m_displayState->setInput(DisplayStatePipeline::Screens, screens);
+    m_displayState->setInput(DisplayStatePipeline::DeviceRatio, qApp->devicePixelRatio());
+    m_displayState->setInput(DisplayStatePipeline::Primary, DIS_INS->primary());
+}
+
+const DisplayStatePipeline *MultiScreenWorker::displayState() const
+{
+    return m_displayState;
 }
 
 /**
@@ -644,7 +549,7 @@ void MultiScreenWorker::changeDockPosition(QString fromScreen, QString toScreen,
 
     // 该动画放到WindowManager中来实现
     // 更新屏幕信息
-    DOCK_SCREEN->updateDockedScreen(toScreen);
+    updateDockedScreen(toScreen);
 
     // TODO: 考虑切换过快的情况,这里需要停止上一次的动画,可增加信号控制,暂时无需要
     qInfo() << "from: " << fromScreen << "  to: " << toScreen;
@@ -666,12 +571,8 @@ QString MultiScreenWorker::getValidScreen(const Position &pos)
     if (DIS_INS->canDock(DIS_INS->screen(DIS_INS->primary()), pos))
         return DIS_INS->primary();
 
-    for (auto s : DIS_INS->screens()) {
-        if (DIS_INS->canDock(s, pos))
-            return s->name();
-    }
-
-    return QString();
+    const ScreenTopology &topology = DIS_INS->topology();
+    return topology.name(topology.firstDockable(pos));
 }
 
 /**
@@ -685,140 +586,83 @@ void MultiScreenWorker::resetDockScreen()
             || Utils::isDraging())
         return;
 
-    DOCK_SCREEN->updateDockedScreen(getValidScreen(position()));
+    updateDockedScreen(getValidScreen(position()));
     // 更新任务栏自身信息
     Q_EMIT requestUpdateDockGeometry(m_hideMode);
 }
 
+/**
+ * @brief updateDockedScreen 更新任务栏所在的屏幕
+ * 所有修改所在屏幕的地方都要经过这里，保证显示状态中的DockedScreen输入和实际所在的屏幕一致
+ */
+void MultiScreenWorker::updateDockedScreen(const QString &screenName)
+{
+    DOCK_SCREEN->updateDockedScreen(screenName);
+    m_displayState->setInput(DisplayStatePipeline::DockedScreen, DOCK_SCREEN->current());
+}
+
 bool MultiScreenWorker::isCursorOut(int x, int y)
 {
     const int realDockSize = int((m_displayMode == DisplayMode::Fashion ? m_windowFashionSize : m_windowEfficientSize) * qApp->devicePixelRatio());
-    for (auto s : DIS_INS->screens()) {
-        // 屏幕此位置不可停靠时,不用监听这块区域
-        if (!DIS_INS->canDock(s, m_position))
-            continue;
-
-        QRect screenRect = s->geometry();
-        screenRect.setSize(screenRect.size() * s->devicePixelRatio());
-
-        if (m_position == Top) {
-            // 如果任务栏在顶部
-            if (x < screenRect.x() || x > (screenRect.x() + screenRect.width()))
-                continue;
-
-            return (y > (screenRect.y() + realDockSize) || y < screenRect.y());
-        }
-
-        if (m_position == Bottom) {
-            // 如果任务栏在底部
-            if (x < screenRect.x() || x > (screenRect.x() + screenRect.width()))
-                continue;
-
-            return (y < (screenRect.y() + screenRect.height() - realDockSize) || y > (screenRect.y() + screenRect.height()));
-        }
-
-        if (m_position == Left) {
-            // 如果任务栏在左侧
-            if (y < screenRect.y() || y > (screenRect.y() + screenRect.height()))
-                continue;
-
-            return (x > (screenRect.x() + realDockSize) || x < screenRect.x());
-        }
-
-        if (m_position == Right) {
-            // 如果在任务栏右侧
-            if (y < screenRect.y() || y > (screenRect.y() + screenRect.height()))
-                continue;
-
-            return (x < (screenRect.x() + screenRect.width() - realDockSize) || x > (screenRect.x() + screenRect.width()));
-        }
-    }
-
-    return false;
+    return DIS_INS->topology().isCursorOut(QPoint(x, y), m_position, realDockSize);
 }
 
 /**
- * @brief checkDaemonXEventMonitorService
- * org.deepin.dde.XEventMonitor1服务比dock晚启动，导致dock启动后的状态错误
+ * @brief createRegionMonitor 创建监听任务栏唤起区域的对象
+ * X11下默认在进程内通过XRecord判断鼠标位置，不可用时使用org.deepin.dde.XEventMonitor1服务
  */
-void MultiScreenWorker::checkXEventMonitorService()
-{
-    auto connectionInit = [ = ](XEventMonitor * eventInter, XEventMonitor * extralEventInter, XEventMonitor * touchEventInter) {
-        connect(eventInter, &XEventMonitor::CursorMove, this, &MultiScreenWorker::onRegionMonitorChanged);
-        connect(eventInter, &XEventMonitor::ButtonPress, this, [ = ] { setStates(MousePress, true); });
-        connect(eventInter, &XEventMonitor::ButtonRelease, this, [ = ] { setStates(MousePress, false); });
-
-        connect(extralEventInter, &XEventMonitor::CursorOut, this, [ = ](int x, int y, const QString &key) {
-            if (isCursorOut(x, y)) {
-                if (testState(ShowAnimationStart)) {
-                    // 在OUT后如果检测到当前的动画正在进行，在out后延迟500毫秒等动画结束再执行移出动画
-                    QTimer::singleShot(500, this, [ = ] {
-                        onExtralRegionMonitorChanged(x, y, key);
-                    });
-                } else {
-                    onExtralRegionMonitorChanged(x, y, key);
-                }
-            }
-        });
-
-        // 触屏时，后端只发送press、release消息，有move消息则为鼠标，press置false
-        connect(touchEventInter, &XEventMonitor::CursorMove, this, [ = ] { setStates(TouchPress, false); });
-        connect(touchEventInter, &XEventMonitor::ButtonPress, this, &MultiScreenWorker::onTouchPress);
-        connect(touchEventInter, &XEventMonitor::ButtonRelease, this, &MultiScreenWorker::onTouchRelease);
-    };
+RegionMonitor *MultiScreenWorker::createRegionMonitor()
+{
+    if (!Utils::IS_WAYLAND_DISPLAY && DockSettings::instance()->getLocalEdgeTrigger()) {
+        EdgeTriggerEngine *engine = new EdgeTriggerEngine(this);
+        if (engine->listenPointer())
+            return engine;
 
-    QDBusConnectionInterface *ifc = QDBusConnection::sessionBus().interface();
+        qWarning() << "local edge trigger is not available, use" << xEventMonitorService;
+        delete engine;
+    }
 
-    if (!ifc->isServiceRegistered(xEventMonitorService)) {
-        connect(ifc, &QDBusConnectionInterface::serviceOwnerChanged, this, [ = ](const QString & name, const QString & oldOwner, const QString & newOwner) {
-            Q_UNUSED(oldOwner)
-            if (name == xEventMonitorService && !newOwner.isEmpty()) {
-                FREE_POINT(m_eventInter);
-                FREE_POINT(m_extralEventInter);
-                FREE_POINT(m_touchEventInter);
+    return new DBusRegionMonitor(this);
+}
 
-                m_eventInter = new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus());
-                m_extralEventInter = new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus());
-                m_touchEventInter = new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus());
-                // connect
-                connectionInit(m_eventInter, m_extralEventInter, m_touchEventInter);
+void MultiScreenWorker::initRegionMonitorConnection()
+{
+    connect(m_regionMonitor, &RegionMonitor::cursorMove, this, &MultiScreenWorker::onRegionMonitorChanged);
+    connect(m_regionMonitor, &RegionMonitor::monitorReset, this, [ = ] {
+        m_regionSet->reset();
+        onRequestUpdateRegionMonitor();
+    });
+    connect(m_regionMonitor, &RegionMonitor::buttonPress, this, [ = ] { setStates(MousePress, true); });
+    connect(m_regionMonitor, &RegionMonitor::buttonRelease, this, [ = ] { setStates(MousePress, false); });
 
-                disconnect(ifc);
+    connect(m_regionMonitor, &RegionMonitor::cursorOut, this, [ = ](int x, int y, const QString &key) {
+        if (isCursorOut(x, y)) {
+            if (testState(ShowAnimationStart)) {
+                // 在OUT后如果检测到当前的动画正在进行，在out后延迟500毫秒等动画结束再执行移出动画
+                QTimer::singleShot(500, this, [ = ] {
+                    onExtralRegionMonitorChanged(x, y, key);
+                });
+            } else {
+                onExtralRegionMonitorChanged(x, y, key);
             }
-        });
-    } else {
-        connectionInit(m_eventInter, m_extralEventInter, m_touchEventInter);
-    }
+        }
+    });
+
+    // 触屏时，后端只发送press、release消息，有move消息则为鼠标，press置false
+    connect(m_regionMonitor, &RegionMonitor::cursorMove, this, [ = ] { setStates(TouchPress, false); });
+    connect(m_regionMonitor, &RegionMonitor::buttonPress, this, &MultiScreenWorker::onTouchPress);
+    connect(m_regionMonitor, &RegionMonitor::buttonRelease, this, &MultiScreenWorker::onTouchRelease);
 }
 
 bool MultiScreenWorker::onScreenEdge(const QString &screenName, const QPoint &point)
 {
-    QScreen *screen = DIS_INS->screen(screenName);
-    if (screen) {
-        const QRect r { screen->geometry() };
-        const QRect rect { r.topLeft(), r.size() *screen->devicePixelRatio() };
-
-        // 除了要判断鼠标的x坐标和当前区域的位置外，还需要判断当前的坐标的y坐标是否在任务栏的区域内
-        // 因为有如下场景：任务栏在左侧，双屏幕屏幕上下拼接，此时鼠标沿着最左侧x=0的位置移动到另外一个屏幕
-        // 如果不判断y坐标的话，此时就认为鼠标在当前任务栏的边缘，导致任务栏在这种状况下没有跟随鼠标
-        if ((rect.x() == point.x() || rect.x() + rect.width() == point.x())
-                && point.y() >= rect.top() && point.y() <= rect.bottom()) {
-            return true;
-        }
-
-        // 同上，不过此时屏幕是左右拼接，任务栏位于上方或者下方
-        if ((rect.y() == point.y() || rect.y() + rect.height() == point.y())
-                && point.x() >= rect.left() && point.x() <= rect.right()) {
-            return true;
-        }
-    }
-
-    return false;
+    const ScreenTopology &topology = DIS_INS->topology();
+    return topology.onScreenEdge(topology.indexOf(screenName), point);
 }
 
 const QPoint MultiScreenWorker::rawXPosition(const QPoint &scaledPos)
 {
-    QScreen const *screen = Utils::screenAtByScaled(scaledPos);
+    QScreen const *screen = DIS_INS->screenAtByScaled(scaledPos);
 
     return screen ? screen->geometry().topLeft() +
                     (scaledPos - screen->geometry().topLeft()) *
@@ -829,7 +673,7 @@ const QPoint MultiScreenWorker::rawXPosition(const QPoint &scaledPos)
 void MultiScreenWorker::onTouchPress(int type, int x, int y, const QString &key)
 {
     Q_UNUSED(type);
-    if (key != m_touchRegisterKey) {
+    if (key != m_regionSet->key(DockRegionSet::Touch)) {
         return;
     }
 
@@ -840,7 +684,7 @@ void MultiScreenWorker::onTouchPress(int type, int x, int y, const QString &key)
 void MultiScreenWorker::onTouchRelease(int type, int x, int y, const QString &key)
 {
     Q_UNUSED(type);
-    if (key != m_touchRegisterKey) {
+    if (key != m_regionSet->key(DockRegionSet::Touch)) {
         return;
     }
 
@@ -910,7 +754,7 @@ void MultiScreenWorker::tryToShowDock(int eventX, int eventY)
     }
 
     QString toScreen;
-    QScreen *screen = Utils::screenAtByScaled(QPoint(eventX, eventY));
+    QScreen *screen = DIS_INS->screenAtByScaled(QPoint(eventX, eventY));
     if (!screen) {
         qWarning() << "cannot find the screen" << QPoint(eventX, eventY);
         return;
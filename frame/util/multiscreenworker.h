@@ -11,8 +11,9 @@
 #include "dockitem.h"
 #include "xcb_misc.h"
 #include "dbusutil.h"
+#include "regionmonitor.h"
+#include "dockregionset.h"
 
-#include "org_deepin_dde_xeventmonitor1.h"
 #include "org_deepin_dde_launcher1.h"
 #include "org_deepin_dde_appearance1.h"
 
@@ -20,6 +21,9 @@
 
 #include <QObject>
 #include <QFlag>
+#include <QScopedPointer>
+
+#include <functional>
 
 #define WINDOWMARGIN ((m_displayMode == Dock::Efficient) ? 0 : 5)
 #define ANIMATIONTIME 300
@@ -38,7 +42,6 @@ DGUI_USE_NAMESPACE
 #define DRAG_AREA_SIZE (5)
 #define DOCKSPACE (WINDOWMARGIN * 2)
 
-using XEventMonitor = ::org::deepin::dde::XEventMonitor1;
 using DBusLuncher = ::org::deepin::dde::Launcher1;
 using Appearance = org::deepin::dde::Appearance1;
 
@@ -50,6 +53,7 @@ class MainWindow;
 class QGSettings;
 class TrayMainWindow;
 class MenuWorker;
+class DisplayStatePipeline;
 
 class MultiScreenWorker : public QObject
 {
@@ -76,11 +80,13 @@ public:
     };
 
     typedef QFlags<RunState> RunStates;
+    typedef std::function<void(int)> DockSizeWriter;
 
     explicit MultiScreenWorker(QObject *parent = Q_NULLPTR);
     ~MultiScreenWorker() override;
 
     void updateDaemonDockSize(const int &dockSize);
+    void setDockSizeWriter(const DockSizeWriter &writer);
 
     inline bool testState(RunState state) { return (m_state & state); }
     void setStates(RunStates state, bool on = true);
@@ -90,6 +96,7 @@ public:
     inline const HideMode &hideMode() { return m_hideMode; }
     inline const HideState &hideState() { return m_hideState; }
     inline quint8 opacity() { return m_opacity * 255; }
+    const DisplayStatePipeline *displayState() const;
 
 signals:
     void opacityChanged(const quint8 value) const;
@@ -121,8 +128,6 @@ private slots:
     void onRegionMonitorChanged(int x, int y, const QString &key);
     void onExtralRegionMonitorChanged(int x, int y, const QString &key);
 
-    void updateDisplay();
-
     void onWindowSizeChanged(uint value);
     void onPrimaryScreenChanged();
 
@@ -151,14 +156,18 @@ private:
 
     void initDisplayData();
     void reInitDisplayData();
+    void initDisplayState();
+    void updateScreenInputs();
 
     void tryToShowDock(int eventX, int eventY);
     void tryToHideDock();
     void changeDockPosition(QString fromScreen, QString toScreen, const Position &fromPos, const Position &toPos);
 
     void resetDockScreen();
+    void updateDockedScreen(const QString &screenName);
 
-    void checkXEventMonitorService();
+    RegionMonitor *createRegionMonitor();
+    void initRegionMonitorConnection();
 
     QString getValidScreen(const Position &pos);
 
@@ -170,16 +179,15 @@ private:
 
 private:
     // monitor screen
-    XEventMonitor *m_eventInter;
-    XEventMonitor *m_extralEventInter;
-    XEventMonitor *m_touchEventInter;
+    RegionMonitor *m_regionMonitor;
+    QScopedPointer<DockRegionSet> m_regionSet;  // 唤起、任务栏内部和触屏三组监听区域
 
     // DBus interface
     DBusLuncher *m_launcherInter;
     Appearance *m_appearanceInter;
 
-    // update monitor info
-    QTimer *m_monitorUpdateTimer;
+    // 屏幕、任务栏属性变化后按依赖关系通知后端、窗管，更新监听区域
+    DisplayStatePipeline *m_displayState;
     QTimer *m_delayWakeTimer;                   // sp3需求，切换屏幕显示延时，默认2秒唤起任务栏
 
     // 任务栏属性
@@ -190,15 +198,10 @@ private:
     DisplayMode m_displayMode;
     uint m_windowFashionSize;
     uint m_windowEfficientSize;
+    DockSizeWriter m_dockSizeWriter;            // 保存任务栏大小，默认写入DockSettings
 
     /***************不和其他流程产生交互,尽量不要动这里的变量***************/
-    QString m_registerKey;
-    QString m_extralRegisterKey;
-    QString m_touchRegisterKey;                 // 触控屏唤起任务栏监控区域key
     QPoint m_touchPos;                          // 触屏按下坐标
-    QList<MonitRect> m_monitorRectList;         // 监听唤起任务栏区域
-    QList<MonitRect> m_extralRectList;          // 任务栏外部区域,随m_monitorRectList一起更新
-    QList<MonitRect> m_touchRectList;           // 监听触屏唤起任务栏区域
     QString m_delayScreen;                      // 任务栏将要切换到的屏幕名
     RunStates m_state;
     /*****************************************************************/
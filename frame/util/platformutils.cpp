@@ -4,8 +4,7 @@
 
 #include "platformutils.h"
 #include "utils.h"
-
-#include <QX11Info>
+#include "xcb_connection.h"
 
 #include <X11/Xlib.h>
 
@@ -31,13 +30,13 @@ QString PlatformUtils::getAppNameForWindow(quint32 winId)
 
 QString PlatformUtils::getWindowProperty(quint32 winId, QString propName)
 {
-    const auto display = Utils::IS_WAYLAND_DISPLAY ? XOpenDisplay(nullptr) : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (!display) {
-        qWarning() << "QX11Info::display() is " << display;
+        qWarning() << "display is " << display;
         return QString();
     }
 
-    Atom atom_prop = XInternAtom(display, propName.toLocal8Bit(), true);
+    Atom atom_prop = XcbConnection::instance()->call(XcbConnection::Platform, XInternAtom, display, propName.toLocal8Bit().constData(), true);
     if (!atom_prop) {
         qDebug() << "Error: get window property failed, invalid property atom";
         return QString();
@@ -47,15 +46,16 @@ QString PlatformUtils::getWindowProperty(quint32 winId, QString propName)
     int actual_format_return;
     unsigned long nitems_return;
     unsigned long bytes_after_return;
-    unsigned char *prop_return;
+    unsigned char *prop_return = nullptr;
 
-    int r = XGetWindowProperty(display, winId, atom_prop, 0, 100, false, AnyPropertyType,
+    int r = XcbConnection::instance()->call(XcbConnection::Platform, XGetWindowProperty, display, winId, atom_prop, 0, 100, false, AnyPropertyType,
             &actual_type_return, &actual_format_return, &nitems_return,
             &bytes_after_return, &prop_return);
 
-    Q_UNUSED(r);
-    if (Utils::IS_WAYLAND_DISPLAY)
-        XCloseDisplay(display);
+    if (r != Success || !prop_return)
+        return QString();
 
-    return QString::fromLocal8Bit((char*)prop_return);
+    const QString value = QString::fromLocal8Bit((char*)prop_return);
+    XFree(prop_return);
+    return value;
 }
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginfilewatcher.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QLibrary>
+#include <QTimer>
+
+// 文件最后一次变化之后等待的时间，安装包通常先写临时文件再重命名
+#define SETTLE_DELAY 500
+
+PluginFileWatcher::PluginFileWatcher(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_settleTimer(new QTimer(this))
+{
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SETTLE_DELAY);
+
+    connect(m_settleTimer, &QTimer::timeout, this, &PluginFileWatcher::scanDirtyDirectories);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &PluginFileWatcher::onPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &PluginFileWatcher::onPathChanged);
+}
+
+void PluginFileWatcher::addDirectory(const QString &dirPath)
+{
+    const QString path = QDir(dirPath).absolutePath();
+    if (m_snapshots.contains(path) || !QFileInfo(path).isDir())
+        return;
+
+    const Snapshot snapshot = scan(path);
+    m_snapshots.insert(path, snapshot);
+    m_watcher->addPath(path);
+    // 直接覆盖写入文件时目录不会变化，需要同时监视文件
+    if (!snapshot.isEmpty())
+        m_watcher->addPaths(snapshot.keys());
+}
+
+QStringList PluginFileWatcher::directories() const
+{
+    return m_snapshots.keys();
+}
+
+void PluginFileWatcher::setSettleDelay(int msec)
+{
+    m_settleTimer->setInterval(msec);
+}
+
+int PluginFileWatcher::settleDelay() const
+{
+    return m_settleTimer->interval();
+}
+
+void PluginFileWatcher::rescan()
+{
+    m_settleTimer->stop();
+    for (auto it = m_snapshots.constBegin(); it != m_snapshots.constEnd(); ++it)
+        m_dirtyDirs << it.key();
+
+    scanDirtyDirectories();
+}
+
+void PluginFileWatcher::onPathChanged(const QString &path)
+{
+    const QString dirPath = m_snapshots.contains(path) ? path : QFileInfo(path).absolutePath();
+    if (!m_snapshots.contains(dirPath))
+        return;
+
+    // 每次变化都重新计时，文件稳定之后再比较
+    m_dirtyDirs << dirPath;
+    m_settleTimer->start();
+}
+
+void PluginFileWatcher::scanDirtyDirectories()
+{
+    const QSet<QString> dirtyDirs = m_dirtyDirs;
+    m_dirtyDirs.clear();
+
+    for (const QString &dirPath : dirtyDirs)
+        scanDirectory(dirPath);
+}
+
+PluginFileWatcher::Snapshot PluginFileWatcher::scan(const QString &dirPath) const
+{
+    Snapshot snapshot;
+    QDir dir(dirPath);
+    const QStringList files = dir.entryList(QDir::Files);
+    for (const QString &file : files) {
+        if (!QLibrary::isLibrary(file))
+            continue;
+
+        const QString filePath = dir.absoluteFilePath(file);
+        const PluginMetaDataCache::FileIdentity identity = PluginMetaDataCache::fileIdentity(filePath);
+        if (identity.isValid())
+            snapshot.insert(filePath, identity);
+    }
+
+    return snapshot;
+}
+
+void PluginFileWatcher::scanDirectory(const QString &dirPath)
+{
+    const Snapshot oldSnapshot = m_snapshots.value(dirPath);
+    const Snapshot newSnapshot = scan(dirPath);
+    m_snapshots.insert(dirPath, newSnapshot);
+
+    QStringList removedFiles;
+    for (auto it = oldSnapshot.constBegin(); it != oldSnapshot.constEnd(); ++it) {
+        if (!newSnapshot.contains(it.key()))
+            removedFiles << it.key();
+    }
+
+    QStringList addedFiles;
+    QStringList changedFiles;
+    for (auto it = newSnapshot.constBegin(); it != newSnapshot.constEnd(); ++it) {
+        auto oldIt = oldSnapshot.constFind(it.key());
+        if (oldIt == oldSnapshot.constEnd())
+            addedFiles << it.key();
+        else if (oldIt.value() != it.value())
+            changedFiles << it.key();
+    }
+
+    // 文件被替换(重命名覆盖)后原来的监视失效，需要重新添加
+    const QStringList staleFiles = removedFiles + changedFiles;
+    for (const QString &pluginFile : staleFiles) {
+        if (m_watcher->files().contains(pluginFile))
+            m_watcher->removePath(pluginFile);
+    }
+
+    const QStringList watchedFiles = m_watcher->files();
+    QStringList unwatchedFiles;
+    for (auto it = newSnapshot.constBegin(); it != newSnapshot.constEnd(); ++it) {
+        if (!watchedFiles.contains(it.key()))
+            unwatchedFiles << it.key();
+    }
+    if (!unwatchedFiles.isEmpty())
+        m_watcher->addPaths(unwatchedFiles);
+
+    for (const QString &pluginFile : removedFiles)
+        Q_EMIT pluginRemoved(pluginFile);
+    for (const QString &pluginFile : changedFiles)
+        Q_EMIT pluginChanged(pluginFile);
+    for (const QString &pluginFile : addedFiles)
+        Q_EMIT pluginAdded(pluginFile);
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINFILEWATCHER_H
+#define PLUGINFILEWATCHER_H
+
+#include "pluginmetadatacache.h"
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @brief PluginFileWatcher 监视插件目录中插件文件的增加、替换和删除
+ * 安装或升级插件时文件会在短时间内多次变化，等待文件稳定(一段时间内没有新的变化)之后，
+ * 再和上次的快照比较(inode、大小、修改时间)，每个发生变化的插件文件只通知一次
+ */
+class PluginFileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PluginFileWatcher(QObject *parent = nullptr);
+
+    void addDirectory(const QString &dirPath);
+    QStringList directories() const;
+
+    void setSettleDelay(int msec);
+    int settleDelay() const;
+
+    // 立即比较所有目录，不等待文件稳定
+    void rescan();
+
+Q_SIGNALS:
+    void pluginAdded(const QString &pluginFile);
+    void pluginChanged(const QString &pluginFile);
+    void pluginRemoved(const QString &pluginFile);
+
+private Q_SLOTS:
+    void onPathChanged(const QString &path);
+    void scanDirtyDirectories();
+
+private:
+    typedef QMap<QString, PluginMetaDataCache::FileIdentity> Snapshot;
+
+    Snapshot scan(const QString &dirPath) const;
+    void scanDirectory(const QString &dirPath);
+
+private:
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_settleTimer;
+    QHash<QString, Snapshot> m_snapshots;       // 目录 -> (插件文件 -> 文件标识)
+    QSet<QString> m_dirtyDirs;
+};
+
+#endif // PLUGINFILEWATCHER_H
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginiconcache.h"
+
+PluginIconCache::PluginIconCache(const Renderer &renderer)
+    : m_renderer(renderer)
+    , m_version(1)
+    , m_renderCount(0)
+{
+}
+
+QByteArray PluginIconCache::iconData(PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType)
+{
+    Entry &entry = m_entries[EntryKey(plugin, int(colorType))];
+    if (entry.version == m_version)
+        return entry.data;
+
+    // 返回的QByteArray是隐式共享的，命中缓存时不会复制数据
+    entry.data = m_renderer ? m_renderer(plugin, colorType) : QByteArray();
+    entry.version = m_version;
+    ++m_renderCount;
+
+    return entry.data;
+}
+
+void PluginIconCache::invalidate(PluginsItemInterface *plugin)
+{
+    for (DGuiApplicationHelper::ColorType colorType : { DGuiApplicationHelper::UnknownType, DGuiApplicationHelper::LightType, DGuiApplicationHelper::DarkType })
+        m_entries.remove(EntryKey(plugin, int(colorType)));
+}
+
+void PluginIconCache::invalidateAll()
+{
+    ++m_version;
+}
+
+quint64 PluginIconCache::version() const
+{
+    return m_version;
+}
+
+int PluginIconCache::renderCount() const
+{
+    return m_renderCount;
+}
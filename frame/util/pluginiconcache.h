@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINICONCACHE_H
+#define PLUGINICONCACHE_H
+
+#include <DGuiApplicationHelper>
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+
+#include <functional>
+
+DGUI_USE_NAMESPACE
+
+class PluginsItemInterface;
+
+/**
+ * @brief PluginIconCache 插件设置图标编码后的数据缓存
+ * 控制中心会反复读取任务栏的插件列表，每次都绘制浅色和深色图标并编码为png的开销较大，
+ * 这里按(插件, 主题)缓存编码后的数据，只有主题变化或者插件更新了图标后才重新生成
+ */
+class PluginIconCache
+{
+public:
+    typedef std::function<QByteArray(PluginsItemInterface *, DGuiApplicationHelper::ColorType)> Renderer;
+
+    explicit PluginIconCache(const Renderer &renderer);
+
+    QByteArray iconData(PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType);
+
+    // 插件更新了图标或者插件被移除(插件指针之后可能被复用)
+    void invalidate(PluginsItemInterface *plugin);
+    // 主题变化，所有的缓存在下一次读取时重新生成
+    void invalidateAll();
+
+    quint64 version() const;
+    int renderCount() const;
+
+private:
+    struct Entry {
+        quint64 version = 0;
+        QByteArray data;
+    };
+
+    typedef QPair<PluginsItemInterface *, int> EntryKey;
+
+private:
+    Renderer m_renderer;
+    QHash<EntryKey, Entry> m_entries;
+    quint64 m_version;
+    int m_renderCount;          // 实际绘制的次数，用于调试和性能测试
+};
+
+#endif // PLUGINICONCACHE_H
@@ -4,19 +4,35 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "pluginloader.h"
+#include "constants.h"
 
 #include <QDir>
 #include <QDebug>
 #include <QLibrary>
+#include <QPluginLoader>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <QGSettings>
 
 #include <DSysInfo>
 
 DCORE_USE_NAMESPACE
 
+// 加载插件的线程数，插件加载主要是动态链接和磁盘IO，不需要太多线程
+#define MAX_LOAD_THREAD_COUNT 4
+
+static const QStringList CompatiblePluginApiList {
+    "1.1.1",
+    "1.2",
+    "1.2.1",
+    "1.2.2",
+    DOCK_PLUGIN_API_VERSION
+};
+
 PluginLoader::PluginLoader(const QString &pluginDirPath, QObject *parent)
     : QThread(parent)
     , m_pluginDirPath(pluginDirPath)
+    , m_metaDataCache(new PluginMetaDataCache(PluginMetaDataCache::cacheFileForDir(pluginDirPath)))
 {
 }
 
@@ -25,42 +41,127 @@ void PluginLoader::run()
     QDir pluginsDir(m_pluginDirPath);
     const QStringList files = pluginsDir.entryList(QDir::Files);
 
-    auto getDisablePluginList = [ = ] {
-        if (QGSettings::isSchemaInstalled("com.deepin.dde.dock.disableplugins")) {
-            QGSettings gsetting("com.deepin.dde.dock.disableplugins", "/com/deepin/dde/dock/disableplugins/");
-            return gsetting.get("disable-plugins-list").toStringList();
-        }
-        return QStringList();
-    };
-
-    const QStringList disable_plugins_list = getDisablePluginList();
+    const QStringList disable_plugins_list = disabledPlugins();
 
     QStringList plugins;
 
     // 查找可用插件
     for (QString file : files) {
-        if (!QLibrary::isLibrary(file))
-            continue;
-
-        // 社区版需要加载键盘布局，其他不需要
-        if (file.contains("libkeyboard-layout") && !DSysInfo::isCommunityEdition())
-            continue;
-
-        // TODO: old dock plugins is uncompatible
-        if (file.startsWith("libdde-dock-"))
+        if (!isPluginFileAccepted(file, disable_plugins_list))
             continue;
 
-        if (disable_plugins_list.contains(file)) {
-            qDebug() << "disable loading plugin:" << file;
-            continue;
-        }
-
         plugins << file;
     }
 
+    // 先通知所有找到的插件，保证接收方在第一个插件初始化之前就知道需要等待哪些插件
     for (auto plugin : plugins) {
         emit pluginFound(pluginsDir.absoluteFilePath(plugin));
     }
 
+    m_metaDataCache->load();
+
+    // 动态链接、符号解析和版本校验在线程池中并行执行，只有创建插件实例和init需要在主线程
+    QThreadPool loadPool;
+    loadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MAX_LOAD_THREAD_COUNT));
+    for (auto plugin : plugins) {
+        const QString pluginFile = pluginsDir.absoluteFilePath(plugin);
+        QtConcurrent::run(&loadPool, [ this, pluginFile ] { loadPluginFile(pluginFile); });
+    }
+    loadPool.waitForDone();
+
+    // 被删除或禁用的插件不再保留在缓存中
+    m_metaDataCache->pruneUntouched();
+    m_metaDataCache->save();
+
     emit finished();
 }
+
+bool PluginLoader::isCompatibleApi(const QString &pluginApi)
+{
+    return !pluginApi.isEmpty() && CompatiblePluginApiList.contains(pluginApi);
+}
+
+QStringList PluginLoader::disabledPlugins()
+{
+    if (QGSettings::isSchemaInstalled("com.deepin.dde.dock.disableplugins")) {
+        QGSettings gsetting("com.deepin.dde.dock.disableplugins", "/com/deepin/dde/dock/disableplugins/");
+        return gsetting.get("disable-plugins-list").toStringList();
+    }
+    return QStringList();
+}
+
+bool PluginLoader::isPluginFileAccepted(const QString &fileName, const QStringList &disabledPlugins)
+{
+    if (!QLibrary::isLibrary(fileName))
+        return false;
+
+    // 社区版需要加载键盘布局，其他不需要
+    if (fileName.contains("libkeyboard-layout") && !DSysInfo::isCommunityEdition())
+        return false;
+
+    // TODO: old dock plugins is uncompatible
+    if (fileName.startsWith("libdde-dock-"))
+        return false;
+
+    if (disabledPlugins.contains(fileName)) {
+        qDebug() << "disable loading plugin:" << fileName;
+        return false;
+    }
+
+    return true;
+}
+
+QSharedPointer<PluginMetaDataCache> PluginLoader::metaDataCache() const
+{
+    return m_metaDataCache;
+}
+
+void PluginLoader::setDeferFilter(const DeferFilter &filter)
+{
+    m_deferFilter = filter;
+}
+
+void PluginLoader::setIsolateFilter(const IsolateFilter &filter)
+{
+    m_isolateFilter = filter;
+}
+
+void PluginLoader::loadPluginFile(const QString &pluginFile)
+{
+    // 文件未变化时直接使用缓存的元数据，版本不匹配的插件不会被打开
+    const QJsonObject &meta = m_metaDataCache->metaData(pluginFile);
+    const QString &pluginApi = meta.value("MetaData").toObject().value("api").toString();
+    if (!isCompatibleApi(pluginApi)) {
+        qDebug() << "plugin api version not matched! expect versions:" << CompatiblePluginApiList
+                 << ", got version:" << pluginApi
+                 << ", the plugin file is:" << pluginFile;
+
+        emit pluginLoadFailed(pluginFile, QString("plugin api version not matched: %1").arg(pluginApi));
+        return;
+    }
+
+    // 在宿主进程中运行的插件不能在任务栏进程中打开，否则插件的崩溃仍然会影响任务栏
+    if (m_isolateFilter && m_isolateFilter(pluginFile)) {
+        emit pluginIsolated(pluginFile);
+        return;
+    }
+
+    // 上次运行时记录过描述信息的插件，如果当前不需要显示，则不打开插件文件
+    QJsonObject descriptor;
+    if (m_deferFilter && m_metaDataCache->descriptor(pluginFile, &descriptor) && m_deferFilter(descriptor)) {
+        emit pluginDeferred(pluginFile, descriptor);
+        return;
+    }
+
+    QPluginLoader *pluginLoader = new QPluginLoader(pluginFile);
+    if (!pluginLoader->load()) {
+        const QString errorString = pluginLoader->errorString();
+        delete pluginLoader;
+        emit pluginLoadFailed(pluginFile, errorString);
+        return;
+    }
+
+    // 插件实例(QObject)必须在主线程创建，这里只把已加载的QPluginLoader交给主线程
+    pluginLoader->moveToThread(thread());
+    emit pluginLoaded(pluginFile, pluginLoader);
+}
@@ -6,24 +6,59 @@
 #ifndef PLUGINLOADER_H
 #define PLUGINLOADER_H
 
+#include "pluginmetadatacache.h"
+
 #include <QThread>
+#include <QSharedPointer>
+
+#include <functional>
+
+class QPluginLoader;
 
 class PluginLoader : public QThread
 {
     Q_OBJECT
 
 public:
+    typedef std::function<bool(const QJsonObject &descriptor)> DeferFilter;
+    typedef std::function<bool(const QString &pluginFile)> IsolateFilter;
+
     explicit PluginLoader(const QString &pluginDirPath, QObject *parent);
 
+    static bool isCompatibleApi(const QString &pluginApi);
+    // 通过gsettings禁用的插件文件名
+    static QStringList disabledPlugins();
+    // 插件目录中的文件是否需要加载，fileName为不带路径的文件名
+    static bool isPluginFileAccepted(const QString &fileName, const QStringList &disabledPlugins);
+
+    QSharedPointer<PluginMetaDataCache> metaDataCache() const;
+    // 根据缓存的插件描述信息判断插件是否延后加载，在加载线程中调用，需要在start之前设置
+    void setDeferFilter(const DeferFilter &filter);
+    // 判断插件是否在独立的宿主进程中运行，在加载线程中调用，需要在start之前设置
+    void setIsolateFilter(const IsolateFilter &filter);
+
 signals:
     void finished() const;
     void pluginFound(const QString &pluginFile) const;
+    // 插件已在工作线程中完成加载(dlopen)和版本校验，pluginLoader已移动到主线程，由接收方负责释放
+    void pluginLoaded(const QString &pluginFile, QPluginLoader *pluginLoader) const;
+    void pluginLoadFailed(const QString &pluginFile, const QString &errorString) const;
+    // 插件未被加载，由接收方在需要时自行加载
+    void pluginDeferred(const QString &pluginFile, const QJsonObject &descriptor) const;
+    // 插件不在任务栏进程中加载，由接收方启动宿主进程
+    void pluginIsolated(const QString &pluginFile) const;
 
 protected:
     void run();
 
+private:
+    void loadPluginFile(const QString &pluginFile);
+
 private:
     QString m_pluginDirPath;
+    QSharedPointer<PluginMetaDataCache> m_metaDataCache;
+    DeferFilter m_deferFilter;
+    IsolateFilter m_isolateFilter;
 };
 
 #endif // PLUGINLOADER_H
@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginmetadatacache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QPluginLoader>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <sys/stat.h>
+
+// 缓存格式变化时修改版本号，旧的缓存会被整体丢弃
+#define CACHE_FORMAT_VERSION 1
+
+bool PluginMetaDataCache::FileIdentity::operator==(const FileIdentity &other) const
+{
+    return inode == other.inode && size == other.size && mtime == other.mtime;
+}
+
+PluginMetaDataCache::PluginMetaDataCache(const QString &cacheFile)
+    : m_cacheFile(cacheFile)
+    , m_reader(&PluginMetaDataCache::readPluginMetaData)
+    , m_dirty(false)
+{
+}
+
+QString PluginMetaDataCache::cacheFileForDir(const QString &pluginDirPath)
+{
+    const QString &cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/dde-dock";
+    const QByteArray &dirHash = QCryptographicHash::hash(QDir(pluginDirPath).absolutePath().toUtf8(), QCryptographicHash::Md5).toHex();
+    return QString("%1/plugin-metadata-%2.json").arg(cacheDir).arg(QString::fromLatin1(dirHash));
+}
+
+PluginMetaDataCache::FileIdentity PluginMetaDataCache::fileIdentity(const QString &filePath)
+{
+    FileIdentity identity;
+    struct stat fileStat;
+    if (::stat(QFile::encodeName(filePath).constData(), &fileStat) != 0)
+        return identity;
+
+    identity.inode = fileStat.st_ino;
+    identity.size = fileStat.st_size;
+    identity.mtime = qint64(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+    return identity;
+}
+
+bool PluginMetaDataCache::load()
+{
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject &root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != CACHE_FORMAT_VERSION) {
+        qDebug() << "discard plugin metadata cache with unknown version:" << m_cacheFile;
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    const QJsonArray &plugins = root.value("plugins").toArray();
+    for (const QJsonValue &value : plugins) {
+        const QJsonObject &object = value.toObject();
+        const QString &path = object.value("path").toString();
+        if (path.isEmpty())
+            continue;
+
+        Entry entry;
+        // 64位整数超出double的精度，按字符串保存
+        entry.identity.inode = object.value("inode").toString().toULongLong();
+        entry.identity.size = object.value("size").toString().toLongLong();
+        entry.identity.mtime = object.value("mtime").toString().toLongLong();
+        entry.metaData = object.value("metadata").toObject();
+        entry.descriptor = object.value("descriptor").toObject();
+        m_entries.insert(path, entry);
+    }
+    m_dirty = false;
+
+    return true;
+}
+
+bool PluginMetaDataCache::save()
+{
+    QJsonArray plugins;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return true;
+
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            QJsonObject object;
+            object["path"] = it.key();
+            object["inode"] = QString::number(it.value().identity.inode);
+            object["size"] = QString::number(it.value().identity.size);
+            object["mtime"] = QString::number(it.value().identity.mtime);
+            object["metadata"] = it.value().metaData;
+            if (!it.value().descriptor.isEmpty())
+                object["descriptor"] = it.value().descriptor;
+            plugins.append(object);
+        }
+        m_dirty = false;
+    }
+
+    QJsonObject root;
+    root["version"] = CACHE_FORMAT_VERSION;
+    root["plugins"] = plugins;
+
+    QDir().mkpath(QFileInfo(m_cacheFile).absolutePath());
+    // 先写临时文件再替换，避免进程异常退出时留下不完整的缓存
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "failed to write plugin metadata cache:" << m_cacheFile << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+QJsonObject PluginMetaDataCache::metaData(const QString &pluginFile)
+{
+    const FileIdentity &identity = fileIdentity(pluginFile);
+    if (!identity.isValid())
+        return QJsonObject();
+
+    MetaDataReader reader;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_touched.insert(pluginFile);
+        auto it = m_entries.constFind(pluginFile);
+        if (it != m_entries.constEnd() && it.value().identity == identity)
+            return it.value().metaData;
+
+        reader = m_reader;
+    }
+
+    // 读取元数据不持锁，多个插件可以并行读取
+    Entry entry;
+    entry.identity = identity;
+    entry.metaData = reader(pluginFile);
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(pluginFile, entry);
+    m_dirty = true;
+
+    return entry.metaData;
+}
+
+bool PluginMetaDataCache::cachedMetaData(const QString &pluginFile, QJsonObject *metaData) const
+{
+    const FileIdentity &identity = fileIdentity(pluginFile);
+    if (!identity.isValid())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(pluginFile);
+    if (it == m_entries.constEnd() || it.value().identity != identity)
+        return false;
+
+    if (metaData)
+        *metaData = it.value().metaData;
+
+    return true;
+}
+
+bool PluginMetaDataCache::descriptor(const QString &pluginFile, QJsonObject *descriptor) const
+{
+    const FileIdentity &identity = fileIdentity(pluginFile);
+    if (!identity.isValid())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(pluginFile);
+    if (it == m_entries.constEnd() || it.value().identity != identity || it.value().descriptor.isEmpty())
+        return false;
+
+    if (descriptor)
+        *descriptor = it.value().descriptor;
+
+    return true;
+}
+
+void PluginMetaDataCache::setDescriptor(const QString &pluginFile, const QJsonObject &descriptor)
+{
+    const FileIdentity &identity = fileIdentity(pluginFile);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(pluginFile);
+    // 只给元数据仍然有效的插件记录描述信息
+    if (it == m_entries.end() || it.value().identity != identity || it.value().descriptor == descriptor)
+        return;
+
+    it.value().descriptor = descriptor;
+    m_dirty = true;
+}
+
+void PluginMetaDataCache::pruneUntouched()
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (m_touched.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+}
+
+void PluginMetaDataCache::setMetaDataReader(const MetaDataReader &reader)
+{
+    QMutexLocker locker(&m_mutex);
+    m_reader = reader;
+}
+
+bool PluginMetaDataCache::isDirty() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dirty;
+}
+
+QJsonObject PluginMetaDataCache::readPluginMetaData(const QString &pluginFile)
+{
+    return QPluginLoader(pluginFile).metaData();
+}
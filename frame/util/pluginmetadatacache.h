@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINMETADATACACHE_H
+#define PLUGINMETADATACACHE_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <functional>
+
+/**
+ * @brief PluginMetaDataCache 插件元数据的磁盘缓存
+ * 以(路径, inode, 文件大小, 修改时间)作为文件标识缓存QPluginLoader::metaData()的结果，
+ * 启动时可以直接根据缓存决定插件加载、拒绝还是延后，不必为读取元数据而映射ELF文件。
+ * 插件文件被替换(inode变化)、重新写入(大小或修改时间变化)时缓存自动失效。
+ * 可以在插件加载线程池中并发调用
+ */
+class PluginMetaDataCache
+{
+public:
+    typedef std::function<QJsonObject(const QString &)> MetaDataReader;
+
+    struct FileIdentity {
+        quint64 inode = 0;
+        qint64 size = -1;
+        qint64 mtime = 0;       // 纳秒
+
+        bool isValid() const { return size >= 0; }
+        bool operator==(const FileIdentity &other) const;
+        bool operator!=(const FileIdentity &other) const { return !(*this == other); }
+    };
+
+    explicit PluginMetaDataCache(const QString &cacheFile);
+
+    // 每个插件目录使用单独的缓存文件，避免多个加载线程同时写同一个文件
+    static QString cacheFileForDir(const QString &pluginDirPath);
+    static FileIdentity fileIdentity(const QString &filePath);
+
+    bool load();
+    bool save();
+
+    // 返回插件的元数据，缓存未命中或已失效时通过reader重新读取并更新缓存
+    QJsonObject metaData(const QString &pluginFile);
+    // 只查询缓存，不读取插件文件
+    bool cachedMetaData(const QString &pluginFile, QJsonObject *metaData) const;
+    // 插件实例化后记录的描述信息(名称、标志等)，下次启动时用于在不加载插件的情况下判断是否可以延后加载，
+    // 文件变化后随元数据一起失效
+    bool descriptor(const QString &pluginFile, QJsonObject *descriptor) const;
+    void setDescriptor(const QString &pluginFile, const QJsonObject &descriptor);
+    // 移除本次没有访问过的插件(已被删除或者被禁用)，下次保存时不再写入
+    void pruneUntouched();
+
+    void setMetaDataReader(const MetaDataReader &reader);
+    bool isDirty() const;
+
+private:
+    struct Entry {
+        FileIdentity identity;
+        QJsonObject metaData;
+        QJsonObject descriptor;
+    };
+
+    static QJsonObject readPluginMetaData(const QString &pluginFile);
+
+private:
+    mutable QMutex m_mutex;
+    QString m_cacheFile;
+    MetaDataReader m_reader;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_touched;
+    bool m_dirty;
+};
+
+#endif // PLUGINMETADATACACHE_H
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginsettingsreconciler.h"
+#include "pluginsettingsstore.h"
+
+#include <QMap>
+
+void PluginSettingsReconciler::setNotifier(const PluginCallback &notifier)
+{
+    m_notifier = notifier;
+}
+
+void PluginSettingsReconciler::setItemLoadedChecker(const PluginPredicate &checker)
+{
+    m_itemLoadedChecker = checker;
+}
+
+void PluginSettingsReconciler::setItemRemover(const PluginCallback &remover)
+{
+    m_itemRemover = remover;
+}
+
+void PluginSettingsReconciler::setItemAdder(const PluginCallback &adder)
+{
+    m_itemAdder = adder;
+}
+
+int PluginSettingsReconciler::reconcile(const QJsonObject &oldSettings, const QJsonObject &newSettings) const
+{
+    const QList<PluginChange> &changes = diff(oldSettings, newSettings);
+
+    // 先通知插件，插件可能在这里根据enable添加或者移除自己的插件项
+    if (m_notifier) {
+        for (const PluginChange &change : changes)
+            m_notifier(change.pluginName);
+    }
+
+    // 位置变化的插件项需要重新插入才能按新的顺序排列
+    for (const PluginChange &change : changes) {
+        if (!change.positionChanged)
+            continue;
+
+        if (m_itemLoadedChecker && !m_itemLoadedChecker(change.pluginName))
+            continue;
+
+        if (m_itemRemover)
+            m_itemRemover(change.pluginName);
+        if (m_itemAdder)
+            m_itemAdder(change.pluginName);
+    }
+
+    return changes.size();
+}
+
+QList<PluginSettingsReconciler::PluginChange> PluginSettingsReconciler::diff(const QJsonObject &oldSettings, const QJsonObject &newSettings)
+{
+    // 按插件名排序，保证通知顺序稳定
+    QMap<QString, PluginChange> pluginChanges;
+    const QList<QPair<QString, QString>> &changedKeys = PluginSettingsStore::changedKeys(oldSettings, newSettings);
+    for (const auto &changedKey : changedKeys) {
+        PluginChange &change = pluginChanges[changedKey.first];
+        change.pluginName = changedKey.first;
+        change.keys << changedKey.second;
+        if (isPositionKey(changedKey.second))
+            change.positionChanged = true;
+    }
+
+    return pluginChanges.values();
+}
+
+bool PluginSettingsReconciler::isPositionKey(const QString &key)
+{
+    // 插件在itemSortKey/setSortKey中使用pos_<itemKey>_<displayMode>保存位置
+    return key.startsWith("pos_");
+}
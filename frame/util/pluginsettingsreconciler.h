@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINSETTINGSRECONCILER_H
+#define PLUGINSETTINGSRECONCILER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+
+#include <functional>
+
+/**
+ * @brief PluginSettingsReconciler 插件配置被外部修改后的增量刷新
+ * 按插件和key比较修改前后的配置，只通知配置发生变化的插件，
+ * 只有排序位置(pos_*)发生变化时才重新添加该插件的插件项，
+ * 显示状态(enable)由插件在pluginSettingsChanged中自己调用itemAdded/itemRemoved处理
+ */
+class PluginSettingsReconciler
+{
+public:
+    typedef std::function<void(const QString &pluginName)> PluginCallback;
+    typedef std::function<bool(const QString &pluginName)> PluginPredicate;
+
+    struct PluginChange {
+        QString pluginName;
+        QStringList keys;
+        bool positionChanged = false;
+    };
+
+    void setNotifier(const PluginCallback &notifier);
+    void setItemLoadedChecker(const PluginPredicate &checker);
+    void setItemRemover(const PluginCallback &remover);
+    void setItemAdder(const PluginCallback &adder);
+
+    // 返回发生变化的插件个数
+    int reconcile(const QJsonObject &oldSettings, const QJsonObject &newSettings) const;
+
+    static QList<PluginChange> diff(const QJsonObject &oldSettings, const QJsonObject &newSettings);
+    static bool isPositionKey(const QString &key);
+
+private:
+    PluginCallback m_notifier;
+    PluginPredicate m_itemLoadedChecker;
+    PluginCallback m_itemRemover;
+    PluginCallback m_itemAdder;
+};
+
+#endif // PLUGINSETTINGSRECONCILER_H
@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginsettingsstore.h"
+
+#include <QJsonDocument>
+#include <QTimer>
+
+// 合并写入的时间间隔，拖动滑块时的连续修改只写入一次
+#define WRITE_DELAY 300
+
+PluginSettingsStore::PluginSettingsStore(const Reader &reader, const Writer &writer, QObject *parent)
+    : QObject(parent)
+    , m_reader(reader)
+    , m_writer(writer)
+    , m_writeTimer(new QTimer(this))
+    , m_lastSynced(reader())
+{
+    m_settings = parse(m_lastSynced);
+
+    m_writeTimer->setSingleShot(true);
+    m_writeTimer->setInterval(WRITE_DELAY);
+    connect(m_writeTimer, &QTimer::timeout, this, &PluginSettingsStore::flush);
+}
+
+PluginSettingsStore::~PluginSettingsStore()
+{
+    // 析构时配置后端可能已经不可用，由持有者在退出前调用flush
+}
+
+QJsonObject PluginSettingsStore::settings() const
+{
+    return m_settings;
+}
+
+QString PluginSettingsStore::toJson() const
+{
+    return QString::fromUtf8(QJsonDocument(m_settings).toJson(QJsonDocument::Compact));
+}
+
+QJsonObject PluginSettingsStore::pluginSettings(const QString &pluginName) const
+{
+    return m_settings.value(pluginName).toObject();
+}
+
+QJsonValue PluginSettingsStore::value(const QString &pluginName, const QString &key) const
+{
+    return m_settings.value(pluginName).toObject().value(key);
+}
+
+void PluginSettingsStore::setValue(const QString &pluginName, const QString &key, const QJsonValue &value)
+{
+    updateValue(pluginName, key, value);
+}
+
+void PluginSettingsStore::merge(const QJsonObject &settings)
+{
+    for (auto pluginsIt = settings.constBegin(); pluginsIt != settings.constEnd(); ++pluginsIt) {
+        const QJsonObject &pluginObject = pluginsIt.value().toObject();
+        for (auto settingsIt = pluginObject.constBegin(); settingsIt != pluginObject.constEnd(); ++settingsIt)
+            updateValue(pluginsIt.key(), settingsIt.key(), settingsIt.value());
+    }
+}
+
+void PluginSettingsStore::remove(const QString &pluginName, const QStringList &keys)
+{
+    if (pluginName.isEmpty())
+        return;
+
+    if (!keys.isEmpty()) {
+        for (const QString &key : keys)
+            updateValue(pluginName, key, QJsonValue(QJsonValue::Undefined));
+        return;
+    }
+
+    if (!m_settings.contains(pluginName))
+        return;
+
+    const QStringList pluginKeys = pluginSettings(pluginName).keys();
+    m_settings.remove(pluginName);
+    // 空key表示整个插件的配置以本地为准
+    markPending(pluginName, QString());
+    for (const QString &key : pluginKeys)
+        Q_EMIT valueChanged(pluginName, key);
+}
+
+void PluginSettingsStore::reset(const QJsonObject &settings)
+{
+    const QList<QPair<QString, QString>> &changes = changedKeys(m_settings, settings);
+    if (changes.isEmpty())
+        return;
+
+    m_settings = settings;
+    for (const auto &change : changes)
+        markPending(change.first, QString());
+
+    for (const auto &change : changes)
+        Q_EMIT valueChanged(change.first, change.second);
+}
+
+void PluginSettingsStore::reload()
+{
+    const QString &jsonStr = m_reader();
+    // 自己写入的配置引起的通知
+    if (jsonStr == m_lastSynced)
+        return;
+
+    m_lastSynced = jsonStr;
+    QJsonObject newSettings = parse(jsonStr);
+
+    // 本地还未写入的修改覆盖外部的修改
+    for (auto it = m_pendingKeys.constBegin(); it != m_pendingKeys.constEnd(); ++it) {
+        const QString &pluginName = it.key();
+        if (!m_settings.contains(pluginName)) {
+            newSettings.remove(pluginName);
+            continue;
+        }
+
+        const QJsonObject &localObject = m_settings.value(pluginName).toObject();
+        if (it.value().contains(QString())) {
+            newSettings.insert(pluginName, localObject);
+            continue;
+        }
+
+        QJsonObject pluginObject = newSettings.value(pluginName).toObject();
+        for (const QString &key : it.value()) {
+            if (localObject.contains(key))
+                pluginObject.insert(key, localObject.value(key));
+            else
+                pluginObject.remove(key);
+        }
+        newSettings.insert(pluginName, pluginObject);
+    }
+
+    const QList<QPair<QString, QString>> &changes = changedKeys(m_settings, newSettings);
+    if (changes.isEmpty())
+        return;
+
+    const QJsonObject oldSettings = m_settings;
+    m_settings = newSettings;
+    for (const auto &change : changes)
+        Q_EMIT valueChanged(change.first, change.second);
+
+    Q_EMIT externalChanged(oldSettings, newSettings);
+}
+
+void PluginSettingsStore::flush()
+{
+    m_writeTimer->stop();
+    if (m_pendingKeys.isEmpty())
+        return;
+
+    // 任务栏和插件管理库各有一份存储，等待写入期间另一方可能写入了其它key，写入前先合并当前的配置
+    reload();
+
+    m_pendingKeys.clear();
+    m_lastSynced = toJson();
+    m_writer(m_lastSynced);
+}
+
+void PluginSettingsStore::setWriteDelay(int msec)
+{
+    m_writeTimer->setInterval(msec);
+}
+
+bool PluginSettingsStore::hasPendingWrite() const
+{
+    return !m_pendingKeys.isEmpty();
+}
+
+QJsonObject PluginSettingsStore::parse(const QString &jsonStr)
+{
+    QJsonObject settings;
+    const QJsonObject &object = QJsonDocument::fromJson(jsonStr.toUtf8()).object();
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        if (it.value().isObject())
+            settings.insert(it.key(), it.value());
+    }
+
+    return settings;
+}
+
+QList<QPair<QString, QString>> PluginSettingsStore::changedKeys(const QJsonObject &oldSettings, const QJsonObject &newSettings)
+{
+    QList<QPair<QString, QString>> changes;
+
+    QSet<QString> pluginNames;
+    for (auto it = oldSettings.constBegin(); it != oldSettings.constEnd(); ++it)
+        pluginNames << it.key();
+    for (auto it = newSettings.constBegin(); it != newSettings.constEnd(); ++it)
+        pluginNames << it.key();
+
+    for (const QString &pluginName : pluginNames) {
+        const QJsonObject &oldObject = oldSettings.value(pluginName).toObject();
+        const QJsonObject &newObject = newSettings.value(pluginName).toObject();
+        if (oldObject == newObject)
+            continue;
+
+        for (auto it = oldObject.constBegin(); it != oldObject.constEnd(); ++it) {
+            if (newObject.value(it.key()) != it.value())
+                changes << qMakePair(pluginName, it.key());
+        }
+        for (auto it = newObject.constBegin(); it != newObject.constEnd(); ++it) {
+            if (!oldObject.contains(it.key()))
+                changes << qMakePair(pluginName, it.key());
+        }
+    }
+
+    return changes;
+}
+
+void PluginSettingsStore::updateValue(const QString &pluginName, const QString &key, const QJsonValue &value)
+{
+    if (pluginName.isEmpty() || key.isEmpty())
+        return;
+
+    QJsonObject pluginObject = m_settings.value(pluginName).toObject();
+    if (pluginObject.value(key) == value)
+        return;
+
+    if (value.isUndefined())
+        pluginObject.remove(key);
+    else
+        pluginObject.insert(key, value);
+
+    m_settings.insert(pluginName, pluginObject);
+    markPending(pluginName, key);
+
+    Q_EMIT valueChanged(pluginName, key);
+}
+
+void PluginSettingsStore::markPending(const QString &pluginName, const QString &key)
+{
+    m_pendingKeys[pluginName].insert(key);
+    scheduleWrite();
+}
+
+void PluginSettingsStore::scheduleWrite()
+{
+    // 已经在等待写入时不重新计时，保证持续修改时也能按间隔写入
+    if (!m_writeTimer->isActive())
+        m_writeTimer->start();
+}
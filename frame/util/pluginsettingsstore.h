@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINSETTINGSSTORE_H
+#define PLUGINSETTINGSSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QSet>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief PluginSettingsStore 插件配置的内存存储
+ * 插件配置在DConfig中以一个JSON字符串保存，这里只在启动和外部修改时解析一次，
+ * 之后按(插件, key)直接修改内存中的文档，短时间内的多次修改合并为一次写入，
+ * 避免滑动音量、亮度等频繁调用saveValue时反复解析和写入整个配置。
+ * 析构时不会自动写入，持有者需要在退出前调用flush
+ */
+class PluginSettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<QString()> Reader;
+    typedef std::function<void(const QString &)> Writer;
+
+    explicit PluginSettingsStore(const Reader &reader, const Writer &writer, QObject *parent = nullptr);
+    ~PluginSettingsStore() override;
+
+    QJsonObject settings() const;
+    QString toJson() const;
+    QJsonObject pluginSettings(const QString &pluginName) const;
+    QJsonValue value(const QString &pluginName, const QString &key) const;
+
+    void setValue(const QString &pluginName, const QString &key, const QJsonValue &value);
+    // settings的格式为{插件: {key: value}}，只覆盖其中出现的key
+    void merge(const QJsonObject &settings);
+    // keys为空时移除插件的所有配置
+    void remove(const QString &pluginName, const QStringList &keys = QStringList());
+    void reset(const QJsonObject &settings);
+
+    // 配置被外部修改后重新读取，本地还未写入的修改会保留
+    void reload();
+    // 合并当前的配置后立即写入还未写入的修改
+    void flush();
+
+    void setWriteDelay(int msec);
+    bool hasPendingWrite() const;
+
+    static QJsonObject parse(const QString &jsonStr);
+    // 比较两份配置，返回值发生变化的(插件, key)
+    static QList<QPair<QString, QString>> changedKeys(const QJsonObject &oldSettings, const QJsonObject &newSettings);
+
+Q_SIGNALS:
+    // 本地或外部修改引起的单个配置项变化
+    void valueChanged(const QString &pluginName, const QString &key);
+    // 外部修改了配置，参数为修改前后的配置
+    void externalChanged(const QJsonObject &oldSettings, const QJsonObject &newSettings);
+
+private:
+    void updateValue(const QString &pluginName, const QString &key, const QJsonValue &value);
+    void markPending(const QString &pluginName, const QString &key);
+    void scheduleWrite();
+
+private:
+    Reader m_reader;
+    Writer m_writer;
+    QTimer *m_writeTimer;
+    QJsonObject m_settings;
+    QString m_lastSynced;                           // 最后一次读取或者写入的配置，用于忽略自己写入引起的变化通知
+    QHash<QString, QSet<QString>> m_pendingKeys;    // 还未写入的修改，插件 -> key
+};
+
+#endif // PLUGINSETTINGSSTORE_H
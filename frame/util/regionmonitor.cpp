@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "regionmonitor.h"
+#include "dbusutil.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+
+using XEventMonitor = ::org::deepin::dde::XEventMonitor1;
+
+RegionMonitor::RegionMonitor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DBusRegionMonitor::DBusRegionMonitor(QObject *parent)
+    : RegionMonitor(parent)
+    , m_eventInter(new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus(), this))
+{
+    QDBusConnectionInterface *ifc = QDBusConnection::sessionBus().interface();
+    if (ifc->isServiceRegistered(xEventMonitorService))
+        connectMonitor();
+
+    // org.deepin.dde.XEventMonitor1服务比dock晚启动或者重新启动时，之前注册的区域都已经失效
+    connect(ifc, &QDBusConnectionInterface::serviceOwnerChanged, this, [ = ](const QString &name, const QString &oldOwner, const QString &newOwner) {
+        Q_UNUSED(oldOwner)
+        if (name != xEventMonitorService || newOwner.isEmpty())
+            return;
+
+        delete m_eventInter;
+        m_eventInter = new XEventMonitor(xEventMonitorService, xEventMonitorPath, QDBusConnection::sessionBus(), this);
+        connectMonitor();
+
+        Q_EMIT monitorReset();
+    });
+}
+
+QString DBusRegionMonitor::registerAreas(const QList<MonitRect> &areas, int flags)
+{
+    return m_eventInter->RegisterAreas(areas, flags);
+}
+
+bool DBusRegionMonitor::unregisterArea(const QString &key)
+{
+    return m_eventInter->UnregisterArea(key);
+}
+
+void DBusRegionMonitor::connectMonitor()
+{
+    connect(m_eventInter, &XEventMonitor::CursorInto, this, &DBusRegionMonitor::cursorInto);
+    connect(m_eventInter, &XEventMonitor::CursorOut, this, &DBusRegionMonitor::cursorOut);
+    connect(m_eventInter, &XEventMonitor::CursorMove, this, &DBusRegionMonitor::cursorMove);
+    connect(m_eventInter, &XEventMonitor::ButtonPress, this, &DBusRegionMonitor::buttonPress);
+    connect(m_eventInter, &XEventMonitor::ButtonRelease, this, &DBusRegionMonitor::buttonRelease);
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef REGIONMONITOR_H
+#define REGIONMONITOR_H
+
+#include "org_deepin_dde_xeventmonitor1.h"
+
+#include <QObject>
+
+/**
+ * @brief RegionMonitor 监听鼠标在指定区域内的移动和点击
+ * 接口和信号与org.deepin.dde.XEventMonitor1保持一致：注册一组区域返回一个key，
+ * 区域内的事件通过信号通知，信号中带有区域的key
+ */
+class RegionMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Flag {
+        Motion = 1 << 0,
+        Button = 1 << 1,
+        Key    = 1 << 2
+    };
+
+    explicit RegionMonitor(QObject *parent = nullptr);
+
+    virtual QString registerAreas(const QList<MonitRect> &areas, int flags) = 0;
+    virtual bool unregisterArea(const QString &key) = 0;
+
+Q_SIGNALS:
+    void cursorInto(int x, int y, const QString &key);
+    void cursorOut(int x, int y, const QString &key);
+    void cursorMove(int x, int y, const QString &key);
+    void buttonPress(int button, int x, int y, const QString &key);
+    void buttonRelease(int button, int x, int y, const QString &key);
+    // 监听服务重新启动，之前注册的区域全部失效，需要重新注册
+    void monitorReset();
+};
+
+/**
+ * @brief DBusRegionMonitor 通过org.deepin.dde.XEventMonitor1服务监听区域
+ * 服务可能比任务栏晚启动，也可能重新启动，每次服务启动后重新连接信号并通知重新注册区域
+ */
+class DBusRegionMonitor : public RegionMonitor
+{
+    Q_OBJECT
+
+public:
+    explicit DBusRegionMonitor(QObject *parent = nullptr);
+
+    QString registerAreas(const QList<MonitRect> &areas, int flags) override;
+    bool unregisterArea(const QString &key) override;
+
+private:
+    void connectMonitor();
+
+private:
+    ::org::deepin::dde::XEventMonitor1 *m_eventInter;
+};
+
+#endif // REGIONMONITOR_H
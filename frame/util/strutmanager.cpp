@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "strutmanager.h"
+
+#include <QTimer>
+
+bool StrutManager::Strut::operator==(const Strut &other) const
+{
+    // 不预留时其他的值没有意义
+    if (isNull() || other.isNull())
+        return isNull() && other.isNull();
+
+    return position == other.position && size == other.size && start == other.start && end == other.end;
+}
+
+StrutManager::StrutManager(QObject *parent)
+    : QObject(parent)
+    , m_delayTimer(new QTimer(this))
+    , m_retryTimer(new QTimer(this))
+    , m_written(false)
+    , m_held(false)
+    , m_minRetryInterval(200)
+    , m_maxRetryInterval(10 * 1000)
+    , m_retryInterval(0)
+    , m_writeCount(0)
+    , m_suppressedCount(0)
+{
+    m_delayTimer->setInterval(100);
+    m_delayTimer->setSingleShot(true);
+    connect(m_delayTimer, &QTimer::timeout, this, &StrutManager::flush);
+
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &StrutManager::flush);
+}
+
+/**
+ * @brief StrutManager::setWriter 设置写入预留区域的方法，写入失败时返回false，稍后会重新写入
+ */
+void StrutManager::setWriter(const Writer &writer)
+{
+    m_writer = writer;
+}
+
+void StrutManager::setDelay(int msec)
+{
+    m_delayTimer->setInterval(msec);
+}
+
+/**
+ * @brief StrutManager::setRetryInterval 写入失败后第一次重试的间隔，之后每次加倍，不超过maxMsec
+ */
+void StrutManager::setRetryInterval(int minMsec, int maxMsec)
+{
+    m_minRetryInterval = qMax(1, minMsec);
+    m_maxRetryInterval = qMax(m_minRetryInterval, maxMsec);
+}
+
+void StrutManager::setStrut(const Strut &strut)
+{
+    if (m_desired == strut && (m_held || m_delayTimer->isActive() || m_retryTimer->isActive() || (m_written && m_applied == strut))) {
+        ++m_suppressedCount;
+        return;
+    }
+
+    m_desired = strut;
+    schedule();
+}
+
+void StrutManager::clear()
+{
+    setStrut(Strut());
+}
+
+StrutManager::Strut StrutManager::strut() const
+{
+    return m_desired;
+}
+
+bool StrutManager::isHeld() const
+{
+    return m_held;
+}
+
+int StrutManager::writeCount() const
+{
+    return m_writeCount;
+}
+
+int StrutManager::suppressedCount() const
+{
+    return m_suppressedCount;
+}
+
+/**
+ * @brief StrutManager::setHold 暂停或者恢复写入，一般在执行动画的过程中暂停
+ */
+void StrutManager::setHold(bool hold)
+{
+    if (m_held == hold)
+        return;
+
+    m_held = hold;
+    if (m_held) {
+        m_delayTimer->stop();
+        m_retryTimer->stop();
+        return;
+    }
+
+    // 恢复之后等待一段时间再写入，合并动画结束时的多次变化
+    schedule();
+}
+
+/**
+ * @brief StrutManager::flush 把期望的预留区域写入到窗管，和上一次写入的值相同时忽略
+ */
+void StrutManager::flush()
+{
+    m_delayTimer->stop();
+    m_retryTimer->stop();
+    if (m_held)
+        return;
+
+    if (m_written && m_applied == m_desired) {
+        m_retryInterval = 0;
+        ++m_suppressedCount;
+        return;
+    }
+
+    if (m_writer && !m_writer(m_desired)) {
+        // 写入失败(例如窗口还没有映射)，连续失败时重试的间隔逐次加倍
+        m_retryInterval = m_retryInterval > 0 ? qMin(m_retryInterval * 2, m_maxRetryInterval) : m_minRetryInterval;
+        m_retryTimer->start(m_retryInterval);
+        return;
+    }
+
+    m_retryInterval = 0;
+    m_applied = m_desired;
+    m_written = true;
+    ++m_writeCount;
+}
+
+void StrutManager::schedule()
+{
+    if (m_held || m_delayTimer->isActive())
+        return;
+
+    m_delayTimer->start();
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef STRUTMANAGER_H
+#define STRUTMANAGER_H
+
+#include "constants.h"
+
+#include <QObject>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief StrutManager 任务栏向窗管申请的预留区域
+ * 记录当前期望的预留区域，短时间内的多次变化合并成一次，和上一次写入的值相同时不再写入；
+ * 动画执行期间暂停写入，动画结束之后再一次性写入最终的值，避免窗管反复调整最大化窗口的大小；
+ * 写入失败时按逐次加倍的间隔重试，直到写入成功
+ */
+class StrutManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 预留区域，size为到屏幕边缘的距离(实际像素)，start和end为任务栏的起止坐标(上下为x，左右为y)，size为0时表示不预留
+    struct Strut {
+        Dock::Position position = Dock::Position::Bottom;
+        int size = 0;
+        int start = 0;
+        int end = 0;
+
+        bool isNull() const { return size <= 0; }
+        bool operator==(const Strut &other) const;
+        bool operator!=(const Strut &other) const { return !(*this == other); }
+    };
+
+    typedef std::function<bool(const Strut &)> Writer;
+
+    explicit StrutManager(QObject *parent = nullptr);
+
+    void setWriter(const Writer &writer);
+    void setDelay(int msec);
+    void setRetryInterval(int minMsec, int maxMsec);
+
+    void setStrut(const Strut &strut);
+    void clear();
+    Strut strut() const;
+
+    bool isHeld() const;
+    int writeCount() const;
+    int suppressedCount() const;
+
+public Q_SLOTS:
+    void setHold(bool hold);
+    void flush();
+
+private:
+    void schedule();
+
+private:
+    QTimer *m_delayTimer;
+    QTimer *m_retryTimer;
+    Writer m_writer;
+    Strut m_desired;
+    Strut m_applied;
+    bool m_written;     // 已经写入过，m_applied有效
+    bool m_held;
+    int m_minRetryInterval;
+    int m_maxRetryInterval;
+    int m_retryInterval;    // 下一次重试的间隔，为0时表示上一次写入没有失败
+    int m_writeCount;
+    int m_suppressedCount;
+};
+
+#endif // STRUTMANAGER_H
@@ -12,6 +12,7 @@
 #include "displaymanager.h"
 #include "menuworker.h"
 #include "docksettings.h"
+#include "geometrytransaction.h"
 
 #include <DStyle>
 #include <DWindowManagerHelper>
@@ -46,6 +47,7 @@ MainWindowBase::MainWindowBase(MultiScreenWorker *multiScreenWorker, QWidget *pa
     , m_multiScreenWorker(multiScreenWorker)
     , m_updateDragAreaTimer(new QTimer(this))
     , m_shadowMaskOptimizeTimer(new QTimer(this))
+    , m_resizeTransaction(new GeometryTransaction(this))
     , m_isShow(false)
     , m_order(0)
 {
@@ -111,17 +113,14 @@ void MainWindowBase::initConnection()
     connect(DWindowManagerHelper::instance(), &DWindowManagerHelper::hasCompositeChanged, m_shadowMaskOptimizeTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
     connect(m_shadowMaskOptimizeTimer, &QTimer::timeout, this, &MainWindowBase::adjustShadowMask, Qt::QueuedConnection);
 
-    connect(m_dragWidget, &DragWidget::dragFinished, this, [ = ] {
-        Utils::setIsDraging(false);
-    });
-
     // -拖拽任务栏改变高度或宽度-------------------------------------------------------------------------------
     connect(m_updateDragAreaTimer, &QTimer::timeout, this, &MainWindowBase::resetDragWindow);
     //TODO 后端考虑删除这块，目前还不能删除，调整任务栏高度的时候，任务栏外部区域有变化
     connect(m_updateDragAreaTimer, &QTimer::timeout, m_multiScreenWorker, &MultiScreenWorker::onRequestUpdateRegionMonitor);
 
     connect(m_dragWidget, &DragWidget::dragPointOffset, this, &MainWindowBase::onMainWindowSizeChanged);
-    connect(m_dragWidget, &DragWidget::dragFinished, this, &MainWindowBase::resetDragWindow);   //　更新拖拽区域
+    // 拖拽结束时才更新拖拽区域，通知后端和窗管
+    connect(m_dragWidget, &DragWidget::dragFinished, m_resizeTransaction, &GeometryTransaction::end);
     connect(TouchSignalManager::instance(), &TouchSignalManager::touchMove, m_dragWidget, &DragWidget::onTouchMove);
     connect(TouchSignalManager::instance(), &TouchSignalManager::middleTouchPress, this, &MainWindowBase::touchRequestResizeDock);
 
@@ -139,6 +138,12 @@ void MainWindowBase::initMember()
     m_updateDragAreaTimer->setSingleShot(true);
     m_shadowMaskOptimizeTimer->setSingleShot(true);
     m_shadowMaskOptimizeTimer->setInterval(100);
+
+    m_resizeTransaction->setApplyFunction([ this ](int dockSize) { applyDockSize(dockSize); });
+    m_resizeTransaction->setCommitFunction([ this ](int) {
+        Utils::setIsDraging(false);
+        resetDragWindow();
+    });
 }
 
 int MainWindowBase::getBorderRadius() const
@@ -189,9 +194,46 @@ QRect MainWindowBase::getAnimationRect(const QRect &sourceRect, const Dock::Posi
 
 /**
  * @brief MainWindow::onMainWindowSizeChanged 任务栏拖拽过程中会不停调用此方法更新自身大小
+ * 拖拽过程中的大小变化合并到每一帧更新一次，拖拽结束时再通知后端和窗管
  * @param offset 拖拽时的坐标偏移量
  */
 void MainWindowBase::onMainWindowSizeChanged(QPoint offset)
+{
+    QScreen *screen = DIS_INS->screen(DOCK_SCREEN->current());
+    if (!screen)
+        return;
+
+    // 拖拽结束之前后端保存的大小不变，偏移量始终相对于拖拽开始时的大小
+    const QRect rect = getDockGeometry(screen, position(), displayMode(), Dock::HideState::Show);
+    int dockSize = 0;
+    switch (m_multiScreenWorker->position()) {
+    case Top:
+        dockSize = rect.height() + offset.y();
+        break;
+    case Bottom:
+        dockSize = rect.height() - offset.y();
+        break;
+    case Left:
+        dockSize = rect.width() + offset.x();
+        break;
+    case Right:
+        dockSize = rect.width() - offset.x();
+        break;
+    }
+
+    if (!m_resizeTransaction->isActive()) {
+        Utils::setIsDraging(true);
+        m_resizeTransaction->begin();
+    }
+
+    m_resizeTransaction->update(qBound(DOCK_MIN_SIZE, dockSize, DOCK_MAX_SIZE));
+}
+
+/**
+ * @brief MainWindowBase::applyDockSize 拖拽过程中按新的大小更新窗口
+ * @param dockSize 任务栏的高度(上下)或宽度(左右)
+ */
+void MainWindowBase::applyDockSize(int dockSize)
 {
     QScreen *screen = DIS_INS->screen(DOCK_SCREEN->current());
     if (!screen)
@@ -204,34 +246,32 @@ void MainWindowBase::onMainWindowSizeChanged(QPoint offset)
         newRect.setX(rect.x());
         newRect.setY(rect.y());
         newRect.setWidth(rect.width());
-        newRect.setHeight(qBound(DOCK_MIN_SIZE, rect.height() + offset.y(), DOCK_MAX_SIZE));
+        newRect.setHeight(dockSize);
     }
         break;
     case Bottom: {
         newRect.setX(rect.x());
-        newRect.setY(rect.y() + rect.height() - qBound(DOCK_MIN_SIZE, rect.height() - offset.y(), DOCK_MAX_SIZE));
+        newRect.setY(rect.y() + rect.height() - dockSize);
         newRect.setWidth(rect.width());
-        newRect.setHeight(qBound(DOCK_MIN_SIZE, rect.height() - offset.y(), DOCK_MAX_SIZE));
+        newRect.setHeight(dockSize);
     }
         break;
     case Left: {
         newRect.setX(rect.x());
         newRect.setY(rect.y());
-        newRect.setWidth(qBound(DOCK_MIN_SIZE, rect.width() + offset.x(), DOCK_MAX_SIZE));
+        newRect.setWidth(dockSize);
         newRect.setHeight(rect.height());
     }
         break;
     case Right: {
-        newRect.setX(rect.x() + rect.width() - qBound(DOCK_MIN_SIZE, rect.width() - offset.x(), DOCK_MAX_SIZE));
+        newRect.setX(rect.x() + rect.width() - dockSize);
         newRect.setY(rect.y());
-        newRect.setWidth(qBound(DOCK_MIN_SIZE, rect.width() - offset.x(), DOCK_MAX_SIZE));
+        newRect.setWidth(dockSize);
         newRect.setHeight(rect.height());
     }
         break;
     }
 
-    Utils::setIsDraging(true);
-
     setFixedSize(newRect.size());
     move(newRect.topLeft());
     resetPanelGeometry();
@@ -470,7 +510,7 @@ QRect MainWindowBase::getDockGeometry(QScreen *screen, const Dock::Position &pos
     return rect;
 }
 
-QVariantAnimation *MainWindowBase::createAnimation(QScreen *screen, const Dock::Position &pos, const Dock::AniAction &act)
+DockAnimationController::Track MainWindowBase::createAnimationTrack(QScreen *screen, const Dock::Position &pos, const Dock::AniAction &act)
 {
     /** FIXME
      * 在高分屏2.75倍缩放的情况下，mainWindowGeometry返回的任务栏高度有问题（实际是40,返回是39）
@@ -485,57 +525,29 @@ QVariantAnimation *MainWindowBase::createAnimation(QScreen *screen, const Dock::
         if (pos == Position::Top || pos == Position::Bottom) {
             if (qAbs(dockShowRect.height() - mainwindowRect.height()) <= 1
                     && mainwindowRect.contains(dockShowRect.center()))
-                return nullptr;
+                return DockAnimationController::Track();
         } else if (pos == Position::Left || pos == Position::Right) {
             if (qAbs(dockShowRect.width() - mainwindowRect.width()) <= 1
                     && mainwindowRect.contains(dockShowRect.center()))
-                return nullptr;
+                return DockAnimationController::Track();
         }
     }
     if (act == Dock::AniAction::Hide && dockHideRect.size() == mainwindowRect.size())
-        return nullptr;
-
-    // 开始播放动画
-    QVariantAnimation *ani = new QVariantAnimation(nullptr);
-    ani->setEasingCurve(QEasingCurve::InOutCubic);
-#ifndef DISABLE_SHOW_ANIMATION
-    const bool composite = DWindowManagerHelper::instance()->hasComposite(); // 判断是否开启特效模式
-    const int duration = composite ? ANIMATIONTIME : 0;
-#else
-    const int duration = 0;
-#endif
-    ani->setDuration(duration);
-
-    connect(ani, &QVariantAnimation::valueChanged, this, [ = ](const QVariant &value) {
-        if ((!m_multiScreenWorker->testState(MultiScreenWorker::ShowAnimationStart)
+        return DockAnimationController::Track();
+
+    DockAnimationController::Track track;
+    track.start = (act == Dock::AniAction::Show ? dockHideRect : dockShowRect);
+    track.end = (act == Dock::AniAction::Show ? dockShowRect : dockHideRect);
+    track.update = [ this, pos ](const QRect &rect) {
+        if (!m_multiScreenWorker->testState(MultiScreenWorker::ShowAnimationStart)
                 && !m_multiScreenWorker->testState(MultiScreenWorker::HideAnimationStart)
                 && !m_multiScreenWorker->testState(MultiScreenWorker::ChangePositionAnimationStart))
-                || ani->state() != QVariantAnimation::State::Running)
             return;
 
-        updateParentGeometry(pos, value.value<QRect>());
-    });
-
-    switch (act) {
-    case Dock::AniAction::Show: {
-        ani->setStartValue(dockHideRect);
-        ani->setEndValue(dockShowRect);
-        connect(ani, &QVariantAnimation::finished, this, [ = ]{
-            updateParentGeometry(pos, dockShowRect);
-        });
-        break;
-    }
-    case Dock::AniAction::Hide: {
-        ani->setStartValue(dockShowRect);
-        ani->setEndValue(dockHideRect);
-        connect(ani, &QVariantAnimation::finished, this, [ = ]{
-            updateParentGeometry(pos, dockHideRect);
-        });
-        break;
-    }
-    }
+        updateParentGeometry(pos, rect);
+    };
 
-    return ani;
+    return track;
 }
 
 Dock::DisplayMode MainWindowBase::displayMode() const
@@ -558,7 +570,8 @@ int MainWindowBase::windowSize() const
 
 bool MainWindowBase::isDraging() const
 {
-    return m_dragWidget->isDraging();
+    // 拖拽结束后还要把最后的大小更新到窗口，事务结束之前仍然当做拖拽中
+    return m_dragWidget->isDraging() || m_resizeTransaction->isActive() || Utils::isDraging();
 }
 
 int MainWindowBase::dockSpace() const
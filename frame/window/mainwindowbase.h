@@ -8,6 +8,7 @@
 
 #include "constants.h"
 #include "dbusutil.h"
+#include "dockanimationcontroller.h"
 
 #include <DBlurEffectWidget>
 #include <DPlatformWindowHandle>
@@ -18,6 +19,7 @@
 #include <utils.h>
 
 class DragWidget;
+class GeometryTransaction;
 class MultiScreenWorker;
 
 DWIDGET_USE_NAMESPACE
@@ -45,7 +47,7 @@ public:
     // 用来更新子区域的位置，一般用于在执行动画的过程中，根据当前的位置来更新里面panel的大小
     virtual void updateParentGeometry(const Dock::Position &pos, const QRect &rect) = 0;
     virtual QRect getDockGeometry(QScreen *screen, const Dock::Position &pos, const Dock::DisplayMode &displaymode, const Dock::HideState &hideState, bool withoutScale = false) const;
-    QVariantAnimation *createAnimation(QScreen *screen, const Dock::Position &pos, const Dock::AniAction &act);
+    DockAnimationController::Track createAnimationTrack(QScreen *screen, const Dock::Position &pos, const Dock::AniAction &act);
     virtual void resetPanelGeometry() {}                        // 重置内部区域，为了让内部区域和当前区域始终保持一致
     virtual int dockSpace() const;                              // 与后面窗体之间的间隔
     virtual void serviceRestart() {}                            // 服务重新启动后的操作
@@ -77,6 +79,7 @@ private:
     void initConnection();
     void initMember();
     void updateDragGeometry();
+    void applyDockSize(int dockSize);
 
     int getBorderRadius() const;
     QRect getAnimationRect(const QRect &sourceRect, const Dock::Position &pos) const;
@@ -99,6 +102,7 @@ private:
     MultiScreenWorker *m_multiScreenWorker;
     QTimer *m_updateDragAreaTimer;
     QTimer *m_shadowMaskOptimizeTimer;
+    GeometryTransaction *m_resizeTransaction;   // 拖拽调整大小时合并更新，结束时统一通知
     bool m_isShow;
     int m_order;
 };
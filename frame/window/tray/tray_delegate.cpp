@@ -74,14 +74,7 @@ QWidget *TrayDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem
 
     BaseTrayWidget *trayWidget = nullptr;
     if(type == TrayIconType::XEmbed) {
-        if (Utils::IS_WAYLAND_DISPLAY) {
-            static Display *display = XOpenDisplay(nullptr);
-            static int screenp = 0;
-            static xcb_connection_t *xcb_connection = xcb_connect(qgetenv("DISPLAY"), &screenp);
-            trayWidget = new XEmbedTrayItemWidget(winId, xcb_connection, display, parent);
-        } else {
-            trayWidget = new XEmbedTrayItemWidget(winId, nullptr, nullptr, parent);
-        }
+        trayWidget = new XEmbedTrayItemWidget(winId, parent);
         const TrayModel *model = qobject_cast<const TrayModel *>(index.model());
         if (model)
             connect(model, &TrayModel::requestUpdateIcon, trayWidget, &BaseTrayWidget::updateIcon);
@@ -182,17 +175,18 @@ QSize TrayDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelInd
 
 void TrayDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
-    Q_UNUSED(index);
-    QRect rect = option.rect;
+    // 拖动排序动画期间叠加当前帧的偏移
+    QRect rect = option.rect.translated(reorderOffset(index));
     // 让控件居中显示
     editor->setGeometry(rect.x() + (rect.width() - ICON_SIZE) / 2,
                         rect.y() + (rect.height() - ICON_SIZE) / 2,
                         ICON_SIZE, ICON_SIZE);
 }
 
-void TrayDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+void TrayDelegate::paint(QPainter *painter, const QStyleOptionViewItem &itemOption, const QModelIndex &index) const
 {
-    Q_UNUSED(index);
+    QStyleOptionViewItem option(itemOption);
+    option.rect.translate(reorderOffset(index));
 
     // 如果不是弹出菜单（在任务栏上显示的），在鼠标没有移入的时候无需绘制背景
     if (!isPopupTray() && !(option.state & QStyle::State_MouseOver))
@@ -267,6 +261,15 @@ void TrayDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
     painter->restore();
 }
 
+QPoint TrayDelegate::reorderOffset(const QModelIndex &index) const
+{
+    TrayGridView *view = qobject_cast<TrayGridView *>(m_listView);
+    if (!view)
+        return QPoint();
+
+    return view->reorderOffset(index);
+}
+
 ExpandIconWidget *TrayDelegate::expandWidget()
 {
     if (!m_listView)
@@ -50,6 +50,7 @@ private:
 
     ExpandIconWidget *expandWidget();
     bool isPopupTray() const;
+    QPoint reorderOffset(const QModelIndex &index) const;
 
 private:
     Dock::Position m_position;
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "tray_gridview.h"
+#include "tray_reorderanimator.h"
 #include "expandiconwidget.h"
 #include "tray_model.h"
 #include "basetraywidget.h"
@@ -20,6 +21,9 @@
 #include <QDebug>
 #include <QTimer>
 
+// 弹出托盘隐藏后，托盘图标控件在该时间内没有再次显示则释放
+#define EDITOR_RELEASE_INTERVAL 30 * 1000
+
 TrayGridView *TrayGridView::getDockTrayGridView(QWidget *parent)
 {
     static TrayGridView *view = nullptr;
@@ -42,10 +46,18 @@ TrayGridView::TrayGridView(QWidget *parent)
     , m_aniDuringTime(250)
     , m_dragDistance(15)
     , m_aniStartTime(new QTimer(this))
+    , m_reorderAnimator(new TrayReorderAnimator(this))
     , m_pressed(false)
     , m_aniRunning(false)
     , m_positon(Dock::Position::Bottom)
+    , m_lazyEditor(false)
+    , m_editorActive(true)
+    , m_releaseTimer(new QTimer(this))
 {
+    m_releaseTimer->setSingleShot(true);
+    m_releaseTimer->setInterval(EDITOR_RELEASE_INTERVAL);
+    connect(m_releaseTimer, &QTimer::timeout, this, &TrayGridView::releaseEditors);
+
     initUi();
 }
 
@@ -136,6 +148,58 @@ QSize TrayGridView::suitableSize(const Dock::Position &position) const
     return QSize(-1, height);
 }
 
+/**
+ * @brief TrayGridView::setLazyEditor 设置是否延迟创建托盘图标控件
+ * 延迟创建时，视图隐藏期间每个托盘只保留模型中的WinInfo，托盘图标控件(以及其中的DBus接口、定时器等)
+ * 在视图显示时(activateEditors)才创建，隐藏一段时间后(deactivateEditors)释放
+ */
+void TrayGridView::setLazyEditor(bool lazy)
+{
+    if (m_lazyEditor == lazy)
+        return;
+
+    m_lazyEditor = lazy;
+    m_editorActive = !lazy || isVisible();
+}
+
+void TrayGridView::openEditor(const QModelIndex &index)
+{
+    if (!index.isValid() || (m_lazyEditor && !m_editorActive))
+        return;
+
+    if (!isPersistentEditorOpen(index))
+        openPersistentEditor(index);
+}
+
+void TrayGridView::activateEditors()
+{
+    m_releaseTimer->stop();
+    if (m_editorActive)
+        return;
+
+    m_editorActive = true;
+    for (int i = 0; i < model()->rowCount(); i++)
+        openEditor(model()->index(i, 0));
+}
+
+void TrayGridView::deactivateEditors()
+{
+    if (!m_lazyEditor || !m_editorActive)
+        return;
+
+    m_releaseTimer->start();
+}
+
+void TrayGridView::releaseEditors()
+{
+    if (!m_lazyEditor || isVisible())
+        return;
+
+    m_editorActive = false;
+    for (int i = 0; i < model()->rowCount(); i++)
+        closePersistentEditor(model()->index(i, 0));
+}
+
 void TrayGridView::setDragDistance(int pixel)
 {
     m_dragDistance = pixel;
@@ -145,6 +209,8 @@ void TrayGridView::setAnimationProperty(const QEasingCurve::Type easing, const i
 {
     m_aniCurveType = easing;
     m_aniDuringTime = duringTime;
+    m_reorderAnimator->setEasingCurve(easing);
+    m_reorderAnimator->setDuration(duringTime);
 }
 
 void TrayGridView::moveAnimation()
@@ -152,11 +218,11 @@ void TrayGridView::moveAnimation()
     if (m_aniRunning || m_aniStartTime->isActive())
         return;
 
-    const QModelIndex dropModelIndex = indexAt(m_dropPos);
+    const QModelIndex dropModelIndex = getIndexFromPos(m_dropPos);
     if (!dropModelIndex.isValid())
         return;
 
-    const QModelIndex dragModelIndex = indexAt(m_dragPos);
+    const QModelIndex dragModelIndex = getIndexFromPos(m_dragPos);
     if (dragModelIndex == dropModelIndex)
         return;
 
@@ -180,8 +246,15 @@ void TrayGridView::moveAnimation()
     const int start = next ? startPos : endPos;
     const int end = !next ? startPos : endPos;
 
-    for (int i = start + next; i <= (end - !next); i++)
-        createAnimation(i, next, (i == (end - !next)));
+    // 拖动项与目标项之间的图标各自向拖动方向的反方向移动一格，所有偏移由同一个动画时钟驱动
+    QHash<int, QPoint> offsets;
+    for (int i = start + next; i <= (end - !next); i++) {
+        const QRect targetRect = indexRect(modelIndex(next ? i - 1 : i + 1));
+        offsets.insert(i, targetRect.topLeft() - indexRect(modelIndex(i)).topLeft());
+    }
+
+    m_aniRunning = true;
+    m_reorderAnimator->start(offsets);
 
     m_dropPos = indexRect(dropModelIndex).center();
     m_dragPos = indexRect(dropModelIndex).center();
@@ -197,6 +270,11 @@ const QRect TrayGridView::indexRect(const QModelIndex &index) const
     return rectForIndex(index);
 }
 
+QPoint TrayGridView::reorderOffset(const QModelIndex &index) const
+{
+    return m_reorderAnimator->offset(index.row());
+}
+
 void TrayGridView::dropSwap()
 {
     qDebug() << "drop end";
@@ -204,12 +282,16 @@ void TrayGridView::dropSwap()
     if (!listModel)
         return;
 
-    QModelIndex index = indexAt(m_dropPos);
-    if (!index.isValid())
+    QModelIndex index = getIndexFromPos(m_dropPos);
+    if (!index.isValid()) {
+        m_reorderAnimator->clear();
+        m_aniRunning = false;
         return;
+    }
 
     listModel->dropSwap(index.row());
     clearDragModelIndex();
+    m_reorderAnimator->clear();
     m_aniRunning = false;
     setState(NoState);
 }
@@ -223,53 +305,6 @@ void TrayGridView::clearDragModelIndex()
     listModel->clearDragDropIndex();
 }
 
-void TrayGridView::createAnimation(const int pos, const bool moveNext, const bool isLastAni)
-{
-    qDebug() << "create moveAnimation";
-    const QModelIndex index(modelIndex(pos));
-    if (!index.isValid())
-        return;
-
-    QLabel *floatLabel = new QLabel(this);
-    QPropertyAnimation *ani = new QPropertyAnimation(floatLabel, "pos", floatLabel);
-    qreal ratio = qApp->devicePixelRatio();
-
-    BaseTrayWidget *widget = qobject_cast<BaseTrayWidget *>(indexWidget(index));
-    if (!widget)
-        return;
-
-    QPixmap pixmap = widget->icon();
-
-    QString text = index.data(Qt::DisplayRole).toString();
-
-    pixmap.scaled(pixmap.size() * ratio, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    pixmap.setDevicePixelRatio(ratio);
-
-    floatLabel->setFixedSize(indexRect(index).size());
-    floatLabel->setPixmap(pixmap);
-    floatLabel->show();
-
-    ani->setStartValue(indexRect(index).center() - QPoint(0, floatLabel->height() /2));
-    ani->setEndValue(indexRect(modelIndex(moveNext ? pos - 1 : pos + 1)).center() - QPoint(0, floatLabel->height() /2));
-    ani->setEasingCurve(m_aniCurveType);
-    ani->setDuration(m_aniDuringTime);
-
-    connect(ani, &QPropertyAnimation::finished, floatLabel, &QLabel::deleteLater);
-    if (isLastAni) {
-        m_aniRunning = true;
-
-        TrayModel *model = qobject_cast<TrayModel *>(this->model());
-        if (!model)
-            return;
-
-        connect(ani, &QPropertyAnimation::finished, this, &TrayGridView::dropSwap);
-        connect(ani, &QPropertyAnimation::valueChanged, m_aniStartTime, &QTimer::stop);
-    } else {
-    }
-
-    ani->start(QPropertyAnimation::DeleteWhenStopped);
-}
-
 void TrayGridView::mousePressEvent(QMouseEvent *e)
 {
     if (e->buttons() == Qt::LeftButton && !m_aniRunning)
@@ -314,7 +349,7 @@ void TrayGridView::mouseReleaseEvent(QMouseEvent *e)
 
 void TrayGridView::dragEnterEvent(QDragEnterEvent *e)
 {
-    const QModelIndex index = indexAt(e->pos());
+    const QModelIndex index = getIndexFromPos(e->pos());
 
     if (model()->canDropMimeData(e->mimeData(), e->dropAction(), index.row(),
                                  index.column(), index))
@@ -338,7 +373,7 @@ void TrayGridView::dragMoveEvent(QDragMoveEvent *e)
     if (m_aniRunning)
         return;
 
-    QModelIndex index = indexAt(e->pos());
+    QModelIndex index = getIndexFromPos(e->pos());
     if (!model()->canDropMimeData(e->mimeData(), e->dropAction(), index.row(),
                                  index.column(), index))
         return;
@@ -356,41 +391,44 @@ void TrayGridView::dragMoveEvent(QDragMoveEvent *e)
         m_aniStartTime->start();
 }
 
+/**
+ * @brief TrayGridView::getIndexFromPos 根据坐标计算所在的索引
+ * 所有单元格大小相同(setUniformItemSizes)，直接由第一个单元格的位置和单元格大小计算行列，
+ * 拖动过程中每次移动鼠标都会调用，不再遍历每个索引的位置
+ * 位于两个图标间隙中的点认为属于后一个图标，位于第一个图标之前的点认为属于第一个图标
+ */
 const QModelIndex TrayGridView::getIndexFromPos(QPoint currentPoint) const
 {
-    QModelIndex index = indexAt(currentPoint);
-    if (index.isValid())
-        return index;
-
-    if (model()->rowCount() == 0)
-        return index;
-
-    // 如果在第一个之前，则认为拖到了第一个的位置
-    QRect indexRect0 = visualRect(model()->index(0, 0));
-    if (currentPoint.x() < indexRect0.x() || currentPoint.y() < indexRect0.y())
-        return model()->index(0, 0);
-
-    // 如果从指定的位置没有找到索引，则依次从每个index中查找，先横向查找
-    for (int i = 1; i < model()->rowCount(); i++) {
-        QModelIndex lastIndex = model()->index(i - 1, 0);
-        QModelIndex currentIndex = model()->index(i, 0);
-        QRect lastIndexRect = visualRect(lastIndex);
-        QRect indexRect = visualRect(currentIndex);
-        if (lastIndexRect.x() + lastIndexRect.width() <= currentPoint.x()
-                && indexRect.x() >= currentPoint.x())
-            return currentIndex;
+    const int count = model()->rowCount();
+    if (count == 0)
+        return QModelIndex();
+
+    const QRect firstRect = rectForIndex(model()->index(0, 0));
+    if (firstRect.isEmpty())
+        return QModelIndex();
+
+    const bool leftToRight = (flow() == QListView::LeftToRight);
+    // 沿排列方向和换行方向上相邻两个单元格的距离
+    const int flowStep = (leftToRight ? firstRect.width() : firstRect.height()) + spacing();
+    const int wrapStep = (leftToRight ? firstRect.height() : firstRect.width()) + spacing();
+    const int flowOrigin = (leftToRight ? firstRect.x() : firstRect.y()) - spacing();
+    const int wrapOrigin = (leftToRight ? firstRect.y() : firstRect.x()) - spacing();
+    const int flowPos = (leftToRight ? currentPoint.x() : currentPoint.y()) - flowOrigin;
+    const int wrapPos = (leftToRight ? currentPoint.y() : currentPoint.x()) - wrapOrigin;
+
+    int lineCount = count;
+    if (isWrapping()) {
+        const int viewLength = leftToRight ? viewport()->width() : viewport()->height();
+        lineCount = qMax(1, (viewLength - flowOrigin) / flowStep);
     }
-    // 如果鼠标位置刚好在上下两个索引中间
-    for (int i = 0; i < model()->rowCount(); i++) {
-        QModelIndex currentIndex = model()->index(i, 0);
-        QRect indexRect = visualRect(currentIndex);
 
-        if (currentPoint.y() >= indexRect.y() - spacing() && currentPoint.y() < indexRect.y()
-                && currentPoint.x() >= indexRect.x() - spacing() && currentPoint.x() < indexRect.x())
-            return currentIndex;
-    }
+    const int column = qBound(0, flowPos / flowStep, lineCount - 1);
+    const int line = qMax(0, wrapPos / wrapStep);
+    const int row = line * lineCount + column;
+    if (row >= count)
+        return QModelIndex();
 
-    return QModelIndex();
+    return model()->index(row, 0);
 }
 
 bool TrayGridView::mouseInDock()
@@ -456,12 +494,8 @@ void TrayGridView::handleDropEvent(QDropEvent *e)
     }
     // 拖拽行为后会自动关闭Edtor，导致托盘图标消失
     QMetaObject::invokeMethod(this, [&] {
-        for (int i = 0; i < model()->rowCount(); i++) {
-            QModelIndex index = model()->index(i, 0);
-            if(!isPersistentEditorOpen(index)) {
-                openPersistentEditor(index);
-            }
-        }
+        for (int i = 0; i < model()->rowCount(); i++)
+            openEditor(model()->index(i, 0));
     }, Qt::QueuedConnection);
 }
 
@@ -476,10 +510,8 @@ void TrayGridView::onUpdateEditorView()
     // 通过openPersistentEditor新建的QWidget给删除，引起bug，因此，在所有的都closePersistentEditor后，异步来调用
     // openPersistentEditor就不会出现这种问题
     QMetaObject::invokeMethod(this, [&] {
-        for (int i = 0; i < model()->rowCount(); i++) {
-            QModelIndex index = model()->index(i, 0);
-            openPersistentEditor(index);
-        }
+        for (int i = 0; i < model()->rowCount(); i++)
+            openEditor(model()->index(i, 0));
     }, Qt::QueuedConnection);
 }
 
@@ -544,7 +576,7 @@ bool TrayGridView::beginDrag(Qt::DropActions supportedActions)
                 pixLabel->deleteLater();
                 listModel->setDragKey(QString());
                 clearDragModelIndex();
-                QModelIndex dropIndex = indexAt(m_dropPos);
+                QModelIndex dropIndex = getIndexFromPos(m_dropPos);
                 // 拖转完成后，将拖动的图标插入到新的位置
                 //listModel->moveToIndex(winInfo, dropIndex.row());
                 listModel->dropSwap(dropIndex.row());
@@ -635,6 +667,12 @@ void TrayGridView::initUi()
     m_aniStartTime->setSingleShot(true);
 
     connect(m_aniStartTime, &QTimer::timeout, this, &TrayGridView::moveAnimation);
+
+    connect(m_reorderAnimator, &TrayReorderAnimator::frameChanged, this, [ this ] {
+        updateEditorGeometries();
+        viewport()->update();
+    });
+    connect(m_reorderAnimator, &TrayReorderAnimator::finished, this, &TrayGridView::dropSwap);
 }
 
 void TrayGridView::dropEvent(QDropEvent *e)
@@ -10,10 +10,12 @@
 
 #include <DListView>
 
-#include <QPropertyAnimation>
+#include <QEasingCurve>
 
 DWIDGET_USE_NAMESPACE
 
+class TrayReorderAnimator;
+
 class TrayGridView : public DListView
 {
     Q_OBJECT
@@ -30,9 +32,15 @@ public:
     void setAnimationProperty(const QEasingCurve::Type easing, const int duringTime = 250);
     const QModelIndex modelIndex(const int index) const;
     const QRect indexRect(const QModelIndex &index) const;
+    QPoint reorderOffset(const QModelIndex &index) const;
 
     void handleDropEvent(QDropEvent *e);
 
+    void setLazyEditor(bool lazy);
+    void openEditor(const QModelIndex &index);
+    void activateEditors();
+    void deactivateEditors();
+
 public Q_SLOTS:
     void onUpdateEditorView();
 
@@ -46,6 +54,7 @@ private Q_SLOTS:
     void clearDragModelIndex();
     void dropSwap();
     void moveAnimation();
+    void releaseEditors();
 
 protected:
     void mousePressEvent(QMouseEvent *e) Q_DECL_OVERRIDE;
@@ -62,7 +71,6 @@ private:
     explicit TrayGridView(QWidget *parent = Q_NULLPTR);
 
     void initUi();
-    void createAnimation(const int pos, const bool moveNext, const bool isLastAni);
     const QModelIndex getIndexFromPos(QPoint currentPoint) const;
     bool mouseInDock();
 
@@ -76,9 +84,14 @@ private:
     int m_dragDistance;
 
     QTimer *m_aniStartTime;
+    TrayReorderAnimator *m_reorderAnimator;
     bool m_pressed;
     bool m_aniRunning;
     Dock::Position m_positon;
+
+    bool m_lazyEditor;          // 为true时只有在视图显示期间才创建托盘图标控件
+    bool m_editorActive;
+    QTimer *m_releaseTimer;
 };
 
 #endif // GRIDVIEW_H
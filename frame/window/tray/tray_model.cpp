@@ -12,6 +12,7 @@
 #include "pluginsiteminterface.h"
 #include "docksettings.h"
 #include "platformutils.h"
+#include "widgets/xembedtrayitemwidget.h"
 
 #include <QMimeData>
 #include <QIcon>
@@ -366,6 +367,8 @@ void TrayModel::onXEmbedTrayAdded(quint32 winId)
 
 void TrayModel::onXEmbedTrayRemoved(quint32 winId)
 {
+    XEmbedTrayItemWidget::releaseContainer(winId);
+
     for (auto info : m_winInfos) {
         if (info.winId == winId)  {
             int index = m_winInfos.indexOf(info);
@@ -603,7 +606,7 @@ void TrayModel::onIndicatorFounded(const QString &indicatorName)
 
     IndicatorPlugin *indicatorTray = nullptr;
     if (!m_indicatorMap.keys().contains(indicatorName)) {
-        indicatorTray = new IndicatorPlugin(indicatorName, this);
+        indicatorTray = new IndicatorPlugin(indicatorName, m_monitor->indicatorConfig(indicatorName), this);
         m_indicatorMap[indicatorName] = indicatorTray;
     } else {
         indicatorTray = m_indicatorMap[itemKey];
@@ -7,6 +7,11 @@
 #include "quicksettingcontroller.h"
 #include "pluginsiteminterface.h"
 #include "utils.h"
+#include "indicatorplugin.h"
+
+#include <QDir>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 TrayMonitor::TrayMonitor(QObject *parent)
     : QObject(parent)
@@ -43,6 +48,8 @@ TrayMonitor::TrayMonitor(QObject *parent)
     });
 
     //-------------------------------Tray Indicator---------------------------------------------//
+    // 配置文件的解析不依赖插件，先在后台线程中进行，与插件加载并行
+    indicatorConfigsFuture();
     // Indicators服务是集成在插件中的，因此需要在所有的插件加载完成后再加载Indicators服务
     connect(quickController, &QuickSettingController::pluginLoaderFinished, this, [ this ] {
         startLoadIndicators();
@@ -77,6 +84,11 @@ QList<PluginsItemInterface *> TrayMonitor::systemTrays() const
     return m_systemTrays;
 }
 
+QJsonObject TrayMonitor::indicatorConfig(const QString &indicatorName) const
+{
+    return m_indicatorConfigs.value(indicatorName);
+}
+
 void TrayMonitor::onTrayIconsChanged()
 {
     QList<quint32> wids = m_trayInter->trayIcons();
@@ -132,11 +144,42 @@ void TrayMonitor::onSniItemsChanged()
 
 void TrayMonitor::startLoadIndicators()
 {
-    QDir indicatorConfDir("/etc/dde-dock/indicator");
+    QFuture<QMap<QString, QJsonObject>> future = indicatorConfigsFuture();
+    if (future.isFinished()) {
+        loadIndicators(future.result());
+        return;
+    }
+
+    QFutureWatcher<QMap<QString, QJsonObject>> *watcher = new QFutureWatcher<QMap<QString, QJsonObject>>(this);
+    connect(watcher, &QFutureWatcher<QMap<QString, QJsonObject>>::finished, this, [ this, watcher ] {
+        loadIndicators(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
 
-    for (const QFileInfo &fileInfo : indicatorConfDir.entryInfoList({"*.json"}, QDir::Files | QDir::NoDotAndDotDot)) {
-        const QString &indicatorName = fileInfo.baseName();
-        m_indicatorNames << indicatorName;
-        Q_EMIT indicatorFounded(indicatorName);
+QFuture<QMap<QString, QJsonObject>> TrayMonitor::indicatorConfigsFuture()
+{
+    // 任务栏和托盘区域各有一个TrayMonitor，配置文件只需要解析一次
+    static QFuture<QMap<QString, QJsonObject>> future = QtConcurrent::run([] {
+        QMap<QString, QJsonObject> configs;
+        QDir indicatorConfDir("/etc/dde-dock/indicator");
+        for (const QFileInfo &fileInfo : indicatorConfDir.entryInfoList({"*.json"}, QDir::Files | QDir::NoDotAndDotDot)) {
+            const QString &indicatorName = fileInfo.baseName();
+            configs.insert(indicatorName, IndicatorPlugin::readConfig(indicatorName));
+        }
+
+        return configs;
+    });
+
+    return future;
+}
+
+void TrayMonitor::loadIndicators(const QMap<QString, QJsonObject> &configs)
+{
+    m_indicatorConfigs = configs;
+    for (auto it = configs.constBegin(); it != configs.constEnd(); ++it) {
+        m_indicatorNames << it.key();
+        Q_EMIT indicatorFounded(it.key());
     }
 }
@@ -7,6 +7,9 @@
 #define TRAYMONITOR_H
 
 #include <QObject>
+#include <QMap>
+#include <QJsonObject>
+#include <QFuture>
 
 #include "dbustraymanager.h"
 #include "statusnotifierwatcher_interface.h"
@@ -26,6 +29,7 @@ public:
     QStringList sniServices() const;
     QStringList indicatorNames() const;
     QList<PluginsItemInterface *> systemTrays() const;
+    QJsonObject indicatorConfig(const QString &indicatorName) const;
 
 Q_SIGNALS:
     void requestUpdateIcon(quint32);
@@ -46,6 +50,10 @@ public Q_SLOTS:
 
     void startLoadIndicators();
 
+private:
+    static QFuture<QMap<QString, QJsonObject>> indicatorConfigsFuture();
+    void loadIndicators(const QMap<QString, QJsonObject> &configs);
+
 private:
     DBusTrayManager *m_trayInter;
     StatusNotifierWatcher *m_sniWatcher;
@@ -53,6 +61,7 @@ private:
     QList<quint32> m_trayWids;
     QStringList m_sniServices;
     QStringList m_indicatorNames;
+    QMap<QString, QJsonObject> m_indicatorConfigs;
     QList<PluginsItemInterface *> m_systemTrays;
 };
 
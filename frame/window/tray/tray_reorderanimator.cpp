@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "tray_reorderanimator.h"
+
+#include <QVariantAnimation>
+
+TrayReorderAnimator::TrayReorderAnimator(QObject *parent)
+    : QObject(parent)
+    , m_clock(new QVariantAnimation(this))
+    , m_progress(0)
+{
+    m_clock->setStartValue(0.0);
+    m_clock->setEndValue(1.0);
+    m_clock->setDuration(250);
+
+    connect(m_clock, &QVariantAnimation::valueChanged, this, [ this ](const QVariant &value) {
+        m_progress = value.toReal();
+        Q_EMIT frameChanged();
+    });
+    connect(m_clock, &QVariantAnimation::finished, this, &TrayReorderAnimator::finished);
+}
+
+void TrayReorderAnimator::setEasingCurve(const QEasingCurve::Type easing)
+{
+    m_clock->setEasingCurve(easing);
+}
+
+void TrayReorderAnimator::setDuration(int msecs)
+{
+    m_clock->setDuration(msecs);
+}
+
+void TrayReorderAnimator::start(const QHash<int, QPoint> &offsets)
+{
+    m_clock->stop();
+    m_offsets = offsets;
+    m_progress = 0;
+    m_clock->start();
+}
+
+void TrayReorderAnimator::clear()
+{
+    m_clock->stop();
+    m_offsets.clear();
+    m_progress = 0;
+    Q_EMIT frameChanged();
+}
+
+bool TrayReorderAnimator::isRunning() const
+{
+    return m_clock->state() == QAbstractAnimation::Running;
+}
+
+QPoint TrayReorderAnimator::offset(int row) const
+{
+    auto it = m_offsets.constFind(row);
+    if (it == m_offsets.constEnd())
+        return QPoint();
+
+    return it.value() * m_progress;
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef TRAYREORDERANIMATOR_H
+#define TRAYREORDERANIMATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QPoint>
+#include <QEasingCurve>
+
+class QVariantAnimation;
+
+/**
+ * @brief The TrayReorderAnimator class
+ * 托盘拖动排序时的位移动画。整个视图共用一个动画时钟，每一帧只计算各行当前的偏移量，
+ * 由TrayDelegate在布局控件和绘制背景时叠加该偏移，不再为每次移位创建QLabel和QPropertyAnimation
+ */
+class TrayReorderAnimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TrayReorderAnimator(QObject *parent = nullptr);
+
+    void setEasingCurve(const QEasingCurve::Type easing);
+    void setDuration(int msecs);
+
+    // offsets: 行号 -> 动画结束时相对于原位置的偏移
+    void start(const QHash<int, QPoint> &offsets);
+    void clear();
+
+    bool isRunning() const;
+    QPoint offset(int row) const;
+
+Q_SIGNALS:
+    void frameChanged();
+    void finished();
+
+private:
+    QVariantAnimation *m_clock;
+    QHash<int, QPoint> m_offsets;
+    qreal m_progress;
+};
+
+#endif // TRAYREORDERANIMATOR_H
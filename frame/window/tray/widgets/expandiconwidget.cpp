@@ -140,6 +140,8 @@ TrayGridWidget *ExpandIconWidget::popupTrayView()
     trayView->setItemDelegate(trayDelegate);
     trayView->setSpacing(ITEM_SPACING);
     trayView->setDragDistance(2);
+    // 弹出托盘默认是折叠的，托盘图标控件在展开时才创建
+    trayView->setLazyEditor(true);
 
     QVBoxLayout *layout = new QVBoxLayout(gridParentView);
     layout->setContentsMargins(ITEM_SPACING, ITEM_SPACING, ITEM_SPACING, ITEM_SPACING);
@@ -164,7 +166,7 @@ TrayGridWidget *ExpandIconWidget::popupTrayView()
         trayView->model()->removeRow(index.row(),index.parent());
     });
     connect(trayModel, &TrayModel::requestOpenEditor, trayView, [ trayView ](const QModelIndex &index) {
-        trayView->openPersistentEditor(index);
+        trayView->openEditor(index);
     });
 
     QMetaObject::invokeMethod(gridParentView, rowCountChanged, Qt::QueuedConnection);
@@ -248,6 +250,7 @@ void TrayGridWidget::showEvent(QShowEvent *event)
     TaskManager::instance()->setTrayGridWidgetVisible(true);
     TaskManager::instance()->updateHideState(true);
     m_regionInter->registerRegion();
+    m_trayGridView->activateEditors();
     DBlurEffectWidget::showEvent(event);
 }
 
@@ -256,6 +259,7 @@ void TrayGridWidget::hideEvent(QHideEvent *event)
     TaskManager::instance()->setTrayGridWidgetVisible(false);
     TaskManager::instance()->updateHideState(true);
     m_regionInter->unregisterRegion();
+    m_trayGridView->deactivateEditors();
     // 在当前托盘区域隐藏后，需要设置任务栏区域的展开按钮的托盘为隐藏状态
     TrayModel::getDockModel()->updateOpenExpand(false);
     DBlurEffectWidget::hideEvent(event);
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "indicatorplugin.h"
+#include "indicatorsignalrouter.h"
 
 #include <QLabel>
 #include <QDBusConnection>
@@ -32,7 +33,7 @@ public:
     template<typename Func>
     void featData(const QString &key,
                   const QJsonObject &data,
-                  const char *propertyChangedSlot,
+                  void (IndicatorPlugin::*propertyChangedSlot)(const QVariant &),
                   Func const &callback)
     {
         Q_Q(IndicatorPlugin);
@@ -54,60 +55,19 @@ public:
 
         if (dataConfig.contains("dbus_properties")) {
             auto propertyName = dataConfig.value("dbus_properties").toString();
-            auto propertyNameCStr = propertyName.toStdString();
-            propertyInterfaceNames.insert(key, dbusInterface);
-            propertyNames.insert(key, QString::fromStdString(propertyNameCStr));
-            QDBusConnection::sessionBus().connect(dbusService,
-                                                  dbusPath,
-                                                  "org.freedesktop.DBus.Properties",
-                                                  "PropertiesChanged",
-                                                  "sa{sv}as",
-                                                  q,
-                                                  propertyChangedSlot);
-
-            // FIXME(sbw): hack for qt dbus property changed signal.
-            // see: https://bugreports.qt.io/browse/QTBUG-48008
-            QDBusConnection::sessionBus().connect(dbusService,
-                                                  dbusPath,
-                                                  dbusInterface,
-                                                  QString("%1Changed").arg(propertyName),
-                                                  "s",
-                                                  q,
-                                                  propertyChangedSlot);
-
-            callback(interface.property(propertyNameCStr.c_str()));
-        }
-    }
-
-    template<typename Func>
-    void propertyChanged(const QString &key, const QDBusMessage &msg, Func const &callback)
-    {
-        QList<QVariant> arguments = msg.arguments();
-        if (1 == arguments.count())
-        {
-            const QString &v = msg.arguments().at(0).toString();
-            callback(v);
-            return;
-        } else if (3 != arguments.count()) {
-            qDebug() << "arguments count must be 3";
-            return;
-        }
+            // 属性变化信号统一由IndicatorSignalRouter分发，不再每个indicator单独注册匹配规则
+            IndicatorSignalRouter::instance()->subscribe(isSystemBus, dbusService, dbusPath, dbusInterface, propertyName, q,
+                                                         [ q, propertyChangedSlot ](const QVariant &value) {
+                (q->*propertyChangedSlot)(value);
+            });
 
-        QString interfaceName = msg.arguments().at(0).toString();
-        if (interfaceName != propertyInterfaceNames.value(key)) {
-            qDebug() << "interfaceName mismatch" << interfaceName << propertyInterfaceNames.value(key) << key;
-            return;
-        }
-        QVariantMap changedProps = qdbus_cast<QVariantMap>(arguments.at(1).value<QDBusArgument>());
-        if (changedProps.contains(propertyNames.value(key))) {
-            callback(changedProps.value(propertyNames.value(key)));
+            callback(interface.property(propertyName.toStdString().c_str()));
         }
     }
 
     IndicatorTrayItem*    indicatorTrayWidget = Q_NULLPTR;
     QString                 indicatorName;
-    QMap<QString, QString>  propertyNames;
-    QMap<QString, QString>  propertyInterfaceNames;
+    QJsonObject             config;
 
     IndicatorPlugin *q_ptr;
     Q_DECLARE_PUBLIC(IndicatorPlugin)
@@ -134,25 +94,19 @@ void IndicatorPluginPrivate::initDBus(const QString &indicatorName)
 {
     Q_Q(IndicatorPlugin);
 
-    QString filepath = QString("/etc/dde-dock/indicator/%1.json").arg(indicatorName);
-    QFile confFile(filepath);
-    if (!confFile.open(QIODevice::ReadOnly)) {
-        qCritical() << "read indicator config Error";
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(confFile.readAll());
-    confFile.close();
-    auto config = doc.object();
+    // 配置文件通常已由TrayMonitor在插件加载期间并行解析好，这里只在未提供时自行读取
+    if (config.isEmpty())
+        config = IndicatorPlugin::readConfig(indicatorName);
 
     auto delay = config.value("delay").toInt(0);
 
     qDebug() << "delay load" << delay << indicatorName << q;
 
-    QTimer::singleShot(delay, [ = ]() {
+    QTimer::singleShot(delay, q, [ = ]() {
         auto data = config.value("data").toObject();
 
         if (data.contains("text")) {
-            featData("text", data, SLOT(textPropertyChanged(QDBusMessage)), [ = ](QVariant v) {
+            featData("text", data, &IndicatorPlugin::textPropertyChanged, [ = ](QVariant v) {
                 if (v.toString().isEmpty()) {
                     q->m_isLoaded = false;
                     Q_EMIT q->removed();
@@ -166,7 +120,7 @@ void IndicatorPluginPrivate::initDBus(const QString &indicatorName)
         }
 
         if (data.contains("icon")) {
-            featData("icon", data, SLOT(iconPropertyChanged(QDBusMessage)), [ = ](QVariant v) {
+            featData("icon", data, &IndicatorPlugin::iconPropertyChanged, [ = ](QVariant v) {
                 if (v.toByteArray().isEmpty()) {
                     q->m_isLoaded = false;
                     Q_EMIT q->removed();
@@ -201,6 +155,11 @@ void IndicatorPluginPrivate::initDBus(const QString &indicatorName)
 }
 
 IndicatorPlugin::IndicatorPlugin(const QString &indicatorName, QObject *parent)
+    : IndicatorPlugin(indicatorName, QJsonObject(), parent)
+{
+}
+
+IndicatorPlugin::IndicatorPlugin(const QString &indicatorName, const QJsonObject &config, QObject *parent)
     : QObject(parent)
     , d_ptr(new IndicatorPluginPrivate(this))
     , m_isLoaded(false)
@@ -208,12 +167,27 @@ IndicatorPlugin::IndicatorPlugin(const QString &indicatorName, QObject *parent)
     Q_D(IndicatorPlugin);
 
     d->indicatorName = indicatorName;
+    d->config = config;
     d->init();
 }
 
 IndicatorPlugin::~IndicatorPlugin()
 {
+    IndicatorSignalRouter::instance()->unsubscribe(this);
+}
 
+QJsonObject IndicatorPlugin::readConfig(const QString &indicatorName)
+{
+    QString filepath = QString("/etc/dde-dock/indicator/%1.json").arg(indicatorName);
+    QFile confFile(filepath);
+    if (!confFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "read indicator config Error";
+        return QJsonObject();
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(confFile.readAll());
+    confFile.close();
+    return doc.object();
 }
 
 IndicatorTrayItem *IndicatorPlugin::widget()
@@ -239,42 +213,38 @@ bool IndicatorPlugin::isLoaded()
     return m_isLoaded;
 }
 
-void IndicatorPlugin::textPropertyChanged(const QDBusMessage &message)
+void IndicatorPlugin::textPropertyChanged(const QVariant &value)
 {
     Q_D(IndicatorPlugin);
 
-    d->propertyChanged("text", message, [ = ] (const QVariant &value) {
-        if (value.toString().isEmpty()) {
-            m_isLoaded = false;
-            Q_EMIT removed();
-            return;
-        }
+    if (value.toString().isEmpty()) {
+        m_isLoaded = false;
+        Q_EMIT removed();
+        return;
+    }
 
-        if (!d->indicatorTrayWidget) {
-            d->init();
-        }
+    if (!d->indicatorTrayWidget) {
+        d->init();
+    }
 
-        d->indicatorTrayWidget->setText(value.toByteArray());
-        Q_EMIT delayLoaded();
-    });
+    d->indicatorTrayWidget->setText(value.toByteArray());
+    Q_EMIT delayLoaded();
 }
 
-void IndicatorPlugin::iconPropertyChanged(const QDBusMessage &message)
+void IndicatorPlugin::iconPropertyChanged(const QVariant &value)
 {
     Q_D(IndicatorPlugin);
 
-    d->propertyChanged("icon", message, [ = ] (const QVariant &value) {
-        if (value.toByteArray().isEmpty()) {
-            m_isLoaded = false;
-            Q_EMIT removed();
-            return;
-        }
+    if (value.toByteArray().isEmpty()) {
+        m_isLoaded = false;
+        Q_EMIT removed();
+        return;
+    }
 
-        if (!d->indicatorTrayWidget) {
-            d->init();
-        }
+    if (!d->indicatorTrayWidget) {
+        d->init();
+    }
 
-        d->indicatorTrayWidget->setPixmapData(value.toByteArray());
-        Q_EMIT delayLoaded();
-    });
+    d->indicatorTrayWidget->setPixmapData(value.toByteArray());
+    Q_EMIT delayLoaded();
 }
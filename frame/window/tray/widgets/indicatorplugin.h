@@ -9,6 +9,7 @@
 
 #include <QObject>
 #include <QScopedPointer>
+#include <QJsonObject>
 
 class IndicatorPluginPrivate;
 class IndicatorPlugin : public QObject
@@ -16,8 +17,11 @@ class IndicatorPlugin : public QObject
     Q_OBJECT
 public:
     explicit IndicatorPlugin(const QString &indicatorName, QObject *parent = nullptr);
+    IndicatorPlugin(const QString &indicatorName, const QJsonObject &config, QObject *parent = nullptr);
     ~IndicatorPlugin();
 
+    static QJsonObject readConfig(const QString &indicatorName);
+
     IndicatorTrayItem *widget();
 
     void removeWidget();
@@ -29,8 +33,8 @@ signals:
     void removed();
 
 private slots:
-    void textPropertyChanged(const QDBusMessage &message);
-    void iconPropertyChanged(const QDBusMessage &message);
+    void textPropertyChanged(const QVariant &value);
+    void iconPropertyChanged(const QVariant &value);
 
 private:
     QScopedPointer<IndicatorPluginPrivate> d_ptr;
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "indicatorsignalrouter.h"
+
+#include <QDBusArgument>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QDebug>
+
+#define PROPERTIES_INTERFACE "org.freedesktop.DBus.Properties"
+
+IndicatorSignalRouter *IndicatorSignalRouter::instance()
+{
+    static IndicatorSignalRouter *router = new IndicatorSignalRouter;
+    return router;
+}
+
+IndicatorSignalRouter::IndicatorSignalRouter(QObject *parent)
+    : QObject(parent)
+    , m_sessionRoute(new IndicatorBusRoute(QDBusConnection::sessionBus(), this))
+    , m_systemRoute(nullptr)
+{
+}
+
+/**
+ * @brief IndicatorSignalRouter::systemRoute 大部分indicator只在会话总线上，系统总线在需要时才连接
+ */
+IndicatorBusRoute *IndicatorSignalRouter::systemRoute()
+{
+    if (!m_systemRoute)
+        m_systemRoute = new IndicatorBusRoute(QDBusConnection::systemBus(), this);
+
+    return m_systemRoute;
+}
+
+void IndicatorSignalRouter::subscribe(bool systemBus, const QString &service, const QString &path, const QString &interface,
+                                      const QString &property, QObject *context, Callback callback)
+{
+    IndicatorBusRoute *route = systemBus ? systemRoute() : m_sessionRoute;
+    route->subscribe(service, path, interface, property, context, callback);
+}
+
+void IndicatorSignalRouter::unsubscribe(QObject *context)
+{
+    m_sessionRoute->unsubscribe(context);
+    if (m_systemRoute)
+        m_systemRoute->unsubscribe(context);
+}
+
+IndicatorBusRoute::IndicatorBusRoute(const QDBusConnection &bus, QObject *parent)
+    : QObject(parent)
+    , m_bus(bus)
+    , m_serviceWatcher(new QDBusServiceWatcher(this))
+{
+    m_serviceWatcher->setConnection(m_bus);
+    m_serviceWatcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &IndicatorBusRoute::onServiceOwnerChanged);
+}
+
+void IndicatorBusRoute::subscribe(const QString &service, const QString &path, const QString &interface,
+                                  const QString &property, QObject *context, IndicatorSignalRouter::Callback callback)
+{
+    if (!m_bus.isConnected()) {
+        qWarning() << "indicator bus is not connected:" << m_bus.name();
+        return;
+    }
+
+    if (!m_serviceOwners.contains(service)) {
+        QString owner;
+        if (service.startsWith(':')) {
+            owner = service;
+        } else {
+            m_serviceWatcher->addWatchedService(service);
+            owner = m_bus.interface()->serviceOwner(service).value();
+        }
+
+        m_serviceOwners.insert(service, owner);
+        if (!owner.isEmpty() && owner != service)
+            m_ownerServices.insert(owner, service);
+    }
+
+    // 同一个(服务, 路径, 接口)只注册一次匹配规则
+    const QString key = routeKey(service, path, interface);
+    if (!m_routes.contains(key)) {
+        Route route;
+        route.service = service;
+        route.path = path;
+        route.interface = interface;
+        if (!connectRoute(route))
+            qWarning() << "connect indicator property signals failed:" << service << path << interface;
+
+        m_routes.insert(key, route);
+    }
+
+    // indicator被移除后再次初始化时会重复订阅，同一对象的同一属性只保留最新的回调
+    QList<Subscription> &subscriptions = m_routes[key].subscriptions;
+    for (Subscription &subscription : subscriptions) {
+        if (subscription.context == context && subscription.property == property) {
+            subscription.callback = callback;
+            return;
+        }
+    }
+
+    Subscription subscription;
+    subscription.property = property;
+    subscription.context = context;
+    subscription.callback = callback;
+    subscriptions.append(subscription);
+}
+
+void IndicatorBusRoute::unsubscribe(QObject *context)
+{
+    for (auto it = m_routes.begin(); it != m_routes.end();) {
+        QList<Subscription> &subscriptions = it.value().subscriptions;
+        for (int i = subscriptions.size() - 1; i >= 0; --i) {
+            if (subscriptions[i].context.isNull() || subscriptions[i].context == context)
+                subscriptions.removeAt(i);
+        }
+
+        if (subscriptions.isEmpty()) {
+            // 没有订阅者之后从总线上移除匹配规则
+            disconnectRoute(it.value());
+            it = m_routes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void IndicatorBusRoute::onPropertiesChanged(const QDBusMessage &message)
+{
+    const QList<QVariant> &arguments = message.arguments();
+    if (arguments.size() != 3)
+        return;
+
+    const QString &interfaceName = arguments.at(0).toString();
+    const QVariantMap &changedProps = qdbus_cast<QVariantMap>(arguments.at(1).value<QDBusArgument>());
+    dispatch(message, interfaceName, [ & ](Subscription &subscription) {
+        if (changedProps.contains(subscription.property))
+            subscription.callback(changedProps.value(subscription.property));
+    });
+}
+
+void IndicatorBusRoute::onPropertySignal(const QDBusMessage &message)
+{
+    const QList<QVariant> &arguments = message.arguments();
+    if (arguments.size() != 1)
+        return;
+
+    const QString &member = message.member();
+    dispatch(message, message.interface(), [ & ](Subscription &subscription) {
+        if (member == QString("%1Changed").arg(subscription.property))
+            subscription.callback(arguments.at(0));
+    });
+}
+
+void IndicatorBusRoute::onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner)
+{
+    if (!oldOwner.isEmpty())
+        m_ownerServices.remove(oldOwner, service);
+
+    m_serviceOwners.insert(service, newOwner);
+    if (!newOwner.isEmpty())
+        m_ownerServices.insert(newOwner, service);
+}
+
+QString IndicatorBusRoute::routeKey(const QString &service, const QString &path, const QString &interface)
+{
+    return service + '|' + path + '|' + interface;
+}
+
+/**
+ * @brief IndicatorBusRoute::connectRoute 注册限定发送者和路径的匹配规则，
+ * PropertiesChanged再用第一个参数限定接口，总线只转发这个对象的信号
+ */
+bool IndicatorBusRoute::connectRoute(const Route &route)
+{
+    bool ret = m_bus.connect(route.service, route.path, PROPERTIES_INTERFACE, "PropertiesChanged",
+                             QStringList() << route.interface, QString(),
+                             this, SLOT(onPropertiesChanged(QDBusMessage)));
+
+    // FIXME(sbw): hack for qt dbus property changed signal.
+    // see: https://bugreports.qt.io/browse/QTBUG-48008
+    // 部分服务通过"<属性>Changed"信号通知
+    ret &= m_bus.connect(route.service, route.path, route.interface, QString(),
+                         this, SLOT(onPropertySignal(QDBusMessage)));
+    return ret;
+}
+
+void IndicatorBusRoute::disconnectRoute(const Route &route)
+{
+    m_bus.disconnect(route.service, route.path, PROPERTIES_INTERFACE, "PropertiesChanged",
+                     QStringList() << route.interface, QString(),
+                     this, SLOT(onPropertiesChanged(QDBusMessage)));
+    m_bus.disconnect(route.service, route.path, route.interface, QString(),
+                     this, SLOT(onPropertySignal(QDBusMessage)));
+}
+
+void IndicatorBusRoute::dispatch(const QDBusMessage &message, const QString &interface, const std::function<void(Subscription &)> &handler)
+{
+    // 信号的发送者是唯一名，先找到它持有的服务名，再按(服务, 路径, 接口)查找订阅者
+    const QString &sender = message.service();
+    QStringList services = m_ownerServices.values(sender);
+    if (m_serviceOwners.contains(sender))
+        services << sender;
+
+    for (const QString &service : services) {
+        auto it = m_routes.find(routeKey(service, message.path(), interface));
+        if (it == m_routes.end())
+            continue;
+
+        // 回调中可能会取消订阅，因此遍历副本
+        QList<Subscription> subscriptions = it.value().subscriptions;
+        for (Subscription &subscription : subscriptions) {
+            if (subscription.context.isNull())
+                continue;
+
+            handler(subscription);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <QObject>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QHash>
+#include <QMultiHash>
+#include <QPointer>
+
+#include <functional>
+
+class QDBusServiceWatcher;
+class IndicatorBusRoute;
+
+/**
+ * @brief The IndicatorSignalRouter class
+ * 所有indicator共用的属性变化信号分发器。每个(服务, 路径, 接口)只注册一次限定了发送者和路径的匹配规则，
+ * 收到信号后查找订阅者并回调，多个indicator订阅同一个对象时不会重复注册；系统总线在第一次订阅时才连接
+ */
+class IndicatorSignalRouter : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<void(const QVariant &)> Callback;
+
+    static IndicatorSignalRouter *instance();
+
+    void subscribe(bool systemBus, const QString &service, const QString &path, const QString &interface,
+                   const QString &property, QObject *context, Callback callback);
+    void unsubscribe(QObject *context);
+
+private:
+    explicit IndicatorSignalRouter(QObject *parent = nullptr);
+    IndicatorBusRoute *systemRoute();
+
+private:
+    IndicatorBusRoute *m_sessionRoute;
+    IndicatorBusRoute *m_systemRoute;
+};
+
+/**
+ * @brief The IndicatorBusRoute class
+ * 单条总线上的订阅表，由IndicatorSignalRouter持有
+ */
+class IndicatorBusRoute : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IndicatorBusRoute(const QDBusConnection &bus, QObject *parent = nullptr);
+
+    void subscribe(const QString &service, const QString &path, const QString &interface,
+                   const QString &property, QObject *context, IndicatorSignalRouter::Callback callback);
+    void unsubscribe(QObject *context);
+
+private Q_SLOTS:
+    void onPropertiesChanged(const QDBusMessage &message);
+    void onPropertySignal(const QDBusMessage &message);
+    void onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner);
+
+private:
+    struct Subscription {
+        QString property;
+        QPointer<QObject> context;
+        IndicatorSignalRouter::Callback callback;
+    };
+
+    struct Route {
+        QString service;
+        QString path;
+        QString interface;
+        QList<Subscription> subscriptions;
+    };
+
+    static QString routeKey(const QString &service, const QString &path, const QString &interface);
+    bool connectRoute(const Route &route);
+    void disconnectRoute(const Route &route);
+    void dispatch(const QDBusMessage &message, const QString &interface, const std::function<void(Subscription &)> &handler);
+
+private:
+    QDBusConnection m_bus;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QHash<QString, Route> m_routes;                     // (服务, 路径, 接口) -> 订阅者
+    QMultiHash<QString, QString> m_ownerServices;       // 唯一名 -> 服务名
+    QHash<QString, QString> m_serviceOwners;            // 服务名 -> 唯一名
+};
@@ -6,11 +6,11 @@
 #include "constants.h"
 #include "xembedtrayitemwidget.h"
 #include "platformutils.h"
+#include "xcb_connection.h"
 //#include "utils.h"
 
 #include <QWindow>
 #include <QPainter>
-#include <QX11Info>
 #include <QDebug>
 #include <QMouseEvent>
 #include <QProcess>
@@ -32,6 +32,9 @@
 #define WINE_WINDOW_PROP_NAME "__wine_prefix"
 #define IS_WINE_WINDOW_BY_WM_CLASS "explorer.exe"
 
+// 每个请求按托盘计数一次
+#define TRAY_REQUEST(...) XcbConnection::instance()->call(XcbConnection::Tray, __VA_ARGS__)
+
 static const qreal iconSize = PLUGIN_ICON_MAX_SIZE;
 
 const bool IS_WAYLAND_DISPLAY = !qgetenv("WAYLAND_DISPLAY").isEmpty();
@@ -44,6 +47,15 @@ const bool IS_WAYLAND_DISPLAY = !qgetenv("WAYLAND_DISPLAY").isEmpty();
 // NOTE: the first suffix will be omit when construct the key of tray widget.
 static QMap<QString, QMap<quint32, int>> AppWinidSuffixMap;
 
+// 嵌入托盘窗口的容器窗口，key为托盘窗口id。
+// 弹出区域的托盘控件隐藏一段时间后会被释放并在下次显示时重新创建，容器窗口保留给新的控件继续使用，
+// 托盘窗口被注销时才销毁(releaseContainer)
+struct EmbedContainer {
+    WId wid;
+    QWindow *window;
+};
+static QMap<WId, EmbedContainer> EmbedContainerMap;
+
 //using namespace Utils;
 
 const QPoint rawXPosition(const QPoint &scaledPos)
@@ -67,13 +79,13 @@ void sni_cleanup_xcb_image(void *data)
     xcb_image_destroy(static_cast<xcb_image_t*>(data));
 }
 
-XEmbedTrayItemWidget::XEmbedTrayItemWidget(quint32 winId, xcb_connection_t *cnn, Display *disp, QWidget *parent)
+XEmbedTrayItemWidget::XEmbedTrayItemWidget(quint32 winId, QWidget *parent)
     : BaseTrayWidget(parent)
     , m_windowId(winId)
+    , m_containerWid(0)
+    , m_containerWindow(nullptr)
     , m_appName(PlatformUtils::getAppNameForWindow(winId))
     , m_valid(true)
-    , m_xcbCnn(cnn)
-    , m_display(disp)
 {
     wrapWindow();
 
@@ -107,11 +119,11 @@ void XEmbedTrayItemWidget::showEvent(QShowEvent *e)
 {
     QWidget::showEvent(e);
 
-    xcb_connection_t *connection = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
+    xcb_connection_t *connection = XcbConnection::instance()->connection();
     if (connection) {
-        xcb_map_window(connection, m_containerWid);
+        TRAY_REQUEST(xcb_map_window, connection, m_containerWid);
 
-        xcb_reparent_window(connection, m_windowId, m_containerWid, 0, 0);
+        TRAY_REQUEST(xcb_reparent_window, connection, m_windowId, m_containerWid, 0, 0);
     }
 
     m_updateTimer->start();
@@ -157,16 +169,16 @@ void XEmbedTrayItemWidget::mouseMoveEvent(QMouseEvent *e)
 
 void XEmbedTrayItemWidget::configContainerPosition()
 {
-    auto c = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
+    auto c = XcbConnection::instance()->connection();
     if (!c) {
-        qWarning() << "QX11Info::connection() is " << c;
+        qWarning() << "xcb connection is " << c;
         return;
     }
 
     const QPoint p(rawXPosition(QCursor::pos()));
 
     const uint32_t containerVals[4] = {uint32_t(p.x()), uint32_t(p.y()), 1, 1};
-    xcb_configure_window(c, m_containerWid,
+    TRAY_REQUEST(xcb_configure_window, c, m_containerWid,
                          XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y | XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT,
                          containerVals);
 
@@ -174,26 +186,35 @@ void XEmbedTrayItemWidget::configContainerPosition()
     // move the actual tray window to {0,0}, because tray icons from some wine
     // applications (QQ, TIM, etc...) may somehow moved to very long distance positions.
     const uint32_t trayVals[2] = { 0, 0 };
-    xcb_configure_window(c, m_windowId, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, trayVals);
+    TRAY_REQUEST(xcb_configure_window, c, m_windowId, XCB_CONFIG_WINDOW_X | XCB_CONFIG_WINDOW_Y, trayVals);
 
     xcb_flush(c);
 }
 
 void XEmbedTrayItemWidget::wrapWindow()
 {
-    auto c = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
+    auto c = XcbConnection::instance()->connection();
     if (!c) {
-        qWarning() << "QX11Info::connection() is " << c;
+        qWarning() << "xcb connection is " << c;
         return;
     }
 
-    auto cookie = xcb_get_geometry(c, m_windowId);
-    xcb_get_geometry_reply_t *clientGeom(xcb_get_geometry_reply(c, cookie, Q_NULLPTR));
+    auto cookie = TRAY_REQUEST(xcb_get_geometry, c, m_windowId);
+    XcbReply<xcb_get_geometry_reply_t> clientGeom(xcb_get_geometry_reply(c, cookie, Q_NULLPTR));
     if (!clientGeom) {
         m_valid = false;
         return;
     }
-    free(clientGeom);
+
+    // 之前的控件已经嵌入过该托盘窗口，直接使用原来的容器窗口
+    auto it = EmbedContainerMap.constFind(m_windowId);
+    if (it != EmbedContainerMap.constEnd()) {
+        m_containerWid = it->wid;
+        m_containerWindow = it->window;
+        setWindowOnTop(true);
+        setX11PassMouseEvent(true);
+        return;
+    }
 
     //create a container window
     const auto ratio = devicePixelRatioF();
@@ -203,16 +224,17 @@ void XEmbedTrayItemWidget::wrapWindow()
     auto mask = XCB_CW_BACK_PIXEL | XCB_CW_OVERRIDE_REDIRECT;
     values[0] = ParentRelative; //draw a solid background so the embedded icon doesn't get garbage in it
     values[1] = true; //bypass wM
-    xcb_create_window (c,                          /* connection    */
-                       XCB_COPY_FROM_PARENT,          /* depth         */
-                       m_containerWid,               /* window Id     */
-                       screen->root,                 /* parent window */
-                       0, 0,                         /* x, y          */
-                       iconSize * ratio, iconSize * ratio,     /* width, height */
-                       0,                            /* border_width  */
-                       XCB_WINDOW_CLASS_INPUT_OUTPUT,/* class         */
-                       screen->root_visual,          /* visual        */
-                       mask, values);                /* masks         */
+    TRAY_REQUEST(xcb_create_window,
+                 c,                             /* connection    */
+                 XCB_COPY_FROM_PARENT,          /* depth         */
+                 m_containerWid,                /* window Id     */
+                 screen->root,                  /* parent window */
+                 0, 0,                          /* x, y          */
+                 iconSize * ratio, iconSize * ratio,     /* width, height */
+                 0,                             /* border_width  */
+                 XCB_WINDOW_CLASS_INPUT_OUTPUT, /* class         */
+                 screen->root_visual,           /* visual        */
+                 mask, values);                 /* masks         */
 
     /*
         We need the window to exist and be mapped otherwise the child won't render it's contents
@@ -228,45 +250,44 @@ void XEmbedTrayItemWidget::wrapWindow()
 //    xcb_configure_window(c, m_containerWid, XCB_CONFIG_WINDOW_STACK_MODE, stackBelowData);
 
     if (!IS_WAYLAND_DISPLAY) {
-        QWindow * win = QWindow::fromWinId(m_containerWid);
-        win->setOpacity(0);
+        m_containerWindow = QWindow::fromWinId(m_containerWid);
+        m_containerWindow->setOpacity(0);
     } else {
         const char* opacityName = "_NET_WM_WINDOW_OPACITY\0";
-        xcb_intern_atom_cookie_t opacityCookie = xcb_intern_atom(c, false, strlen(opacityName), opacityName);
-        xcb_intern_atom_reply_t *opacityReply = xcb_intern_atom_reply(c, opacityCookie, 0);
-        xcb_atom_t opacityAtom = opacityReply->atom;
+        xcb_intern_atom_cookie_t opacityCookie = TRAY_REQUEST(xcb_intern_atom, c, false, strlen(opacityName), opacityName);
+        XcbReply<xcb_intern_atom_reply_t> opacityReply(xcb_intern_atom_reply(c, opacityCookie, 0));
+        xcb_atom_t opacityAtom = opacityReply ? opacityReply->atom : XCB_ATOM_NONE;
         quint32 opacity = 10;
-        xcb_change_property(c,
-                           XCB_PROP_MODE_REPLACE,
-                           m_containerWid,
-                           opacityAtom,
-                           XCB_ATOM_CARDINAL,
-                           32,
-                           1,
-                           (uchar *)&opacity);
+        TRAY_REQUEST(xcb_change_property, c,
+                     XCB_PROP_MODE_REPLACE,
+                     m_containerWid,
+                     opacityAtom,
+                     XCB_ATOM_CARDINAL,
+                     32,
+                     1,
+                     (uchar *)&opacity);
     }
 
 //    setX11PassMouseEvent(true);
 
     xcb_flush(c);
 
+    TRAY_REQUEST(xcb_map_window, c, m_containerWid);
 
-    xcb_map_window(c, m_containerWid);
-
-    xcb_reparent_window(c, m_windowId,
-                        m_containerWid,
-                        0, 0);
+    TRAY_REQUEST(xcb_reparent_window, c, m_windowId,
+                 m_containerWid,
+                 0, 0);
 
     /*
      * Render the embedded window offscreen
      */
-    xcb_composite_redirect_window(c, m_windowId, XCB_COMPOSITE_REDIRECT_MANUAL);
+    TRAY_REQUEST(xcb_composite_redirect_window, c, m_windowId, XCB_COMPOSITE_REDIRECT_MANUAL);
 
 
     /* we grab the window, but also make sure it's automatically reparented back
      * to the root window if we should die.
     */
-    xcb_change_save_set(c, XCB_SET_MODE_INSERT, m_windowId);
+    TRAY_REQUEST(xcb_change_save_set, c, XCB_SET_MODE_INSERT, m_windowId);
 
     //tell client we're embedding it
     // xembed_message_send(m_windowId, XEMBED_EMBEDDED_NOTIFY, m_containerWid, 0, 0);
@@ -286,22 +307,54 @@ void XEmbedTrayItemWidget::wrapWindow()
 //    if (clientGeom->width > iconSize || clientGeom->height > iconSize )
     {
         const uint32_t windowMoveConfigVals[2] = { uint32_t(iconSize * ratio), uint32_t(iconSize * ratio) };
-        xcb_configure_window(c, m_windowId,
-                             XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT,
-                             windowMoveConfigVals);
+        TRAY_REQUEST(xcb_configure_window, c, m_windowId,
+                     XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT,
+                     windowMoveConfigVals);
     }
 
     //show the embedded window otherwise nothing happens
-    xcb_map_window(c, m_windowId);
+    TRAY_REQUEST(xcb_map_window, c, m_windowId);
 
 //    xcb_clear_area(c, 0, m_windowId, 0, 0, qMin(clientGeom->width, iconSize), qMin(clientGeom->height, iconSize));
 
     xcb_flush(c);
+    EmbedContainerMap.insert(m_windowId, EmbedContainer{ m_containerWid, m_containerWindow });
 //    setWindowOnTop(false);
     setWindowOnTop(true);
     setX11PassMouseEvent(true);
 }
 
+/**
+ * @brief XEmbedTrayItemWidget::releaseContainer 托盘窗口注销后销毁嵌入它的容器窗口
+ * 托盘窗口仍然存在(例如只是不再作为托盘显示)时先还给根窗口，否则销毁容器窗口时会把它一起销毁
+ */
+void XEmbedTrayItemWidget::releaseContainer(quint32 winId)
+{
+    auto it = EmbedContainerMap.find(winId);
+    if (it == EmbedContainerMap.end())
+        return;
+
+    const EmbedContainer container = it.value();
+    EmbedContainerMap.erase(it);
+    delete container.window;
+
+    auto c = XcbConnection::instance()->connection();
+    if (!c)
+        return;
+
+    xcb_query_tree_cookie_t cookie = TRAY_REQUEST(xcb_query_tree, c, winId);
+    XcbReply<xcb_query_tree_reply_t> tree(xcb_query_tree_reply(c, cookie, nullptr));
+    if (tree && tree->parent == container.wid) {
+        TRAY_REQUEST(xcb_unmap_window, c, winId);
+        TRAY_REQUEST(xcb_composite_unredirect_window, c, winId, XCB_COMPOSITE_REDIRECT_MANUAL);
+        TRAY_REQUEST(xcb_reparent_window, c, winId, tree->root, 0, 0);
+        TRAY_REQUEST(xcb_change_save_set, c, XCB_SET_MODE_DELETE, winId);
+    }
+
+    TRAY_REQUEST(xcb_destroy_window, c, container.wid);
+    xcb_flush(c);
+}
+
 void XEmbedTrayItemWidget::sendHoverEvent()
 {
     if (!rect().contains(mapFromGlobal(QCursor::pos()))) {
@@ -313,9 +366,9 @@ void XEmbedTrayItemWidget::sendHoverEvent()
     configContainerPosition();
     setX11PassMouseEvent(false);
     setWindowOnTop(true);
-    Display *display = IS_WAYLAND_DISPLAY ? m_display : QX11Info::display();
+    Display *display = XcbConnection::instance()->display();
     if (display) {
-        XTestFakeMotionEvent(display, 0, p.x(), p.y(), CurrentTime);
+        TRAY_REQUEST(XTestFakeMotionEvent, display, 0, p.x(), p.y(), CurrentTime);
         XFlush(display);
     }
 
@@ -357,12 +410,15 @@ void XEmbedTrayItemWidget::sendClick(uint8_t mouseButton, int x, int y)
     setX11PassMouseEvent(false);
     setWindowOnTop(true);
 
-    Display *display = IS_WAYLAND_DISPLAY ? m_display : QX11Info::display();
-    XTestFakeMotionEvent(display, 0, p.x(), p.y(), CurrentTime);
+    Display *display = XcbConnection::instance()->display();
+    if (!display)
+        return;
+
+    TRAY_REQUEST(XTestFakeMotionEvent, display, 0, p.x(), p.y(), CurrentTime);
     XFlush(display);
-    XTestFakeButtonEvent(display, mouseButton, true, CurrentTime);
+    TRAY_REQUEST(XTestFakeButtonEvent, display, mouseButton, true, CurrentTime);
     XFlush(display);
-    XTestFakeButtonEvent(display, mouseButton, false, CurrentTime);
+    TRAY_REQUEST(XTestFakeButtonEvent, display, mouseButton, false, CurrentTime);
     XFlush(display);
     QTimer::singleShot(100, this, [=] { setX11PassMouseEvent(true); });
 }
@@ -385,14 +441,14 @@ QPixmap XEmbedTrayItemWidget::icon()
 void XEmbedTrayItemWidget::refershIconImage()
 {
     const auto ratio = devicePixelRatioF();
-    auto c = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
+    auto c = XcbConnection::instance()->connection();
     if (!c) {
-        qWarning() << "QX11Info::connection() is " << c;
+        qWarning() << "xcb connection is " << c;
         return;
     }
 
-    auto cookie = xcb_get_geometry(c, m_windowId);
-    xcb_get_geometry_reply_t *geom(xcb_get_geometry_reply(c, cookie, Q_NULLPTR));
+    auto cookie = TRAY_REQUEST(xcb_get_geometry, c, m_windowId);
+    XcbReply<xcb_get_geometry_reply_t> geom(xcb_get_geometry_reply(c, cookie, Q_NULLPTR));
     if (!geom) {
         return;
     }
@@ -404,18 +460,16 @@ void XEmbedTrayItemWidget::refershIconImage()
     expose.y = 0;
     expose.width = iconSize * ratio;
     expose.height = iconSize * ratio;
-    xcb_send_event_checked(c, false, m_containerWid, XCB_EVENT_MASK_VISIBILITY_CHANGE, reinterpret_cast<char *>(&expose));
+    TRAY_REQUEST(xcb_send_event_checked, c, false, m_containerWid, XCB_EVENT_MASK_VISIBILITY_CHANGE, reinterpret_cast<char *>(&expose));
     xcb_flush(c);
 
-    xcb_image_t *image = xcb_image_get(c, m_windowId, 0, 0, geom->width, geom->height, ~0, XCB_IMAGE_FORMAT_Z_PIXMAP);
+    xcb_image_t *image = TRAY_REQUEST(xcb_image_get, c, m_windowId, 0, 0, geom->width, geom->height, ~0u, XCB_IMAGE_FORMAT_Z_PIXMAP);
     if (!image) {
-        free(geom);
         return;
     }
 
     QImage qimage(image->data, image->width, image->height, image->stride, QImage::Format_ARGB32, sni_cleanup_xcb_image, image);
     if (qimage.isNull()) {
-         free(geom);
         return;
     }
 
@@ -476,10 +530,14 @@ void XEmbedTrayItemWidget::setX11PassMouseEvent(const bool pass)
         return;
     }
 
+    Display *display = XcbConnection::instance()->display();
+    if (!display)
+        return;
+
     if (pass)
     {
-        XShapeCombineRectangles(QX11Info::display(), m_containerWid, ShapeBounding, 0, 0, nullptr, 0, ShapeSet, YXBanded);
-        XShapeCombineRectangles(QX11Info::display(), m_containerWid, ShapeInput, 0, 0, nullptr, 0, ShapeSet, YXBanded);
+        TRAY_REQUEST(XShapeCombineRectangles, display, m_containerWid, ShapeBounding, 0, 0, nullptr, 0, ShapeSet, YXBanded);
+        TRAY_REQUEST(XShapeCombineRectangles, display, m_containerWid, ShapeInput, 0, 0, nullptr, 0, ShapeSet, YXBanded);
     }
     else
     {
@@ -489,34 +547,32 @@ void XEmbedTrayItemWidget::setX11PassMouseEvent(const bool pass)
         rectangle.width = 1;
         rectangle.height = 1;
 
-        XShapeCombineRectangles(QX11Info::display(), m_containerWid, ShapeBounding, 0, 0, &rectangle, 1, ShapeSet, YXBanded);
-        XShapeCombineRectangles(QX11Info::display(), m_containerWid, ShapeInput, 0, 0, &rectangle, 1, ShapeSet, YXBanded);
+        TRAY_REQUEST(XShapeCombineRectangles, display, m_containerWid, ShapeBounding, 0, 0, &rectangle, 1, ShapeSet, YXBanded);
+        TRAY_REQUEST(XShapeCombineRectangles, display, m_containerWid, ShapeInput, 0, 0, &rectangle, 1, ShapeSet, YXBanded);
     }
 
-    XFlush(QX11Info::display());
+    XFlush(display);
 }
 
 void XEmbedTrayItemWidget::setWindowOnTop(const bool top)
 {
-    auto c = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
+    auto c = XcbConnection::instance()->connection();
     if (!c) {
-        qWarning() << "QX11Info::connection() is " << c;
+        qWarning() << "xcb connection is " << c;
         return;
     }
     const uint32_t stackAboveData[] = {top ? XCB_STACK_MODE_ABOVE : XCB_STACK_MODE_BELOW};
-    xcb_configure_window(c, m_containerWid, XCB_CONFIG_WINDOW_STACK_MODE, stackAboveData);
+    TRAY_REQUEST(xcb_configure_window, c, m_containerWid, XCB_CONFIG_WINDOW_STACK_MODE, stackAboveData);
     xcb_flush(c);
 }
 
 bool XEmbedTrayItemWidget::isBadWindow()
 {
-    auto c = IS_WAYLAND_DISPLAY ? m_xcbCnn : QX11Info::connection();
-
-    auto cookie = xcb_get_geometry(c, m_windowId);
-    xcb_get_geometry_reply_t *clientGeom = xcb_get_geometry_reply(c, cookie, Q_NULLPTR);
-    bool result = clientGeom ? false : true;
-
-    free(clientGeom);
+    auto c = XcbConnection::instance()->connection();
+    if (!c)
+        return true;
 
-    return result;
+    auto cookie = TRAY_REQUEST(xcb_get_geometry, c, m_windowId);
+    XcbReply<xcb_get_geometry_reply_t> clientGeom(xcb_get_geometry_reply(c, cookie, Q_NULLPTR));
+    return !clientGeom;
 }
@@ -13,14 +13,14 @@
 
 #include <xcb/xcb.h>
 
-typedef struct _XDisplay Display;
+class QWindow;
 
 class XEmbedTrayItemWidget : public BaseTrayWidget
 {
     Q_OBJECT
 
 public:
-    explicit XEmbedTrayItemWidget(quint32 winId, xcb_connection_t *cnn = nullptr, Display *disp = nullptr, QWidget *parent = nullptr);
+    explicit XEmbedTrayItemWidget(quint32 winId, QWidget *parent = nullptr);
     ~XEmbedTrayItemWidget() override;
 
     QString itemKeyForConfig() override;
@@ -29,6 +29,7 @@ public:
 
     static QString toXEmbedKey(quint32 winId);
     static bool isXEmbedKey(const QString &itemKey);
+    static void releaseContainer(quint32 winId);
     virtual bool isValid() override {return m_valid;}
     QPixmap icon() override;
     bool containsPoint(const QPoint &mouse) override { return false; }
@@ -52,14 +53,13 @@ private:
     bool m_active = false;
     WId m_windowId;
     WId m_containerWid;
+    QWindow *m_containerWindow;
     QImage m_image;
     QString m_appName;
 
     QTimer *m_updateTimer;
     QTimer *m_sendHoverEvent;
     bool m_valid;
-    xcb_connection_t *m_xcbCnn;
-    Display* m_display;
 };
 
 #endif // XEMBEDTRAYWIDGET_H
@@ -12,6 +12,7 @@
 #include "dockitemmanager.h"
 #include "dockscreen.h"
 #include "displaymanager.h"
+#include "geometrytransaction.h"
 
 #include <DWindowManagerHelper>
 #include <DDBusSender>
@@ -42,6 +43,9 @@ WindowManager::WindowManager(MultiScreenWorker *multiScreenWorker, QObject *pare
     , m_position(Dock::Position::Bottom)
     , m_dbusDaemonInterface(QDBusConnection::sessionBus().interface())
     , m_sniWatcher(new StatusNotifierWatcher(SNI_WATCHER_SERVICE, SNI_WATCHER_PATH, QDBusConnection::sessionBus(), this))
+    , m_resizeTransaction(new GeometryTransaction(this))
+    , m_animationController(new DockAnimationController(this))
+    , m_strutManager(new StrutManager(this))
 {
     initSNIHost();
     initConnection();
@@ -147,6 +151,7 @@ void WindowManager::callShow()
 }
 
 /** 调整任务栏的大小，这个接口提供给dbus使用，一般是控制中心来调用
+ * 拖拽过程中合并到每一帧更新一次窗口，拖拽结束时再通知后端
  * @brief WindowManager::resizeDock
  * @param offset
  * @param dragging
@@ -159,7 +164,25 @@ void WindowManager::resizeDock(int offset, bool dragging)
 
     Utils::setIsDraging(dragging);
 
-    int dockSize = qBound(DOCK_MIN_SIZE, offset, DOCK_MAX_SIZE);
+    if (dragging)
+        m_resizeTransaction->begin();
+
+    m_resizeTransaction->update(qBound(DOCK_MIN_SIZE, offset, DOCK_MAX_SIZE));
+
+    if (!dragging)
+        m_resizeTransaction->end();
+}
+
+/**
+ * @brief WindowManager::applyDockSize 按新的大小更新所有的顶层窗口
+ * @param dockSize 任务栏的高度(上下)或宽度(左右)
+ */
+void WindowManager::applyDockSize(int dockSize)
+{
+    QScreen *screen = DIS_INS->screen(DOCKSCREEN_INS->current());
+    if (!screen)
+        return;
+
     for (MainWindowBase *mainWindow : m_topWindows) {
         QRect windowRect = mainWindow->getDockGeometry(screen, m_multiScreenWorker->position(), m_multiScreenWorker->displayMode(), Dock::HideState::Hide);
         QRect newWindowRect;
@@ -201,8 +224,6 @@ void WindowManager::resizeDock(int offset, bool dragging)
         mainWindow->move(newWindowRect.topLeft());
         mainWindow->blockSignals(false);
     }
-
-    m_multiScreenWorker->updateDaemonDockSize(dockSize);
 }
 
 /** 获取任务栏的实际大小，这个接口用于获取任务栏的尺寸返回给dbus接口
@@ -460,6 +481,8 @@ void WindowManager::updateDockGeometry(const QRect &rect)
 
 void WindowManager::initConnection()
 {
+    // 拖拽结束的通知丢失时，事务自动结束，同时结束拖拽状态
+    connect(m_resizeTransaction, &GeometryTransaction::idleTimeout, this, [] { Utils::setIsDraging(false); });
     connect(m_dbusDaemonInterface, &QDBusConnectionInterface::serviceOwnerChanged, this, &WindowManager::onDbusNameOwnerChanged);
 
     connect(m_multiScreenWorker, &MultiScreenWorker::serviceRestart, this, &WindowManager::onServiceRestart);
@@ -472,6 +495,8 @@ void WindowManager::initConnection()
     connect(m_multiScreenWorker, &MultiScreenWorker::requestNotifyWindowManager, this, &WindowManager::onRequestNotifyWindowManager);
     connect(m_multiScreenWorker, &MultiScreenWorker::requestUpdateFrontendGeometry, DockItemManager::instance(), &DockItemManager::requestUpdateDockItem);
     connect(DockItemManager::instance(), &DockItemManager::requestWindowAutoHide, m_multiScreenWorker, &MultiScreenWorker::onAutoHideChanged);
+    // 动画结束之后再更新预留区域
+    connect(m_animationController, &DockAnimationController::runningChanged, m_strutManager, &StrutManager::setHold);
 }
 
 void WindowManager::initSNIHost()
@@ -492,6 +517,12 @@ void WindowManager::initMember()
 {
     m_displayMode = m_multiScreenWorker->displayMode();
     m_position = m_multiScreenWorker->position();
+
+    m_resizeTransaction->setApplyFunction([ this ](int dockSize) { applyDockSize(dockSize); });
+    m_resizeTransaction->setCommitFunction([ this ](int dockSize) { m_multiScreenWorker->updateDaemonDockSize(dockSize); });
+    m_strutManager->setWriter([ this ](const StrutManager::Strut &strut) { return writeStrut(strut); });
+    // 动画的帧间隔和丢帧统计，用于排查动画卡顿
+    m_animationController->registerOnBus(QDBusConnection::sessionBus());
 }
 
 // 更新任务栏的位置和尺寸的信息
@@ -539,8 +570,8 @@ void WindowManager::onPlayAnimation(const QString &screenName, const Dock::Posit
             || !screen)
         return;
 
-    QParallelAnimationGroup *group = createAnimationGroup(act, screenName, pos);
-    if (!group)
+    DockAnimationController::Stage stage;
+    if (!createAnimationStage(act, screenName, pos, stage))
         return;
 
     switch (act) {
@@ -551,7 +582,7 @@ void WindowManager::onPlayAnimation(const QString &screenName, const Dock::Posit
         m_multiScreenWorker->setStates(MultiScreenWorker::HideAnimationStart);
     }
 
-    connect(group, &QParallelAnimationGroup::finished, this, [ = ] {
+    stage.finished = [ this, act, updatePos ] {
         switch (act) {
         case Dock::AniAction::Show:
             showAniFinish();
@@ -568,93 +599,81 @@ void WindowManager::onPlayAnimation(const QString &screenName, const Dock::Posit
             animationFinish(false);
             break;
         }
-    });
+    };
 
-    group->stop();
-    group->start(QVariantAnimation::DeleteWhenStopped);
+    m_animationController->play(act == Dock::AniAction::Show ? "show" : "hide", { stage });
 }
 
 /**创建动画，在时尚模式先同时创建左区域和右区域的动画
- * @brief WindowManager::createAnimationGroup
+ * @brief WindowManager::createAnimationStage
  * @param aniAction  显示动画还是隐藏动画
  * @param screenName 执行动画的屏幕
  * @param position   执行动画的位置（上下左右）
- * @return           要执行的动画组（左右侧区域同时执行的动画组）
+ * @param stage      要执行的动画（左右侧区域同时执行）
+ * @return           是否需要执行动画
  */
-QParallelAnimationGroup *WindowManager::createAnimationGroup(const Dock::AniAction &aniAction, const QString &screenName, const Dock::Position &position) const
+bool WindowManager::createAnimationStage(const Dock::AniAction &aniAction, const QString &screenName, const Dock::Position &position, DockAnimationController::Stage &stage) const
 {
     QScreen *screen = DIS_INS->screen(screenName);
     if (!screen)
-        return nullptr;
+        return false;
 
-    bool stopAnimation = false;
-    QList<QVariantAnimation *> animations;
+    QList<DockAnimationController::Track> tracks;
     for (MainWindowBase *mainWindow : m_topWindows) {
         if (!mainWindow->isVisible())
             continue;
 
-        QVariantAnimation *ani = mainWindow->createAnimation(screen, position, aniAction);
-        if (!ani) {
-            stopAnimation = true;
-            continue;
-        }
-
-        animations << ani;
-    }
-
-    if (stopAnimation) {
-        qDeleteAll(animations.begin(), animations.end());
-        return nullptr;
-    }
+        const DockAnimationController::Track track = mainWindow->createAnimationTrack(screen, position, aniAction);
+        if (!track.isValid())
+            return false;
 
-    QParallelAnimationGroup *aniGroup = new QParallelAnimationGroup;
-    for (QVariantAnimation *ani : animations) {
-        ani->setParent(aniGroup);
-        aniGroup->addAnimation(ani);
+        tracks << track;
     }
 
-    return aniGroup;
+#ifndef DISABLE_SHOW_ANIMATION
+    const bool composite = DWindowManagerHelper::instance()->hasComposite(); // 判断是否开启特效模式
+    stage.duration = composite ? ANIMATIONTIME : 0;
+#else
+    stage.duration = 0;
+#endif
+    stage.tracks = tracks;
+    return true;
 }
 
 void WindowManager::onChangeDockPosition(QString fromScreen, QString toScreen, const Dock::Position &fromPos, const Dock::Position &toPos)
 {
-    QList<QParallelAnimationGroup *> animations;
+    // 所有窗口共用一个动画，切换位置时先结束正在执行的动画，由它的回调清除显示或隐藏的动画状态
+    m_animationController->finish();
+
+    QList<DockAnimationController::Stage> stages;
     // 获取隐藏的动作
-    QParallelAnimationGroup *hideGroup = createAnimationGroup(Dock::AniAction::Hide, fromScreen, fromPos);
-    if (hideGroup) {
-        connect(hideGroup, &QParallelAnimationGroup::finished, this, [ = ] {
+    DockAnimationController::Stage hideStage;
+    if (createAnimationStage(Dock::AniAction::Hide, fromScreen, fromPos, hideStage)) {
+        hideStage.finished = [ this ] {
             // 在隐藏动画结束的时候，开始设置位置信息
             onPositionChanged(m_multiScreenWorker->position());
             DockItem::setDockPosition(m_multiScreenWorker->position());
             qApp->setProperty(PROP_POSITION, QVariant::fromValue(m_multiScreenWorker->position()));
-        });
-        animations << hideGroup;
+        };
+        stages << hideStage;
     }
     // 获取显示的动作
-    QParallelAnimationGroup *showGroup = createAnimationGroup(Dock::AniAction::Show, toScreen, toPos);
-    if (showGroup)
-        animations << showGroup;
+    DockAnimationController::Stage showStage;
+    if (createAnimationStage(Dock::AniAction::Show, toScreen, toPos, showStage))
+        stages << showStage;
 
-    if (animations.size() == 0)
+    if (stages.size() == 0)
         return;
 
     m_multiScreenWorker->setStates(MultiScreenWorker::ChangePositionAnimationStart);
 
-    QSequentialAnimationGroup *group = new QSequentialAnimationGroup;
-    connect(group, &QVariantAnimation::finished, this, [ = ] {
+    m_animationController->play("position", stages, [ this ] {
         // 结束之后需要根据确定需要再隐藏
         showAniFinish();
         m_multiScreenWorker->setStates(MultiScreenWorker::ChangePositionAnimationStart, false);
         animationFinish(true);
         emit panelGeometryChanged();
     });
-
-    for (QParallelAnimationGroup *ani : animations) {
-        ani->setParent(group);
-        group->addAnimation(ani);
-    }
-
-    group->start(QVariantAnimation::DeleteWhenStopped);
 }
 
 void WindowManager::onRequestUpdateFrontendGeometry()
@@ -679,12 +698,52 @@ void WindowManager::onRequestUpdateFrontendGeometry()
     TaskManager::instance()->setFrontendWindowRect(x, y, uint(rect.width()), uint(rect.height()));
 }
 
+/**
+ * @brief WindowManager::onRequestNotifyWindowManager 计算任务栏的预留区域，由StrutManager合并之后写入窗管
+ */
 void WindowManager::onRequestNotifyWindowManager()
 {
-    static QRect lastRect = QRect();
-    static int lastScreenWidth = 0;
-    static int lastScreenHeight = 0;
+    /* 在非主屏或非一直显示状态时，清除任务栏区域，不挤占应用 */
+    if ((!DIS_INS->isCopyMode() && DOCKSCREEN_INS->current() != DOCKSCREEN_INS->primary()) || m_multiScreenWorker->hideMode() != HideMode::KeepShowing) {
+        m_strutManager->clear();
+        return;
+    }
 
+    const QRect dockGeometry = getDockGeometry(true);
+    StrutManager::Strut strut;
+    strut.position = m_position;
+    switch (m_position) {
+    case Position::Top:
+        strut.size = dockGeometry.y() + dockGeometry.height();
+        strut.start = dockGeometry.x();
+        strut.end = dockGeometry.x() + dockGeometry.width();
+        break;
+    case Position::Bottom:
+        strut.size = DIS_INS->screenRawHeight() - dockGeometry.y();
+        strut.start = dockGeometry.x();
+        strut.end = dockGeometry.x() + dockGeometry.width();
+        break;
+    case Position::Left:
+        strut.size = dockGeometry.x() + dockGeometry.width();
+        strut.start = dockGeometry.y();
+        strut.end = dockGeometry.y() + dockGeometry.height();
+        break;
+    case Position::Right:
+        strut.size = DIS_INS->screenRawWidth() - dockGeometry.x();
+        strut.start = dockGeometry.y();
+        strut.end = dockGeometry.y() + dockGeometry.height();
+        break;
+    }
+
+    m_strutManager->setStrut(strut);
+}
+
+/**
+ * @brief WindowManager::writeStrut 把预留区域写入主窗口的属性
+ * @return 是否写入成功
+ */
+bool WindowManager::writeStrut(const StrutManager::Strut &strut)
+{
     // 从列表中查找主窗口
     MainWindowBase *mainWindow = nullptr;
     for (MainWindowBase *window : m_topWindows) {
@@ -696,130 +755,76 @@ void WindowManager::onRequestNotifyWindowManager()
     }
 
     if (!mainWindow)
-        return;
-
-    /* 在非主屏或非一直显示状态时，清除任务栏区域，不挤占应用 */
-    if ((!DIS_INS->isCopyMode() && DOCKSCREEN_INS->current() != DOCKSCREEN_INS->primary()) || m_multiScreenWorker->hideMode() != HideMode::KeepShowing) {
-        lastRect = QRect();
-
-        if (Utils::IS_WAYLAND_DISPLAY) {
-            QList<QVariant> varList;
-            varList.append(0);//dock位置
-            varList.append(0);//dock高度/宽度
-            varList.append(0);//start值
-            varList.append(0);//end值
-
-            // 此处只需获取左侧主窗口部分即可
-            QPlatformWindow *windowHandle = mainWindow->windowHandle()->handle();
-            if (windowHandle)
-                QGuiApplication::platformNativeInterface()->setWindowProperty(windowHandle, "_d_dwayland_dockstrut", varList);
-
-        } else {
-            const auto display = QX11Info::display();
-            if (!display) {
-                qWarning() << "QX11Info::display() is " << display;
-                return;
-            }
-
-            XcbMisc::instance()->clear_strut_partial(xcb_window_t(mainWindow->winId()));
-        }
+        return false;
 
-        return;
-    }
-
-    QRect dockGeometry = getDockGeometry(true);
-    if (lastRect == dockGeometry
-            && lastScreenWidth == DIS_INS->screenRawWidth()
-            && lastScreenHeight == DIS_INS->screenRawHeight()) {
-        return;
-    }
+    qDebug() << "set reserved area:" << strut.position << strut.size << strut.start << strut.end
+             << ", screen width:" << DIS_INS->screenRawWidth() << ", height:" << DIS_INS->screenRawHeight();
 
-    lastRect = dockGeometry;
-    lastScreenWidth = DIS_INS->screenRawWidth();
-    lastScreenHeight = DIS_INS->screenRawHeight();
-    qDebug() << "dock real geometry:" << dockGeometry;
-    qDebug() << "screen width:" << DIS_INS->screenRawWidth() << ", height:" << DIS_INS->screenRawHeight();
-
-    const qreal &ratio = qApp->devicePixelRatio();
     if (Utils::IS_WAYLAND_DISPLAY) {
+        // dock位置, dock高度/宽度, start值, end值
         QList<QVariant> varList = {0, 0, 0, 0};
-        switch (m_position) {
-        case Position::Top:
-            varList[0] = 1;
-            varList[1] = dockGeometry.y() + dockGeometry.height() + WINDOWMARGIN * ratio;
-            varList[2] = dockGeometry.x();
-            varList[3] = dockGeometry.x() + dockGeometry.width();
-            break;
-        case Position::Bottom:
-            varList[0] = 3;
-            varList[1] = DIS_INS->screenRawHeight() - dockGeometry.y() + WINDOWMARGIN * ratio;
-            varList[2] = dockGeometry.x();
-            varList[3] = dockGeometry.x() + dockGeometry.width();
-            break;
-        case Position::Left:
-            varList[0] = 0;
-            varList[1] = dockGeometry.x() + dockGeometry.width() + WINDOWMARGIN * ratio;
-            varList[2] = dockGeometry.y();
-            varList[3] = dockGeometry.y() + dockGeometry.height();
-            break;
-        case Position::Right:
-            varList[0] = 2;
-            varList[1] = DIS_INS->screenRawWidth() - dockGeometry.x() + WINDOWMARGIN * ratio;
-            varList[2] = dockGeometry.y();
-            varList[3] = dockGeometry.y() + dockGeometry.height();
-            break;
+        if (!strut.isNull()) {
+            const qreal &ratio = qApp->devicePixelRatio();
+            switch (strut.position) {
+            case Position::Top:
+                varList[0] = 1;
+                break;
+            case Position::Bottom:
+                varList[0] = 3;
+                break;
+            case Position::Left:
+                varList[0] = 0;
+                break;
+            case Position::Right:
+                varList[0] = 2;
+                break;
+            }
+            varList[1] = strut.size + WINDOWMARGIN * ratio;
+            varList[2] = strut.start;
+            varList[3] = strut.end;
         }
 
+        // 此处只需获取左侧主窗口部分即可
         QPlatformWindow *windowHandle = mainWindow->windowHandle()->handle();
-        if (windowHandle) {
-            QGuiApplication::platformNativeInterface()->setWindowProperty(windowHandle,"_d_dwayland_dockstrut", varList);
-        }
-    } else {
-        XcbMisc::Orientation orientation = XcbMisc::OrientationTop;
-        double strut = 0;
-        double strutStart = 0;
-        double strutEnd = 0;
-
-        switch (m_position) {
-        case Position::Top:
-            orientation = XcbMisc::OrientationTop;
-            strut = dockGeometry.y() + dockGeometry.height();
-            strutStart = dockGeometry.x();
-            strutEnd = qMin(dockGeometry.x() + dockGeometry.width(), dockGeometry.right());
-            break;
-        case Position::Bottom:
-            orientation = XcbMisc::OrientationBottom;
-            strut = DIS_INS->screenRawHeight() - dockGeometry.y();
-            strutStart = dockGeometry.x();
-            strutEnd = qMin(dockGeometry.x() + dockGeometry.width(), dockGeometry.right());
-            break;
-        case Position::Left:
-            orientation = XcbMisc::OrientationLeft;
-            strut = dockGeometry.x() + dockGeometry.width();
-            strutStart = dockGeometry.y();
-            strutEnd = qMin(dockGeometry.y() + dockGeometry.height(), dockGeometry.bottom());
-            break;
-        case Position::Right:
-            orientation = XcbMisc::OrientationRight;
-            strut = DIS_INS->screenRawWidth() - dockGeometry.x();
-            strutStart = dockGeometry.y();
-            strutEnd = qMin(dockGeometry.y() + dockGeometry.height(), dockGeometry.bottom());
-            break;
-        }
+        if (!windowHandle)
+            return false;
 
-        qDebug() << "set reserved area to xcb:" << strut << strutStart << strutEnd;
+        QGuiApplication::platformNativeInterface()->setWindowProperty(windowHandle, "_d_dwayland_dockstrut", varList);
+        return true;
+    }
 
-        const auto display = QX11Info::display();
-        if (!display) {
-            qWarning() << "QX11Info::display() is " << display;
-            return;
-        }
+    const auto display = QX11Info::display();
+    if (!display) {
+        qWarning() << "QX11Info::display() is " << display;
+        return false;
+    }
 
-        XcbMisc::instance()->set_strut_partial(static_cast<xcb_window_t>(mainWindow->winId()), orientation,
-                                               static_cast<uint>(strut),                 // 设置窗口与屏幕边缘距离，需要乘缩放
-                                               static_cast<uint>(strutStart),                                   // 设置任务栏起点坐标（上下为x，左右为y）
-                                               static_cast<uint>(strutEnd));                                    // 设置任务栏终点坐标（上下为x，左右为y）
+    if (strut.isNull()) {
+        XcbMisc::instance()->clear_strut_partial(xcb_window_t(mainWindow->winId()));
+        return true;
     }
+
+    XcbMisc::Orientation orientation = XcbMisc::OrientationTop;
+    switch (strut.position) {
+    case Position::Top:
+        orientation = XcbMisc::OrientationTop;
+        break;
+    case Position::Bottom:
+        orientation = XcbMisc::OrientationBottom;
+        break;
+    case Position::Left:
+        orientation = XcbMisc::OrientationLeft;
+        break;
+    case Position::Right:
+        orientation = XcbMisc::OrientationRight;
+        break;
+    }
+
+    XcbMisc::instance()->set_strut_partial(static_cast<xcb_window_t>(mainWindow->winId()), orientation,
+                                           static_cast<uint>(strut.size),           // 设置窗口与屏幕边缘距离，需要乘缩放
+                                           static_cast<uint>(strut.start),          // 设置任务栏起点坐标（上下为x，左右为y）
+                                           static_cast<uint>(strut.end - 1));       // 设置任务栏终点坐标（上下为x，左右为y）
+    return true;
 }
 
 void WindowManager::onServiceRestart()
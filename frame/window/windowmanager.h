@@ -8,6 +8,8 @@
 
 #include "constants.h"
 #include "statusnotifierwatcher_interface.h"
+#include "dockanimationcontroller.h"
+#include "strutmanager.h"
 
 #include <QObject>
 
@@ -19,6 +21,7 @@ class TrayMainWindow;
 class MultiScreenWorker;
 class MenuWorker;
 class QDBusConnectionInterface;
+class GeometryTransaction;
 
 using namespace Dtk::Gui;
 
@@ -45,7 +48,7 @@ private:
     void initSNIHost();
     void initMember();
     void updateMainGeometry(const Dock::HideState &hideState);
-    QParallelAnimationGroup *createAnimationGroup(const Dock::AniAction &aniAction, const QString &screenName, const Dock::Position &position) const;
+    bool createAnimationStage(const Dock::AniAction &aniAction, const QString &screenName, const Dock::Position &position, DockAnimationController::Stage &stage) const;
 
     void showAniFinish();
     void animationFinish(bool showOrHide);
@@ -54,6 +57,8 @@ private:
 
     void RegisterDdeSession();
     void updateDockGeometry(const QRect &rect);
+    void applyDockSize(int dockSize);
+    bool writeStrut(const StrutManager::Strut &strut);
 
 private Q_SLOTS:
     void onUpdateDockGeometry(const Dock::HideMode &hideMode);
@@ -79,6 +84,9 @@ private:
     QDBusConnectionInterface *m_dbusDaemonInterface;
     org::kde::StatusNotifierWatcher *m_sniWatcher;      // DBUS状态通知
     QList<MainWindowBase *> m_topWindows;
+    GeometryTransaction *m_resizeTransaction;           // 控制中心拖拽调整大小时合并更新
+    DockAnimationController *m_animationController;     // 显示、隐藏、切换位置的动画
+    StrutManager *m_strutManager;                       // 合并之后写入窗管的预留区域
 };
 
 #endif // WINDOWMANAGER_H
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "xcb_connection.h"
+
+#include <QDBusConnection>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QX11Info>
+
+#include <X11/Xlib.h>
+#include <X11/Xlib-xcb.h>
+
+#define DBUS_PATH "/org/deepin/dde/Dock1/XRequests"
+
+static const char *callerName(XcbConnection::Caller caller)
+{
+    switch (caller) {
+    case XcbConnection::TaskManager: return "taskmanager";
+    case XcbConnection::Tray: return "tray";
+    case XcbConnection::Snapshot: return "snapshot";
+    case XcbConnection::Platform: return "platform";
+    default: break;
+    }
+
+    return "unknown";
+}
+
+XcbConnection::XcbConnection()
+    : m_display(nullptr)
+    , m_connection(nullptr)
+    , m_screenNumber(0)
+    , m_ownDisplay(false)
+{
+    resetStatistics();
+
+    if (QX11Info::isPlatformX11()) {
+        m_display = QX11Info::display();
+        m_connection = QX11Info::connection();
+        m_screenNumber = QX11Info::appScreen();
+        return;
+    }
+
+    // Wayland下通过XWayland访问X窗口(XEmbed托盘、窗口预览等)，整个进程只打开这一个连接
+    m_display = XOpenDisplay(nullptr);
+    if (!m_display) {
+        qWarning() << "XcbConnection: open display failed";
+        return;
+    }
+
+    m_ownDisplay = true;
+    m_connection = XGetXCBConnection(m_display);
+    m_screenNumber = DefaultScreen(m_display);
+}
+
+XcbConnection::~XcbConnection()
+{
+    if (m_ownDisplay && m_display)
+        XCloseDisplay(m_display);
+}
+
+XcbConnection *XcbConnection::instance()
+{
+    static XcbConnection instance;
+    return &instance;
+}
+
+xcb_connection_t *XcbConnection::connection() const
+{
+    return m_connection;
+}
+
+Display *XcbConnection::display() const
+{
+    return m_display;
+}
+
+int XcbConnection::screenNumber() const
+{
+    return m_screenNumber;
+}
+
+xcb_window_t XcbConnection::rootWindow() const
+{
+    if (!m_connection)
+        return XCB_WINDOW_NONE;
+
+    xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(m_connection));
+    for (int i = 0; i < m_screenNumber && it.rem; ++i)
+        xcb_screen_next(&it);
+
+    return it.data ? it.data->root : XCB_WINDOW_NONE;
+}
+
+bool XcbConnection::registerOnBus(QDBusConnection connection)
+{
+    return connection.registerObject(DBUS_PATH, this, QDBusConnection::ExportScriptableSlots);
+}
+
+void XcbConnection::trace(Caller caller)
+{
+    if (caller < 0 || caller >= CallerCount)
+        return;
+
+    m_requests[caller].fetch_add(1, std::memory_order_relaxed);
+}
+
+void XcbConnection::traceError(Caller caller, const xcb_generic_error_t *error)
+{
+    if (caller < 0 || caller >= CallerCount)
+        return;
+
+    m_errors[caller].fetch_add(1, std::memory_order_relaxed);
+    if (error) {
+        qDebug() << "xcb request failed, caller:" << callerName(caller)
+                 << "error code:" << error->error_code
+                 << "major code:" << error->major_code
+                 << "sequence:" << error->sequence;
+    }
+}
+
+XcbConnection::Counters XcbConnection::statistics(Caller caller) const
+{
+    if (caller < 0 || caller >= CallerCount)
+        return Counters{0, 0};
+
+    return Counters{m_requests[caller].load(std::memory_order_relaxed),
+                    m_errors[caller].load(std::memory_order_relaxed)};
+}
+
+void XcbConnection::resetStatistics()
+{
+    for (int i = 0; i < CallerCount; ++i) {
+        m_requests[i].store(0, std::memory_order_relaxed);
+        m_errors[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief XcbConnection::Statistics 按调用方返回请求数和错误数
+ * @return 例如 {"tray":{"requests":12,"errors":0},...}
+ */
+QString XcbConnection::Statistics() const
+{
+    QJsonObject callers;
+    for (int i = 0; i < CallerCount; ++i) {
+        const Counters counters = statistics(Caller(i));
+        QJsonObject callerObject;
+        callerObject["requests"] = double(counters.requests);
+        callerObject["errors"] = double(counters.errors);
+        callers[callerName(Caller(i))] = callerObject;
+    }
+
+    return QString::fromUtf8(QJsonDocument(callers).toJson(QJsonDocument::Compact));
+}
+
+void XcbConnection::Reset()
+{
+    resetStatistics();
+}
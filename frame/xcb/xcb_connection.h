@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef XCB_CONNECTION_H
+#define XCB_CONNECTION_H
+
+#include <QObject>
+
+#include <xcb/xcb.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+typedef struct _XDisplay Display;
+class QDBusConnection;
+
+/**
+ * @brief XcbReply xcb返回的reply由libxcb通过malloc分配，使用该类型在作用域结束时自动释放，
+ * 替代std::shared_ptr加自定义删除器的写法，避免每个reply额外分配一个控制块
+ */
+struct XcbReplyDeleter
+{
+    void operator()(void *reply) const { std::free(reply); }
+};
+
+template<typename T>
+using XcbReply = std::unique_ptr<T, XcbReplyDeleter>;
+
+/**
+ * @brief XcbConnection 进程内唯一的X连接
+ * X11下直接复用Qt的连接，Wayland(XWayland)下只打开一个Display，xcb请求和Xlib请求共用同一个socket。
+ * 同时按调用方统计请求数和错误数，用于衡量各个模块产生的X流量，
+ * 统计结果通过DBus接口org.deepin.dde.Dock1.XRequests提供给调试工具
+ */
+class XcbConnection : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.Dock1.XRequests")
+
+public:
+    enum Caller {
+        TaskManager = 0,    // 任务栏窗口管理(XCBUtils)
+        Tray,               // XEmbed托盘
+        Snapshot,           // 窗口预览
+        Platform,           // 其他零散的属性读取
+        CallerCount
+    };
+
+    struct Counters {
+        quint64 requests;
+        quint64 errors;
+    };
+
+    static XcbConnection *instance();
+
+    xcb_connection_t *connection() const;
+    Display *display() const;
+    int screenNumber() const;
+    xcb_window_t rootWindow() const;
+
+    bool registerOnBus(QDBusConnection connection);
+
+    /**
+     * @brief call 发出一个X请求(xcb或Xlib的请求函数)，并按调用方计数一次
+     * 例如 call(XcbConnection::Tray, xcb_map_window, connection, window)
+     */
+    template<typename Request, typename... Args>
+    auto call(Caller caller, Request request, Args &&...args) -> decltype(request(std::forward<Args>(args)...))
+    {
+        trace(caller);
+        return request(std::forward<Args>(args)...);
+    }
+
+    // 记录一次错误，错误对象的释放由调用方负责
+    void traceError(Caller caller, const xcb_generic_error_t *error);
+    Counters statistics(Caller caller) const;
+    void resetStatistics();
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString Statistics() const;
+    Q_SCRIPTABLE void Reset();
+
+private:
+    XcbConnection();
+    ~XcbConnection();
+    Q_DISABLE_COPY(XcbConnection)
+
+    void trace(Caller caller);
+
+private:
+    Display *m_display;
+    xcb_connection_t *m_connection;
+    int m_screenNumber;
+    bool m_ownDisplay;
+
+    std::atomic<quint64> m_requests[CallerCount];
+    std::atomic<quint64> m_errors[CallerCount];
+};
+
+#endif // XCB_CONNECTION_H
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginhost.h"
+
+#include <DApplication>
+
+#include <QCommandLineParser>
+#include <QDebug>
+
+DWIDGET_USE_NAMESPACE
+
+/**
+ * 任务栏插件宿主进程，用法：dde-dock-plugin-host --socket <name> <plugin file>
+ * 由任务栏启动，通过本地套接字和共享内存与任务栏通信，插件崩溃或者阻塞时不影响任务栏
+ */
+int main(int argc, char *argv[])
+{
+    DApplication app(argc, argv);
+    app.setOrganizationName("deepin");
+    app.setApplicationName("dde-dock-plugin-host");
+    app.setQuitOnLastWindowClosed(false);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption socketOption("socket", "Local socket name of the dock.", "name");
+    parser.addOption(socketOption);
+    parser.addPositionalArgument("plugin", "Plugin file to load.");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (!parser.isSet(socketOption) || args.size() != 1) {
+        parser.showHelp(-1);
+    }
+
+    PluginHost host(parser.value(socketOption), args.first());
+    if (!host.start())
+        return -1;
+
+    return app.exec();
+}
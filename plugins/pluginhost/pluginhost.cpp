@@ -0,0 +1,320 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginhost.h"
+#include "pluginsiteminterface.h"
+#include "constants.h"
+
+#include <QApplication>
+#include <QImage>
+#include <QLocalSocket>
+#include <QMouseEvent>
+#include <QPluginLoader>
+#include <QSharedMemory>
+#include <QTimer>
+#include <QWidget>
+#include <QDebug>
+
+// 合并短时间内的多次重绘
+#define RENDER_DELAY 16
+#define CONNECT_TIMEOUT 3000
+
+PluginHost::PluginHost(const QString &socketName, const QString &pluginFile, QObject *parent)
+    : QObject(parent)
+    , m_socketName(socketName)
+    , m_pluginFile(pluginFile)
+    , m_socket(new QLocalSocket(this))
+    , m_channel(new PluginHostChannel(m_socket, this))
+    , m_pluginLoader(new QPluginLoader(pluginFile, this))
+    , m_plugin(nullptr)
+    , m_inited(false)
+    , m_renderTimer(new QTimer(this))
+    , m_segmentSerial(0)
+    , m_grabbing(false)
+{
+    m_renderTimer->setSingleShot(true);
+    m_renderTimer->setInterval(RENDER_DELAY);
+    connect(m_renderTimer, &QTimer::timeout, this, &PluginHost::renderPendingItems);
+
+    connect(m_channel, &PluginHostChannel::messageReceived, this, &PluginHost::onMessageReceived);
+    // 任务栏退出或者主动断开连接时，宿主进程随之退出
+    connect(m_channel, &PluginHostChannel::disconnected, qApp, &QCoreApplication::quit, Qt::QueuedConnection);
+}
+
+PluginHost::~PluginHost()
+{
+    qDeleteAll(m_itemImages);
+}
+
+bool PluginHost::start()
+{
+    if (!m_pluginLoader->load()) {
+        qWarning() << "plugin host load plugin failed:" << m_pluginLoader->errorString();
+        return false;
+    }
+
+    // 宿主进程只支持v23接口的插件
+    m_plugin = qobject_cast<PluginsItemInterface *>(m_pluginLoader->instance());
+    if (!m_plugin) {
+        qWarning() << "plugin host unsupported plugin:" << m_pluginFile;
+        return false;
+    }
+
+    m_socket->connectToServer(m_socketName);
+    if (!m_socket->waitForConnected(CONNECT_TIMEOUT)) {
+        qWarning() << "plugin host connect to dock failed:" << m_socket->errorString();
+        return false;
+    }
+
+    m_channel->send(PluginHostChannel::Hello, m_plugin->pluginName(), m_plugin->pluginDisplayName(),
+                    int(m_plugin->flags()), int(m_plugin->type()), int(m_plugin->pluginSizePolicy()));
+    return true;
+}
+
+bool PluginHost::eventFilter(QObject *watched, QEvent *event)
+{
+    // grab()会同步发送绘制事件，如果在这里再次请求重绘会一直循环截图
+    if (m_grabbing)
+        return QObject::eventFilter(watched, event);
+
+    // 插件项调用update()后会收到UpdateRequest，不处理每次绘制的Paint事件
+    switch (event->type()) {
+    case QEvent::UpdateRequest:
+    case QEvent::Resize:
+    case QEvent::LayoutRequest: {
+        for (auto it = m_itemWidgets.constBegin(); it != m_itemWidgets.constEnd(); ++it) {
+            QWidget *itemWidget = it.value().data();
+            if (itemWidget && (itemWidget == watched || itemWidget->isAncestorOf(qobject_cast<QWidget *>(watched))))
+                scheduleRender(it.key());
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+void PluginHost::itemAdded(PluginsItemInterface * const itemInter, const QString &itemKey)
+{
+    QWidget *itemWidget = itemInter->itemWidget(itemKey);
+    if (itemWidget) {
+        // 插件项窗口只在本进程中离屏显示，由任务栏显示绘制结果
+        itemWidget->setAttribute(Qt::WA_DontShowOnScreen);
+        itemWidget->show();
+        itemWidget->installEventFilter(this);
+        m_itemWidgets[itemKey] = itemWidget;
+    }
+
+    m_channel->send(PluginHostChannel::ItemAdded, itemKey);
+    scheduleRender(itemKey);
+}
+
+void PluginHost::itemUpdate(PluginsItemInterface * const itemInter, const QString &itemKey)
+{
+    Q_UNUSED(itemInter);
+
+    m_channel->send(PluginHostChannel::ItemUpdate, itemKey);
+    scheduleRender(itemKey);
+}
+
+void PluginHost::itemRemoved(PluginsItemInterface * const itemInter, const QString &itemKey)
+{
+    Q_UNUSED(itemInter);
+
+    releaseItem(itemKey);
+    m_channel->send(PluginHostChannel::ItemRemoved, itemKey);
+}
+
+void PluginHost::requestWindowAutoHide(PluginsItemInterface * const itemInter, const QString &itemKey, const bool autoHide)
+{
+    Q_UNUSED(itemInter);
+    Q_UNUSED(itemKey);
+    Q_UNUSED(autoHide);
+}
+
+void PluginHost::requestRefreshWindowVisible(PluginsItemInterface * const itemInter, const QString &itemKey)
+{
+    Q_UNUSED(itemInter);
+    Q_UNUSED(itemKey);
+}
+
+void PluginHost::requestSetAppletVisible(PluginsItemInterface * const itemInter, const QString &itemKey, const bool visible)
+{
+    Q_UNUSED(itemInter);
+
+    m_channel->send(PluginHostChannel::RequestAppletVisible, itemKey, visible);
+}
+
+void PluginHost::saveValue(PluginsItemInterface * const itemInter, const QString &key, const QVariant &value)
+{
+    Q_UNUSED(itemInter);
+
+    m_settings.insert(key, value);
+    m_channel->send(PluginHostChannel::SaveValue, key, value);
+}
+
+const QVariant PluginHost::getValue(PluginsItemInterface * const itemInter, const QString &key, const QVariant &fallback)
+{
+    Q_UNUSED(itemInter);
+
+    return m_settings.value(key, fallback);
+}
+
+void PluginHost::removeValue(PluginsItemInterface * const itemInter, const QStringList &keyList)
+{
+    Q_UNUSED(itemInter);
+
+    if (keyList.isEmpty()) {
+        m_settings.clear();
+    } else {
+        for (const QString &key : keyList)
+            m_settings.remove(key);
+    }
+
+    m_channel->send(PluginHostChannel::RemoveValue, keyList);
+}
+
+void PluginHost::scheduleRender(const QString &itemKey)
+{
+    if (!m_itemWidgets.contains(itemKey))
+        return;
+
+    m_dirtyItems << itemKey;
+    if (!m_renderTimer->isActive())
+        m_renderTimer->start();
+}
+
+void PluginHost::renderPendingItems()
+{
+    const QSet<QString> dirtyItems = m_dirtyItems;
+    m_dirtyItems.clear();
+
+    for (const QString &itemKey : dirtyItems)
+        renderItem(itemKey);
+}
+
+void PluginHost::renderItem(const QString &itemKey)
+{
+    QWidget *itemWidget = m_itemWidgets.value(itemKey).data();
+    if (!itemWidget)
+        return;
+
+    m_grabbing = true;
+    const QImage image = itemWidget->grab().toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    m_grabbing = false;
+    if (image.isNull())
+        return;
+
+    const int bytes = image.sizeInBytes();
+    QSharedMemory *segment = m_itemImages.value(itemKey);
+    if (!segment || segment->size() < bytes) {
+        delete segment;
+        // 尺寸变大时换用新的共享内存，任务栏收到新的key后重新连接
+        segment = new QSharedMemory(QString("dde-dock-plugin-host-%1-%2").arg(QCoreApplication::applicationPid()).arg(++m_segmentSerial));
+        if (!segment->create(bytes)) {
+            qWarning() << "plugin host create shared memory failed:" << segment->errorString();
+            delete segment;
+            m_itemImages.remove(itemKey);
+            return;
+        }
+        m_itemImages[itemKey] = segment;
+    }
+
+    segment->lock();
+    memcpy(segment->data(), image.constBits(), size_t(bytes));
+    segment->unlock();
+
+    m_channel->send(PluginHostChannel::ItemImage, itemKey, segment->key(), image.size(),
+                    image.bytesPerLine(), itemWidget->devicePixelRatioF());
+}
+
+void PluginHost::releaseItem(const QString &itemKey)
+{
+    m_dirtyItems.remove(itemKey);
+    if (QWidget *itemWidget = m_itemWidgets.take(itemKey).data()) {
+        itemWidget->removeEventFilter(this);
+        itemWidget->hide();
+    }
+
+    delete m_itemImages.take(itemKey);
+}
+
+void PluginHost::onMessageReceived(PluginHostChannel::MessageType type, const QByteArray &body)
+{
+    QDataStream stream(body);
+    stream.setVersion(PluginHostChannel::StreamVersion);
+
+    switch (type) {
+    case PluginHostChannel::Init: {
+        int displayMode = 0;
+        int position = 0;
+        stream >> m_settings >> displayMode >> position;
+        qApp->setProperty(PROP_DISPLAY_MODE, QVariant::fromValue(Dock::DisplayMode(displayMode)));
+        qApp->setProperty(PROP_POSITION, QVariant::fromValue(Dock::Position(position)));
+
+        if (!m_inited) {
+            m_inited = true;
+            m_plugin->init(this);
+        }
+        break;
+    }
+    case PluginHostChannel::SettingsChanged:
+        stream >> m_settings;
+        m_plugin->pluginSettingsChanged();
+        break;
+    case PluginHostChannel::DisplayModeChanged: {
+        int displayMode = 0;
+        stream >> displayMode;
+        qApp->setProperty(PROP_DISPLAY_MODE, QVariant::fromValue(Dock::DisplayMode(displayMode)));
+        m_plugin->displayModeChanged(Dock::DisplayMode(displayMode));
+        break;
+    }
+    case PluginHostChannel::PositionChanged: {
+        int position = 0;
+        stream >> position;
+        qApp->setProperty(PROP_POSITION, QVariant::fromValue(Dock::Position(position)));
+        m_plugin->positionChanged(Dock::Position(position));
+        break;
+    }
+    case PluginHostChannel::ItemResize: {
+        QString itemKey;
+        QSize size;
+        stream >> itemKey >> size;
+        if (QWidget *itemWidget = m_itemWidgets.value(itemKey).data())
+            itemWidget->resize(size);
+        scheduleRender(itemKey);
+        break;
+    }
+    case PluginHostChannel::ItemMouseEvent: {
+        QString itemKey;
+        int eventType = 0, button = 0, buttons = 0, modifiers = 0;
+        QPointF pos;
+        stream >> itemKey >> eventType >> pos >> button >> buttons >> modifiers;
+
+        QWidget *itemWidget = m_itemWidgets.value(itemKey).data();
+        if (!itemWidget)
+            break;
+
+        // 发送给鼠标位置下的子窗口
+        QWidget *target = itemWidget->childAt(pos.toPoint());
+        if (!target)
+            target = itemWidget;
+
+        const QPointF localPos = target->mapFrom(itemWidget, pos.toPoint());
+        QMouseEvent mouseEvent(QEvent::Type(eventType), localPos, localPos, Qt::MouseButton(button),
+                               Qt::MouseButtons(buttons), Qt::KeyboardModifiers(modifiers));
+        QCoreApplication::sendEvent(target, &mouseEvent);
+        scheduleRender(itemKey);
+        break;
+    }
+    case PluginHostChannel::Ping:
+        // 在主线程中回复，插件阻塞主线程时任务栏收不到回复
+        m_channel->send(PluginHostChannel::Pong);
+        break;
+    default:
+        break;
+    }
+}
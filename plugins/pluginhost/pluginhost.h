@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINHOST_H
+#define PLUGINHOST_H
+
+#include "pluginproxyinterface.h"
+#include "pluginhostchannel.h"
+
+#include <QObject>
+#include <QMap>
+#include <QPointer>
+#include <QSet>
+#include <QVariantMap>
+
+class PluginsItemInterface;
+class QLocalSocket;
+class QPluginLoader;
+class QSharedMemory;
+class QTimer;
+class QWidget;
+
+/**
+ * @brief PluginHost 在独立进程中运行单个插件
+ * 插件的itemWidget在本进程中离屏显示，绘制结果写入共享内存后通知任务栏，
+ * 任务栏转发的鼠标事件在这里发送给插件的窗口，插件的配置读写也转发给任务栏
+ */
+class PluginHost : public QObject, public PluginProxyInterface
+{
+    Q_OBJECT
+
+public:
+    PluginHost(const QString &socketName, const QString &pluginFile, QObject *parent = nullptr);
+    ~PluginHost() override;
+
+    bool start();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    // implements PluginProxyInterface
+    void itemAdded(PluginsItemInterface * const itemInter, const QString &itemKey) override;
+    void itemUpdate(PluginsItemInterface * const itemInter, const QString &itemKey) override;
+    void itemRemoved(PluginsItemInterface * const itemInter, const QString &itemKey) override;
+    void requestWindowAutoHide(PluginsItemInterface * const itemInter, const QString &itemKey, const bool autoHide) override;
+    void requestRefreshWindowVisible(PluginsItemInterface * const itemInter, const QString &itemKey) override;
+    void requestSetAppletVisible(PluginsItemInterface * const itemInter, const QString &itemKey, const bool visible) override;
+    void saveValue(PluginsItemInterface * const itemInter, const QString &key, const QVariant &value) override;
+    const QVariant getValue(PluginsItemInterface *const itemInter, const QString &key, const QVariant& fallback = QVariant()) override;
+    void removeValue(PluginsItemInterface *const itemInter, const QStringList &keyList) override;
+
+    void scheduleRender(const QString &itemKey);
+    void renderItem(const QString &itemKey);
+    void releaseItem(const QString &itemKey);
+
+private Q_SLOTS:
+    void onMessageReceived(PluginHostChannel::MessageType type, const QByteArray &body);
+    void renderPendingItems();
+
+private:
+    QString m_socketName;
+    QString m_pluginFile;
+    QLocalSocket *m_socket;
+    PluginHostChannel *m_channel;
+    QPluginLoader *m_pluginLoader;
+    PluginsItemInterface *m_plugin;
+    bool m_inited;
+
+    QVariantMap m_settings;                             // 本插件的配置，由任务栏同步过来
+    QMap<QString, QPointer<QWidget>> m_itemWidgets;     // itemKey -> 插件项窗口
+    QMap<QString, QSharedMemory *> m_itemImages;        // itemKey -> 保存插件项图像的共享内存
+    QSet<QString> m_dirtyItems;                         // 需要重新绘制的插件项
+    QTimer *m_renderTimer;
+    int m_segmentSerial;
+    bool m_grabbing;                                    // 正在截取插件项图像，忽略截图过程中的事件
+};
+
+#endif // PLUGINHOST_H
@@ -8,6 +8,11 @@
 #include "pluginsiteminterface.h"
 #include "pluginsiteminterface_v20.h"
 #include "pluginadapter.h"
+#include "pluginsettingsstore.h"
+#include "pluginsettingsreconciler.h"
+#include "plugincallmonitor.h"
+#include "remotepluginproxy.h"
+#include "pluginfilewatcher.h"
 #include "utils.h"
 
 #include <DNotifySender>
@@ -15,50 +20,55 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QFutureWatcher>
 #include <QMapIterator>
 #include <QPluginLoader>
+#include <QSet>
+#include <QTimer>
+#include <QtConcurrent>
 
-#define PLUGININFO "pluginInfo"
-
-static const QStringList CompatiblePluginApiList {
-    "1.1.1",
-    "1.2",
-    "1.2.1",
-    "1.2.2",
-    DOCK_PLUGIN_API_VERSION
-};
-
-class PluginInfo : public QObject
-{
-public:
-    PluginInfo() : QObject(nullptr), m_loaded(false), m_visible(false) {}
-    bool m_loaded;
-    bool m_visible;
-    QString m_itemKey;
-};
+// 启动加载完成后等待一段时间再加载延后的插件，之后每次只加载一个，不阻塞事件循环
+static const int DeferredActivateDelay = 3000;
+static const int DeferredActivateInterval = 200;
 
 DockPluginController::DockPluginController(PluginProxyInterface *proxyInter, QObject *parent)
     : QObject(parent)
     , m_dbusDaemonInterface(QDBusConnection::sessionBus().interface())
     // , m_dockDaemonInter(new DockInter(dockServiceName(), dockServicePath(), QDBusConnection::sessionBus(), this))
+    , m_deferredTimer(new QTimer(this))
+    , m_fileWatcher(new PluginFileWatcher(this))
+    , m_reloadSerial(0)
     , m_proxyInter(proxyInter)
 {
     qApp->installEventFilter(this);
 
-    refreshPluginSettings();
+    m_deferredTimer->setSingleShot(true);
+    connect(m_deferredTimer, &QTimer::timeout, this, &DockPluginController::activateNextDeferredPlugin);
+
+    connect(m_fileWatcher, &PluginFileWatcher::pluginAdded, this, &DockPluginController::onPluginFileAdded);
+    connect(m_fileWatcher, &PluginFileWatcher::pluginChanged, this, &DockPluginController::onPluginFileChanged);
+    connect(m_fileWatcher, &PluginFileWatcher::pluginRemoved, this, &DockPluginController::onPluginFileRemoved);
+
+    // 插件接口调用耗时统计，超过上限时输出警告
+    PluginCallMonitor *callMonitor = PluginCallMonitor::instance();
+    callMonitor->setBudget(int(DockSettings::instance()->getPluginCallBudget()));
+    callMonitor->registerOnBus(QDBusConnection::sessionBus());
+    connect(DockSettings::instance(), &DockSettings::pluginCallBudgetChanged, callMonitor, [ callMonitor ](uint msec) {
+        callMonitor->setBudget(int(msec));
+    });
 
     connect(DockSettings::instance(), &DockSettings::quickPluginsChanged, this, &DockPluginController::onConfigChanged);
+    connect(DockSettings::instance()->pluginSettings(), &PluginSettingsStore::externalChanged, this, &DockPluginController::refreshPluginSettings);
     // connect(m_dockDaemonInter, &DockInter::PluginSettingsSynced, this, &DockPluginController::refreshPluginSettings, Qt::QueuedConnection);
 }
 
 DockPluginController::~DockPluginController()
 {
-    for (auto inter : m_pluginsMap.keys()) {
-        delete m_pluginsMap.value(inter).value("pluginloader");
-        m_pluginsMap[inter]["pluginloader"] = nullptr;
-        if (m_pluginsMap[inter].contains(PLUGININFO))
-            m_pluginsMap[inter][PLUGININFO]->deleteLater();
-        m_pluginsMap.remove(inter);
+    for (auto inter : m_registry.plugins()) {
+        delete m_registry.record(inter)->pluginLoader;
+        m_registry.removePlugin(inter);
+        PluginCallMonitor::instance()->unregisterPlugin(inter);
         delete inter;
         inter = nullptr;
     }
@@ -66,7 +76,7 @@ DockPluginController::~DockPluginController()
 
 QList<PluginsItemInterface *> DockPluginController::plugins() const
 {
-    return m_pluginsMap.keys();
+    return m_registry.plugins();
 }
 
 QList<PluginsItemInterface *> DockPluginController::pluginsInSetting() const
@@ -78,19 +88,14 @@ QList<PluginsItemInterface *> DockPluginController::pluginsInSetting() const
     // 此处返回的是第二种插件
     QList<PluginsItemInterface *> settingPlugins;
     QMap<PluginsItemInterface *, int> pluginSort;
-    for (auto it = m_pluginsMap.begin(); it != m_pluginsMap.end(); it++) {
-        PluginsItemInterface *plugin = it.key();
+    for (PluginsItemInterface *plugin : m_registry.plugins()) {
         qInfo() << plugin->pluginName();
         if (plugin->pluginDisplayName().isEmpty())
             continue;
 
-        QMap<QString, QObject *> pluginMap = it.value();
-        // 如果不包含PLUGININFO这个key值，肯定是未加载
-        if (!pluginMap.contains(PLUGININFO))
-            continue;
-
-        PluginInfo *pluginInfo = static_cast<PluginInfo *>(pluginMap[PLUGININFO]);
-        if (!pluginInfo->m_loaded)
+        // 没有调用过itemAdded方法，或者已经调用了itemRemoved方法，都是未加载
+        const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(plugin);
+        if (!pluginRecord->loaded)
             continue;
 
         // 这里只需要返回插件为可以在控制中心设置的插件
@@ -98,7 +103,7 @@ QList<PluginsItemInterface *> DockPluginController::pluginsInSetting() const
             continue;
 
         settingPlugins << plugin;
-        pluginSort[plugin] = plugin->itemSortKey(pluginInfo->m_itemKey);
+        pluginSort[plugin] = plugin->itemSortKey(pluginRecord->itemKey);
     }
 
     std::sort(settingPlugins.begin(), settingPlugins.end(), [ pluginSort ](PluginsItemInterface *plugin1, PluginsItemInterface *plugin2) {
@@ -113,18 +118,13 @@ QList<PluginsItemInterface *> DockPluginController::currentPlugins() const
     QList<PluginsItemInterface *> loadedPlugins;
 
     QMap<PluginsItemInterface *, int> pluginSortMap;
-    for (auto it = m_pluginsMap.begin(); it != m_pluginsMap.end(); it++) {
-        QMap<QString, QObject *> objectMap = it.value();
-        if (!objectMap.contains(PLUGININFO))
-            continue;
-
-        PluginInfo *pluginInfo = static_cast<PluginInfo *>(objectMap[PLUGININFO]);
-        if (!pluginInfo->m_loaded)
+    for (PluginsItemInterface *plugin : m_registry.plugins()) {
+        const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(plugin);
+        if (!pluginRecord->loaded)
             continue;
 
-        PluginsItemInterface *plugin = it.key();
         loadedPlugins << plugin;
-        pluginSortMap[plugin] = plugin->itemSortKey(pluginInfo->m_itemKey);
+        pluginSortMap[plugin] = plugin->itemSortKey(pluginRecord->itemKey);
     }
 
     std::sort(loadedPlugins.begin(), loadedPlugins.end(), [ pluginSortMap ](PluginsItemInterface *pluginItem1, PluginsItemInterface *pluginItem2) {
@@ -160,19 +160,18 @@ void DockPluginController::itemAdded(PluginsItemInterface * const itemInter, con
     }
 
     // 如果是通过插件来调用m_proxyInter的
-    PluginInfo *pluginInfo = nullptr;
-    QMap<QString, QObject *> &interfaceData = m_pluginsMap[pluginItem];
-    if (interfaceData.contains(PLUGININFO)) {
-        pluginInfo = static_cast<PluginInfo *>(interfaceData[PLUGININFO]);
-        // 如果插件已经加载，则无需再次加载（此处保证插件出现重复调用itemAdded的情况）
-        if (pluginInfo->m_loaded)
-            return;
-    } else {
-        pluginInfo = new PluginInfo;
-        interfaceData[PLUGININFO] = pluginInfo;
-    }
-    pluginInfo->m_itemKey = itemKey;
-    pluginInfo->m_loaded = true;
+    PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginItem);
+    if (!pluginRecord)
+        return;
+
+    // 如果插件已经加载，则无需再次加载（此处保证插件出现重复调用itemAdded的情况）
+    if (pluginRecord->loaded)
+        return;
+
+    pluginRecord->added = true;
+    pluginRecord->itemKey = itemKey;
+    pluginRecord->loaded = true;
+    m_registry.bindItem(pluginItem, itemKey, nullptr);
 
     if (pluginCanDock(pluginItem))
         addPluginItem(pluginItem, itemKey);
@@ -189,14 +188,14 @@ void DockPluginController::itemRemoved(PluginsItemInterface * const itemInter, c
 {
     PluginsItemInterface *pluginInter = getPluginInterface(itemInter);
     // 更新字段中的isLoaded字段，表示当前没有加载
-    QMap<QString, QObject *> &interfaceData = m_pluginsMap[pluginInter];
-    if (interfaceData.contains(PLUGININFO)) {
-        PluginInfo *pluginInfo = static_cast<PluginInfo *>(interfaceData[PLUGININFO]);
+    PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginInter);
+    if (pluginRecord && pluginRecord->added) {
         // 将是否加载的标记修改为未加载
-        pluginInfo->m_loaded = false;
+        pluginRecord->loaded = false;
     }
 
     removePluginItem(pluginInter, itemKey);
+    m_registry.unbindItem(pluginInter, itemKey);
     Q_EMIT pluginRemoved(pluginInter);
 }
 
@@ -230,37 +229,32 @@ PluginsItemInterface *DockPluginController::getPluginInterface(PluginsItemInterf
 
 void DockPluginController::addPluginItem(PluginsItemInterface * const itemInter, const QString &itemKey)
 {
-    // 如果这个插件都没有加载，那么此处肯定是无需新增
-    if (!m_pluginsMap.contains(itemInter))
+    // 如果这个插件都没有加载，或者没有调用过itemAdded方法，那么此处肯定是无需新增
+    PluginRegistry::PluginRecord *pluginRecord = m_registry.record(itemInter);
+    if (!pluginRecord || !pluginRecord->added)
         return;
 
-    PluginInfo *pluginInfo = nullptr;
-    QMap<QString, QObject *> &interfaceData = m_pluginsMap[itemInter];
-    // 此处的PLUGININFO的数据已经在前面调用的地方给填充了数据，如果没有获取到这个数据，则无需新增
-    if (!interfaceData.contains(PLUGININFO))
-        return;
+    pluginRecord->visible = true;
 
-    pluginInfo = static_cast<PluginInfo *>(interfaceData[PLUGININFO]);
-    pluginInfo->m_visible = true;
+    // 记录插件项窗口，拖拽等场景下可以直接根据窗口找到插件
+    QWidget *itemWidget = timedPluginCall(itemInter, "itemWidget", [ & ] { return itemInter->itemWidget(itemKey); });
+    m_registry.bindItem(itemInter, itemKey, itemWidget);
+    if (itemWidget)
+        connect(itemWidget, &QObject::destroyed, this, &DockPluginController::onItemObjectDestroyed, Qt::UniqueConnection);
 
     m_proxyInter->itemAdded(itemInter, itemKey);
 }
 
 void DockPluginController::removePluginItem(PluginsItemInterface * const itemInter, const QString &itemKey)
 {
-    if (!m_pluginsMap.contains(itemInter))
+    PluginRegistry::PluginRecord *pluginRecord = m_registry.record(itemInter);
+    if (!pluginRecord || !pluginRecord->added)
         return;
 
-    // 更新字段中的isLoaded字段，表示当前没有加载
-    QMap<QString, QObject *> &interfaceData = m_pluginsMap[itemInter];
-    if (!interfaceData.contains(PLUGININFO))
-        return;
-
-    PluginInfo *pluginInfo = static_cast<PluginInfo *>(interfaceData[PLUGININFO]);
     // 将是否在任务栏显示的标记改为不显示
-    pluginInfo->m_visible = false;
+    pluginRecord->visible = false;
 
-    if (QWidget * popup = itemInter->itemPopupApplet(itemKey))
+    if (QWidget * popup = timedPluginCall(itemInter, "itemPopupApplet", [ & ] { return itemInter->itemPopupApplet(itemKey); }))
         popup->hide();
 
     m_proxyInter->itemRemoved(itemInter, itemKey);
@@ -268,72 +262,49 @@ void DockPluginController::removePluginItem(PluginsItemInterface * const itemInt
 
 QString DockPluginController::itemKey(PluginsItemInterface *itemInter) const
 {
-    if (!m_pluginsMap.contains(itemInter))
+    const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(itemInter);
+    if (!pluginRecord || !pluginRecord->added)
         return QString();
 
-    QMap<QString, QObject *> interfaceData = m_pluginsMap[itemInter];
-    if (!interfaceData.contains(PLUGININFO))
-        return QString();
-
-    PluginInfo *pluginInfo = static_cast<PluginInfo *>(interfaceData[PLUGININFO]);
-    return pluginInfo->m_itemKey;
+    return pluginRecord->itemKey;
 }
 
 QJsonObject DockPluginController::metaData(PluginsItemInterface *pluginItem)
 {
-    if (!m_pluginsMap.contains(pluginItem))
+    const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginItem);
+    if (!pluginRecord || !pluginRecord->pluginLoader)
         return QJsonObject();
 
-    QPluginLoader *pluginLoader = qobject_cast<QPluginLoader *>(m_pluginsMap[pluginItem].value("pluginloader"));
-
-    if (!pluginLoader)
-        return QJsonObject();
-
-    return pluginLoader->metaData().value("MetaData").toObject();
+    return pluginRecord->pluginLoader->metaData().value("MetaData").toObject();
 }
 
 void DockPluginController::savePluginValue(PluginsItemInterface * const itemInter, const QString &key, const QVariant &value)
 {
-    // is it necessary?
-    //    refreshPluginSettings();
-
-    // save to local cache
-    QJsonObject localObject = m_pluginSettingsObject.value(itemInter->pluginName()).toObject();
-    localObject.insert(key, QJsonValue::fromVariant(value)); //Note: QVariant::toJsonValue() not work in Qt 5.7
-
-    // save to daemon
-    QJsonObject remoteObject, remoteObjectInter;
-    remoteObjectInter.insert(key, QJsonValue::fromVariant(value)); //Note: QVariant::toJsonValue() not work in Qt 5.7
-    remoteObject.insert(itemInter->pluginName(), remoteObjectInter);
+    // 只修改内存中的配置，由配置存储合并写入
+    PluginSettingsStore *pluginSettings = DockSettings::instance()->pluginSettings();
+    const QString &pluginName = itemInter->pluginName();
+    pluginSettings->setValue(pluginName, key, QJsonValue::fromVariant(value)); //Note: QVariant::toJsonValue() not work in Qt 5.7
 
     if (itemInter->type() == PluginsItemInterface::Fixed && key == "enable" && !value.toBool()) {
         int fixedPluginCount = 0;
         // 遍历FixPlugin插件个数
-        for (auto it(m_pluginsMap.begin()); it != m_pluginsMap.end();) {
-            if (it.key()->type() == PluginsItemInterface::Fixed) {
+        for (PluginsItemInterface *plugin : m_registry.plugins()) {
+            if (plugin->type() == PluginsItemInterface::Fixed) {
                 fixedPluginCount++;
             }
-            ++it;
         }
         // 修改插件的order值，位置为队尾
-        QString name = localObject.keys().last();
+        QString name = pluginSettings->pluginSettings(pluginName).keys().last();
         // 此次做一下判断，有可能初始数据不存在pos_*字段，会导致enable字段被修改。或者此处可以循环所有字段是否存在pos_开头的字段？
         if (name != key) {
-            localObject.insert(name, QJsonValue::fromVariant(fixedPluginCount)); //Note: QVariant::toJsonValue() not work in Qt 5.7
-            // daemon中同样修改
-            remoteObjectInter.insert(name, QJsonValue::fromVariant(fixedPluginCount)); //Note: QVariant::toJsonValue() not work in Qt 5.7
-            remoteObject.insert(itemInter->pluginName(), remoteObjectInter);
+            pluginSettings->setValue(pluginName, name, QJsonValue::fromVariant(fixedPluginCount)); //Note: QVariant::toJsonValue() not work in Qt 5.7
         }
     }
-
-    m_pluginSettingsObject.insert(itemInter->pluginName(), localObject);
-    DockSettings::instance()->mergePluginSettings(QJsonDocument(remoteObject).toJson(QJsonDocument::JsonFormat::Compact));
 }
 
 const QVariant DockPluginController::getPluginValue(PluginsItemInterface * const itemInter, const QString &key, const QVariant &fallback)
 {
-    // load from local cache
-    QVariant v = m_pluginSettingsObject.value(itemInter->pluginName()).toObject().value(key).toVariant();
+    QVariant v = DockSettings::instance()->pluginSettings()->value(itemInter->pluginName(), key).toVariant();
     if (v.isNull() || !v.isValid()) {
         v = fallback;
     }
@@ -343,17 +314,7 @@ const QVariant DockPluginController::getPluginValue(PluginsItemInterface * const
 
 void DockPluginController::removePluginValue(PluginsItemInterface * const itemInter, const QStringList &keyList)
 {
-    if (keyList.isEmpty()) {
-        m_pluginSettingsObject.remove(itemInter->pluginName());
-    } else {
-        QJsonObject localObject = m_pluginSettingsObject.value(itemInter->pluginName()).toObject();
-        for (auto key : keyList) {
-            localObject.remove(key);
-        }
-        m_pluginSettingsObject.insert(itemInter->pluginName(), localObject);
-    }
-
-    DockSettings::instance()->removePluginSettings(itemInter->pluginName(), keyList);
+    DockSettings::instance()->pluginSettings()->remove(itemInter->pluginName(), keyList);
 }
 
 void DockPluginController::startLoadPlugin(const QStringList &dirs)
@@ -363,67 +324,60 @@ void DockPluginController::startLoadPlugin(const QStringList &dirs)
         if (!dir.exists(path))
             continue;
 
+        m_pluginDirs << path;
         startLoader(new PluginLoader(path, this));
     }
 }
 
 bool DockPluginController::isPluginLoaded(PluginsItemInterface *itemInter)
 {
-    if (!m_pluginsMap.contains(itemInter))
+    const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(itemInter);
+    if (!pluginRecord || !pluginRecord->added)
         return false;
 
-    QMap<QString, QObject *> pluginObject = m_pluginsMap.value(itemInter);
-    if (!pluginObject.contains(PLUGININFO))
-        return false;
-
-    PluginInfo *pluginInfo = static_cast<PluginInfo *>(pluginObject.value(PLUGININFO));
-    return pluginInfo->m_visible;
+    return pluginRecord->visible;
 }
 
 QObject *DockPluginController::pluginItemAt(PluginsItemInterface *const itemInter, const QString &itemKey) const
 {
-    if (!m_pluginsMap.contains(itemInter))
-        return nullptr;
-
-    return m_pluginsMap[itemInter][itemKey];
+    return m_registry.itemObject(itemInter, itemKey);
 }
 
 PluginsItemInterface *DockPluginController::pluginInterAt(const QString &itemKey)
 {
-    QMapIterator<PluginsItemInterface *, QMap<QString, QObject *>> it(m_pluginsMap);
-    while (it.hasNext()) {
-        it.next();
-        if (it.value().keys().contains(itemKey)) {
-            return it.key();
-        }
-    }
-
-    return nullptr;
+    return m_registry.pluginByItemKey(itemKey);
 }
 
 PluginsItemInterface *DockPluginController::pluginInterAt(QObject *destItem)
 {
-    QMapIterator<PluginsItemInterface *, QMap<QString, QObject *>> it(m_pluginsMap);
-    while (it.hasNext()) {
-        it.next();
-        if (it.value().values().contains(destItem)) {
-            return it.key();
-        }
-    }
-
-    return nullptr;
+    return m_registry.pluginByObject(destItem);
 }
 
 void DockPluginController::startLoader(PluginLoader *loader)
 {
+    const QSharedPointer<PluginMetaDataCache> metaDataCache = loader->metaDataCache();
     connect(loader, &PluginLoader::finished, loader, &PluginLoader::deleteLater, Qt::QueuedConnection);
     connect(loader, &PluginLoader::pluginFound, this, [ = ](const QString &pluginFile) {
-        QPair<QString, PluginsItemInterface *> pair;
-        pair.first = pluginFile;
-        pair.second = nullptr;
-        m_pluginLoadMap.insert(pair, false);
+        m_registry.addPluginFile(pluginFile);
+        m_metaDataCaches.insert(pluginFile, metaDataCache);
     });
-    connect(loader, &PluginLoader::pluginFound, this, &DockPluginController::loadPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginLoaded, this, &DockPluginController::loadPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginLoadFailed, this, &DockPluginController::rejectPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginDeferred, this, &DockPluginController::deferPlugin, Qt::QueuedConnection);
+    connect(loader, &PluginLoader::pluginIsolated, this, &DockPluginController::isolatePlugin, Qt::QueuedConnection);
+
+    // 加载线程中不能访问DockSettings，这里把当前的配置交给过滤函数
+    const QStringList config = DockSettings::instance()->getQuickPlugins();
+    loader->setDeferFilter([ config ](const QJsonObject &descriptor) {
+        return canDeferPlugin(descriptor, config);
+    });
+    // 配置中的插件在独立的宿主进程中运行，按插件文件名匹配
+    const QStringList isolatedPlugins = DockSettings::instance()->getIsolatedPlugins();
+    if (!isolatedPlugins.isEmpty()) {
+        loader->setIsolateFilter([ isolatedPlugins ](const QString &pluginFile) {
+            return isolatedPlugins.contains(QFileInfo(pluginFile).fileName());
+        });
+    }
 
     int delay = Utils::SettingValue("com.deepin.dde.dock", "/com/deepin/dde/dock/", "delay-plugins-time", 0).toInt();
     QTimer::singleShot(delay, loader, [ = ] { loader->start(QThread::LowestPriority); });
@@ -432,35 +386,26 @@ void DockPluginController::startLoader(PluginLoader *loader)
 void DockPluginController::displayModeChanged()
 {
     const Dock::DisplayMode displayMode = qApp->property(PROP_DISPLAY_MODE).value<Dock::DisplayMode>();
-    const auto inters = m_pluginsMap.keys();
+    const auto inters = m_registry.plugins();
 
     for (auto inter : inters)
-        inter->displayModeChanged(displayMode);
+        timedPluginCall(inter, "displayModeChanged", [ & ] { inter->displayModeChanged(displayMode); });
 }
 
 void DockPluginController::positionChanged()
 {
     const Dock::Position position = qApp->property(PROP_POSITION).value<Dock::Position>();
-    const auto inters = m_pluginsMap.keys();
+    const auto inters = m_registry.plugins();
 
     for (auto inter : inters)
-        inter->positionChanged(position);
+        timedPluginCall(inter, "positionChanged", [ & ] { inter->positionChanged(position); });
 }
 
-void DockPluginController::loadPlugin(const QString &pluginFile)
+void DockPluginController::loadPlugin(const QString &pluginFile, QPluginLoader *pluginLoader)
 {
-    QPluginLoader *pluginLoader = new QPluginLoader(pluginFile, this);
+    // 插件的动态链接和版本校验已经在PluginLoader的工作线程中完成，这里只创建插件实例
+    pluginLoader->setParent(this);
     const QJsonObject &meta = pluginLoader->metaData().value("MetaData").toObject();
-    const QString &pluginApi = meta.value("api").toString();
-    bool pluginIsValid = true;
-    if (pluginApi.isEmpty() || !CompatiblePluginApiList.contains(pluginApi)) {
-        qDebug() << objectName()
-                 << "plugin api version not matched! expect versions:" << CompatiblePluginApiList
-                 << ", got version:" << pluginApi
-                 << ", the plugin file is:" << pluginFile;
-
-        pluginIsValid = false;
-    }
 
     PluginsItemInterface *interface = qobject_cast<PluginsItemInterface *>(pluginLoader->instance());
     if (!interface) {
@@ -482,46 +427,21 @@ void DockPluginController::loadPlugin(const QString &pluginFile)
         pluginLoader->unload();
         pluginLoader->deleteLater();
 
-        pluginIsValid = false;
-    }
-
-    if (!pluginIsValid) {
-        for (auto &pair : m_pluginLoadMap.keys()) {
-            if (pair.first == pluginFile) {
-                m_pluginLoadMap.remove(pair);
-            }
-        }
-        QString notifyMessage(tr("The plugin %1 is not compatible with the system."));
-        Dtk::Core::DUtil::DNotifySender(notifyMessage.arg(QFileInfo(pluginFile).fileName())).appIcon("dialog-warning").call();
+        rejectPlugin(pluginFile);
         return;
     }
 
     if (interface->pluginName() == "multitasking" && (Utils::IS_WAYLAND_DISPLAY || Dtk::Core::DSysInfo::deepinType() == Dtk::Core::DSysInfo::DeepinServer)) {
-        for (auto &pair : m_pluginLoadMap.keys()) {
-            if (pair.first == pluginFile) {
-                m_pluginLoadMap.remove(pair);
-            }
-        }
+        m_registry.removePluginFile(pluginFile);
+        checkLoadFinished();
         return;
     }
 
-    QMapIterator<QPair<QString, PluginsItemInterface *>, bool> it(m_pluginLoadMap);
-    while (it.hasNext()) {
-        it.next();
-        if (it.key().first == pluginFile) {
-            m_pluginLoadMap.remove(it.key());
-            QPair<QString, PluginsItemInterface *> newPair;
-            newPair.first = pluginFile;
-            newPair.second = interface;
-            m_pluginLoadMap.insert(newPair, false);
-            break;
-        }
-    }
+    recordPluginDescriptor(pluginFile, interface);
 
     // 保存 PluginLoader 对象指针
-    QMap<QString, QObject *> interfaceData;
-    interfaceData["pluginloader"] = pluginLoader;
-    m_pluginsMap.insert(interface, interfaceData);
+    m_registry.addPlugin(interface, pluginFile, pluginLoader);
+    PluginCallMonitor::instance()->registerPlugin(interface);
     QString dbusService = meta.value("depends-daemon-dbus-service").toString();
     if (!dbusService.isEmpty() && !m_dbusDaemonInterface->isServiceRegistered(dbusService).value()) {
         qDebug() << objectName() << dbusService << "daemon has not started, waiting for signal";
@@ -544,90 +464,313 @@ void DockPluginController::loadPlugin(const QString &pluginFile)
     QMetaObject::invokeMethod(this, std::bind(&DockPluginController::initPlugin, this, interface), Qt::QueuedConnection);
 }
 
+void DockPluginController::rejectPlugin(const QString &pluginFile)
+{
+    m_registry.removePluginFile(pluginFile);
+    // 被拒绝的插件可能是最后一个等待的插件
+    checkLoadFinished();
+
+    QString notifyMessage(tr("The plugin %1 is not compatible with the system."));
+    Dtk::Core::DUtil::DNotifySender(notifyMessage.arg(QFileInfo(pluginFile).fileName())).appIcon("dialog-warning").call();
+}
+
+void DockPluginController::deferPlugin(const QString &pluginFile, const QJsonObject &descriptor)
+{
+    // 延后加载的插件不参与启动时的加载流程
+    m_registry.removePluginFile(pluginFile);
+
+    qDebug() << objectName() << "defer plugin:" << descriptor.value("name").toString();
+    m_deferredPlugins.insert(pluginFile, descriptor);
+
+    // 加载线程运行期间配置可能已经发生了变化
+    if (!canDeferPlugin(descriptor, DockSettings::instance()->getQuickPlugins()))
+        activateDeferredPlugin(pluginFile);
+
+    checkLoadFinished();
+}
+
+void DockPluginController::isolatePlugin(const QString &pluginFile)
+{
+    RemotePluginProxy *proxy = new RemotePluginProxy(pluginFile, this);
+    connect(proxy, &RemotePluginProxy::ready, this, [ this, proxy ] {
+        const QString &pluginFile = proxy->pluginFile();
+        recordPluginDescriptor(pluginFile, proxy);
+        m_registry.addPlugin(proxy, pluginFile, nullptr);
+        PluginCallMonitor::instance()->registerPlugin(proxy);
+        initPlugin(proxy);
+    });
+    connect(proxy, &RemotePluginProxy::failed, this, [ this, proxy ] {
+        rejectPlugin(proxy->pluginFile());
+        proxy->deleteLater();
+    });
+    connect(proxy, &RemotePluginProxy::hostExited, this, [ this, proxy ] {
+        removeRemotePlugin(proxy);
+    });
+
+    if (!proxy->start()) {
+        delete proxy;
+        rejectPlugin(pluginFile);
+    }
+}
+
+void DockPluginController::removeRemotePlugin(RemotePluginProxy *proxy)
+{
+    // 宿主进程退出后插件从任务栏移除，不影响任务栏和其他插件
+    const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(proxy);
+    if (pluginRecord && pluginRecord->loaded) {
+        for (const QString &itemKey : m_registry.itemKeys(proxy))
+            itemRemoved(proxy, itemKey);
+    }
+
+    m_registry.removePlugin(proxy);
+    PluginCallMonitor::instance()->unregisterPlugin(proxy);
+    proxy->deleteLater();
+}
+
 void DockPluginController::initPlugin(PluginsItemInterface *interface)
 {
-    if (!interface)
+    // 插件可能在队列中等待初始化时已经被卸载
+    if (!interface || !m_registry.contains(interface))
         return;
 
     qDebug() << objectName() << "init plugin: " << interface->pluginName();
-    interface->init(this);
+    timedPluginCall(interface, "init", [ & ] { interface->init(this); });
 
-    for (const auto &pair : m_pluginLoadMap.keys()) {
-        if (pair.second == interface)
-            m_pluginLoadMap.insert(pair, true);
-    }
+    // 延后加载的插件初始化时启动流程早已结束，不再通知
+    if (m_registry.setPluginInited(interface))
+        checkLoadFinished();
 
-    bool loaded = true;
-    for (int i = 0; i < m_pluginLoadMap.keys().size(); ++i) {
-        if (!m_pluginLoadMap.values()[i]) {
-            loaded = false;
-            break;
-        }
-    }
+    qDebug() << objectName() << "init plugin finished: " << interface->pluginName();
+}
+
+void DockPluginController::checkLoadFinished()
+{
+    if (!m_registry.isAllPluginsInited())
+        return;
 
     // 插件全部加载完成
-    if (loaded) {
-        emit pluginLoadFinished();
-    }
-    qDebug() << objectName() << "init plugin finished: " << interface->pluginName();
+    saveMetaDataCaches();
+    for (const QString &pluginDir : m_pluginDirs)
+        m_fileWatcher->addDirectory(pluginDir);
+
+    emit pluginLoadFinished();
+
+    // 延后的插件只是不阻塞启动，部分插件有后台功能(如电量提醒)，空闲时仍然需要加载
+    if (!m_deferredPlugins.isEmpty() && !m_deferredTimer->isActive())
+        m_deferredTimer->start(DeferredActivateDelay);
 }
 
-void DockPluginController::refreshPluginSettings()
+void DockPluginController::activateNextDeferredPlugin()
 {
-    const QString &pluginSettings = DockSettings::instance()->getPluginSettings();
-    if (pluginSettings.isEmpty()) {
-        qDebug() << "Error! get plugin settings from dbus failed!";
+    if (m_deferredPlugins.isEmpty())
         return;
-    }
 
-    const QJsonObject &pluginSettingsObject = QJsonDocument::fromJson(pluginSettings.toLocal8Bit()).object();
-    if (pluginSettingsObject.isEmpty()) {
+    activateDeferredPlugin(m_deferredPlugins.firstKey());
+
+    if (!m_deferredPlugins.isEmpty())
+        m_deferredTimer->start(DeferredActivateInterval);
+}
+
+bool DockPluginController::canDeferPlugin(const QJsonObject &descriptor, const QStringList &config)
+{
+    // 快捷面板插件、托盘插件和强制驻留任务栏的插件始终显示，不能延后加载
+    const PluginFlags flags = static_cast<PluginFlags>(descriptor.value("flags").toInt());
+    if (flags & (PluginFlag::Type_Common | PluginFlag::Type_Tray | PluginFlag::Attribute_ForceDock))
+        return false;
+
+    // 工具、系统和固定区域插件是否显示完全由配置决定
+    if (!(flags & (PluginFlag::Type_Tool | PluginFlag::Type_System | PluginFlag::Type_Fixed)))
+        return false;
+
+    return !config.contains(descriptor.value("name").toString());
+}
+
+void DockPluginController::activateDeferredPlugin(const QString &pluginFile)
+{
+    if (!m_deferredPlugins.contains(pluginFile))
         return;
-    }
 
-    // nothing changed
-    if (pluginSettingsObject == m_pluginSettingsObject) {
+    qDebug() << objectName() << "activate deferred plugin:" << m_deferredPlugins.value(pluginFile).value("name").toString();
+    m_deferredPlugins.remove(pluginFile);
+
+    loadPluginFile(pluginFile);
+}
+
+void DockPluginController::loadPluginFile(const QString &pluginFile)
+{
+    if (DockSettings::instance()->getIsolatedPlugins().contains(QFileInfo(pluginFile).fileName())) {
+        isolatePlugin(pluginFile);
         return;
     }
 
-    for (auto pluginsIt = pluginSettingsObject.constBegin(); pluginsIt != pluginSettingsObject.constEnd(); ++pluginsIt) {
-        const QString &pluginName = pluginsIt.key();
-        const QJsonObject &settingsObject = pluginsIt.value().toObject();
-        QJsonObject newSettingsObject = m_pluginSettingsObject.value(pluginName).toObject();
-        for (auto settingsIt = settingsObject.constBegin(); settingsIt != settingsObject.constEnd(); ++settingsIt) {
-            newSettingsObject.insert(settingsIt.key(), settingsIt.value());
-        }
-        // TODO: remove not exists key-values
-        m_pluginSettingsObject.insert(pluginName, newSettingsObject);
+    // 带有STB_GNU_UNIQUE符号的动态库dlclose后不会真正卸载，用同样的路径dlopen拿到的还是旧的代码，
+    // 卸载过的插件复制到新的路径再加载，复制的路径以原来的路径结尾，插件目录的判断不受影响
+    const int serial = ++m_reloadSerial;
+    QString libraryFile = pluginFile;
+    QString copyDir;
+    if (m_unloadedPluginFiles.contains(pluginFile)) {
+        copyDir = QString("%1/dde-dock-plugin-%2-%3").arg(QDir::tempPath()).arg(QCoreApplication::applicationPid()).arg(serial);
+        libraryFile = copyDir + QFileInfo(pluginFile).absoluteFilePath();
     }
 
-    // not notify plugins to refresh settings if this update is not emit by dock daemon
-    // if (sender() != m_dockDaemonInter) {
-    //     return;
-    // }
+    // 复制文件、动态链接和版本校验在工作线程中执行，和启动时的PluginLoader一样只在主线程创建插件实例
+    m_loadingPlugins.insert(pluginFile, serial);
+    const QString name = objectName();
+    QThread *mainThread = thread();
+    QFutureWatcher<QPluginLoader *> *watcher = new QFutureWatcher<QPluginLoader *>(this);
+    connect(watcher, &QFutureWatcher<QPluginLoader *>::finished, this, [ this, watcher, pluginFile, serial ] {
+        watcher->deleteLater();
+        QPluginLoader *pluginLoader = watcher->result();
+
+        // 加载期间插件文件被删除或再次变化，丢弃这次的结果
+        if (m_loadingPlugins.value(pluginFile) != serial) {
+            if (pluginLoader) {
+                pluginLoader->unload();
+                delete pluginLoader;
+            }
+            return;
+        }
 
-    // notify all plugins to reload plugin settings
-    for (PluginsItemInterface *pluginInter : m_pluginsMap.keys()) {
-        pluginInter->pluginSettingsChanged();
+        m_loadingPlugins.remove(pluginFile);
+        if (!pluginLoader) {
+            rejectPlugin(pluginFile);
+            return;
+        }
+
+        loadPlugin(pluginFile, pluginLoader);
+    });
+    watcher->setFuture(QtConcurrent::run([ name, mainThread, pluginFile, libraryFile, copyDir ]() -> QPluginLoader * {
+        if (!copyDir.isEmpty() && (!QDir().mkpath(QFileInfo(libraryFile).path()) || !QFile::copy(pluginFile, libraryFile))) {
+            qWarning() << name << "copy plugin failed:" << pluginFile << libraryFile;
+            QDir(copyDir).removeRecursively();
+            return nullptr;
+        }
+
+        QPluginLoader *pluginLoader = new QPluginLoader(libraryFile);
+        const QString &pluginApi = pluginLoader->metaData().value("MetaData").toObject().value("api").toString();
+        const bool loaded = PluginLoader::isCompatibleApi(pluginApi) && pluginLoader->load();
+        // 动态库已经映射到内存中，复制的文件可以删除
+        if (!copyDir.isEmpty())
+            QDir(copyDir).removeRecursively();
+
+        if (!loaded) {
+            qWarning() << name << "load plugin failed:" << pluginApi << pluginLoader->errorString() << pluginFile;
+            delete pluginLoader;
+            return nullptr;
+        }
+
+        pluginLoader->moveToThread(mainThread);
+        return pluginLoader;
+    }));
+}
+
+void DockPluginController::unloadPlugin(const QString &pluginFile)
+{
+    PluginsItemInterface *interface = m_registry.pluginByFile(pluginFile);
+    if (!interface)
+        return;
+
+    qDebug() << objectName() << "unload plugin:" << interface->pluginName();
+
+    // 插件的配置保存在任务栏中，重新加载后插件在init中读取原来的配置
+    DockSettings::instance()->pluginSettings()->flush();
+
+    for (const QString &itemKey : m_registry.itemKeys(interface))
+        itemRemoved(interface, itemKey);
+
+    QPluginLoader *pluginLoader = m_registry.record(interface)->pluginLoader;
+    m_registry.removePlugin(interface);
+    m_registry.removePluginFile(pluginFile);
+    PluginCallMonitor::instance()->unregisterPlugin(interface);
+
+    if (RemotePluginProxy *proxy = dynamic_cast<RemotePluginProxy *>(interface)) {
+        delete proxy;
+        return;
     }
 
-    // reload all plugin items for sort order or container
-    QMap<PluginsItemInterface *, QMap<QString, QObject *>> pluginsMapTemp = m_pluginsMap;
-    for (auto it = pluginsMapTemp.constBegin(); it != pluginsMapTemp.constEnd(); ++it) {
-        const QList<QString> &itemKeyList = it.value().keys();
-        for (auto key : itemKeyList) {
-            if (key != "pluginloader") {
-                itemRemoved(it.key(), key);
-            }
+    PluginAdapter *pluginAdapter = dynamic_cast<PluginAdapter *>(interface);
+    if (pluginAdapter) {
+        for (auto it = m_pluginAdapterMap.begin(); it != m_pluginAdapterMap.end();) {
+            if (it.value() == pluginAdapter)
+                it = m_pluginAdapterMap.erase(it);
+            else
+                ++it;
         }
-        for (auto key : itemKeyList) {
-            if (key != "pluginloader") {
-                itemAdded(it.key(), key);
-            }
+    }
+
+    if (pluginLoader)
+        m_unloadedPluginFiles << pluginFile;
+
+    // 包装插件项的窗口在itemRemoved之后可能还在等待deleteLater，删除时还会执行插件的代码，
+    // 排在它们后面再删除插件实例并卸载动态库
+    QObject *unloader = new QObject;
+    connect(unloader, &QObject::destroyed, this, [ this, pluginAdapter, pluginLoader ] {
+        delete pluginAdapter;
+        if (pluginLoader) {
+            if (!pluginLoader->unload())
+                qWarning() << objectName() << "unload plugin failed:" << pluginLoader->errorString();
+            delete pluginLoader;
         }
+    });
+    unloader->deleteLater();
+}
+
+void DockPluginController::recordPluginDescriptor(const QString &pluginFile, PluginsItemInterface *interface)
+{
+    const QSharedPointer<PluginMetaDataCache> &metaDataCache = m_metaDataCaches.value(pluginFile);
+    if (metaDataCache.isNull())
+        return;
+
+    // 下次启动时据此判断插件是否可以延后加载
+    QJsonObject descriptor;
+    descriptor["name"] = interface->pluginName();
+    descriptor["displayName"] = interface->pluginDisplayName();
+    descriptor["flags"] = static_cast<int>(interface->flags());
+    metaDataCache->setDescriptor(pluginFile, descriptor);
+}
+
+void DockPluginController::saveMetaDataCaches()
+{
+    QSet<PluginMetaDataCache *> savedCaches;
+    for (const QSharedPointer<PluginMetaDataCache> &metaDataCache : m_metaDataCaches) {
+        if (savedCaches.contains(metaDataCache.data()))
+            continue;
+
+        savedCaches << metaDataCache.data();
+        metaDataCache->save();
     }
 }
 
+void DockPluginController::refreshPluginSettings(const QJsonObject &oldSettings, const QJsonObject &newSettings)
+{
+    QHash<QString, PluginsItemInterface *> pluginsByName;
+    for (PluginsItemInterface *pluginInter : m_registry.plugins())
+        pluginsByName.insert(pluginInter->pluginName(), pluginInter);
+
+    // 只刷新配置发生变化的插件，避免所有插件项被移除再添加引起的闪烁和重新布局
+    PluginSettingsReconciler reconciler;
+    reconciler.setNotifier([ & ](const QString &pluginName) {
+        if (PluginsItemInterface *pluginInter = pluginsByName.value(pluginName))
+            timedPluginCall(pluginInter, "pluginSettingsChanged", [ & ] { pluginInter->pluginSettingsChanged(); });
+    });
+    reconciler.setItemLoadedChecker([ & ](const QString &pluginName) {
+        const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginsByName.value(pluginName));
+        return pluginRecord && pluginRecord->loaded;
+    });
+    // 配置中可能有已经卸载或者还没有加载的插件，登记表中没有记录
+    reconciler.setItemRemover([ & ](const QString &pluginName) {
+        PluginsItemInterface *pluginInter = pluginsByName.value(pluginName);
+        if (const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginInter))
+            itemRemoved(pluginInter, pluginRecord->itemKey);
+    });
+    reconciler.setItemAdder([ & ](const QString &pluginName) {
+        PluginsItemInterface *pluginInter = pluginsByName.value(pluginName);
+        if (const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(pluginInter))
+            itemAdded(pluginInter, pluginRecord->itemKey);
+    });
+    reconciler.reconcile(oldSettings, newSettings);
+}
+
 bool DockPluginController::eventFilter(QObject *object, QEvent *event)
 {
     if (object != qApp || event->type() != QEvent::DynamicPropertyChange)
@@ -659,17 +802,12 @@ bool DockPluginController::pluginCanDock(const QStringList &config, PluginsItemI
         return true;
 
     // 3、如果该插件并未加载（未调用itemAdde或已经调用itemRemoved)，则该插件不显示
-    if (!m_pluginsMap.contains(plugin))
+    const PluginRegistry::PluginRecord *pluginRecord = m_registry.record(plugin);
+    if (!pluginRecord)
         return false;
 
-    const QMap<QString, QObject *> &pluginMap = m_pluginsMap[plugin];
-    // 如果不包含PLUGININFO，说明该插件从未调用itemAdded方法，无需加载
-    if (!pluginMap.contains(PLUGININFO))
-        return false;
-
-    // 如果该插件信息的m_loaded为true,说明已经调用过itemAdded方法，并且之后又调用了itemRemoved方法,则插件也无需加载
-    PluginInfo *pluginInfo = static_cast<PluginInfo *>(pluginMap[PLUGININFO]);
-    if (!pluginInfo->m_loaded)
+    // 从未调用itemAdded方法，或者调用过itemAdded方法之后又调用了itemRemoved方法，则插件无需加载
+    if (!pluginRecord->loaded)
         return false;
 
     // 4、插件已经驻留在任务栏，则始终显示
@@ -682,8 +820,22 @@ void DockPluginController::updateDockInfo(PluginsItemInterface * const itemInter
     Q_EMIT pluginUpdated(itemInter, part);
 }
 
+void DockPluginController::onItemObjectDestroyed(QObject *object)
+{
+    m_registry.unbindObject(object);
+}
+
 void DockPluginController::onConfigChanged(const QStringList &pluginNames)
 {
+    // 延后加载的插件需要显示时再加载，初始化后在itemAdded中根据配置添加到任务栏
+    QStringList activateFiles;
+    for (auto it = m_deferredPlugins.constBegin(); it != m_deferredPlugins.constEnd(); ++it) {
+        if (!canDeferPlugin(it.value(), pluginNames))
+            activateFiles << it.key();
+    }
+    for (const QString &pluginFile : activateFiles)
+        activateDeferredPlugin(pluginFile);
+
     // 这里只处理工具插件(回收站)和系统插件(电源插件)
     for (PluginsItemInterface *plugin : plugins()) {
         QString itemKey = this->itemKey(plugin);
@@ -691,7 +843,7 @@ void DockPluginController::onConfigChanged(const QStringList &pluginNames)
         if (!canDock && isPluginLoaded(plugin)) {
             // 如果当前配置中不包含当前插件，但是当前插件已经加载，那么就移除该插件
             removePluginItem(plugin, itemKey);
-            QWidget *itemWidget = plugin->itemWidget(itemKey);
+            QWidget *itemWidget = timedPluginCall(plugin, "itemWidget", [ & ] { return plugin->itemWidget(itemKey); });
             if (itemWidget)
                 itemWidget->setVisible(false);
         } else if (canDock && !isPluginLoaded(plugin)) {
@@ -704,10 +856,54 @@ void DockPluginController::onConfigChanged(const QStringList &pluginNames)
             addPluginItem(plugin, itemKey);
             // 工具|固定区域 插件是通过QWidget的方式进行显示的
             if (plugin->flags() & (PluginFlag::Type_Tool | PluginFlag::Type_Fixed)) {
-                QWidget *itemWidget = plugin->itemWidget(itemKey);
+                QWidget *itemWidget = timedPluginCall(plugin, "itemWidget", [ & ] { return plugin->itemWidget(itemKey); });
                 if (itemWidget)
                     itemWidget->setVisible(true);
             }
         }
     }
 }
+
+void DockPluginController::onPluginFileAdded(const QString &pluginFile)
+{
+    if (m_registry.pluginByFile(pluginFile) || m_deferredPlugins.contains(pluginFile) || m_loadingPlugins.contains(pluginFile))
+        return;
+
+    if (!PluginLoader::isPluginFileAccepted(QFileInfo(pluginFile).fileName(), PluginLoader::disabledPlugins()))
+        return;
+
+    qDebug() << objectName() << "plugin file added:" << pluginFile;
+    loadPluginFile(pluginFile);
+}
+
+void DockPluginController::onPluginFileChanged(const QString &pluginFile)
+{
+    // 延后加载的插件在需要显示时直接加载新的文件
+    if (m_deferredPlugins.contains(pluginFile))
+        return;
+
+    // 正在加载的插件可能已经打开了旧的文件，重新从复制的文件加载，旧的结果会被丢弃
+    if (m_loadingPlugins.contains(pluginFile)) {
+        qDebug() << objectName() << "reload loading plugin:" << pluginFile;
+        m_unloadedPluginFiles << pluginFile;
+        loadPluginFile(pluginFile);
+        return;
+    }
+
+    // 之前加载失败的插件按新增的插件处理
+    if (!m_registry.pluginByFile(pluginFile)) {
+        onPluginFileAdded(pluginFile);
+        return;
+    }
+
+    qDebug() << objectName() << "reload plugin:" << pluginFile;
+    unloadPlugin(pluginFile);
+    loadPluginFile(pluginFile);
+}
+
+void DockPluginController::onPluginFileRemoved(const QString &pluginFile)
+{
+    m_deferredPlugins.remove(pluginFile);
+    m_loadingPlugins.remove(pluginFile);
+    unloadPlugin(pluginFile);
+}
@@ -8,14 +8,20 @@
 
 #include "pluginproxyinterface.h"
 #include "pluginloader.h"
+#include "pluginregistry.h"
 #include "dbusutil.h"
 
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QDBusConnectionInterface>
 
 class PluginsItemInterface;
 class PluginAdapter;
+class RemotePluginProxy;
+class PluginFileWatcher;
+class QPluginLoader;
+class QTimer;
 
 class DockPluginController : public QObject, protected PluginProxyInterface
 {
@@ -73,27 +79,56 @@ private:
     void addPluginItem(PluginsItemInterface * const itemInter, const QString &itemKey);
     void removePluginItem(PluginsItemInterface * const itemInter, const QString &itemKey);
 
+    static bool canDeferPlugin(const QJsonObject &descriptor, const QStringList &config);
+    void activateDeferredPlugin(const QString &pluginFile);
+    void loadPluginFile(const QString &pluginFile);
+    void unloadPlugin(const QString &pluginFile);
+    void recordPluginDescriptor(const QString &pluginFile, PluginsItemInterface *interface);
+    void saveMetaDataCaches();
+    void checkLoadFinished();
+
 private Q_SLOTS:
     void startLoader(PluginLoader *loader);
     void displayModeChanged();
     void positionChanged();
-    void loadPlugin(const QString &pluginFile);
+    void loadPlugin(const QString &pluginFile, QPluginLoader *pluginLoader);
+    void rejectPlugin(const QString &pluginFile);
+    void deferPlugin(const QString &pluginFile, const QJsonObject &descriptor);
+    void isolatePlugin(const QString &pluginFile);
+    void removeRemotePlugin(RemotePluginProxy *proxy);
     void initPlugin(PluginsItemInterface *interface);
-    void refreshPluginSettings();
+    void activateNextDeferredPlugin();
+    void refreshPluginSettings(const QJsonObject &oldSettings, const QJsonObject &newSettings);
     void onConfigChanged(const QStringList &pluginNames);
+    void onItemObjectDestroyed(QObject *object);
+    void onPluginFileAdded(const QString &pluginFile);
+    void onPluginFileChanged(const QString &pluginFile);
+    void onPluginFileRemoved(const QString &pluginFile);
 
 private:
     QDBusConnectionInterface *m_dbusDaemonInterface;
 
-    // interface,  "pluginloader", PluginLoader指针对象
-    QMap<PluginsItemInterface *, QMap<QString, QObject *>> m_pluginsMap;
+    // 插件、插件项和插件文件加载状态的登记表
+    PluginRegistry m_registry;
 
-    // filepath, interface, loaded
-    QMap<QPair<QString, PluginsItemInterface *>, bool> m_pluginLoadMap;
+    // filepath, 延后加载的插件的描述信息
+    QMap<QString, QJsonObject> m_deferredPlugins;
+    // 启动完成后空闲时逐个加载延后的插件，恢复插件的后台功能
+    QTimer *m_deferredTimer;
+    // filepath, 插件所在目录的元数据缓存
+    QMap<QString, QSharedPointer<PluginMetaDataCache>> m_metaDataCaches;
 
-    QJsonObject m_pluginSettingsObject;
     QMap<qulonglong, PluginAdapter *> m_pluginAdapterMap;
 
+    // 启动加载完成后监视插件目录，插件文件变化时只重新加载对应的插件
+    QStringList m_pluginDirs;
+    PluginFileWatcher *m_fileWatcher;
+    // 卸载过的插件文件，再次加载时从复制的文件加载
+    QSet<QString> m_unloadedPluginFiles;
+    int m_reloadSerial;
+    // filepath, 正在工作线程中加载的插件及其序号，序号不一致的加载结果被丢弃
+    QMap<QString, int> m_loadingPlugins;
+
     PluginProxyInterface *m_proxyInter;
 };
 
@@ -5,6 +5,7 @@
 
 #include "largerquickitem.h"
 #include "pluginsiteminterface.h"
+#include "plugincallmonitor.h"
 
 #include <DFontSizeManager>
 #include <DGuiApplicationHelper>
@@ -80,13 +81,13 @@ bool LargerQuickItem::eventFilter(QObject *obj, QEvent *event)
         }
         if (obj->objectName() == "expandLabel") {
             // 如果是鼠标的按下事件
-            QWidget *widget = pluginItem()->itemPopupApplet(QUICK_ITEM_KEY);
+            QWidget *widget = timedPluginCall(pluginItem(), "itemPopupApplet", [ this ] { return pluginItem()->itemPopupApplet(QUICK_ITEM_KEY); });
             if (widget)
                 Q_EMIT requestShowChildWidget(widget);
             break;
         }
         if (obj == this) {
-            QStringList commandArgumend = pluginItem()->itemCommand(itemKey()).split(" ");
+            QStringList commandArgumend = timedPluginCall(pluginItem(), "itemCommand", [ this ] { return pluginItem()->itemCommand(itemKey()); }).split(" ");
             if (commandArgumend.size() == 0)
                 break;
 
@@ -276,7 +277,7 @@ QColor QuickIconWidget::foregroundColor() const
 
 QPixmap QuickIconWidget::pluginIcon(bool contailGrab) const
 {
-    QIcon icon = m_pluginInter->icon(DockPart::QuickPanel);
+    QIcon icon = timedPluginCall(m_pluginInter, "icon", [ this ] { return m_pluginInter->icon(DockPart::QuickPanel); });
     if (icon.isNull() && contailGrab) {
         // 如果图标为空，就使用itemWidget的截图作为它的图标，这种一般是适用于老版本插件或者没有实现v23接口的插件
         QWidget *itemWidget = m_pluginInter->itemWidget(m_itemKey);
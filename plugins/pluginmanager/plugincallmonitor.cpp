@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "plugincallmonitor.h"
+#include "pluginsiteminterface.h"
+
+#include <QDBusConnection>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDebug>
+
+#define DBUS_PATH "/org/deepin/dde/Dock1/PluginCalls"
+#define DEFAULT_BUDGET 100
+
+PluginCallMonitor::PluginCallMonitor(QObject *parent)
+    : QObject(parent)
+    , m_budget(DEFAULT_BUDGET)
+{
+}
+
+PluginCallMonitor *PluginCallMonitor::instance()
+{
+    static PluginCallMonitor instance;
+    return &instance;
+}
+
+bool PluginCallMonitor::registerOnBus(QDBusConnection connection)
+{
+    return connection.registerObject(DBUS_PATH, this, QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportAllProperties);
+}
+
+void PluginCallMonitor::registerPlugin(PluginsItemInterface *plugin)
+{
+    if (plugin)
+        m_pluginNames.insert(plugin, plugin->pluginName());
+}
+
+void PluginCallMonitor::unregisterPlugin(PluginsItemInterface *plugin)
+{
+    m_pluginNames.remove(plugin);
+}
+
+void PluginCallMonitor::record(PluginsItemInterface *plugin, const char *method, qint64 nsecs)
+{
+    if (!plugin)
+        return;
+
+    auto it = m_pluginNames.constFind(plugin);
+    // 没有登记的插件(如快捷面板中转的插件)才调用pluginName
+    record(it != m_pluginNames.constEnd() ? it.value() : plugin->pluginName(), QString::fromLatin1(method), nsecs);
+}
+
+void PluginCallMonitor::record(const QString &pluginName, const QString &method, qint64 nsecs)
+{
+    const qint64 usecs = nsecs / 1000;
+
+    CallStats &stats = m_stats[pluginName][method];
+    ++stats.count;
+    stats.totalUsecs += usecs;
+    stats.maxUsecs = qMax(stats.maxUsecs, usecs);
+    ++stats.buckets[bucketIndex(usecs)];
+
+    const qint64 msecs = usecs / 1000;
+    if (m_budget > 0 && msecs > m_budget) {
+        qWarning() << "plugin call exceeded budget:" << pluginName << method << msecs << "ms, budget:" << m_budget << "ms";
+        Q_EMIT budgetExceeded(pluginName, method, msecs);
+    }
+}
+
+int PluginCallMonitor::budget() const
+{
+    return m_budget;
+}
+
+void PluginCallMonitor::setBudget(int msec)
+{
+    m_budget = msec;
+}
+
+QJsonObject PluginCallMonitor::statistics() const
+{
+    QJsonObject plugins;
+    for (auto pluginIt = m_stats.constBegin(); pluginIt != m_stats.constEnd(); ++pluginIt) {
+        QJsonObject methods;
+        for (auto methodIt = pluginIt.value().constBegin(); methodIt != pluginIt.value().constEnd(); ++methodIt) {
+            const CallStats &stats = methodIt.value();
+            QJsonArray buckets;
+            for (int i = 0; i < BucketCount; ++i)
+                buckets << double(stats.buckets[i]);
+
+            QJsonObject methodObject;
+            methodObject["count"] = double(stats.count);
+            methodObject["totalUsecs"] = double(stats.totalUsecs);
+            methodObject["maxUsecs"] = double(stats.maxUsecs);
+            methodObject["buckets"] = buckets;
+            methods[methodIt.key()] = methodObject;
+        }
+        plugins[pluginIt.key()] = methods;
+    }
+
+    QJsonArray bounds;
+    for (int i = 0; i < BucketCount - 1; ++i)
+        bounds << (1 << i);
+
+    QJsonObject statistics;
+    statistics["budgetMsecs"] = m_budget;
+    statistics["bucketBoundsMsecs"] = bounds;
+    statistics["plugins"] = plugins;
+    return statistics;
+}
+
+int PluginCallMonitor::bucketIndex(qint64 usecs)
+{
+    // 第i个区间记录耗时不超过2^i毫秒的调用
+    int index = 0;
+    qint64 bound = 1000;
+    while (index < BucketCount - 1 && usecs > bound) {
+        bound *= 2;
+        ++index;
+    }
+
+    return index;
+}
+
+QString PluginCallMonitor::Statistics() const
+{
+    return QString::fromUtf8(QJsonDocument(statistics()).toJson(QJsonDocument::Compact));
+}
+
+void PluginCallMonitor::Reset()
+{
+    m_stats.clear();
+}
+
+PluginCallTimer::PluginCallTimer(PluginsItemInterface *plugin, const char *method)
+    : m_plugin(plugin)
+    , m_method(method)
+{
+    m_timer.start();
+}
+
+PluginCallTimer::~PluginCallTimer()
+{
+    PluginCallMonitor::instance()->record(m_plugin, m_method, m_timer.nsecsElapsed());
+}
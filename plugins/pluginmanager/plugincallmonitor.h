@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINCALLMONITOR_H
+#define PLUGINCALLMONITOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+
+class PluginsItemInterface;
+class QDBusConnection;
+
+/**
+ * @brief PluginCallMonitor 统计任务栏调用插件接口的耗时
+ * 插件接口都在主线程中同步调用，某个插件阻塞时整个任务栏都会卡住，
+ * 这里按插件和接口记录调用次数、耗时和耗时分布，单次调用超过设定的上限时输出带插件名的警告，
+ * 统计结果通过DBus接口org.deepin.dde.Dock1.PluginCalls提供给调试工具
+ */
+class PluginCallMonitor : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.Dock1.PluginCalls")
+    Q_PROPERTY(int Budget READ budget WRITE setBudget)
+
+public:
+    // 耗时分布的区间上限(毫秒)为1,2,4...1024，最后一个区间记录超过1024毫秒的调用
+    enum { BucketCount = 12 };
+
+    static PluginCallMonitor *instance();
+
+    bool registerOnBus(QDBusConnection connection);
+
+    // 加载插件时记录插件名，计时时不再调用插件的虚函数
+    void registerPlugin(PluginsItemInterface *plugin);
+    void unregisterPlugin(PluginsItemInterface *plugin);
+
+    void record(PluginsItemInterface *plugin, const char *method, qint64 nsecs);
+    void record(const QString &pluginName, const QString &method, qint64 nsecs);
+
+    int budget() const;
+    void setBudget(int msec);
+
+    QJsonObject statistics() const;
+    static int bucketIndex(qint64 usecs);
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString Statistics() const;
+    Q_SCRIPTABLE void Reset();
+
+Q_SIGNALS:
+    void budgetExceeded(const QString &pluginName, const QString &method, qint64 msec);
+
+private:
+    explicit PluginCallMonitor(QObject *parent = nullptr);
+
+private:
+    struct CallStats {
+        quint64 count = 0;
+        qint64 totalUsecs = 0;
+        qint64 maxUsecs = 0;
+        quint64 buckets[BucketCount] = {};
+    };
+
+    int m_budget;                                               // 单次调用的耗时上限(毫秒)，小于等于0时不检查
+    QHash<PluginsItemInterface *, QString> m_pluginNames;       // 插件 -> 插件名
+    QHash<QString, QHash<QString, CallStats>> m_stats;          // 插件名 -> (接口 -> 统计)
+};
+
+/**
+ * @brief PluginCallTimer 在作用域内记录一次插件接口调用的耗时
+ */
+class PluginCallTimer
+{
+public:
+    PluginCallTimer(PluginsItemInterface *plugin, const char *method);
+    ~PluginCallTimer();
+
+private:
+    Q_DISABLE_COPY(PluginCallTimer)
+
+    PluginsItemInterface *m_plugin;
+    const char *m_method;
+    QElapsedTimer m_timer;
+};
+
+// 调用插件接口并记录耗时，例如 timedPluginCall(plugin, "itemWidget", [ & ] { return plugin->itemWidget(itemKey); })
+template<typename Func>
+inline auto timedPluginCall(PluginsItemInterface *plugin, const char *method, Func func) -> decltype(func())
+{
+    PluginCallTimer callTimer(plugin, method);
+    return func();
+}
+
+#endif // PLUGINCALLMONITOR_H
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginhostchannel.h"
+
+#include <QLocalSocket>
+#include <QtEndian>
+#include <QDebug>
+
+// 单条消息的长度上限，图像数据不经过套接字，正常的消息远小于这个值
+#define MAX_MESSAGE_SIZE (4 * 1024 * 1024)
+
+PluginHostChannel::PluginHostChannel(QLocalSocket *socket, QObject *parent)
+    : QObject(parent)
+    , m_socket(socket)
+{
+    connect(m_socket, &QLocalSocket::readyRead, this, &PluginHostChannel::onReadyRead);
+    connect(m_socket, &QLocalSocket::disconnected, this, &PluginHostChannel::disconnected);
+}
+
+QLocalSocket *PluginHostChannel::socket() const
+{
+    return m_socket;
+}
+
+void PluginHostChannel::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+
+    while (m_buffer.size() >= int(sizeof(quint32))) {
+        const quint32 length = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(m_buffer.constData()));
+        if (length == 0 || length > MAX_MESSAGE_SIZE) {
+            qWarning() << "invalid plugin host message, length:" << length;
+            m_buffer.clear();
+            m_socket->abort();
+            return;
+        }
+
+        if (m_buffer.size() < int(sizeof(quint32) + length))
+            return;
+
+        const QByteArray payload = m_buffer.mid(sizeof(quint32), length);
+        m_buffer.remove(0, sizeof(quint32) + length);
+
+        const MessageType type = static_cast<MessageType>(quint8(payload.at(0)));
+        Q_EMIT messageReceived(type, payload.mid(1));
+    }
+}
+
+void PluginHostChannel::write(const QByteArray &payload)
+{
+    if (m_socket->state() != QLocalSocket::ConnectedState)
+        return;
+
+    uchar header[sizeof(quint32)];
+    qToBigEndian<quint32>(quint32(payload.size()), header);
+    m_socket->write(reinterpret_cast<const char *>(header), sizeof(header));
+    m_socket->write(payload);
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINHOSTCHANNEL_H
+#define PLUGINHOSTCHANNEL_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QDataStream>
+
+class QLocalSocket;
+
+/**
+ * @brief PluginHostChannel 任务栏和插件宿主进程之间的通信通道
+ * 基于本地套接字，每条消息为4字节长度加上QDataStream序列化的内容，内容的第一个字段为消息类型，
+ * 插件项的图像通过共享内存传递，消息中只包含共享内存的key和图像的格式
+ */
+class PluginHostChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum MessageType : quint8 {
+        // 宿主进程 -> 任务栏
+        Hello = 1,              // pluginName, displayName, flags, type, sizePolicy
+        ItemAdded,              // itemKey
+        ItemUpdate,             // itemKey
+        ItemRemoved,            // itemKey
+        ItemImage,              // itemKey, shmKey, size, bytesPerLine, devicePixelRatio
+        SaveValue,              // key, value
+        RemoveValue,            // keys
+        RequestAppletVisible,   // itemKey, visible
+        Pong,                   // 回复Ping
+
+        // 任务栏 -> 宿主进程
+        Init = 64,              // settings, displayMode, position
+        SettingsChanged,        // settings
+        DisplayModeChanged,     // displayMode
+        PositionChanged,        // position
+        ItemResize,             // itemKey, size
+        ItemMouseEvent,         // itemKey, eventType, pos, button, buttons, modifiers
+        Ping,                   // 检查宿主进程的主线程是否阻塞
+    };
+
+    enum { StreamVersion = QDataStream::Qt_5_11 };
+
+    // socket由调用者创建，通道不持有socket
+    explicit PluginHostChannel(QLocalSocket *socket, QObject *parent = nullptr);
+
+    QLocalSocket *socket() const;
+
+    template<typename... Args>
+    void send(MessageType type, const Args &...args)
+    {
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(StreamVersion);
+        stream << quint8(type);
+        (stream << ... << args);
+        write(payload);
+    }
+
+Q_SIGNALS:
+    // body为去掉类型字段后的内容，使用StreamVersion版本的QDataStream读取
+    void messageReceived(PluginHostChannel::MessageType type, const QByteArray &body);
+    void disconnected();
+
+private Q_SLOTS:
+    void onReadyRead();
+
+private:
+    void write(const QByteArray &payload);
+
+private:
+    QLocalSocket *m_socket;
+    QByteArray m_buffer;
+};
+
+#endif // PLUGINHOSTCHANNEL_H
@@ -7,6 +7,7 @@
 #include "dockplugincontroller.h"
 #include "quicksettingcontainer.h"
 #include "iconmanager.h"
+#include "plugincallmonitor.h"
 
 #include <QResizeEvent>
 
@@ -41,7 +42,7 @@ void PluginManager::init(PluginProxyInterface *proxyInter)
 
     connect(m_dockController.data(), &DockPluginController::requestAppletVisible, this, [ this ](PluginsItemInterface *itemInter, const QString &itemKey, bool visible) {
         if (visible) {
-            QWidget *appletWidget = itemInter->itemPopupApplet(itemKey);
+            QWidget *appletWidget = timedPluginCall(itemInter, "itemPopupApplet", [ & ] { return itemInter->itemPopupApplet(itemKey); });
             if (appletWidget)
                 m_quickContainer->showPage(appletWidget, itemInter);
         } else {
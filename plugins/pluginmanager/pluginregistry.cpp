@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginregistry.h"
+
+#include <QPluginLoader>
+
+void PluginRegistry::addPluginFile(const QString &pluginFile)
+{
+    if (m_fileStates.contains(pluginFile))
+        return;
+
+    m_fileStates.insert(pluginFile, FileState());
+    ++m_pendingCount;
+}
+
+void PluginRegistry::removePluginFile(const QString &pluginFile)
+{
+    auto it = m_fileStates.find(pluginFile);
+    if (it == m_fileStates.end())
+        return;
+
+    if (!it.value().inited)
+        --m_pendingCount;
+
+    m_fileStates.erase(it);
+}
+
+bool PluginRegistry::containsPluginFile(const QString &pluginFile) const
+{
+    return m_fileStates.contains(pluginFile);
+}
+
+bool PluginRegistry::setPluginInited(PluginsItemInterface *interface)
+{
+    const PluginRecord *pluginRecord = record(interface);
+    if (!pluginRecord)
+        return false;
+
+    auto it = m_fileStates.find(pluginRecord->pluginFile);
+    if (it == m_fileStates.end() || it.value().interface != interface)
+        return false;
+
+    setFileInited(it.value(), true);
+    return true;
+}
+
+bool PluginRegistry::isAllPluginsInited() const
+{
+    return m_pendingCount == 0;
+}
+
+void PluginRegistry::addPlugin(PluginsItemInterface *interface, const QString &pluginFile, QPluginLoader *pluginLoader)
+{
+    if (!m_records.contains(interface))
+        m_plugins << interface;
+
+    PluginRecord &pluginRecord = m_records[interface];
+    pluginRecord.pluginFile = pluginFile;
+    m_fileIndex.insert(pluginFile, interface);
+    pluginRecord.pluginLoader = pluginLoader;
+
+    // 启动时等待的插件文件在这里关联到插件，重新开始等待初始化
+    auto it = m_fileStates.find(pluginFile);
+    if (it != m_fileStates.end()) {
+        it.value().interface = interface;
+        setFileInited(it.value(), false);
+    }
+
+    if (pluginLoader)
+        m_objectIndex.insert(pluginLoader, ItemRef(interface, QString()));
+}
+
+void PluginRegistry::removePlugin(PluginsItemInterface *interface)
+{
+    auto recordIt = m_records.find(interface);
+    if (recordIt == m_records.end())
+        return;
+
+    for (auto it = m_itemObjects.begin(); it != m_itemObjects.end();) {
+        if (it.key().first == interface) {
+            m_objectIndex.remove(it.value());
+            it = m_itemObjects.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const QString &itemKey : recordIt.value().itemKeys)
+        removeItemKey(interface, itemKey);
+
+    if (recordIt.value().pluginLoader)
+        m_objectIndex.remove(recordIt.value().pluginLoader);
+
+    if (m_fileIndex.value(recordIt.value().pluginFile) == interface)
+        m_fileIndex.remove(recordIt.value().pluginFile);
+
+    m_records.erase(recordIt);
+    m_plugins.removeOne(interface);
+}
+
+bool PluginRegistry::contains(PluginsItemInterface *interface) const
+{
+    return m_records.contains(interface);
+}
+
+PluginRegistry::PluginRecord *PluginRegistry::record(PluginsItemInterface *interface)
+{
+    auto it = m_records.find(interface);
+    return it == m_records.end() ? nullptr : &it.value();
+}
+
+const PluginRegistry::PluginRecord *PluginRegistry::record(PluginsItemInterface *interface) const
+{
+    auto it = m_records.constFind(interface);
+    return it == m_records.constEnd() ? nullptr : &it.value();
+}
+
+QList<PluginsItemInterface *> PluginRegistry::plugins() const
+{
+    return m_plugins;
+}
+
+PluginsItemInterface *PluginRegistry::pluginByFile(const QString &pluginFile) const
+{
+    return m_fileIndex.value(pluginFile);
+}
+
+void PluginRegistry::bindItem(PluginsItemInterface *interface, const QString &itemKey, QObject *itemObject)
+{
+    auto recordIt = m_records.find(interface);
+    if (recordIt == m_records.end())
+        return;
+
+    if (!recordIt.value().itemKeys.contains(itemKey)) {
+        recordIt.value().itemKeys << itemKey;
+        m_itemKeyIndex[itemKey] << interface;
+    }
+
+    const ItemRef key(interface, itemKey);
+    QObject *oldObject = m_itemObjects.value(key);
+    if (oldObject == itemObject)
+        return;
+
+    if (oldObject)
+        m_objectIndex.remove(oldObject);
+
+    if (itemObject) {
+        m_itemObjects.insert(key, itemObject);
+        m_objectIndex.insert(itemObject, key);
+    } else {
+        m_itemObjects.remove(key);
+    }
+}
+
+void PluginRegistry::unbindItem(PluginsItemInterface *interface, const QString &itemKey)
+{
+    auto recordIt = m_records.find(interface);
+    if (recordIt != m_records.end() && recordIt.value().itemKeys.removeOne(itemKey))
+        removeItemKey(interface, itemKey);
+
+    QObject *itemObject = m_itemObjects.take(ItemRef(interface, itemKey));
+    if (itemObject)
+        m_objectIndex.remove(itemObject);
+}
+
+void PluginRegistry::unbindObject(QObject *itemObject)
+{
+    auto it = m_objectIndex.find(itemObject);
+    if (it == m_objectIndex.end())
+        return;
+
+    auto itemIt = m_itemObjects.find(it.value());
+    if (itemIt != m_itemObjects.end() && itemIt.value() == itemObject)
+        m_itemObjects.erase(itemIt);
+
+    m_objectIndex.erase(it);
+}
+
+/**
+ * @brief PluginRegistry::pluginByItemKey 多个插件使用同一个key时返回最先添加的插件
+ */
+PluginsItemInterface *PluginRegistry::pluginByItemKey(const QString &itemKey) const
+{
+    auto it = m_itemKeyIndex.constFind(itemKey);
+    return (it == m_itemKeyIndex.constEnd() || it.value().isEmpty()) ? nullptr : it.value().first();
+}
+
+QStringList PluginRegistry::itemKeys(PluginsItemInterface *interface) const
+{
+    const PluginRecord *pluginRecord = record(interface);
+    return pluginRecord ? pluginRecord->itemKeys : QStringList();
+}
+
+PluginsItemInterface *PluginRegistry::pluginByObject(QObject *object) const
+{
+    auto it = m_objectIndex.constFind(object);
+    return it == m_objectIndex.constEnd() ? nullptr : it.value().first;
+}
+
+QObject *PluginRegistry::itemObject(PluginsItemInterface *interface, const QString &itemKey) const
+{
+    return m_itemObjects.value(ItemRef(interface, itemKey));
+}
+
+void PluginRegistry::removeItemKey(PluginsItemInterface *interface, const QString &itemKey)
+{
+    auto it = m_itemKeyIndex.find(itemKey);
+    if (it == m_itemKeyIndex.end())
+        return;
+
+    it.value().removeOne(interface);
+    if (it.value().isEmpty())
+        m_itemKeyIndex.erase(it);
+}
+
+void PluginRegistry::setFileInited(FileState &state, bool inited)
+{
+    if (state.inited == inited)
+        return;
+
+    state.inited = inited;
+    m_pendingCount += inited ? -1 : 1;
+}
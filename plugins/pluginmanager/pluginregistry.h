@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef PLUGINREGISTRY_H
+#define PLUGINREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+class PluginsItemInterface;
+class QPluginLoader;
+class QObject;
+
+/**
+ * @brief PluginRegistry 已加载插件的登记表
+ * 替代原来嵌套的QMap，按插件接口保存插件信息，同时维护插件项key、插件项对象和插件文件到插件的哈希索引，
+ * 插件项的增删、更新以及拖拽过程中的查找都是O(1)，不再遍历所有插件
+ */
+class PluginRegistry
+{
+public:
+    struct PluginRecord {
+        QString pluginFile;
+        QPluginLoader *pluginLoader = nullptr;
+        bool added = false;         // 插件是否调用过itemAdded方法
+        bool loaded = false;        // 调用itemAdded后为true，调用itemRemoved后为false
+        bool visible = false;       // 是否在任务栏显示
+        QString itemKey;
+        QStringList itemKeys;       // 插件所有的插件项，按添加顺序
+    };
+
+    // 启动时需要等待初始化的插件文件
+    void addPluginFile(const QString &pluginFile);
+    void removePluginFile(const QString &pluginFile);
+    bool containsPluginFile(const QString &pluginFile) const;
+    // 标记插件已经初始化，插件不是启动时加载的返回false
+    bool setPluginInited(PluginsItemInterface *interface);
+    bool isAllPluginsInited() const;
+
+    void addPlugin(PluginsItemInterface *interface, const QString &pluginFile, QPluginLoader *pluginLoader);
+    void removePlugin(PluginsItemInterface *interface);
+    bool contains(PluginsItemInterface *interface) const;
+    PluginRecord *record(PluginsItemInterface *interface);
+    const PluginRecord *record(PluginsItemInterface *interface) const;
+    QList<PluginsItemInterface *> plugins() const;
+    PluginsItemInterface *pluginByFile(const QString &pluginFile) const;
+
+    // 插件项(itemKey及其对应的窗口对象)的索引
+    void bindItem(PluginsItemInterface *interface, const QString &itemKey, QObject *itemObject);
+    void unbindItem(PluginsItemInterface *interface, const QString &itemKey);
+    void unbindObject(QObject *itemObject);
+    PluginsItemInterface *pluginByItemKey(const QString &itemKey) const;
+    QStringList itemKeys(PluginsItemInterface *interface) const;
+    PluginsItemInterface *pluginByObject(QObject *object) const;
+    QObject *itemObject(PluginsItemInterface *interface, const QString &itemKey) const;
+
+private:
+    struct FileState {
+        PluginsItemInterface *interface = nullptr;
+        bool inited = false;
+    };
+
+    typedef QPair<PluginsItemInterface *, QString> ItemRef;
+
+    void removeItemKey(PluginsItemInterface *interface, const QString &itemKey);
+    void setFileInited(FileState &state, bool inited);
+
+private:
+    QList<PluginsItemInterface *> m_plugins;                                // 按加载顺序保存
+    QHash<PluginsItemInterface *, PluginRecord> m_records;
+    QHash<QString, FileState> m_fileStates;                                 // 插件文件 -> 加载状态
+    QHash<QString, PluginsItemInterface *> m_fileIndex;                     // 插件文件 -> 插件
+    int m_pendingCount = 0;                                                 // 还未初始化的插件文件个数
+    QHash<QString, QList<PluginsItemInterface *>> m_itemKeyIndex;           // itemKey -> 使用这个key的插件，不同插件的key可能相同
+    QHash<QObject *, ItemRef> m_objectIndex;                                // 插件项对象 -> (插件, itemKey)
+    QHash<ItemRef, QObject *> m_itemObjects;                                // (插件, itemKey) -> 插件项对象
+};
+
+#endif // PLUGINREGISTRY_H
@@ -0,0 +1,419 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "remotepluginproxy.h"
+#include "docksettings.h"
+#include "pluginsettingsstore.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QProcess>
+#include <QSharedMemory>
+#include <QTimer>
+#include <QDebug>
+
+// 宿主进程启动并加载插件的最长等待时间
+#define HELLO_TIMEOUT 5000
+#define QUIT_TIMEOUT 1000
+// 宿主进程在一个间隔内没有回复Ping时认为插件已经阻塞
+#define PING_INTERVAL 3000
+
+RemoteItemWidget::RemoteItemWidget(const QString &itemKey, QWidget *parent)
+    : QWidget(parent)
+    , m_itemKey(itemKey)
+    , m_sharedMemory(nullptr)
+{
+    setMouseTracking(true);
+}
+
+RemoteItemWidget::~RemoteItemWidget()
+{
+    delete m_sharedMemory;
+}
+
+QString RemoteItemWidget::itemKey() const
+{
+    return m_itemKey;
+}
+
+QImage RemoteItemWidget::image() const
+{
+    return m_image;
+}
+
+void RemoteItemWidget::updateImage(const QString &shmKey, const QSize &size, int bytesPerLine, qreal devicePixelRatio)
+{
+    // 宿主进程在图像变大时会换用新的共享内存
+    if (!m_sharedMemory || m_sharedMemory->key() != shmKey) {
+        delete m_sharedMemory;
+        m_sharedMemory = new QSharedMemory(shmKey);
+        if (!m_sharedMemory->attach(QSharedMemory::ReadOnly)) {
+            qWarning() << "attach plugin host shared memory failed:" << m_sharedMemory->errorString();
+            delete m_sharedMemory;
+            m_sharedMemory = nullptr;
+            return;
+        }
+    }
+
+    if (m_sharedMemory->size() < bytesPerLine * size.height())
+        return;
+
+    m_sharedMemory->lock();
+    m_image = QImage(static_cast<const uchar *>(m_sharedMemory->constData()), size.width(), size.height(),
+                     bytesPerLine, QImage::Format_ARGB32_Premultiplied).copy();
+    m_sharedMemory->unlock();
+    m_image.setDevicePixelRatio(devicePixelRatio);
+
+    updateGeometry();
+    update();
+}
+
+QSize RemoteItemWidget::sizeHint() const
+{
+    if (m_image.isNull())
+        return QWidget::sizeHint();
+
+    return m_image.size() / m_image.devicePixelRatio();
+}
+
+void RemoteItemWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    if (m_image.isNull())
+        return;
+
+    QPainter painter(this);
+    painter.drawImage(QPoint(0, 0), m_image);
+}
+
+void RemoteItemWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    Q_EMIT resized(m_itemKey, size());
+}
+
+void RemoteItemWidget::mousePressEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void RemoteItemWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void RemoteItemWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void RemoteItemWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    forwardMouseEvent(event);
+}
+
+void RemoteItemWidget::forwardMouseEvent(QMouseEvent *event)
+{
+    Q_EMIT mouseEventReceived(m_itemKey, event);
+    // 任务栏还需要根据鼠标事件弹出菜单和面板，这里不接收事件
+    event->ignore();
+}
+
+RemotePluginProxy::RemotePluginProxy(const QString &pluginFile, QObject *parent)
+    : QObject(parent)
+    , m_pluginFile(pluginFile)
+    , m_server(new QLocalServer(this))
+    , m_process(new QProcess(this))
+    , m_channel(nullptr)
+    , m_hostProgram(hostProgram())
+    , m_helloTimer(new QTimer(this))
+    , m_pingTimer(new QTimer(this))
+    , m_pingPending(false)
+    , m_ready(false)
+    , m_flags(PluginFlag::Type_NoneFlag)
+    , m_type(Normal)
+    , m_sizePolicy(System)
+{
+    m_process->setProcessChannelMode(QProcess::ForwardedChannels);
+
+    m_helloTimer->setSingleShot(true);
+    m_helloTimer->setInterval(HELLO_TIMEOUT);
+    connect(m_helloTimer, &QTimer::timeout, this, [ this ] {
+        qWarning() << "plugin host not responding:" << m_pluginFile;
+        m_process->kill();
+    });
+
+    m_pingTimer->setInterval(PING_INTERVAL);
+    connect(m_pingTimer, &QTimer::timeout, this, [ this ] {
+        if (m_pingPending) {
+            // 结束宿主进程后按宿主进程退出处理，插件从任务栏移除
+            qWarning() << "plugin host hung:" << m_pluginFile;
+            m_pingTimer->stop();
+            m_process->kill();
+            return;
+        }
+
+        m_pingPending = true;
+        m_channel->send(PluginHostChannel::Ping);
+    });
+
+    connect(m_server, &QLocalServer::newConnection, this, &RemotePluginProxy::onNewConnection);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &RemotePluginProxy::onHostFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [ this ](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            onHostFinished();
+    });
+}
+
+RemotePluginProxy::~RemotePluginProxy()
+{
+    // 断开连接后宿主进程自行退出
+    m_process->disconnect(this);
+    if (m_channel)
+        m_channel->socket()->disconnectFromServer();
+
+    if (m_process->state() != QProcess::NotRunning && !m_process->waitForFinished(QUIT_TIMEOUT))
+        m_process->kill();
+
+    for (const QPointer<RemoteItemWidget> &itemWidget : m_itemWidgets)
+        delete itemWidget.data();
+}
+
+QString RemotePluginProxy::hostProgram()
+{
+#ifdef QT_DEBUG
+    return QString("%1/../plugins/pluginhost/dde-dock-plugin-host").arg(qApp->applicationDirPath());
+#else
+    return QString(PLUGIN_HOST_PATH);
+#endif
+}
+
+QString RemotePluginProxy::pluginFile() const
+{
+    return m_pluginFile;
+}
+
+bool RemotePluginProxy::start()
+{
+    const QString serverName = QString("dde-dock-plugin-%1-%2").arg(QCoreApplication::applicationPid()).arg(QFileInfo(m_pluginFile).completeBaseName());
+    QLocalServer::removeServer(serverName);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(serverName)) {
+        qWarning() << "plugin host listen failed:" << m_server->errorString();
+        return false;
+    }
+
+    qDebug() << "start plugin host for:" << m_pluginFile;
+    m_process->start(m_hostProgram, { "--socket", m_server->fullServerName(), m_pluginFile });
+    m_helloTimer->start();
+    return true;
+}
+
+const QString RemotePluginProxy::pluginName() const
+{
+    return m_pluginName;
+}
+
+const QString RemotePluginProxy::pluginDisplayName() const
+{
+    return m_pluginDisplayName;
+}
+
+void RemotePluginProxy::init(PluginProxyInterface *proxyInter)
+{
+    m_proxyInter = proxyInter;
+
+    m_channel->send(PluginHostChannel::Init, pluginSettings(), int(displayMode()), int(position()));
+}
+
+QWidget *RemotePluginProxy::itemWidget(const QString &itemKey)
+{
+    return m_itemWidgets.value(itemKey).data();
+}
+
+void RemotePluginProxy::displayModeChanged(const Dock::DisplayMode displayMode)
+{
+    m_channel->send(PluginHostChannel::DisplayModeChanged, int(displayMode));
+}
+
+void RemotePluginProxy::positionChanged(const Dock::Position position)
+{
+    m_channel->send(PluginHostChannel::PositionChanged, int(position));
+}
+
+void RemotePluginProxy::pluginSettingsChanged()
+{
+    m_channel->send(PluginHostChannel::SettingsChanged, pluginSettings());
+}
+
+PluginsItemInterface::PluginType RemotePluginProxy::type()
+{
+    return m_type;
+}
+
+PluginsItemInterface::PluginSizePolicy RemotePluginProxy::pluginSizePolicy() const
+{
+    return m_sizePolicy;
+}
+
+QIcon RemotePluginProxy::icon(const DockPart &dockPart, DGuiApplicationHelper::ColorType themeType)
+{
+    Q_UNUSED(dockPart);
+    Q_UNUSED(themeType);
+
+    // 宿主进程只传递插件项的图像，这里使用快捷面板插件项或者第一个插件项的图像
+    RemoteItemWidget *itemWidget = m_itemWidgets.value(QUICK_ITEM_KEY).data();
+    if (!itemWidget && !m_itemWidgets.isEmpty())
+        itemWidget = m_itemWidgets.first().data();
+
+    if (!itemWidget || itemWidget->image().isNull())
+        return QIcon();
+
+    return QIcon(QPixmap::fromImage(itemWidget->image()));
+}
+
+PluginFlags RemotePluginProxy::flags() const
+{
+    return m_flags;
+}
+
+QVariantMap RemotePluginProxy::pluginSettings() const
+{
+    return DockSettings::instance()->pluginSettings()->pluginSettings(m_pluginName).toVariantMap();
+}
+
+void RemotePluginProxy::onNewConnection()
+{
+    QLocalSocket *socket = m_server->nextPendingConnection();
+    // 每个宿主进程只有一个连接
+    if (m_channel) {
+        socket->abort();
+        socket->deleteLater();
+        return;
+    }
+
+    m_server->close();
+    socket->setParent(this);
+    m_channel = new PluginHostChannel(socket, this);
+    connect(m_channel, &PluginHostChannel::messageReceived, this, &RemotePluginProxy::onMessageReceived);
+}
+
+void RemotePluginProxy::onMessageReceived(PluginHostChannel::MessageType type, const QByteArray &body)
+{
+    QDataStream stream(body);
+    stream.setVersion(PluginHostChannel::StreamVersion);
+
+    QString itemKey;
+    switch (type) {
+    case PluginHostChannel::Hello: {
+        int flags = 0, pluginType = 0, sizePolicy = 0;
+        stream >> m_pluginName >> m_pluginDisplayName >> flags >> pluginType >> sizePolicy;
+        m_flags = PluginFlags(flags);
+        m_type = PluginType(pluginType);
+        m_sizePolicy = PluginSizePolicy(sizePolicy);
+
+        m_helloTimer->stop();
+        m_pingPending = false;
+        m_pingTimer->start();
+        if (!m_ready) {
+            m_ready = true;
+            Q_EMIT ready();
+        }
+        break;
+    }
+    case PluginHostChannel::Pong:
+        m_pingPending = false;
+        break;
+    case PluginHostChannel::ItemAdded: {
+        stream >> itemKey;
+        if (!m_itemWidgets.value(itemKey)) {
+            RemoteItemWidget *itemWidget = new RemoteItemWidget(itemKey);
+            connect(itemWidget, &RemoteItemWidget::mouseEventReceived, this, &RemotePluginProxy::onItemMouseEvent);
+            connect(itemWidget, &RemoteItemWidget::resized, this, &RemotePluginProxy::onItemResized);
+            m_itemWidgets[itemKey] = itemWidget;
+        }
+        if (m_proxyInter)
+            m_proxyInter->itemAdded(this, itemKey);
+        break;
+    }
+    case PluginHostChannel::ItemUpdate:
+        stream >> itemKey;
+        if (m_proxyInter)
+            m_proxyInter->itemUpdate(this, itemKey);
+        break;
+    case PluginHostChannel::ItemRemoved:
+        stream >> itemKey;
+        if (m_proxyInter)
+            m_proxyInter->itemRemoved(this, itemKey);
+        break;
+    case PluginHostChannel::ItemImage: {
+        QString shmKey;
+        QSize size;
+        int bytesPerLine = 0;
+        qreal devicePixelRatio = 1;
+        stream >> itemKey >> shmKey >> size >> bytesPerLine >> devicePixelRatio;
+        if (RemoteItemWidget *itemWidget = m_itemWidgets.value(itemKey).data())
+            itemWidget->updateImage(shmKey, size, bytesPerLine, devicePixelRatio);
+        break;
+    }
+    case PluginHostChannel::SaveValue: {
+        QString key;
+        QVariant value;
+        stream >> key >> value;
+        if (m_proxyInter)
+            m_proxyInter->saveValue(this, key, value);
+        break;
+    }
+    case PluginHostChannel::RemoveValue: {
+        QStringList keyList;
+        stream >> keyList;
+        if (m_proxyInter)
+            m_proxyInter->removeValue(this, keyList);
+        break;
+    }
+    case PluginHostChannel::RequestAppletVisible: {
+        bool visible = false;
+        stream >> itemKey >> visible;
+        if (m_proxyInter)
+            m_proxyInter->requestSetAppletVisible(this, itemKey, visible);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void RemotePluginProxy::onHostFinished()
+{
+    m_helloTimer->stop();
+    m_pingTimer->stop();
+    qWarning() << "plugin host exited:" << m_pluginFile << m_process->exitCode() << m_process->errorString();
+
+    if (m_ready)
+        Q_EMIT hostExited();
+    else
+        Q_EMIT failed();
+}
+
+void RemotePluginProxy::onItemMouseEvent(const QString &itemKey, QMouseEvent *event)
+{
+    if (!m_channel)
+        return;
+
+    m_channel->send(PluginHostChannel::ItemMouseEvent, itemKey, int(event->type()), event->localPos(),
+                    int(event->button()), int(event->buttons()), int(event->modifiers()));
+}
+
+void RemotePluginProxy::onItemResized(const QString &itemKey, const QSize &size)
+{
+    if (!m_channel)
+        return;
+
+    m_channel->send(PluginHostChannel::ItemResize, itemKey, size);
+}
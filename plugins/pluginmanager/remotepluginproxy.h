@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef REMOTEPLUGINPROXY_H
+#define REMOTEPLUGINPROXY_H
+
+#include "pluginsiteminterface.h"
+#include "pluginhostchannel.h"
+
+#include <QObject>
+#include <QMap>
+#include <QPointer>
+#include <QWidget>
+#include <QImage>
+
+class QLocalServer;
+class QProcess;
+class QSharedMemory;
+class QTimer;
+
+/**
+ * @brief RemoteItemWidget 宿主进程中插件项在任务栏中的替身
+ * 显示宿主进程写入共享内存的图像，鼠标事件和尺寸变化转发给宿主进程
+ */
+class RemoteItemWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RemoteItemWidget(const QString &itemKey, QWidget *parent = nullptr);
+    ~RemoteItemWidget() override;
+
+    QString itemKey() const;
+    QImage image() const;
+    void updateImage(const QString &shmKey, const QSize &size, int bytesPerLine, qreal devicePixelRatio);
+
+    QSize sizeHint() const override;
+
+Q_SIGNALS:
+    void mouseEventReceived(const QString &itemKey, QMouseEvent *event);
+    void resized(const QString &itemKey, const QSize &size);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    void forwardMouseEvent(QMouseEvent *event);
+
+private:
+    QString m_itemKey;
+    QSharedMemory *m_sharedMemory;
+    QImage m_image;
+};
+
+/**
+ * @brief RemotePluginProxy 在独立宿主进程(dde-dock-plugin-host)中运行的插件
+ * 对任务栏来说和普通的v23插件一样，插件接口的调用通过本地套接字转发给宿主进程，
+ * 插件崩溃或者阻塞只影响宿主进程，宿主进程退出后插件从任务栏移除
+ */
+class RemotePluginProxy : public QObject, public PluginsItemInterface
+{
+    Q_OBJECT
+
+public:
+    explicit RemotePluginProxy(const QString &pluginFile, QObject *parent = nullptr);
+    ~RemotePluginProxy() override;
+
+    static QString hostProgram();
+
+    QString pluginFile() const;
+    bool start();
+
+    const QString pluginName() const override;
+    const QString pluginDisplayName() const override;
+    void init(PluginProxyInterface *proxyInter) override;
+    QWidget *itemWidget(const QString &itemKey) override;
+    void displayModeChanged(const Dock::DisplayMode displayMode) override;
+    void positionChanged(const Dock::Position position) override;
+    void pluginSettingsChanged() override;
+    PluginType type() override;
+    PluginSizePolicy pluginSizePolicy() const override;
+    QIcon icon(const DockPart &dockPart, DGuiApplicationHelper::ColorType themeType) override;
+    PluginFlags flags() const override;
+
+Q_SIGNALS:
+    // 宿主进程已经加载插件，可以初始化
+    void ready();
+    // 宿主进程启动或者加载插件失败
+    void failed();
+    // 插件初始化后宿主进程退出，或者阻塞后被结束
+    void hostExited();
+
+private:
+    QVariantMap pluginSettings() const;
+
+private Q_SLOTS:
+    void onNewConnection();
+    void onMessageReceived(PluginHostChannel::MessageType type, const QByteArray &body);
+    void onHostFinished();
+    void onItemMouseEvent(const QString &itemKey, QMouseEvent *event);
+    void onItemResized(const QString &itemKey, const QSize &size);
+
+private:
+    QString m_pluginFile;
+    QLocalServer *m_server;
+    QProcess *m_process;
+    PluginHostChannel *m_channel;
+    QString m_hostProgram;
+    QTimer *m_helloTimer;
+    QTimer *m_pingTimer;
+    bool m_pingPending;                 // 上一次Ping还没有收到回复
+    bool m_ready;
+
+    // 宿主进程通过Hello消息告知的插件信息
+    QString m_pluginName;
+    QString m_pluginDisplayName;
+    PluginFlags m_flags;
+    PluginType m_type;
+    PluginSizePolicy m_sizePolicy;
+
+    QMap<QString, QPointer<RemoteItemWidget>> m_itemWidgets;
+};
+
+#endif // REMOTEPLUGINPROXY_H
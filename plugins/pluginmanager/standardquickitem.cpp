@@ -5,6 +5,7 @@
 
 #include "standardquickitem.h"
 #include "pluginsiteminterface.h"
+#include "plugincallmonitor.h"
 
 #include <DFontSizeManager>
 #include <DGuiApplicationHelper>
@@ -51,7 +52,7 @@ void StandardQuickItem::mouseReleaseEvent(QMouseEvent *event)
     if (event->button() != Qt::LeftButton) {
         return;
     }
-    QStringList commandArgument = pluginItem()->itemCommand(itemKey()).split(" ");
+    QStringList commandArgument = timedPluginCall(pluginItem(), "itemCommand", [ this ] { return pluginItem()->itemCommand(itemKey()); }).split(" ");
     if (commandArgument.size() > 0) {
         QString command = commandArgument.first();
         commandArgument.removeFirst();
@@ -79,7 +80,7 @@ QWidget *StandardQuickItem::iconWidget(QWidget *parent)
     // 显示图标的窗体
     QWidget *widget = new QWidget(parent);
     m_needPaint = true;
-    QIcon icon = pluginItem()->icon(DockPart::QuickPanel);
+    QIcon icon = timedPluginCall(pluginItem(), "icon", [ this ] { return pluginItem()->icon(DockPart::QuickPanel); });
     if (icon.isNull()) {
         // 如果图标为空，则将获取itemWidget作为它的显示
         QWidget *itemWidget = pluginItem()->itemWidget(QUICK_ITEM_KEY);
@@ -124,7 +125,7 @@ QWidget *StandardQuickItem::iconWidget(QWidget *parent)
 QPixmap StandardQuickItem::pixmap() const
 {
     // 如果快捷面板区域的图标为空，那么就获取itemWidget的截图
-    QIcon icon = pluginItem()->icon(DockPart::QuickPanel);
+    QIcon icon = timedPluginCall(pluginItem(), "icon", [ this ] { return pluginItem()->icon(DockPart::QuickPanel); });
     if (icon.isNull())
         return QPixmap();
 
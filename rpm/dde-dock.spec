@@ -23,6 +23,7 @@ BuildRequires:  pkgconfig(Qt5DBus)
 BuildRequires:  pkgconfig(Qt5X11Extras)
 BuildRequires:  pkgconfig(Qt5Svg)
 BuildRequires:  pkgconfig(x11)
+BuildRequires:  pkgconfig(x11-xcb)
 BuildRequires:  pkgconfig(xtst)
 BuildRequires:  pkgconfig(xext)
 BuildRequires:  pkgconfig(xcb-composite)
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "fakexeventmonitor.h"
+#include "edgetriggerengine.h"
+#include "dbusutil.h"
+
+#include <QDebug>
+
+FakeXEventMonitor::FakeXEventMonitor(const QString &address, QObject *parent)
+    : QObject(parent)
+    , m_connection(QDBusConnection::connectToBus(address, "fake-xevent-monitor"))
+    , m_engine(new EdgeTriggerEngine(this))
+    , m_valid(false)
+{
+    registerAreaListMetaType();
+
+    connect(m_engine, &EdgeTriggerEngine::cursorInto, this, &FakeXEventMonitor::CursorInto);
+    connect(m_engine, &EdgeTriggerEngine::cursorOut, this, &FakeXEventMonitor::CursorOut);
+    connect(m_engine, &EdgeTriggerEngine::cursorMove, this, &FakeXEventMonitor::CursorMove);
+    connect(m_engine, &EdgeTriggerEngine::buttonPress, this, &FakeXEventMonitor::ButtonPress);
+    connect(m_engine, &EdgeTriggerEngine::buttonRelease, this, &FakeXEventMonitor::ButtonRelease);
+
+    m_valid = m_connection.registerObject(xEventMonitorPath, this, QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals)
+            && m_connection.registerService(xEventMonitorService);
+    if (!m_valid)
+        qWarning() << "register fake XEventMonitor failed:" << m_connection.lastError().message();
+}
+
+FakeXEventMonitor::~FakeXEventMonitor()
+{
+    m_connection.unregisterService(xEventMonitorService);
+    m_connection.unregisterObject(xEventMonitorPath);
+    QDBusConnection::disconnectFromBus("fake-xevent-monitor");
+}
+
+bool FakeXEventMonitor::isValid() const
+{
+    return m_valid;
+}
+
+EdgeTriggerEngine *FakeXEventMonitor::engine() const
+{
+    return m_engine;
+}
+
+QString FakeXEventMonitor::RegisterAreas(const AreaList &areas, int flags)
+{
+    return m_engine->registerAreas(areas, flags);
+}
+
+bool FakeXEventMonitor::UnregisterArea(const QString &key)
+{
+    return m_engine->unregisterArea(key);
+}
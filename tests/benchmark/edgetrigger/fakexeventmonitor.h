@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef FAKEXEVENTMONITOR_H
+#define FAKEXEVENTMONITOR_H
+
+#include "arealist.h"
+
+#include <QObject>
+#include <QDBusConnection>
+
+class EdgeTriggerEngine;
+
+/**
+ * @brief The FakeXEventMonitor class
+ * 私有总线上的org.deepin.dde.XEventMonitor1，区域判断使用和任务栏相同的EdgeTriggerEngine，
+ * 两种方式的耗时差别只在于事件是否经过D-Bus转发
+ */
+class FakeXEventMonitor : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.XEventMonitor1")
+
+public:
+    explicit FakeXEventMonitor(const QString &address, QObject *parent = nullptr);
+    ~FakeXEventMonitor() override;
+
+    bool isValid() const;
+    // 模拟服务从X服务器收到鼠标事件
+    EdgeTriggerEngine *engine() const;
+
+public Q_SLOTS:
+    QString RegisterAreas(const AreaList &areas, int flags);
+    bool UnregisterArea(const QString &key);
+
+Q_SIGNALS:
+    void CursorInto(int x, int y, const QString &key);
+    void CursorOut(int x, int y, const QString &key);
+    void CursorMove(int x, int y, const QString &key);
+    void ButtonPress(int button, int x, int y, const QString &key);
+    void ButtonRelease(int button, int x, int y, const QString &key);
+
+private:
+    QDBusConnection m_connection;
+    EdgeTriggerEngine *m_engine;
+    bool m_valid;
+};
+
+#endif // FAKEXEVENTMONITOR_H
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "fakexeventmonitor.h"
+#include "edgetriggerengine.h"
+#include "regionmonitor.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+/**
+ * 任务栏唤起延迟性能测试
+ * 回放合成的鼠标轨迹(从屏幕中间移动到底部边缘再移回)，统计鼠标进入唤起区域到任务栏收到CursorMove的耗时，
+ * 对比进程内的EdgeTriggerEngine和经过org.deepin.dde.XEventMonitor1服务转发两种方式
+ */
+
+static const int screenWidth = 1920;
+static const int screenHeight = 1080;
+static const int monitorHeight = 15;
+
+// 启动一个只属于本进程的会话总线，避免和桌面上真实的XEventMonitor服务互相干扰
+static QString startPrivateBus(QProcess &daemon)
+{
+    daemon.start("dbus-daemon", { "--session", "--nofork", "--print-address=1" });
+    if (!daemon.waitForStarted() || !daemon.waitForReadyRead())
+        return QString();
+
+    return QString::fromLocal8Bit(daemon.readLine()).trimmed();
+}
+
+static bool waitFor(const std::function<bool()> &predicate, int timeout)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    // 保证事件循环定期被唤醒，检查是否超时
+    QTimer wakeTimer;
+    wakeTimer.start(10);
+    while (!predicate()) {
+        if (elapsed.elapsed() > timeout)
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    return true;
+}
+
+// 和XRecordPointerSource一样，把鼠标事件投递到判断区域的对象所在的线程
+static void postMotion(EdgeTriggerEngine *engine, int x, int y)
+{
+    QMetaObject::invokeMethod(engine, "handleMotion", Qt::QueuedConnection, Q_ARG(int, x), Q_ARG(int, y));
+}
+
+struct Result {
+    std::vector<qint64> latencies;
+    int missed = 0;
+};
+
+static Result measure(RegionMonitor *monitor, EdgeTriggerEngine *eventEngine, int reveals, int steps)
+{
+    MonitRect rect;
+    rect.x1 = 0;
+    rect.y1 = screenHeight - monitorHeight;
+    rect.x2 = screenWidth;
+    rect.y2 = screenHeight;
+    const QString key = monitor->registerAreas({ rect }, RegionMonitor::Motion | RegionMonitor::Button);
+
+    Result result;
+    QElapsedTimer clock;
+    clock.start();
+    qint64 enterTime = 0;
+    bool revealed = false;
+    bool out = false;
+
+    QObject context;
+    QObject::connect(monitor, &RegionMonitor::cursorMove, &context, [ & ](int, int, const QString &moveKey) {
+        if (moveKey != key || revealed)
+            return;
+
+        revealed = true;
+        result.latencies.push_back(clock.nsecsElapsed() - enterTime);
+    });
+    QObject::connect(monitor, &RegionMonitor::cursorOut, &context, [ & ](int, int, const QString &outKey) {
+        if (outKey == key)
+            out = true;
+    });
+
+    for (int i = 0; i < reveals; ++i) {
+        revealed = false;
+        out = false;
+
+        const int x = (i * 97) % screenWidth;
+        for (int step = 0; step < steps; ++step)
+            postMotion(eventEngine, x, screenHeight / 2 + step * (screenHeight / 2 - monitorHeight - 1) / steps);
+
+        enterTime = clock.nsecsElapsed();
+        postMotion(eventEngine, x, screenHeight - monitorHeight / 2);
+        if (!waitFor([ & ] { return revealed; }, 1000)) {
+            ++result.missed;
+            continue;
+        }
+
+        postMotion(eventEngine, x, screenHeight / 2);
+        waitFor([ & ] { return out; }, 1000);
+    }
+
+    monitor->unregisterArea(key);
+    return result;
+}
+
+static void printResult(const char *name, Result &result)
+{
+    std::vector<qint64> &latencies = result.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    qint64 total = 0;
+    for (qint64 latency : latencies)
+        total += latency;
+
+    auto percentile = [ & ](double p) {
+        if (latencies.empty())
+            return 0.0;
+        return double(latencies[std::min(latencies.size() - 1, size_t(p * (latencies.size() - 1) + 0.5))]) / 1000;
+    };
+
+    printf("%-10s | %10.1f %10.1f %10.1f %10.1f | %6zu %6d\n", name,
+           latencies.empty() ? 0.0 : double(total) / latencies.size() / 1000,
+           percentile(0.5), percentile(0.99), percentile(1.0),
+           latencies.size(), result.missed);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption revealsOption("reveals", "Times the pointer hits the dock edge.", "count", "500");
+    QCommandLineOption stepsOption("steps", "Pointer moves before reaching the edge.", "count", "20");
+    parser.addOptions({ revealsOption, stepsOption });
+    parser.process(app);
+
+    const int reveals = qMax(1, parser.value(revealsOption).toInt());
+    const int steps = qMax(0, parser.value(stepsOption).toInt());
+
+    QProcess daemon;
+    const QString address = startPrivateBus(daemon);
+    if (address.isEmpty()) {
+        qWarning() << "failed to start private dbus-daemon";
+        return -1;
+    }
+
+    // DBusRegionMonitor使用QDBusConnection::sessionBus()，在第一次使用之前切换到私有总线
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address.toLocal8Bit());
+
+    int ret = 0;
+    {
+        EdgeTriggerEngine localEngine;
+        Result localResult = measure(&localEngine, &localEngine, reveals, steps);
+
+        // 服务在单独的线程中处理事件，和独立进程一样通过总线发出信号
+        QThread serviceThread;
+        FakeXEventMonitor *service = new FakeXEventMonitor(address);
+        if (!service->isValid()) {
+            delete service;
+            ret = -1;
+        } else {
+            service->moveToThread(&serviceThread);
+            QObject::connect(&serviceThread, &QThread::finished, service, &QObject::deleteLater);
+            serviceThread.start();
+
+            DBusRegionMonitor dbusMonitor;
+            Result dbusResult = measure(&dbusMonitor, service->engine(), reveals, steps);
+
+            printf("reveal latency in us, %d reveals, %d moves before the edge\n", reveals, steps);
+            printf("%-10s | %10s %10s %10s %10s | %6s %6s\n", "backend", "avg", "p50", "p99", "max", "count", "missed");
+            printResult("local", localResult);
+            printResult("dbus", dbusResult);
+
+            serviceThread.quit();
+            serviceThread.wait();
+        }
+    }
+
+    daemon.terminate();
+    daemon.waitForFinished();
+    return ret;
+}
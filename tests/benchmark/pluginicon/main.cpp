@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginiconcache.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QPainter>
+#include <QPixmap>
+
+#include <cstdio>
+
+/**
+ * 插件设置图标读取性能测试
+ * 模拟控制中心反复读取DBusDockAdaptors::plugins()，对比每次都绘制并编码浅色、深色图标
+ * 和从PluginIconCache读取编码后数据的耗时
+ */
+
+static PluginsItemInterface *fakePlugin(int index)
+{
+    // 缓存只把插件指针当作key使用，不会访问插件对象
+    return reinterpret_cast<PluginsItemInterface *>(quintptr(index + 1) * sizeof(void *));
+}
+
+static QIcon pluginIcon(int index)
+{
+    QPixmap pixmap(20, 20);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor::fromHsv((index * 37) % 360, 200, 200));
+    painter.drawEllipse(QRect(2, 2, 16, 16).adjusted(index % 3, 0, 0, -(index % 3)));
+    painter.end();
+
+    return QIcon(pixmap);
+}
+
+// 和DBusDockAdaptors::renderSettingIcon相同的流程：SourceIn填充后编码为png
+static QByteArray renderIcon(const QIcon &icon, DGuiApplicationHelper::ColorType colorType)
+{
+    QPixmap pixmap = icon.pixmap(QSize(20, 20));
+    QPainter painter(&pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    painter.fillRect(pixmap.rect(), colorType == DGuiApplicationHelper::LightType ? Qt::black : Qt::white);
+    painter.end();
+
+    QByteArray iconData;
+    QBuffer buffer(&iconData);
+    if (buffer.open(QIODevice::WriteOnly))
+        pixmap.save(&buffer, "png");
+
+    return iconData;
+}
+
+// 模拟一次属性读取，返回所有图标数据的总长度
+template<typename Func>
+static qint64 readProperty(int pluginCount, Func iconData)
+{
+    qint64 bytes = 0;
+    for (int i = 0; i < pluginCount; ++i) {
+        const QByteArray light = iconData(i, DGuiApplicationHelper::LightType);
+        const QByteArray dark = iconData(i, DGuiApplicationHelper::DarkType);
+        bytes += light.size() + dark.size();
+    }
+
+    return bytes;
+}
+
+template<typename Func>
+static double usPerRead(int reads, Func func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < reads; ++i)
+        func(i);
+
+    return timer.nsecsElapsed() / 1000.0 / reads;
+}
+
+static void runCase(int pluginCount, int reads)
+{
+    QList<QIcon> icons;
+    for (int i = 0; i < pluginCount; ++i)
+        icons << pluginIcon(i);
+
+    PluginIconCache cache([ & ](PluginsItemInterface *plugin, DGuiApplicationHelper::ColorType colorType) {
+        const int index = int(quintptr(plugin) / sizeof(void *)) - 1;
+        return renderIcon(icons[index], colorType);
+    });
+
+    volatile qint64 sink = 0;
+
+    const double uncached = usPerRead(reads, [ & ](int) {
+        sink += readProperty(pluginCount, [ & ](int index, DGuiApplicationHelper::ColorType colorType) {
+            return renderIcon(icons[index], colorType);
+        });
+    });
+
+    // 第一次读取生成缓存，不计入稳定状态的耗时
+    const double cold = usPerRead(1, [ & ](int) {
+        sink += readProperty(pluginCount, [ & ](int index, DGuiApplicationHelper::ColorType colorType) {
+            return cache.iconData(fakePlugin(index), colorType);
+        });
+    });
+    const double cached = usPerRead(reads, [ & ](int) {
+        sink += readProperty(pluginCount, [ & ](int index, DGuiApplicationHelper::ColorType colorType) {
+            return cache.iconData(fakePlugin(index), colorType);
+        });
+    });
+
+    // 每次读取之前有一个插件更新了图标
+    const double oneUpdated = usPerRead(reads, [ & ](int i) {
+        cache.invalidate(fakePlugin(i % pluginCount));
+        sink += readProperty(pluginCount, [ & ](int index, DGuiApplicationHelper::ColorType colorType) {
+            return cache.iconData(fakePlugin(index), colorType);
+        });
+    });
+
+    printf("%8d | %12.1f %12.1f %12.1f %12.1f | %8d\n",
+           pluginCount, uncached, cold, cached, oneUpdated, cache.renderCount());
+}
+
+int main(int argc, char *argv[])
+{
+    // 不依赖图形环境
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption readsOption("reads", "Property reads measured per case.", "count", "200");
+    parser.addOption(readsOption);
+    parser.process(app);
+
+    const int reads = qMax(1, parser.value(readsOption).toInt());
+
+    printf("plugins() property read cost in us (render every read | cache)\n");
+    printf("%8s | %12s %12s %12s %12s | %8s\n", "plugins", "uncached", "cold", "cached", "1 updated", "renders");
+    for (int pluginCount : { 8, 16, 32, 64 })
+        runCase(pluginCount, reads);
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "pluginregistry.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QDebug>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+/**
+ * 插件登记表查找性能测试
+ * 对比原来DockPluginController中嵌套QMap的遍历查找和PluginRegistry的哈希索引，
+ * 插件数和插件项数增加时，登记表的单次查找耗时应当基本不变
+ */
+
+// 原来的数据结构：插件 -> (itemKey/"pluginloader" -> 对象)
+typedef QMap<PluginsItemInterface *, QMap<QString, QObject *>> NestedPluginMap;
+
+static PluginsItemInterface *fakePlugin(int index)
+{
+    // 登记表只把插件指针当作key使用，不会访问插件对象
+    return reinterpret_cast<PluginsItemInterface *>(quintptr(index + 1) * sizeof(void *));
+}
+
+static PluginsItemInterface *nestedInterAt(const NestedPluginMap &pluginsMap, const QString &itemKey)
+{
+    QMapIterator<PluginsItemInterface *, QMap<QString, QObject *>> it(pluginsMap);
+    while (it.hasNext()) {
+        it.next();
+        if (it.value().keys().contains(itemKey))
+            return it.key();
+    }
+
+    return nullptr;
+}
+
+static PluginsItemInterface *nestedInterAt(const NestedPluginMap &pluginsMap, QObject *destItem)
+{
+    QMapIterator<PluginsItemInterface *, QMap<QString, QObject *>> it(pluginsMap);
+    while (it.hasNext()) {
+        it.next();
+        if (it.value().values().contains(destItem))
+            return it.key();
+    }
+
+    return nullptr;
+}
+
+static bool nestedIsLoaded(const QMap<QPair<QString, PluginsItemInterface *>, bool> &loadMap)
+{
+    for (int i = 0; i < loadMap.keys().size(); ++i) {
+        if (!loadMap.values()[i])
+            return false;
+    }
+
+    return true;
+}
+
+template<typename Func>
+static double nsPerCall(int iterations, Func func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        func(i);
+
+    return double(timer.nsecsElapsed()) / iterations;
+}
+
+static void runCase(int pluginCount, int itemCount, int iterations)
+{
+    NestedPluginMap pluginsMap;
+    QMap<QPair<QString, PluginsItemInterface *>, bool> loadMap;
+    PluginRegistry registry;
+
+    std::vector<std::unique_ptr<QObject>> objects;
+    QStringList itemKeys;
+    for (int i = 0; i < pluginCount; ++i) {
+        PluginsItemInterface *plugin = fakePlugin(i);
+        const QString pluginFile = QString("/usr/lib/dde-dock/plugins/libplugin-%1.so").arg(i);
+
+        registry.addPluginFile(pluginFile);
+        registry.addPlugin(plugin, pluginFile, nullptr);
+        registry.setPluginInited(plugin);
+        loadMap.insert(qMakePair(pluginFile, plugin), true);
+
+        QMap<QString, QObject *> &interfaceData = pluginsMap[plugin];
+        interfaceData["pluginloader"] = nullptr;
+        for (int j = 0; j < itemCount; ++j) {
+            const QString itemKey = QString("plugin-%1-item-%2").arg(i).arg(j);
+            objects.emplace_back(new QObject);
+            interfaceData[itemKey] = objects.back().get();
+            registry.bindItem(plugin, itemKey, objects.back().get());
+            itemKeys << itemKey;
+        }
+    }
+
+    const int total = itemKeys.size();
+    volatile quintptr sink = 0;
+
+    const double nestedKey = nsPerCall(iterations, [ & ](int i) {
+        sink += quintptr(nestedInterAt(pluginsMap, itemKeys[i % total]));
+    });
+    const double registryKey = nsPerCall(iterations, [ & ](int i) {
+        sink += quintptr(registry.pluginByItemKey(itemKeys[i % total]));
+    });
+    const double nestedObject = nsPerCall(iterations, [ & ](int i) {
+        sink += quintptr(nestedInterAt(pluginsMap, objects[i % total].get()));
+    });
+    const double registryObject = nsPerCall(iterations, [ & ](int i) {
+        sink += quintptr(registry.pluginByObject(objects[i % total].get()));
+    });
+    // 原来的实现每次都复制keys()和values()，是O(n^2)的，减少循环次数
+    const double nestedLoaded = nsPerCall(qMax(10, iterations / pluginCount), [ & ](int) {
+        sink += nestedIsLoaded(loadMap);
+    });
+    const double registryLoaded = nsPerCall(iterations, [ & ](int) {
+        sink += registry.isAllPluginsInited();
+    });
+
+    printf("%8d %6d | %12.1f %12.1f | %12.1f %12.1f | %12.1f %12.1f\n",
+           pluginCount, itemCount,
+           nestedKey, registryKey,
+           nestedObject, registryObject,
+           nestedLoaded, registryLoaded);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "Lookups measured per case.", "count", "20000");
+    parser.addOption(iterationsOption);
+    parser.process(app);
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    printf("lookup cost in ns per call (nested map | registry)\n");
+    printf("%8s %6s | %25s | %25s | %25s\n", "plugins", "items", "by item key", "by item object", "all loaded");
+    for (int pluginCount : { 8, 32, 128, 512 }) {
+        for (int itemCount : { 1, 4 })
+            runCase(pluginCount, itemCount, iterations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fakewindowsource.h"
+
+// XCB_ATOM_WM_CLASS等预定义原子的值都很小，脚本中的原子从1000开始分配
+static const XCBAtom firstAtom = 1000;
+static const XWindow fakeRootWindow = 1;
+
+FakeWindowSource::FakeWindowSource()
+    : m_active(0)
+    , m_currentDesktop(0)
+    , m_queryCount(0)
+{
+}
+
+void FakeWindowSource::addWindow(XWindow xid, const FakeWindow &window)
+{
+    m_windows.insert(xid, window);
+    m_clientList.removeOne(xid);
+    m_clientList.push_back(xid);
+    m_stacking.removeOne(xid);
+    m_stacking.push_back(xid);
+}
+
+void FakeWindowSource::removeWindow(XWindow xid)
+{
+    m_windows.remove(xid);
+    m_clientList.removeOne(xid);
+    m_stacking.removeOne(xid);
+    if (m_active == xid)
+        m_active = 0;
+}
+
+FakeWindow *FakeWindowSource::window(XWindow xid)
+{
+    auto it = m_windows.find(xid);
+    return it != m_windows.end() ? &it.value() : nullptr;
+}
+
+QList<XWindow> FakeWindowSource::windows() const
+{
+    return m_clientList;
+}
+
+void FakeWindowSource::raise(XWindow xid)
+{
+    if (!m_stacking.removeOne(xid))
+        return;
+
+    m_stacking.push_back(xid);
+}
+
+void FakeWindowSource::setActiveWindow(XWindow xid)
+{
+    m_active = xid;
+}
+
+void FakeWindowSource::setCurrentDesktop(uint32_t desktop)
+{
+    m_currentDesktop = desktop;
+}
+
+XWindow FakeWindowSource::rootWindow() const
+{
+    return fakeRootWindow;
+}
+
+XWindow FakeWindowSource::activeWindow() const
+{
+    return m_active;
+}
+
+/**
+ * @brief FakeWindowSource::topVisibleWindow 窗口管理器在最小化、切换工作区后激活的窗口
+ * @return 当前工作区最上层的可见窗口
+ */
+XWindow FakeWindowSource::topVisibleWindow() const
+{
+    for (auto it = m_stacking.crbegin(); it != m_stacking.crend(); ++it) {
+        const FakeWindow &window = m_windows[*it];
+        if (!window.isHidden && !window.isDesktopType && window.desktop == m_currentDesktop)
+            return *it;
+    }
+
+    return 0;
+}
+
+int FakeWindowSource::queryCount() const
+{
+    return m_queryCount;
+}
+
+void FakeWindowSource::resetQueryCount()
+{
+    m_queryCount = 0;
+}
+
+XWindow FakeWindowSource::getRootWindow()
+{
+    ++m_queryCount;
+    return fakeRootWindow;
+}
+
+XCBAtom FakeWindowSource::getAtom(const char *name)
+{
+    auto it = m_atoms.find(name);
+    if (it == m_atoms.end())
+        it = m_atoms.insert(name, firstAtom + XCBAtom(m_atoms.size()));
+
+    return it.value();
+}
+
+XWindow FakeWindowSource::getActiveWindow()
+{
+    ++m_queryCount;
+    return m_active;
+}
+
+std::list<XWindow> FakeWindowSource::getClientList()
+{
+    ++m_queryCount;
+    return std::list<XWindow>(m_clientList.begin(), m_clientList.end());
+}
+
+std::list<XWindow> FakeWindowSource::getClientListStacking()
+{
+    ++m_queryCount;
+    return std::list<XWindow>(m_stacking.begin(), m_stacking.end());
+}
+
+uint32_t FakeWindowSource::getCurrentWMDesktop()
+{
+    ++m_queryCount;
+    return m_currentDesktop;
+}
+
+bool FakeWindowSource::isGoodWindow(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.contains(xid);
+}
+
+Geometry FakeWindowSource::getWindowGeometry(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.value(xid).geometry;
+}
+
+std::vector<XCBAtom> FakeWindowSource::getWMState(XWindow xid)
+{
+    ++m_queryCount;
+    std::vector<XCBAtom> states;
+    const FakeWindow window = m_windows.value(xid);
+    if (window.isHidden)
+        states.push_back(getAtom("_NET_WM_STATE_HIDDEN"));
+    if (window.isMaximized) {
+        states.push_back(getAtom("_NET_WM_STATE_MAXIMIZED_VERT"));
+        states.push_back(getAtom("_NET_WM_STATE_MAXIMIZED_HORZ"));
+    }
+
+    return states;
+}
+
+std::vector<XCBAtom> FakeWindowSource::getWMWindoType(XWindow xid)
+{
+    ++m_queryCount;
+    if (m_windows.value(xid).isDesktopType)
+        return { getAtom("_NET_WM_WINDOW_TYPE_DESKTOP") };
+
+    return { getAtom("_NET_WM_WINDOW_TYPE_NORMAL") };
+}
+
+std::vector<XCBAtom> FakeWindowSource::getWMAllowedActions(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return {};
+}
+
+uint32_t FakeWindowSource::getWMDesktop(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.value(xid).desktop;
+}
+
+XWindow FakeWindowSource::getWMTransientFor(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.value(xid).transientFor;
+}
+
+XWindow FakeWindowSource::getWMClientLeader(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return 0;
+}
+
+uint32_t FakeWindowSource::getWMPid(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.value(xid).pid;
+}
+
+WMClass FakeWindowSource::getWMClass(XWindow xid)
+{
+    ++m_queryCount;
+    const std::string wmClass = m_windows.value(xid).wmClass;
+    return WMClass{ wmClass, wmClass };
+}
+
+std::string FakeWindowSource::getWMName(XWindow xid)
+{
+    ++m_queryCount;
+    return m_windows.value(xid).wmClass;
+}
+
+std::vector<std::string> FakeWindowSource::getWMCommand(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return {};
+}
+
+WMIcon FakeWindowSource::getWMIcon(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return WMIcon{ 0, 0, {} };
+}
+
+MotifWMHints FakeWindowSource::getWindowMotifWMHints(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return MotifWMHints{ 0, 0, 0, 0, 0 };
+}
+
+bool FakeWindowSource::hasXEmbedInfo(XWindow xid)
+{
+    Q_UNUSED(xid);
+    ++m_queryCount;
+    return false;
+}
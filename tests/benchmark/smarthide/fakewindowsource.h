@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FAKEWINDOWSOURCE_H
+#define FAKEWINDOWSOURCE_H
+
+#include "windowsource.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QRect>
+
+/**
+ * @brief The FakeWindow struct 窗口管理器记录的窗口属性
+ */
+struct FakeWindow
+{
+    Geometry geometry = Geometry{ 0, 0, 0, 0 };
+    bool isHidden = false;
+    bool isMaximized = false;
+    bool isDesktopType = false;
+    uint32_t desktop = 0;
+    XWindow transientFor = 0;
+    uint32_t pid = 0;
+    std::string wmClass;
+};
+
+/**
+ * @brief The FakeWindowSource class
+ * 模拟窗口管理器和X服务器保存的属性，脚本操作只修改属性，事件由回放程序交给X11Manager处理；
+ * 除原子外每次查询计数一次，原子在XCBUtils中有缓存，不需要和X服务器交互
+ */
+class FakeWindowSource : public WindowSource
+{
+public:
+    FakeWindowSource();
+
+    // 模拟窗口管理器修改属性
+    void addWindow(XWindow xid, const FakeWindow &window);
+    void removeWindow(XWindow xid);
+    FakeWindow *window(XWindow xid);
+    QList<XWindow> windows() const;
+    void raise(XWindow xid);
+    void setActiveWindow(XWindow xid);
+    void setCurrentDesktop(uint32_t desktop);
+    XWindow rootWindow() const;
+    XWindow activeWindow() const;
+    XWindow topVisibleWindow() const;
+
+    int queryCount() const;
+    void resetQueryCount();
+
+    XWindow getRootWindow() override;
+    XCBAtom getAtom(const char *name) override;
+    XWindow getActiveWindow() override;
+    std::list<XWindow> getClientList() override;
+    std::list<XWindow> getClientListStacking() override;
+    uint32_t getCurrentWMDesktop() override;
+
+    bool isGoodWindow(XWindow xid) override;
+    Geometry getWindowGeometry(XWindow xid) override;
+    std::vector<XCBAtom> getWMState(XWindow xid) override;
+    std::vector<XCBAtom> getWMWindoType(XWindow xid) override;
+    std::vector<XCBAtom> getWMAllowedActions(XWindow xid) override;
+    uint32_t getWMDesktop(XWindow xid) override;
+    XWindow getWMTransientFor(XWindow xid) override;
+    XWindow getWMClientLeader(XWindow xid) override;
+    uint32_t getWMPid(XWindow xid) override;
+    WMClass getWMClass(XWindow xid) override;
+    std::string getWMName(XWindow xid) override;
+    std::vector<std::string> getWMCommand(XWindow xid) override;
+    WMIcon getWMIcon(XWindow xid) override;
+    MotifWMHints getWindowMotifWMHints(XWindow xid) override;
+    bool hasXEmbedInfo(XWindow xid) override;
+
+private:
+    QMap<XWindow, FakeWindow> m_windows;
+    QList<XWindow> m_clientList;        // 按映射顺序
+    QList<XWindow> m_stacking;          // 从下到上
+    QMap<QByteArray, XCBAtom> m_atoms;
+    XWindow m_active;
+    uint32_t m_currentDesktop;
+    int m_queryCount;
+};
+
+#endif // FAKEWINDOWSOURCE_H
@@ -0,0 +1,484 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "common.h"
+#include "fakewindowsource.h"
+#include "smarthidecontroller.h"
+#include "taskmanager.h"
+#include "x11manager.h"
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QTimer>
+#include <QDebug>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+/**
+ * 智能隐藏判断回放测试
+ * 不需要X服务器，FakeWindowSource按脚本模拟窗口管理器修改窗口属性，再把对应的事件交给TaskManager中真实的X11Manager处理，
+ * 隐藏状态由TaskManager::shouldHideOnSmartHideMode判断；每个场景结束后对比任务栏最终的隐藏状态，
+ * 并统计从事件到判断完成的延迟、判断次数和经过WindowSource的X查询次数
+ *
+ * 场景脚本每行一个操作，每个操作之后等待判断完成(burst中的移动之间不等待)：
+ *   map <xid> <x> <y> <w> <h> <desktop> <pid> [transientFor] [desktopType]
+ *   activate <xid>
+ *   move <xid> <x> <y> <w> <h>
+ *   burst <xid> <count> <x> <y> <w> <h>
+ *   maximize <xid>
+ *   minimize <xid>
+ *   workspace <desktop>
+ *   launcher|traygrid|popup <0|1>
+ */
+
+static const QRect screenRect(0, 0, 1920, 1080);
+static const QRect dockRect(0, 1040, 1920, 40);
+
+struct Scenario
+{
+    const char *name;
+    QStringList script;
+    Dock::HideState expected;
+};
+
+// pid从5000000开始，超过内核的pid上限，不会对应到系统中真实的进程
+static QList<Scenario> scenarios()
+{
+    return {
+        { "maximize", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001" }, Dock::HideState::Hide },
+        { "restore", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001",
+              "move 1001 100 100 800 600" }, Dock::HideState::Show },
+        { "move_into_dock", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "move 1001 100 600 800 600" }, Dock::HideState::Hide },
+        { "move_away", {
+              "map 1001 100 600 800 600 0 5000101",
+              "activate 1001",
+              "move 1001 100 100 800 600" }, Dock::HideState::Show },
+        { "minimize_active", {
+              "map 1001 0 0 1920 1080 0 5000101",
+              "map 1002 100 100 400 300 0 5000102",
+              "activate 1001",
+              "minimize 1001" }, Dock::HideState::Show },
+        { "activate_minimized", {
+              "map 1001 0 0 1920 1080 0 5000101",
+              "map 1002 100 100 400 300 0 5000102",
+              "activate 1001",
+              "minimize 1001",
+              "activate 1001" }, Dock::HideState::Hide },
+        { "workspace_switch", {
+              "map 1001 0 0 1920 1080 0 5000101",
+              "map 1002 100 100 400 300 1 5000102",
+              "activate 1001",
+              "workspace 1" }, Dock::HideState::Show },
+        { "workspace_back", {
+              "map 1001 0 0 1920 1080 0 5000101",
+              "map 1002 100 100 400 300 1 5000102",
+              "activate 1001",
+              "workspace 1",
+              "workspace 0" }, Dock::HideState::Hide },
+        { "dialog_over_maximized", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001",
+              "map 1002 760 390 400 300 0 5000101 1001",
+              "activate 1002" }, Dock::HideState::Hide },
+        { "desktop_window", {
+              "map 1001 0 0 1920 1080 0 5000101",
+              "activate 1001",
+              "map 1002 0 0 1920 1080 0 5000102 0 1",
+              "activate 1002" }, Dock::HideState::Show },
+        { "drag_burst", {
+              "map 1001 100 600 800 600 0 5000101",
+              "activate 1001",
+              "burst 1001 50 300 200 800 600" }, Dock::HideState::Show },
+        { "launcher_over_maximized", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001",
+              "launcher 1" }, Dock::HideState::Show },
+        { "launcher_closed", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001",
+              "launcher 1",
+              "launcher 0" }, Dock::HideState::Hide },
+        { "traygrid_over_maximized", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "maximize 1001",
+              "traygrid 1" }, Dock::HideState::Show },
+        { "popup_move_into_dock", {
+              "map 1001 100 100 800 600 0 5000101",
+              "activate 1001",
+              "popup 1",
+              "move 1001 100 600 800 600" }, Dock::HideState::Show },
+    };
+}
+
+struct Result
+{
+    Dock::HideState state = Dock::HideState::Unknown;
+    int decisions = 0;
+    int queries = 0;
+    int decisionQueries = 0;    // 判断过程中的X查询，应该为0
+    std::vector<qint64> latencies;
+};
+
+static double percentile(const std::vector<qint64> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    const size_t index = std::min(sorted.size() - 1, size_t(p * (sorted.size() - 1) + 0.5));
+    return double(sorted[index]);
+}
+
+static double average(const std::vector<qint64> &values)
+{
+    if (values.empty())
+        return 0;
+
+    qint64 total = 0;
+    for (qint64 value : values)
+        total += value;
+
+    return double(total) / values.size();
+}
+
+static const char *stateName(Dock::HideState state)
+{
+    switch (state) {
+    case Dock::HideState::Show:
+        return "show";
+    case Dock::HideState::Hide:
+        return "hide";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief The ReplayHarness class 把脚本操作转换成X事件交给X11Manager，由TaskManager判断隐藏状态
+ */
+class ReplayHarness
+{
+public:
+    explicit ReplayHarness(int hideDelay)
+        : m_taskManager(new TaskManager(&m_source))
+        , m_x11Manager(m_taskManager->m_x11Manager)
+        , m_pendingActivations(0)
+        , m_result(nullptr)
+    {
+        // 不修改用户的配置，直接按智能隐藏模式处理
+        m_taskManager->m_hideMode = Dock::HideMode::SmartHide;
+        m_taskManager->setFrontendWindowRect(dockRect.x(), dockRect.y(), uint(dockRect.width()), uint(dockRect.height()));
+
+        SmartHideController *controller = m_taskManager->m_smartHide;
+        controller->setDelay(hideDelay);
+        controller->setDecider([ this ] {
+            const int queries = m_source.queryCount();
+            const bool hide = m_taskManager->shouldHideOnSmartHideMode();
+            if (m_result) {
+                const qint64 now = m_clock.nsecsElapsed();
+                for (qint64 since : m_pendingEvents)
+                    m_result->latencies.push_back(now - since);
+                m_result->decisionQueries += m_source.queryCount() - queries;
+            }
+            m_pendingEvents.clear();
+            return hide;
+        });
+
+        // 在TaskManager之后连接，事件已经交给TaskManager处理
+        QObject::connect(m_x11Manager, &X11Manager::requestUpdateHideState, [ this ] {
+            m_pendingEvents.push_back(m_clock.nsecsElapsed());
+        });
+        QObject::connect(m_x11Manager, &X11Manager::requestHandleActiveWindowChange, [ this ] {
+            m_pendingEvents.push_back(m_clock.nsecsElapsed());
+            // TaskManager::handleActiveWindowChanged延迟更新隐藏状态，同样时长的定时器在它之后超时
+            ++m_pendingActivations;
+            QTimer::singleShot(activeWindowChangeDelay, [ this ] { --m_pendingActivations; });
+        });
+        m_clock.start();
+    }
+
+    Result run(const Scenario &scenario)
+    {
+        reset();
+
+        Result result;
+        m_result = &result;
+        SmartHideController *controller = m_taskManager->m_smartHide;
+        const int decisions = controller->decisionCount();
+        m_source.resetQueryCount();
+
+        for (const QString &line : scenario.script) {
+            execute(line.split(' ', Qt::SkipEmptyParts));
+            waitForDecision();
+        }
+
+        result.state = controller->hideState();
+        result.decisions = controller->decisionCount() - decisions;
+        result.queries = m_source.queryCount();
+        m_result = nullptr;
+        return result;
+    }
+
+private:
+    void execute(const QStringList &args)
+    {
+        const QString &type = args.first();
+        auto arg = [ & ](int i) { return args.value(i).toUInt(); };
+        auto rect = [ & ](int i) { return QRect(args.value(i).toInt(), args.value(i + 1).toInt(), args.value(i + 2).toInt(), args.value(i + 3).toInt()); };
+
+        if (type == "map" && args.size() >= 8) {
+            FakeWindow window;
+            window.geometry = toGeometry(rect(2));
+            window.desktop = arg(6);
+            window.pid = arg(7);
+            window.transientFor = arg(8);
+            window.isDesktopType = arg(9);
+            window.wmClass = QString("app-%1").arg(window.pid).toStdString();
+            map(arg(1), window);
+        } else if (type == "activate") {
+            activate(arg(1));
+        } else if (type == "move" && args.size() >= 6) {
+            move(arg(1), rect(2));
+        } else if (type == "burst" && args.size() >= 7) {
+            // 拖动窗口时连续的移动，经过任务栏区域后停在最后的位置
+            const QRect target = rect(3);
+            const int count = qMax(1, args.value(2).toInt());
+            for (int i = 1; i < count; ++i)
+                move(arg(1), target.translated(0, (i * 37) % 800 - 400));
+            move(arg(1), target);
+        } else if (type == "maximize") {
+            maximize(arg(1));
+        } else if (type == "minimize") {
+            minimize(arg(1));
+        } else if (type == "workspace") {
+            switchWorkspace(arg(1));
+        } else if (type == "launcher") {
+            // 对应DBusHandler中启动器的VisibleChanged
+            m_pendingEvents.push_back(m_clock.nsecsElapsed());
+            m_taskManager->setDdeLauncherVisible(arg(1));
+            m_taskManager->updateHideState(true);
+        } else if (type == "traygrid") {
+            // 对应TrayGridWidget的showEvent和hideEvent
+            m_pendingEvents.push_back(m_clock.nsecsElapsed());
+            m_taskManager->setTrayGridWidgetVisible(arg(1));
+            m_taskManager->updateHideState(true);
+        } else if (type == "popup") {
+            // 对应DockPopupWindow的showEvent和hideEvent，不主动更新隐藏状态
+            m_taskManager->setPopupVisible(arg(1));
+        } else {
+            qWarning() << "unknown script line" << args;
+        }
+    }
+
+    // 新窗口加入_NET_CLIENT_LIST，根窗口收到MapNotify，窗口放到最上层
+    void map(XWindow xid, const FakeWindow &window)
+    {
+        m_source.addWindow(xid, window);
+        notifyRoot("_NET_CLIENT_LIST");
+        m_x11Manager->handleMapNotifyEvent(xid);
+        notifyRoot("_NET_CLIENT_LIST_STACKING");
+    }
+
+    // 最小化的窗口恢复显示，窗口移动到最上层后设置为活动窗口
+    void activate(XWindow xid)
+    {
+        FakeWindow *window = m_source.window(xid);
+        if (!window)
+            return;
+
+        if (window->isHidden) {
+            window->isHidden = false;
+            notifyWindow(xid, "_NET_WM_STATE");
+        }
+
+        m_source.raise(xid);
+        notifyRoot("_NET_CLIENT_LIST_STACKING");
+        m_source.setActiveWindow(xid);
+        notifyRoot("_NET_ACTIVE_WINDOW");
+    }
+
+    void move(XWindow xid, const QRect &geometry)
+    {
+        FakeWindow *window = m_source.window(xid);
+        if (!window)
+            return;
+
+        window->geometry = toGeometry(geometry);
+        if (window->isMaximized) {
+            window->isMaximized = false;
+            notifyWindow(xid, "_NET_WM_STATE");
+        }
+        m_x11Manager->handleConfigureNotifyEvent(xid, geometry.x(), geometry.y(), geometry.width(), geometry.height());
+    }
+
+    // 智能隐藏模式下任务栏不占用工作区，最大化的窗口铺满整个屏幕
+    void maximize(XWindow xid)
+    {
+        FakeWindow *window = m_source.window(xid);
+        if (!window)
+            return;
+
+        window->isMaximized = true;
+        window->geometry = toGeometry(screenRect);
+        notifyWindow(xid, "_NET_WM_STATE");
+        m_x11Manager->handleConfigureNotifyEvent(xid, screenRect.x(), screenRect.y(), screenRect.width(), screenRect.height());
+    }
+
+    // 最小化活动窗口后，窗口管理器激活当前工作区最上层的可见窗口
+    void minimize(XWindow xid)
+    {
+        FakeWindow *window = m_source.window(xid);
+        if (!window)
+            return;
+
+        window->isHidden = true;
+        notifyWindow(xid, "_NET_WM_STATE");
+        if (m_source.activeWindow() == xid) {
+            m_source.setActiveWindow(m_source.topVisibleWindow());
+            notifyRoot("_NET_ACTIVE_WINDOW");
+        }
+    }
+
+    // 切换工作区后，窗口管理器激活新工作区最上层的可见窗口
+    void switchWorkspace(uint32_t desktop)
+    {
+        m_source.setCurrentDesktop(desktop);
+        notifyRoot("_NET_CURRENT_DESKTOP");
+        m_source.setActiveWindow(m_source.topVisibleWindow());
+        notifyRoot("_NET_ACTIVE_WINDOW");
+    }
+
+    void notifyRoot(const char *atom)
+    {
+        m_x11Manager->handlePropertyNotifyEvent(m_source.rootWindow(), m_source.getAtom(atom));
+    }
+
+    void notifyWindow(XWindow xid, const char *atom)
+    {
+        m_x11Manager->handlePropertyNotifyEvent(xid, m_source.getAtom(atom));
+    }
+
+    /**
+     * @brief reset 销毁上一个场景的窗口，恢复到没有活动窗口、任务栏显示的状态
+     */
+    void reset()
+    {
+        for (XWindow xid : m_source.windows()) {
+            m_source.removeWindow(xid);
+            notifyRoot("_NET_CLIENT_LIST");
+            m_x11Manager->handleDestroyNotifyEvent(xid);
+        }
+        m_source.setCurrentDesktop(0);
+        notifyRoot("_NET_CURRENT_DESKTOP");
+        notifyRoot("_NET_CLIENT_LIST_STACKING");
+        notifyRoot("_NET_ACTIVE_WINDOW");
+        // 活动窗口销毁后根窗口上没有已注册的活动窗口，X11Manager不会通知TaskManager
+        m_taskManager->handleActiveWindowChanged(nullptr);
+        m_taskManager->setDdeLauncherVisible(false);
+        m_taskManager->setTrayGridWidgetVisible(false);
+        m_taskManager->setPopupVisible(false);
+        waitForDecision();
+
+        m_taskManager->m_smartHide->resetHideState(Dock::HideState::Show);
+        m_pendingEvents.clear();
+    }
+
+    void waitForDecision()
+    {
+        QCoreApplication::processEvents();
+        while (m_pendingActivations > 0 || m_taskManager->m_smartHide->isPending())
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    static Geometry toGeometry(const QRect &rect)
+    {
+        return Geometry{ int16_t(rect.x()), int16_t(rect.y()), uint16_t(rect.width()), uint16_t(rect.height()) };
+    }
+
+private:
+    FakeWindowSource m_source;
+    TaskManager *m_taskManager;     // 不释放，进程退出时回收
+    X11Manager *m_x11Manager;
+
+    int m_pendingActivations;
+    QElapsedTimer m_clock;
+    std::vector<qint64> m_pendingEvents;
+    Result *m_result;
+};
+
+int main(int argc, char *argv[])
+{
+    // 识别窗口时会读取图标，不需要显示
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption hideDelayOption("hide-delay", "Smart-hide timer delay in milliseconds.", "msec", QString::number(smartHideTimerDelay));
+    QCommandLineOption repeatOption("repeat", "Replay every scenario this many times.", "count", "1");
+    parser.addOption(hideDelayOption);
+    parser.addOption(repeatOption);
+    parser.process(app);
+
+    // 判断过程中的日志会淹没判断本身的耗时
+    QLoggingCategory::setFilterRules("default.info=false\ndefault.debug=false");
+
+    ReplayHarness harness(qMax(0, parser.value(hideDelayOption).toInt()));
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    std::vector<qint64> allLatencies;
+    int failures = 0;
+    int decisions = 0;
+    int queries = 0;
+    int decisionQueries = 0;
+
+    printf("%-24s %-6s %-6s %-6s %9s %8s %12s %12s\n",
+           "scenario", "result", "state", "expect", "decisions", "queries", "avg(ms)", "max(ms)");
+    for (const Scenario &scenario : scenarios()) {
+        for (int i = 0; i < repeat; ++i) {
+            Result result = harness.run(scenario);
+            const bool passed = (result.state == scenario.expected);
+            failures += !passed;
+            decisions += result.decisions;
+            queries += result.queries;
+            decisionQueries += result.decisionQueries;
+
+            std::sort(result.latencies.begin(), result.latencies.end());
+            allLatencies.insert(allLatencies.end(), result.latencies.begin(), result.latencies.end());
+            printf("%-24s %-6s %-6s %-6s %9d %8d %12.3f %12.3f\n",
+                   scenario.name, passed ? "PASS" : "FAIL",
+                   stateName(result.state), stateName(scenario.expected),
+                   result.decisions, result.queries,
+                   average(result.latencies) / 1e6, percentile(result.latencies, 1.0) / 1e6);
+        }
+    }
+
+    std::sort(allLatencies.begin(), allLatencies.end());
+    printf("decision latency in ms: avg %.3f p50 %.3f p99 %.3f max %.3f over %zu events\n",
+           average(allLatencies) / 1e6,
+           percentile(allLatencies, 0.5) / 1e6,
+           percentile(allLatencies, 0.99) / 1e6,
+           percentile(allLatencies, 1.0) / 1e6,
+           allLatencies.size());
+    printf("%d decisions, %d X queries (%d during decisions), %d failed scenarios\n",
+           decisions, queries, decisionQueries, failures);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "fakesniitem.h"
+
+#include <QDBusMessage>
+#include <QDebug>
+
+#define ITEM_PATH "/StatusNotifierItem"
+
+static const QStringList IconNames = { "dialog-information", "dialog-warning", "dialog-error", "mail-unread" };
+
+FakeSNIItem::FakeSNIItem(const QString &address, int index, QObject *parent)
+    : QObject(parent)
+    , m_connectionName(QString("fake-sni-item-%1").arg(index))
+    , m_connection(QDBusConnection::connectToBus(address, m_connectionName))
+    , m_id(QString("fake-sni-%1").arg(index))
+    , m_iconSerial(0)
+    , m_iconReadCount(0)
+    , m_connected(m_connection.isConnected())
+{
+    // 断开连接后拿不到唯一名，提前记录
+    m_servicePath = m_connection.baseService() + ITEM_PATH;
+}
+
+FakeSNIItem::~FakeSNIItem()
+{
+    crash();
+}
+
+bool FakeSNIItem::registerItem()
+{
+    if (!m_connected)
+        return false;
+
+    if (!m_connection.registerObject(ITEM_PATH, this, QDBusConnection::ExportAllContents)) {
+        qWarning() << "register fake sni item failed:" << m_id << m_connection.lastError().message();
+        return false;
+    }
+
+    QDBusMessage msg = QDBusMessage::createMethodCall("org.kde.StatusNotifierWatcher", "/StatusNotifierWatcher",
+                                                      "org.kde.StatusNotifierWatcher", "RegisterStatusNotifierItem");
+    msg << m_connection.baseService();
+    return m_connection.send(msg);
+}
+
+void FakeSNIItem::crash()
+{
+    if (!m_connected)
+        return;
+
+    m_connected = false;
+    m_connection.unregisterObject(ITEM_PATH);
+    QDBusConnection::disconnectFromBus(m_connectionName);
+}
+
+void FakeSNIItem::updateIcon()
+{
+    ++m_iconSerial;
+    Q_EMIT NewIcon();
+}
+
+QString FakeSNIItem::servicePath() const
+{
+    return m_servicePath;
+}
+
+QString FakeSNIItem::iconName() const
+{
+    ++m_iconReadCount;
+    return IconNames.at(m_iconSerial % IconNames.size());
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef FAKESNIITEM_H
+#define FAKESNIITEM_H
+
+#include <QObject>
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+
+/**
+ * @brief The FakeSNIItem class
+ * 模拟一个应用的StatusNotifierItem，每个对象使用独立的总线连接，拥有自己的唯一名，
+ * 断开连接即相当于应用崩溃退出
+ */
+class FakeSNIItem : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.StatusNotifierItem")
+    Q_PROPERTY(QString Category READ category)
+    Q_PROPERTY(QString Id READ id)
+    Q_PROPERTY(QString Title READ title)
+    Q_PROPERTY(QString Status READ status)
+    Q_PROPERTY(int WindowId READ windowId)
+    Q_PROPERTY(QString IconThemePath READ iconThemePath)
+    Q_PROPERTY(QString IconName READ iconName)
+    Q_PROPERTY(QString OverlayIconName READ overlayIconName)
+    Q_PROPERTY(QString AttentionIconName READ attentionIconName)
+    Q_PROPERTY(QString AttentionMovieName READ attentionMovieName)
+    Q_PROPERTY(bool ItemIsMenu READ itemIsMenu)
+    Q_PROPERTY(QDBusObjectPath Menu READ menu)
+
+public:
+    FakeSNIItem(const QString &address, int index, QObject *parent = nullptr);
+    ~FakeSNIItem() override;
+
+    bool registerItem();
+    void crash();
+    void updateIcon();
+
+    QString servicePath() const;
+    // 托盘读取IconName属性的次数，用来衡量图标更新的处理量
+    int iconReadCount() const { return m_iconReadCount; }
+
+    QString category() const { return "ApplicationStatus"; }
+    QString id() const { return m_id; }
+    QString title() const { return m_id; }
+    QString status() const { return "Active"; }
+    int windowId() const { return 0; }
+    QString iconThemePath() const { return QString(); }
+    QString iconName() const;
+    QString overlayIconName() const { return QString(); }
+    QString attentionIconName() const { return QString(); }
+    QString attentionMovieName() const { return QString(); }
+    bool itemIsMenu() const { return false; }
+    QDBusObjectPath menu() const { return QDBusObjectPath("/NO_DBUSMENU"); }
+
+public Q_SLOTS:
+    void Activate(int x, int y) { Q_UNUSED(x); Q_UNUSED(y); }
+    void SecondaryActivate(int x, int y) { Q_UNUSED(x); Q_UNUSED(y); }
+    void ContextMenu(int x, int y) { Q_UNUSED(x); Q_UNUSED(y); }
+    void Scroll(int delta, const QString &orientation) { Q_UNUSED(delta); Q_UNUSED(orientation); }
+
+Q_SIGNALS:
+    void NewIcon();
+    void NewStatus(const QString &status);
+
+private:
+    QString m_connectionName;
+    QDBusConnection m_connection;
+    QString m_id;
+    QString m_servicePath;
+    int m_iconSerial;
+    mutable int m_iconReadCount;
+    bool m_connected;
+};
+
+#endif // FAKESNIITEM_H
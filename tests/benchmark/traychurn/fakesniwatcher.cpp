@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "fakesniwatcher.h"
+
+#include <QDBusServiceWatcher>
+#include <QDebug>
+
+#define WATCHER_SERVICE "org.kde.StatusNotifierWatcher"
+#define WATCHER_PATH "/StatusNotifierWatcher"
+
+FakeSNIWatcher::FakeSNIWatcher(const QString &address, QObject *parent)
+    : QObject(parent)
+    , m_connection(QDBusConnection::connectToBus(address, "fake-sni-watcher"))
+    , m_serviceWatcher(new QDBusServiceWatcher(this))
+    , m_valid(false)
+{
+    m_serviceWatcher->setConnection(m_connection);
+    m_serviceWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &FakeSNIWatcher::onServiceUnregistered);
+
+    m_valid = m_connection.registerObject(WATCHER_PATH, this, QDBusConnection::ExportAllContents)
+            && m_connection.registerService(WATCHER_SERVICE);
+    if (!m_valid)
+        qWarning() << "register fake StatusNotifierWatcher failed:" << m_connection.lastError().message();
+}
+
+FakeSNIWatcher::~FakeSNIWatcher()
+{
+    m_connection.unregisterService(WATCHER_SERVICE);
+    m_connection.unregisterObject(WATCHER_PATH);
+    QDBusConnection::disconnectFromBus("fake-sni-watcher");
+}
+
+bool FakeSNIWatcher::isValid() const
+{
+    return m_valid;
+}
+
+void FakeSNIWatcher::RegisterStatusNotifierItem(const QString &service)
+{
+    // 与dde-daemon保持一致，列表中保存"服务名/路径"的格式
+    QString owner = service;
+    QString servicePath = service;
+    if (service.startsWith('/')) {
+        owner = message().service();
+        servicePath = owner + service;
+    } else if (!service.contains('/')) {
+        servicePath = service + "/StatusNotifierItem";
+    } else {
+        owner = service.left(service.indexOf('/'));
+    }
+
+    if (m_items.contains(servicePath))
+        return;
+
+    m_serviceWatcher->addWatchedService(owner);
+    m_items << servicePath;
+    Q_EMIT StatusNotifierItemRegistered(servicePath);
+}
+
+void FakeSNIWatcher::RegisterStatusNotifierHost(const QString &service)
+{
+    Q_UNUSED(service);
+    Q_EMIT StatusNotifierHostRegistered();
+}
+
+void FakeSNIWatcher::onServiceUnregistered(const QString &service)
+{
+    m_serviceWatcher->removeWatchedService(service);
+
+    const QString prefix = service + "/";
+    for (int i = m_items.size() - 1; i >= 0; --i) {
+        if (!m_items[i].startsWith(prefix))
+            continue;
+
+        const QString servicePath = m_items.takeAt(i);
+        Q_EMIT StatusNotifierItemUnregistered(servicePath);
+    }
+}
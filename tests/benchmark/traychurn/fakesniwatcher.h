@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef FAKESNIWATCHER_H
+#define FAKESNIWATCHER_H
+
+#include <QObject>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QStringList>
+
+class QDBusServiceWatcher;
+
+/**
+ * @brief The FakeSNIWatcher class
+ * 私有总线上的org.kde.StatusNotifierWatcher，只实现任务栏用到的注册、注销和列表属性
+ */
+class FakeSNIWatcher : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.StatusNotifierWatcher")
+    Q_PROPERTY(QStringList RegisteredStatusNotifierItems READ registeredStatusNotifierItems)
+    Q_PROPERTY(bool IsStatusNotifierHostRegistered READ isStatusNotifierHostRegistered)
+    Q_PROPERTY(int ProtocolVersion READ protocolVersion)
+
+public:
+    explicit FakeSNIWatcher(const QString &address, QObject *parent = nullptr);
+    ~FakeSNIWatcher() override;
+
+    bool isValid() const;
+
+    QStringList registeredStatusNotifierItems() const { return m_items; }
+    bool isStatusNotifierHostRegistered() const { return true; }
+    int protocolVersion() const { return 0; }
+
+public Q_SLOTS:
+    void RegisterStatusNotifierItem(const QString &service);
+    void RegisterStatusNotifierHost(const QString &service);
+
+Q_SIGNALS:
+    void StatusNotifierItemRegistered(const QString &service);
+    void StatusNotifierItemUnregistered(const QString &service);
+    void StatusNotifierHostRegistered();
+
+private Q_SLOTS:
+    void onServiceUnregistered(const QString &service);
+
+private:
+    QDBusConnection m_connection;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QStringList m_items;
+    bool m_valid;
+};
+
+#endif // FAKESNIWATCHER_H
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "fakexembedclient.h"
+#include "xcb_connection.h"
+
+#include <QDBusMessage>
+#include <QDBusMetaType>
+#include <QDebug>
+
+#define TRAYMANAGER_SERVICE "org.deepin.dde.TrayManager1"
+#define TRAYMANAGER_PATH "/org/deepin/dde/TrayManager1"
+
+FakeTrayManager::FakeTrayManager(const QString &address, QObject *parent)
+    : QObject(parent)
+    , m_connection(QDBusConnection::connectToBus(address, "fake-tray-manager"))
+    , m_valid(false)
+{
+    qRegisterMetaType<TrayList>("TrayList");
+    qDBusRegisterMetaType<TrayList>();
+
+    m_valid = m_connection.registerObject(TRAYMANAGER_PATH, this, QDBusConnection::ExportAllContents)
+            && m_connection.registerService(TRAYMANAGER_SERVICE);
+    if (!m_valid)
+        qWarning() << "register fake TrayManager1 failed:" << m_connection.lastError().message();
+}
+
+FakeTrayManager::~FakeTrayManager()
+{
+    m_connection.unregisterService(TRAYMANAGER_SERVICE);
+    m_connection.unregisterObject(TRAYMANAGER_PATH);
+    QDBusConnection::disconnectFromBus("fake-tray-manager");
+}
+
+bool FakeTrayManager::isValid() const
+{
+    return m_valid;
+}
+
+void FakeTrayManager::setTrayIcons(const TrayList &trayIcons)
+{
+    m_trayIcons = trayIcons;
+
+    // DBusTrayManager通过PropertiesChanged得知列表变化，导出的Qt属性不会自动发送该信号
+    QDBusMessage msg = QDBusMessage::createSignal(TRAYMANAGER_PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    QVariantMap changedProps;
+    changedProps.insert("TrayIcons", QVariant::fromValue(QDBusVariant(QVariant::fromValue(m_trayIcons))));
+    msg << QString(TRAYMANAGER_SERVICE) << changedProps << QStringList();
+    m_connection.send(msg);
+}
+
+void FakeTrayManager::notifyChanged(quint32 winId)
+{
+    Q_EMIT Changed(winId);
+}
+
+FakeXEmbedClient::FakeXEmbedClient(FakeTrayManager *trayManager, QObject *parent)
+    : QObject(parent)
+    , m_trayManager(trayManager)
+    , m_serial(0)
+{
+}
+
+FakeXEmbedClient::~FakeXEmbedClient()
+{
+    const QList<quint32> winIds = m_windows;
+    destroyWindows(winIds);
+}
+
+bool FakeXEmbedClient::isAvailable()
+{
+    return XcbConnection::instance()->connection() != nullptr;
+}
+
+QList<quint32> FakeXEmbedClient::createWindows(int count)
+{
+    xcb_connection_t *c = XcbConnection::instance()->connection();
+    QList<quint32> winIds;
+    if (!c)
+        return winIds;
+
+    const xcb_window_t root = XcbConnection::instance()->rootWindow();
+    for (int i = 0; i < count; ++i) {
+        xcb_window_t winId = xcb_generate_id(c);
+        xcb_create_window(c, XCB_COPY_FROM_PARENT, winId, root, 0, 0, 16, 16, 0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, 0, nullptr);
+
+        // WM_CLASS是"实例名\0类名\0"，托盘根据它生成配置中的键值
+        const QByteArray wmClass = QString("fake-xembed-%1").arg(m_serial++).toLatin1();
+        const QByteArray value = wmClass + '\0' + wmClass + '\0';
+        xcb_change_property(c, XCB_PROP_MODE_REPLACE, winId, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 8,
+                            static_cast<uint32_t>(value.size()), value.constData());
+        winIds << winId;
+    }
+    xcb_flush(c);
+
+    m_windows << winIds;
+    m_trayManager->setTrayIcons(m_windows);
+    return winIds;
+}
+
+void FakeXEmbedClient::destroyWindows(const QList<quint32> &winIds)
+{
+    xcb_connection_t *c = XcbConnection::instance()->connection();
+    if (!c || winIds.isEmpty())
+        return;
+
+    for (quint32 winId : winIds) {
+        xcb_destroy_window(c, winId);
+        m_windows.removeOne(winId);
+    }
+    xcb_flush(c);
+
+    m_trayManager->setTrayIcons(m_windows);
+}
+
+void FakeXEmbedClient::damage(quint32 winId)
+{
+    m_trayManager->notifyChanged(winId);
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef FAKEXEMBEDCLIENT_H
+#define FAKEXEMBEDCLIENT_H
+
+#include <QObject>
+#include <QDBusConnection>
+#include <QList>
+
+#include <xcb/xcb.h>
+
+typedef QList<quint32> TrayList;
+
+/**
+ * @brief The FakeTrayManager class
+ * 私有总线上的org.deepin.dde.TrayManager1，托盘图标列表由FakeXEmbedClient维护
+ */
+class FakeTrayManager : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.TrayManager1")
+    Q_PROPERTY(TrayList TrayIcons READ trayIcons)
+
+public:
+    explicit FakeTrayManager(const QString &address, QObject *parent = nullptr);
+    ~FakeTrayManager() override;
+
+    bool isValid() const;
+
+    TrayList trayIcons() const { return m_trayIcons; }
+    void setTrayIcons(const TrayList &trayIcons);
+    void notifyChanged(quint32 winId);
+
+public Q_SLOTS:
+    bool Manage() { return true; }
+    bool Unmanage() { return true; }
+    void RetryManager() {}
+    void EnableNotification(uint winId, bool enable) { Q_UNUSED(winId); Q_UNUSED(enable); }
+    QString GetName(uint winId) { return QString::number(winId); }
+
+Q_SIGNALS:
+    void Added(uint winId);
+    void Removed(uint winId);
+    void Changed(uint winId);
+    void Inited();
+
+private:
+    QDBusConnection m_connection;
+    TrayList m_trayIcons;
+    bool m_valid;
+};
+
+/**
+ * @brief The FakeXEmbedClient class
+ * 创建一批带WM_CLASS的X窗口作为XEmbed托盘客户端，并通过FakeTrayManager通知任务栏
+ */
+class FakeXEmbedClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeXEmbedClient(FakeTrayManager *trayManager, QObject *parent = nullptr);
+    ~FakeXEmbedClient() override;
+
+    static bool isAvailable();
+
+    QList<quint32> createWindows(int count);
+    void destroyWindows(const QList<quint32> &winIds);
+    void damage(quint32 winId);
+
+private:
+    FakeTrayManager *m_trayManager;
+    QList<quint32> m_windows;
+    int m_serial;
+};
+
+#endif // FAKEXEMBEDCLIENT_H
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "traychurnbenchmark.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QProcess>
+#include <QDebug>
+
+// 启动一个只属于本进程的会话总线，避免和桌面上真实的托盘服务互相干扰
+static QString startPrivateBus(QProcess &daemon)
+{
+    daemon.start("dbus-daemon", { "--session", "--nofork", "--print-address=1" });
+    if (!daemon.waitForStarted() || !daemon.waitForReadyRead())
+        return QString();
+
+    return QString::fromLocal8Bit(daemon.readLine()).trimmed();
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    // 设置应用名为dde-dock，否则dconfig相关的配置就读不到了
+    app.setApplicationName("dde-dock");
+    app.setProperty("CANSHOW", true);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption itemsOption("items", "SNI items registered per round.", "count", "30");
+    QCommandLineOption roundsOption("rounds", "Register/unregister rounds.", "count", "5");
+    QCommandLineOption updatesOption("updates", "Icon updates per item and round.", "count", "20");
+    QCommandLineOption xembedOption("xembed", "XEmbed items created per round, 0 to skip.", "count", "10");
+    QCommandLineOption expandedOption("expanded", "Keep the tray popup expanded so item widgets are created.");
+    parser.addOptions({ itemsOption, roundsOption, updatesOption, xembedOption, expandedOption });
+    parser.process(app);
+
+    TrayChurnBenchmark::Options options;
+    options.items = parser.value(itemsOption).toInt();
+    options.rounds = parser.value(roundsOption).toInt();
+    options.updates = parser.value(updatesOption).toInt();
+    options.xembedItems = parser.value(xembedOption).toInt();
+    options.expanded = parser.isSet(expandedOption);
+
+    QProcess daemon;
+    const QString address = startPrivateBus(daemon);
+    if (address.isEmpty()) {
+        qWarning() << "failed to start private dbus-daemon";
+        return -1;
+    }
+
+    // 被测代码统一使用QDBusConnection::sessionBus()，在第一次使用之前切换到私有总线
+    qputenv("DBUS_SESSION_BUS_ADDRESS", address.toLocal8Bit());
+
+    int ret = 0;
+    {
+        TrayChurnBenchmark benchmark(address, options);
+        ret = benchmark.run();
+    }
+
+    daemon.terminate();
+    daemon.waitForFinished();
+    return ret;
+}
@@ -0,0 +1,314 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "traychurnbenchmark.h"
+#include "fakesniwatcher.h"
+#include "fakesniitem.h"
+#include "fakexembedclient.h"
+#include "tray_model.h"
+#include "tray_gridview.h"
+#include "expandiconwidget.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+#include <algorithm>
+#include <unistd.h>
+
+#define XEMBED_KEY(winId) QString("xembed:%1").arg(winId)
+
+QString TrayChurnBenchmark::Samples::summary() const
+{
+    if (values.isEmpty())
+        return QString("no samples, %1 timeout").arg(timeouts);
+
+    QVector<qint64> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [ &sorted ](double p) {
+        return sorted.at(qMin(sorted.size() - 1, static_cast<int>(sorted.size() * p)));
+    };
+
+    return QString("n=%1 min=%2us p50=%3us p95=%4us max=%5us timeout=%6")
+            .arg(sorted.size()).arg(sorted.first()).arg(percentile(0.5))
+            .arg(percentile(0.95)).arg(sorted.last()).arg(timeouts);
+}
+
+TrayChurnBenchmark::TrayChurnBenchmark(const QString &busAddress, const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_busAddress(busAddress)
+    , m_options(options)
+    , m_watcher(nullptr)
+    , m_trayManager(nullptr)
+    , m_xembedClient(nullptr)
+{
+}
+
+TrayChurnBenchmark::~TrayChurnBenchmark()
+{
+    qDeleteAll(m_items);
+    delete m_xembedClient;
+    delete m_trayManager;
+    delete m_watcher;
+}
+
+int TrayChurnBenchmark::run()
+{
+    if (!setUp())
+        return -1;
+
+    flushDeferredDelete();
+    const qint64 baseMemory = residentMemory();
+    const int baseWidgets = QApplication::allWidgets().size();
+    const int baseRows = totalRows();
+
+    for (int round = 0; round < m_options.rounds; ++round) {
+        if (!runSniRound(round))
+            qWarning() << "sni round" << round << "did not settle";
+
+        if (m_xembedClient && !runXEmbedRound(round))
+            qWarning() << "xembed round" << round << "did not settle";
+
+        flushDeferredDelete();
+        m_roundMemory << residentMemory() - baseMemory;
+        m_roundWidgets << QApplication::allWidgets().size() - baseWidgets;
+    }
+
+    printReport(baseMemory, baseWidgets, baseRows);
+    return 0;
+}
+
+bool TrayChurnBenchmark::setUp()
+{
+    m_watcher = new FakeSNIWatcher(m_busAddress);
+    m_trayManager = new FakeTrayManager(m_busAddress);
+    if (!m_watcher->isValid() || !m_trayManager->isValid())
+        return false;
+
+    if (m_options.xembedItems > 0 && FakeXEmbedClient::isAvailable())
+        m_xembedClient = new FakeXEmbedClient(m_trayManager);
+
+    m_clock.start();
+
+    // 两个模型各自持有一个TrayMonitor，托盘会根据配置出现在其中一个模型中
+    for (TrayModel *model : { TrayModel::getDockModel(), TrayModel::getIconModel() }) {
+        connect(model, &TrayModel::rowsInserted, this, [ this, model ](const QModelIndex &, int first, int last) {
+            onRowsInserted(model, first, last);
+        });
+        connect(model, &TrayModel::rowsAboutToBeRemoved, this, [ this, model ](const QModelIndex &, int first, int last) {
+            onRowsAboutToBeRemoved(model, first, last);
+        });
+    }
+
+    if (m_options.expanded)
+        ExpandIconWidget::popupTrayView()->trayView()->activateEditors();
+
+    // 等待TrayMonitor完成初始的列表读取
+    QElapsedTimer settleTimer;
+    settleTimer.start();
+    waitFor([ &settleTimer ] { return settleTimer.elapsed() > 500; });
+    return true;
+}
+
+bool TrayChurnBenchmark::runSniRound(int round)
+{
+    // 注册
+    for (int i = 0; i < m_options.items; ++i) {
+        FakeSNIItem *item = new FakeSNIItem(m_busAddress, round * m_options.items + i);
+        m_pendingAdd.insert(item->servicePath(), m_clock.nsecsElapsed() / 1000);
+        if (!item->registerItem()) {
+            m_pendingAdd.remove(item->servicePath());
+            delete item;
+            continue;
+        }
+
+        m_items << item;
+    }
+
+    bool settled = waitFor([ this ] { return m_pendingAdd.isEmpty(); });
+    m_addLatency.timeouts += m_pendingAdd.size();
+    m_pendingAdd.clear();
+
+    // 图标刷新
+    const int readsBefore = iconReads();
+    QElapsedTimer updateClock;
+    updateClock.start();
+    for (int i = 0; i < m_options.updates; ++i) {
+        for (FakeSNIItem *item : m_items)
+            item->updateIcon();
+    }
+
+    // 只有已创建控件的托盘才会读取图标，以读取次数不再增长作为处理完成的标志
+    int lastReads = -1;
+    waitFor([ this, &lastReads ] {
+        const int reads = iconReads();
+        if (reads == lastReads)
+            return true;
+
+        lastReads = reads;
+        return false;
+    });
+    const qint64 updateElapsed = qMax<qint64>(1, updateClock.nsecsElapsed() / 1000);
+    m_iconThroughput << (iconReads() - readsBefore) * 1000000.0 / updateElapsed;
+
+    // 模拟应用崩溃，所有托盘同时断开
+    for (FakeSNIItem *item : m_items) {
+        m_pendingRemove.insert(item->servicePath(), m_clock.nsecsElapsed() / 1000);
+        item->crash();
+    }
+
+    settled = waitFor([ this ] { return m_pendingRemove.isEmpty(); }) && settled;
+    m_removeLatency.timeouts += m_pendingRemove.size();
+    m_pendingRemove.clear();
+
+    qDeleteAll(m_items);
+    m_items.clear();
+    return settled;
+}
+
+bool TrayChurnBenchmark::runXEmbedRound(int round)
+{
+    Q_UNUSED(round);
+
+    const qint64 start = m_clock.nsecsElapsed() / 1000;
+    const QList<quint32> winIds = m_xembedClient->createWindows(m_options.xembedItems);
+    for (quint32 winId : winIds)
+        m_pendingAdd.insert(XEMBED_KEY(winId), start);
+
+    bool settled = waitFor([ this ] { return m_pendingAdd.isEmpty(); });
+    m_xembedAddLatency.timeouts += m_pendingAdd.size();
+    m_pendingAdd.clear();
+
+    for (int i = 0; i < m_options.updates; ++i) {
+        for (quint32 winId : winIds)
+            m_xembedClient->damage(winId);
+    }
+
+    const qint64 removeStart = m_clock.nsecsElapsed() / 1000;
+    for (quint32 winId : winIds)
+        m_pendingRemove.insert(XEMBED_KEY(winId), removeStart);
+    m_xembedClient->destroyWindows(winIds);
+
+    settled = waitFor([ this ] { return m_pendingRemove.isEmpty(); }) && settled;
+    m_xembedRemoveLatency.timeouts += m_pendingRemove.size();
+    m_pendingRemove.clear();
+    return settled;
+}
+
+void TrayChurnBenchmark::onRowsInserted(TrayModel *model, int first, int last)
+{
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = model->index(row, 0);
+        const TrayIconType type = index.data(TrayModel::TypeRole).value<TrayIconType>();
+        if (type == TrayIconType::Sni) {
+            const QString key = index.data(TrayModel::ServiceRole).toString();
+            if (m_pendingAdd.contains(key))
+                m_addLatency.append(now - m_pendingAdd.take(key));
+        } else if (type == TrayIconType::XEmbed) {
+            const QString key = XEMBED_KEY(index.data(TrayModel::WinIdRole).value<quint32>());
+            if (m_pendingAdd.contains(key))
+                m_xembedAddLatency.append(now - m_pendingAdd.take(key));
+        }
+    }
+}
+
+void TrayChurnBenchmark::onRowsAboutToBeRemoved(TrayModel *model, int first, int last)
+{
+    const qint64 now = m_clock.nsecsElapsed() / 1000;
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = model->index(row, 0);
+        const TrayIconType type = index.data(TrayModel::TypeRole).value<TrayIconType>();
+        if (type == TrayIconType::Sni) {
+            const QString key = index.data(TrayModel::ServiceRole).toString();
+            if (m_pendingRemove.contains(key))
+                m_removeLatency.append(now - m_pendingRemove.take(key));
+        } else if (type == TrayIconType::XEmbed) {
+            const QString key = XEMBED_KEY(index.data(TrayModel::WinIdRole).value<quint32>());
+            if (m_pendingRemove.contains(key))
+                m_xembedRemoveLatency.append(now - m_pendingRemove.take(key));
+        }
+    }
+}
+
+bool TrayChurnBenchmark::waitFor(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < m_options.timeout) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        if (condition())
+            return true;
+    }
+
+    return false;
+}
+
+void TrayChurnBenchmark::flushDeferredDelete()
+{
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+int TrayChurnBenchmark::totalRows() const
+{
+    return TrayModel::getDockModel()->rowCount() + TrayModel::getIconModel()->rowCount();
+}
+
+int TrayChurnBenchmark::iconReads() const
+{
+    int reads = 0;
+    for (FakeSNIItem *item : m_items)
+        reads += item->iconReadCount();
+
+    return reads;
+}
+
+qint64 TrayChurnBenchmark::residentMemory()
+{
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return 0;
+
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2)
+        return 0;
+
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+}
+
+void TrayChurnBenchmark::printReport(qint64 baseMemory, int baseWidgets, int baseRows)
+{
+    QTextStream out(stdout);
+    out << "tray churn benchmark: " << m_options.rounds << " rounds, " << m_options.items << " sni items, "
+        << m_options.xembedItems << " xembed items, " << m_options.updates << " icon updates per item, tray "
+        << (m_options.expanded ? "expanded" : "collapsed") << Qt::endl;
+
+    out << "  sni add latency:       " << m_addLatency.summary() << Qt::endl;
+    out << "  sni remove latency:    " << m_removeLatency.summary() << Qt::endl;
+    if (m_xembedClient) {
+        out << "  xembed add latency:    " << m_xembedAddLatency.summary() << Qt::endl;
+        out << "  xembed remove latency: " << m_xembedRemoveLatency.summary() << Qt::endl;
+    } else {
+        out << "  xembed: skipped, no X connection" << Qt::endl;
+    }
+
+    out << "  icon updates/s:";
+    for (double throughput : m_iconThroughput)
+        out << " " << QString::number(throughput, 'f', 0);
+    out << Qt::endl;
+
+    out << "  memory growth (KiB):";
+    for (qint64 memory : m_roundMemory)
+        out << " " << memory / 1024;
+    out << "  (base " << baseMemory / 1024 << " KiB)" << Qt::endl;
+
+    out << "  leaked widgets:";
+    for (int widgets : m_roundWidgets)
+        out << " " << widgets;
+    out << "  (base " << baseWidgets << ")" << Qt::endl;
+
+    out << "  leaked rows: " << totalRows() - baseRows << Qt::endl;
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef TRAYCHURNBENCHMARK_H
+#define TRAYCHURNBENCHMARK_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include <functional>
+
+class FakeSNIWatcher;
+class FakeSNIItem;
+class FakeTrayManager;
+class FakeXEmbedClient;
+class TrayModel;
+
+/**
+ * @brief The TrayChurnBenchmark class
+ * 在私有会话总线上模拟大量托盘反复注册、刷新图标和注销(例如聊天软件崩溃重启)，
+ * 统计TrayMonitor/TrayModel及托盘控件的增删延迟、图标刷新吞吐、内存增长和泄漏的控件
+ */
+class TrayChurnBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int items = 30;             // 每轮注册的SNI托盘数
+        int rounds = 5;             // 注册/注销的轮数
+        int updates = 20;           // 每个托盘每轮刷新图标的次数
+        int xembedItems = 10;       // 每轮创建的XEmbed托盘数
+        bool expanded = false;      // 是否展开托盘区域(展开后才会创建托盘图标控件)
+        int timeout = 10000;        // 每个阶段的超时时间(毫秒)
+    };
+
+    TrayChurnBenchmark(const QString &busAddress, const Options &options, QObject *parent = nullptr);
+    ~TrayChurnBenchmark() override;
+
+    int run();
+
+private:
+    struct Samples {
+        QVector<qint64> values;     // 微秒
+        int timeouts = 0;
+
+        void append(qint64 value) { values << value; }
+        QString summary() const;
+    };
+
+    bool setUp();
+    bool runSniRound(int round);
+    bool runXEmbedRound(int round);
+
+    void onRowsInserted(TrayModel *model, int first, int last);
+    void onRowsAboutToBeRemoved(TrayModel *model, int first, int last);
+    bool waitFor(const std::function<bool()> &condition);
+    void flushDeferredDelete();
+    int totalRows() const;
+    int iconReads() const;
+    static qint64 residentMemory();
+
+    void printReport(qint64 baseMemory, int baseWidgets, int baseRows);
+
+private:
+    QString m_busAddress;
+    Options m_options;
+    QElapsedTimer m_clock;
+
+    FakeSNIWatcher *m_watcher;
+    FakeTrayManager *m_trayManager;
+    FakeXEmbedClient *m_xembedClient;
+    QList<FakeSNIItem *> m_items;
+
+    QHash<QString, qint64> m_pendingAdd;       // 托盘标识 -> 发起注册的时间
+    QHash<QString, qint64> m_pendingRemove;    // 托盘标识 -> 发起注销的时间
+
+    Samples m_addLatency;
+    Samples m_removeLatency;
+    Samples m_xembedAddLatency;
+    Samples m_xembedRemoveLatency;
+    QVector<double> m_iconThroughput;           // 每秒处理的图标刷新次数
+    QVector<qint64> m_roundMemory;
+    QVector<int> m_roundWidgets;
+};
+
+#endif // TRAYCHURNBENCHMARK_H
@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowstateindex.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QDebug>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+/**
+ * 智能隐藏判断性能测试
+ * 回放窗口事件序列(ConfigureNotify、PropertyNotify、层叠顺序和工作区变化)，维护窗口状态索引，
+ * 每次活动窗口变化和窗口移动后进行一次智能隐藏判断，统计判断耗时
+ *
+ * 事件序列文件每行一个事件：
+ *   window <xid> <x> <y> <w> <h> <desktop> <pid> <leader> <transientFor> <class>
+ *   configure <xid> <x> <y> <w> <h>
+ *   hidden <xid> <0|1>
+ *   desktop <xid> <desktop>
+ *   current <desktop>
+ *   stack <xid> ...
+ *   remove <xid>
+ *   active <xid>
+ */
+
+static const QRect dockRect(0, 1040, 1920, 40);
+
+// 生成固定的事件序列：打开指定数量的窗口，之后反复移动、切换、最小化窗口和切换工作区
+static QStringList generateTrace(int windowCount, int eventCount)
+{
+    QRandomGenerator random(20230101);
+    QStringList trace;
+    QVector<uint> windows;
+
+    auto stackLine = [ & ] {
+        QString line = "stack";
+        for (uint xid : windows)
+            line += QString(" %1").arg(xid);
+        return line;
+    };
+
+    for (int i = 0; i < windowCount; ++i) {
+        const uint xid = 0x4000000 + uint(i) * 0x10;
+        // 每个应用平均4个窗口，部分窗口是对话框
+        const int app = i / 4;
+        const uint transientFor = (i % 4 == 3) ? windows.last() : 0;
+        trace << QString("window %1 %2 %3 %4 %5 %6 %7 %8 %9 app-%10")
+                 .arg(xid)
+                 .arg(random.bounded(1600)).arg(random.bounded(900))
+                 .arg(320 + random.bounded(800)).arg(240 + random.bounded(600))
+                 .arg(random.bounded(4))
+                 .arg(1000 + app)
+                 .arg(0x3000000 + uint(app) * 0x10)
+                 .arg(transientFor)
+                 .arg(app);
+        windows << xid;
+    }
+    trace << stackLine() << "current 0";
+
+    for (int i = 0; i < eventCount; ++i) {
+        const uint xid = windows.at(random.bounded(windows.size()));
+        const int type = random.bounded(100);
+        if (type < 60) {
+            trace << QString("configure %1 %2 %3 %4 %5").arg(xid)
+                     .arg(random.bounded(1600)).arg(random.bounded(1000))
+                     .arg(320 + random.bounded(800)).arg(240 + random.bounded(600));
+        } else if (type < 85) {
+            // 激活窗口时窗口移动到最上层
+            windows.removeOne(xid);
+            windows << xid;
+            trace << stackLine() << QString("active %1").arg(xid);
+            continue;
+        } else if (type < 93) {
+            trace << QString("hidden %1 %2").arg(xid).arg(random.bounded(2));
+        } else if (type < 97) {
+            trace << QString("desktop %1 %2").arg(xid).arg(random.bounded(4));
+        } else {
+            trace << QString("current %1").arg(random.bounded(4));
+        }
+        trace << QString("active %1").arg(windows.last());
+    }
+
+    return trace;
+}
+
+static QStringList loadTrace(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "failed to open trace file" << filePath;
+        return QStringList();
+    }
+
+    return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+static void saveTrace(const QString &filePath, const QStringList &trace)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "failed to write trace file" << filePath;
+        return;
+    }
+
+    QTextStream stream(&file);
+    for (const QString &line : trace)
+        stream << line << '\n';
+}
+
+static double percentile(const std::vector<qint64> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    const size_t index = std::min(sorted.size() - 1, size_t(p * (sorted.size() - 1) + 0.5));
+    return double(sorted[index]);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption windowsOption("windows", "Windows opened by the generated trace.", "count", "200");
+    QCommandLineOption eventsOption("events", "Events in the generated trace.", "count", "20000");
+    QCommandLineOption saveOption("save", "Write the generated trace to a file.", "file");
+    parser.addOption(windowsOption);
+    parser.addOption(eventsOption);
+    parser.addOption(saveOption);
+    parser.addPositionalArgument("trace", "Recorded event trace to replay.", "[trace]");
+    parser.process(app);
+
+    QStringList trace;
+    if (!parser.positionalArguments().isEmpty()) {
+        trace = loadTrace(parser.positionalArguments().first());
+    } else {
+        trace = generateTrace(qMax(1, parser.value(windowsOption).toInt()), qMax(1, parser.value(eventsOption).toInt()));
+        if (parser.isSet(saveOption))
+            saveTrace(parser.value(saveOption), trace);
+    }
+
+    if (trace.isEmpty())
+        return 1;
+
+    // 判断过程中的日志会淹没判断本身的耗时
+    QLoggingCategory::setFilterRules("default.info=false");
+
+    WindowStateIndex index;
+    std::vector<qint64> decisionCosts;
+    qint64 eventCost = 0;
+    int eventCount = 0;
+    int hideCount = 0;
+    XWindow active = 0;
+
+    QElapsedTimer timer;
+    for (const QString &line : trace) {
+        const QStringList args = line.split(' ', Qt::SkipEmptyParts);
+        const QString &type = args.first();
+        auto arg = [ & ](int i) { return args.value(i).toUInt(); };
+
+        if (type == "active")
+            active = arg(1);
+
+        timer.start();
+        if (type == "window" && args.size() >= 11) {
+            WindowState state;
+            state.geometry = Geometry{ int16_t(arg(2)), int16_t(arg(3)), uint16_t(arg(4)), uint16_t(arg(5)) };
+            state.desktop = arg(6);
+            state.pid = arg(7);
+            state.clientLeader = arg(8);
+            state.transientFor = arg(9);
+            state.instanceName = args.at(10);
+            state.className = args.at(10);
+            index.updateWindow(arg(1), state);
+        } else if (type == "configure" && args.size() >= 6) {
+            index.setGeometry(arg(1), Geometry{ int16_t(arg(2)), int16_t(arg(3)), uint16_t(arg(4)), uint16_t(arg(5)) });
+        } else if (type == "hidden") {
+            index.setHidden(arg(1), arg(2));
+        } else if (type == "desktop") {
+            index.setDesktop(arg(1), arg(2));
+        } else if (type == "current") {
+            index.setCurrentDesktop(arg(1));
+        } else if (type == "stack") {
+            QVector<XWindow> stacking;
+            for (int i = 1; i < args.size(); ++i)
+                stacking << arg(i);
+            index.setStacking(stacking);
+        } else if (type == "remove") {
+            index.removeWindow(arg(1));
+        } else if (type != "active") {
+            continue;
+        }
+        eventCost += timer.nsecsElapsed();
+        ++eventCount;
+
+        // 活动窗口变化和窗口移动都会触发智能隐藏判断
+        if (active == 0 || (type != "active" && type != "configure"))
+            continue;
+
+        timer.start();
+        hideCount += index.shouldHide(active, dockRect);
+        decisionCosts.push_back(timer.nsecsElapsed());
+    }
+
+    std::sort(decisionCosts.begin(), decisionCosts.end());
+    qint64 total = 0;
+    for (qint64 cost : decisionCosts)
+        total += cost;
+
+    printf("smart-hide decision with %d windows, %zu decisions (%d hide)\n",
+           index.size(), decisionCosts.size(), hideCount);
+    printf("decision latency in ns: avg %.1f p50 %.1f p99 %.1f max %.1f\n",
+           decisionCosts.empty() ? 0.0 : double(total) / decisionCosts.size(),
+           percentile(decisionCosts, 0.5),
+           percentile(decisionCosts, 0.99),
+           percentile(decisionCosts, 1.0));
+    printf("event update in ns: avg %.1f over %d events\n",
+           eventCount ? double(eventCost) / eventCount : 0.0, eventCount);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QProcess>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "remotepluginproxy.h"
+#include "constants.h"
+
+#if defined(HOST_FIXTURE_PLUGIN) && defined(PLUGIN_HOST_PROGRAM)
+
+// 模拟任务栏的插件代理，记录宿主进程添加的插件项
+class HostFixtureProxy : public PluginProxyInterface
+{
+public:
+    void itemAdded(PluginsItemInterface * const, const QString &itemKey) override { items << itemKey; }
+    void itemUpdate(PluginsItemInterface * const, const QString &) override {}
+    void itemRemoved(PluginsItemInterface * const, const QString &itemKey) override { items.remove(itemKey); }
+    void requestWindowAutoHide(PluginsItemInterface * const, const QString &, const bool) override {}
+    void requestRefreshWindowVisible(PluginsItemInterface * const, const QString &) override {}
+    void requestSetAppletVisible(PluginsItemInterface * const, const QString &, const bool) override {}
+    void saveValue(PluginsItemInterface * const, const QString &, const QVariant &) override {}
+    const QVariant getValue(PluginsItemInterface * const, const QString &, const QVariant &fallback) override { return fallback; }
+    void removeValue(PluginsItemInterface * const, const QStringList &) override {}
+
+public:
+    QSet<QString> items;
+};
+
+class Test_RemotePluginProxy : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    // 启动宿主进程并用指定的配置初始化插件，不经过DockSettings
+    bool startHost(const QVariantMap &settings);
+
+public:
+    RemotePluginProxy *proxy = nullptr;
+    HostFixtureProxy *proxyInter = nullptr;
+};
+
+void Test_RemotePluginProxy::SetUp()
+{
+    proxy = new RemotePluginProxy(HOST_FIXTURE_PLUGIN);
+    proxy->m_hostProgram = PLUGIN_HOST_PROGRAM;
+    proxy->m_pingTimer->setInterval(200);
+    proxyInter = new HostFixtureProxy;
+}
+
+void Test_RemotePluginProxy::TearDown()
+{
+    delete proxy;
+    proxy = nullptr;
+    delete proxyInter;
+    proxyInter = nullptr;
+}
+
+bool Test_RemotePluginProxy::startHost(const QVariantMap &settings)
+{
+    QSignalSpy readySpy(proxy, &RemotePluginProxy::ready);
+    if (!proxy->start() || !readySpy.wait(5000))
+        return false;
+
+    proxy->m_proxyInter = proxyInter;
+    proxy->m_channel->send(PluginHostChannel::Init, settings, int(Dock::Efficient), int(Dock::Bottom));
+    return true;
+}
+
+TEST_F(Test_RemotePluginProxy, render_test)
+{
+    ASSERT_TRUE(startHost(QVariantMap()));
+    ASSERT_EQ(proxy->pluginName(), "host-fixture");
+    ASSERT_TRUE(QTest::qWaitFor([ & ] { return proxyInter->items.contains("host-fixture"); }, 3000));
+
+    // 插件项的图像通过共享内存传过来
+    QWidget *itemWidget = proxy->itemWidget("host-fixture");
+    ASSERT_NE(itemWidget, nullptr);
+    RemoteItemWidget *remoteWidget = static_cast<RemoteItemWidget *>(itemWidget);
+    ASSERT_TRUE(QTest::qWaitFor([ & ] { return !remoteWidget->image().isNull(); }, 3000));
+    ASSERT_EQ(QColor(remoteWidget->image().pixel(10, 10)), QColor(Qt::red));
+
+    // 插件项没有变化时宿主进程不再发送图像，截图本身不能触发下一次截图
+    int imageCount = 0;
+    QObject::connect(proxy->m_channel, &PluginHostChannel::messageReceived, [ & ](PluginHostChannel::MessageType type) {
+        if (type == PluginHostChannel::ItemImage)
+            ++imageCount;
+    });
+    QTest::qWait(500);
+    ASSERT_LE(imageCount, 1);
+
+    // 宿主进程一直回复Ping
+    QSignalSpy exitedSpy(proxy, &RemotePluginProxy::hostExited);
+    QTest::qWait(1000);
+    ASSERT_EQ(exitedSpy.count(), 0);
+}
+
+TEST_F(Test_RemotePluginProxy, crash_test)
+{
+    QSignalSpy exitedSpy(proxy, &RemotePluginProxy::hostExited);
+    ASSERT_TRUE(startHost(QVariantMap { { "crash", true } }));
+    ASSERT_TRUE(exitedSpy.wait(3000));
+}
+
+TEST_F(Test_RemotePluginProxy, hang_test)
+{
+    // 插件在初始化时阻塞，宿主进程不再回复Ping后被结束
+    QSignalSpy exitedSpy(proxy, &RemotePluginProxy::hostExited);
+    ASSERT_TRUE(startHost(QVariantMap { { "hang", true } }));
+    ASSERT_TRUE(exitedSpy.wait(3000));
+    ASSERT_EQ(proxy->m_process->exitStatus(), QProcess::CrashExit);
+}
+
+TEST_F(Test_RemotePluginProxy, failed_test)
+{
+    // 不是插件的文件，宿主进程加载失败后直接退出
+    delete proxy;
+    proxy = new RemotePluginProxy(PLUGIN_HOST_PROGRAM);
+    proxy->m_hostProgram = PLUGIN_HOST_PROGRAM;
+
+    QSignalSpy failedSpy(proxy, &RemotePluginProxy::failed);
+    ASSERT_TRUE(proxy->start());
+    ASSERT_TRUE(failedSpy.wait(5000));
+}
+
+#endif
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "screentopology.h"
+
+using namespace Dock;
+
+static ScreenTopology::ScreenInfo screenInfo(const QString &name, const QRect &geometry, qreal ratio = 1.0, bool primary = false)
+{
+    ScreenTopology::ScreenInfo info;
+    info.name = name;
+    info.geometry = geometry;
+    info.devicePixelRatio = ratio;
+    info.primary = primary;
+    return info;
+}
+
+// 横向rows行columns列排列的屏幕，序号按行排列
+static QList<ScreenTopology::ScreenInfo> gridScreens(int rows, int columns)
+{
+    QList<ScreenTopology::ScreenInfo> screens;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            screens << screenInfo(QString("HDMI-%1").arg(screens.size()), QRect(column * 1920, row * 1080, 1920, 1080));
+    }
+
+    return screens;
+}
+
+class Test_ScreenTopology : public ::testing::Test
+{
+public:
+    ScreenTopology topology;
+};
+
+TEST_F(Test_ScreenTopology, empty_test)
+{
+    ASSERT_EQ(topology.count(), 0);
+    ASSERT_EQ(topology.screenAt(QPoint(0, 0)), -1);
+    ASSERT_EQ(topology.firstDockable(Bottom), -1);
+    ASSERT_FALSE(topology.canDock(0, Bottom));
+    ASSERT_FALSE(topology.isCursorOut(QPoint(0, 0), Bottom, 40));
+    ASSERT_TRUE(topology.name(topology.firstDockable(Bottom)).isEmpty());
+}
+
+TEST_F(Test_ScreenTopology, single_test)
+{
+    topology.build(gridScreens(1, 1));
+
+    for (int pos = Top; pos <= Left; ++pos)
+        ASSERT_TRUE(topology.canDock(0, Position(pos)));
+
+    ASSERT_EQ(topology.indexOf("HDMI-0"), 0);
+    ASSERT_EQ(topology.screenAt(QPoint(1919, 1079)), 0);
+    ASSERT_EQ(topology.screenAt(QPoint(1920, 0)), -1);
+    ASSERT_FALSE(topology.isCursorOut(QPoint(960, 1050), Bottom, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(960, 1000), Bottom, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(100, 500), Left, 40));
+    ASSERT_TRUE(topology.onScreenEdge(0, QPoint(1920, 500)));
+    ASSERT_FALSE(topology.onScreenEdge(0, QPoint(1000, 500)));
+}
+
+TEST_F(Test_ScreenTopology, horizontal_test)
+{
+    // 1到6个横向排列的屏幕，两端屏幕的外侧和所有屏幕的上下边可以停靠
+    for (int n = 1; n <= 6; ++n) {
+        topology.build(gridScreens(1, n));
+        ASSERT_EQ(topology.count(), n);
+
+        for (int i = 0; i < n; ++i) {
+            ASSERT_TRUE(topology.canDock(i, Top));
+            ASSERT_TRUE(topology.canDock(i, Bottom));
+            ASSERT_EQ(topology.canDock(i, Left), i == 0);
+            ASSERT_EQ(topology.canDock(i, Right), i == n - 1);
+            ASSERT_EQ(topology.screenAt(QPoint(i * 1920 + 960, 540)), i);
+            ASSERT_EQ(topology.screenAt(QPoint(i * 1920, 0)), i);
+        }
+
+        ASSERT_EQ(topology.screenAt(QPoint(n * 1920, 0)), -1);
+        ASSERT_EQ(topology.firstDockable(Right), n - 1);
+    }
+
+    // 共享的边界上优先使用排在前面的屏幕
+    ASSERT_FALSE(topology.isCursorOut(QPoint(1920, 1060), Bottom, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(1920, 1000), Bottom, 40));
+    ASSERT_EQ(topology.neighbours(1, Right), QList<int>() << 2);
+    ASSERT_EQ(topology.neighbours(1, Left), QList<int>() << 0);
+}
+
+TEST_F(Test_ScreenTopology, grid_test)
+{
+    // 两行三列
+    topology.build(gridScreens(2, 3));
+
+    ASSERT_TRUE(topology.canDock(0, Top));
+    ASSERT_TRUE(topology.canDock(0, Left));
+    ASSERT_FALSE(topology.canDock(0, Bottom));
+    ASSERT_FALSE(topology.canDock(0, Right));
+    ASSERT_FALSE(topology.canDock(4, Top));
+    ASSERT_FALSE(topology.canDock(4, Left));
+    ASSERT_FALSE(topology.canDock(4, Right));
+    ASSERT_TRUE(topology.canDock(4, Bottom));
+    ASSERT_TRUE(topology.canDock(5, Right));
+
+    ASSERT_EQ(topology.firstDockable(Bottom), 3);
+    ASSERT_EQ(topology.firstDockable(Right), 2);
+    ASSERT_EQ(topology.screenAt(QPoint(2000, 1100)), 4);
+    ASSERT_EQ(topology.screenAt(QPoint(5759, 2159)), 5);
+    ASSERT_EQ(topology.screenAt(QPoint(5760, 2159)), -1);
+
+    // 任务栏在下方时只和下面一行屏幕比较
+    ASSERT_FALSE(topology.isCursorOut(QPoint(3000, 2150), Bottom, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(3000, 1000), Bottom, 40));
+    ASSERT_FALSE(topology.isCursorOut(QPoint(5750, 1500), Right, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(5000, 1500), Right, 40));
+}
+
+TEST_F(Test_ScreenTopology, diagonal_test)
+{
+    // 对角排列的屏幕只有一个公共点，不算拼接
+    topology.build({ screenInfo("HDMI-0", QRect(0, 0, 1920, 1080)), screenInfo("HDMI-1", QRect(1920, 1080, 1920, 1080)) });
+
+    for (int i = 0; i < 2; ++i) {
+        for (int pos = Top; pos <= Left; ++pos)
+            ASSERT_TRUE(topology.canDock(i, Position(pos)));
+    }
+
+    ASSERT_EQ(topology.screenAt(QPoint(1920, 1080)), 1);
+    ASSERT_EQ(topology.screenAt(QPoint(1919, 1080)), -1);
+}
+
+TEST_F(Test_ScreenTopology, mixedDpi_test)
+{
+    // 第二个屏幕缩放2倍，逻辑大小1280x720，实际像素2560x1440
+    topology.build({ screenInfo("eDP-1", QRect(0, 0, 1920, 1080), 1.0, true),
+                     screenInfo("DP-1", QRect(1920, 0, 1280, 720), 2.0) });
+
+    ASSERT_EQ(topology.rect(1), QRect(1920, 0, 2560, 1440));
+    ASSERT_FALSE(topology.canDock(0, Right));
+    ASSERT_FALSE(topology.canDock(1, Left));
+    ASSERT_TRUE(topology.canDock(1, Bottom));
+
+    ASSERT_EQ(topology.screenAt(QPoint(3000, 1200)), 1);
+    ASSERT_EQ(topology.screenAt(QPoint(1000, 1200)), -1);
+
+    // 每个屏幕按自己的实际大小判断任务栏区域
+    ASSERT_FALSE(topology.isCursorOut(QPoint(3000, 1400), Bottom, 60));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(3000, 1300), Bottom, 60));
+    ASSERT_FALSE(topology.isCursorOut(QPoint(1000, 1050), Bottom, 60));
+    ASSERT_TRUE(topology.onScreenEdge(1, QPoint(4480, 100)));
+}
+
+TEST_F(Test_ScreenTopology, stacked_test)
+{
+    // 上下拼接，下面的屏幕较窄
+    topology.build({ screenInfo("HDMI-0", QRect(0, 0, 2560, 1440)), screenInfo("HDMI-1", QRect(320, 1440, 1920, 1080)) });
+
+    ASSERT_FALSE(topology.canDock(0, Bottom));
+    ASSERT_FALSE(topology.canDock(1, Top));
+    ASSERT_TRUE(topology.canDock(0, Left));
+    ASSERT_TRUE(topology.canDock(1, Left));
+
+    // 下面屏幕之外的横坐标没有可以停靠的屏幕
+    ASSERT_FALSE(topology.isCursorOut(QPoint(100, 500), Bottom, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(1000, 500), Bottom, 40));
+
+    // 任务栏在左侧时按纵坐标找到所在的屏幕
+    ASSERT_FALSE(topology.isCursorOut(QPoint(330, 2000), Left, 40));
+    ASSERT_TRUE(topology.isCursorOut(QPoint(100, 2000), Left, 40));
+}
+
+TEST_F(Test_ScreenTopology, copyMode_test)
+{
+    topology.build({ screenInfo("HDMI-0", QRect(0, 0, 1920, 1080)), screenInfo("HDMI-1", QRect(0, 0, 1920, 1080)) });
+
+    for (int i = 0; i < 2; ++i) {
+        for (int pos = Top; pos <= Left; ++pos)
+            ASSERT_TRUE(topology.canDock(i, Position(pos)));
+    }
+
+    ASSERT_EQ(topology.screenAt(QPoint(100, 100)), 0);
+}
+
+TEST_F(Test_ScreenTopology, onlyPrimary_test)
+{
+    QList<ScreenTopology::ScreenInfo> screens = gridScreens(1, 3);
+    screens[1].primary = true;
+    topology.build(screens, true);
+
+    for (int pos = Top; pos <= Left; ++pos) {
+        ASSERT_FALSE(topology.canDock(0, Position(pos)));
+        ASSERT_TRUE(topology.canDock(1, Position(pos)));
+        ASSERT_FALSE(topology.canDock(2, Position(pos)));
+        ASSERT_EQ(topology.firstDockable(Position(pos)), 1);
+    }
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QMouseEvent>
+#include <QTest>
+#include <QWidget>
+
+#include <gtest/gtest.h>
+
+#include "dragfeedback.h"
+
+class Test_DragFeedback : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    void moveMouse(const QPoint &globalPos);
+
+public:
+    DragFeedback *feedback = nullptr;
+    QWidget *source = nullptr;
+};
+
+void Test_DragFeedback::SetUp()
+{
+    source = new QWidget;
+    feedback = new DragFeedback;
+    feedback->setPositionFunction([](const QPoint &mousePos) { return mousePos - QPoint(10, 10); });
+    QPixmap pixmap(48, 48);
+    pixmap.fill(Qt::red);
+    feedback->setPixmap(pixmap, pixmap.size());
+}
+
+void Test_DragFeedback::TearDown()
+{
+    delete feedback;
+    feedback = nullptr;
+    delete source;
+    source = nullptr;
+}
+
+void Test_DragFeedback::moveMouse(const QPoint &globalPos)
+{
+    QMouseEvent event(QEvent::MouseMove, source->mapFromGlobal(globalPos), globalPos, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(source, &event);
+}
+
+TEST_F(Test_DragFeedback, idle_test)
+{
+    feedback->start();
+    const int moveCount = feedback->moveCount();
+
+    // 鼠标静止时不会被唤醒
+    QTest::qWait(300);
+    qInfo() << "idle drag wakeups per second:" << feedback->wakeupsPerSecond();
+    ASSERT_EQ(feedback->wakeupCount(), 0);
+    ASSERT_EQ(feedback->moveCount(), moveCount);
+    ASSERT_EQ(feedback->wakeupsPerSecond(), 0);
+}
+
+TEST_F(Test_DragFeedback, move_test)
+{
+    feedback->start();
+    QTest::qWait(10);
+
+    for (int i = 1; i <= 50; ++i) {
+        moveMouse(QPoint(100 + i, 200));
+        // 同一个事件发送给父控件时不重复处理
+        moveMouse(QPoint(100 + i, 200));
+    }
+
+    qInfo() << "moving drag wakeups per second:" << feedback->wakeupsPerSecond();
+    ASSERT_EQ(feedback->wakeupCount(), 50);
+    ASSERT_EQ(feedback->widget()->pos(), QPoint(140, 190));
+
+    // 停止之后不再跟随鼠标
+    feedback->stop();
+    moveMouse(QPoint(300, 300));
+    ASSERT_EQ(feedback->wakeupCount(), 50);
+    ASSERT_EQ(feedback->widget()->pos(), QPoint(140, 190));
+}
+
+TEST_F(Test_DragFeedback, shape_test)
+{
+    ASSERT_EQ(feedback->shapeCount(), 1);
+
+    // 重绘和相同大小的图标不重新计算形状
+    QPixmap pixmap(48, 48);
+    pixmap.fill(Qt::blue);
+    feedback->setPixmap(pixmap, pixmap.size());
+    for (int i = 0; i < 10; ++i)
+        feedback->widget()->repaint();
+    ASSERT_EQ(feedback->shapeCount(), 1);
+
+    // 大小变化时重新计算
+    QPixmap smallPixmap(16, 16);
+    smallPixmap.fill(Qt::blue);
+    feedback->setPixmap(smallPixmap, smallPixmap.size());
+    ASSERT_EQ(feedback->shapeCount(), 2);
+    ASSERT_EQ(feedback->widget()->size(), QSize(16, 16));
+}
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "hostfixtureplugin.h"
+
+#include <QThread>
+#include <QWidget>
+
+#include <cstdlib>
+
+#define ITEM_KEY "host-fixture"
+
+HostFixturePlugin::HostFixturePlugin(QObject *parent)
+    : QObject(parent)
+{
+}
+
+HostFixturePlugin::~HostFixturePlugin()
+{
+    delete m_itemWidget.data();
+}
+
+const QString HostFixturePlugin::pluginName() const
+{
+    return ITEM_KEY;
+}
+
+void HostFixturePlugin::init(PluginProxyInterface *proxyInter)
+{
+    m_proxyInter = proxyInter;
+
+    if (m_proxyInter->getValue(this, "crash", false).toBool())
+        abort();
+
+    while (m_proxyInter->getValue(this, "hang", false).toBool())
+        QThread::sleep(1);
+
+    m_itemWidget = new QWidget;
+    m_itemWidget->setFixedSize(20, 20);
+    m_itemWidget->setAutoFillBackground(true);
+    QPalette palette = m_itemWidget->palette();
+    palette.setColor(QPalette::Window, Qt::red);
+    m_itemWidget->setPalette(palette);
+
+    m_proxyInter->itemAdded(this, ITEM_KEY);
+}
+
+QWidget *HostFixturePlugin::itemWidget(const QString &itemKey)
+{
+    return itemKey == ITEM_KEY ? m_itemWidget.data() : nullptr;
+}
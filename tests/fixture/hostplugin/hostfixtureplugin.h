@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef HOSTFIXTUREPLUGIN_H
+#define HOSTFIXTUREPLUGIN_H
+
+#include "pluginsiteminterface.h"
+
+#include <QObject>
+#include <QPointer>
+
+// 插件宿主进程测试使用的插件，添加一个纯色的插件项，配置中的crash和hang分别让插件在初始化时崩溃和阻塞
+class HostFixturePlugin : public QObject, PluginsItemInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(PluginsItemInterface)
+    Q_PLUGIN_METADATA(IID "com.deepin.dock.PluginsItemInterface" FILE "hostfixture.json")
+
+public:
+    explicit HostFixturePlugin(QObject *parent = nullptr);
+    ~HostFixturePlugin() override;
+
+    const QString pluginName() const override;
+    void init(PluginProxyInterface *proxyInter) override;
+    QWidget *itemWidget(const QString &itemKey) override;
+
+private:
+    QPointer<QWidget> m_itemWidget;
+};
+
+#endif // HOSTFIXTUREPLUGIN_H
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "reloadfixtureplugin.h"
+
+#include <QWidget>
+
+#define ITEM_KEY "reload-fixture"
+
+ReloadFixturePlugin::ReloadFixturePlugin(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ReloadFixturePlugin::~ReloadFixturePlugin()
+{
+    delete m_itemWidget.data();
+}
+
+const QString ReloadFixturePlugin::pluginName() const
+{
+    return ITEM_KEY;
+}
+
+void ReloadFixturePlugin::init(PluginProxyInterface *proxyInter)
+{
+    m_proxyInter = proxyInter;
+    m_itemWidget = new QWidget;
+    ++fixtureInitCount();
+
+    const int loadCount = m_proxyInter->getValue(this, "loadCount", 0).toInt();
+    m_proxyInter->saveValue(this, "loadCount", loadCount + 1);
+    m_proxyInter->itemAdded(this, ITEM_KEY);
+}
+
+QWidget *ReloadFixturePlugin::itemWidget(const QString &itemKey)
+{
+    return itemKey == ITEM_KEY ? m_itemWidget.data() : nullptr;
+}
@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef RELOADFIXTUREPLUGIN_H
+#define RELOADFIXTUREPLUGIN_H
+
+#include "pluginsiteminterface.h"
+
+#include <QObject>
+#include <QPointer>
+
+// 内联函数中的静态变量是STB_GNU_UNIQUE符号，和很多实际的插件一样，带有这种符号的动态库dlclose后不会被卸载
+inline int &fixtureInitCount()
+{
+    static int count = 0;
+    return count;
+}
+
+// 插件热重载测试使用的插件，每次初始化时把配置中的加载次数加一并添加一个插件项
+class ReloadFixturePlugin : public QObject, PluginsItemInterface
+{
+    Q_OBJECT
+    Q_INTERFACES(PluginsItemInterface)
+    Q_PLUGIN_METADATA(IID "com.deepin.dock.PluginsItemInterface" FILE "reloadfixture.json")
+
+public:
+    explicit ReloadFixturePlugin(QObject *parent = nullptr);
+    ~ReloadFixturePlugin() override;
+
+    const QString pluginName() const override;
+    void init(PluginProxyInterface *proxyInter) override;
+    QWidget *itemWidget(const QString &itemKey) override;
+
+private:
+    QPointer<QWidget> m_itemWidget;
+};
+
+#endif // RELOADFIXTUREPLUGIN_H
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QRect>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "displaystatepipeline.h"
+
+class Test_DisplayStatePipeline : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    DisplayStatePipeline *pipeline = nullptr;
+    int updates[DisplayStatePipeline::OutputCount];
+};
+
+void Test_DisplayStatePipeline::SetUp()
+{
+    pipeline = new DisplayStatePipeline;
+    for (int i = 0; i < DisplayStatePipeline::OutputCount; ++i)
+        updates[i] = 0;
+
+    pipeline->setOutput(DisplayStatePipeline::UpdateRegion, DisplayStatePipeline::Screens | DisplayStatePipeline::DockSize
+                        | DisplayStatePipeline::DockPosition, [ this ] { ++updates[DisplayStatePipeline::UpdateRegion]; });
+    pipeline->setOutput(DisplayStatePipeline::NotifyFrontend, DisplayStatePipeline::Screens | DisplayStatePipeline::DockSize
+                        | DisplayStatePipeline::DockHideMode, [ this ] { ++updates[DisplayStatePipeline::NotifyFrontend]; });
+    pipeline->setOutput(DisplayStatePipeline::NotifyWindowManager, DisplayStatePipeline::Primary
+                        | DisplayStatePipeline::DockedScreen, [ this ] { ++updates[DisplayStatePipeline::NotifyWindowManager]; });
+}
+
+void Test_DisplayStatePipeline::TearDown()
+{
+    delete pipeline;
+    pipeline = nullptr;
+}
+
+TEST_F(Test_DisplayStatePipeline, dependency_test)
+{
+    pipeline->setInput(DisplayStatePipeline::Screens, QVariantList { QRect(0, 0, 1920, 1080) });
+    pipeline->setInput(DisplayStatePipeline::Primary, "HDMI-0");
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::UpdateRegion], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+
+    // 隐藏模式只影响通知后端
+    pipeline->setInput(DisplayStatePipeline::DockHideMode, 1);
+    ASSERT_FALSE(pipeline->isDirty(DisplayStatePipeline::UpdateRegion));
+    ASSERT_TRUE(pipeline->isDirty(DisplayStatePipeline::NotifyFrontend));
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::UpdateRegion], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 2);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+    ASSERT_EQ(pipeline->pushCount(DisplayStatePipeline::NotifyFrontend), 2);
+
+    // 重复的输入不推送，记录被忽略的次数
+    ASSERT_EQ(pipeline->suppressedCount(), 0);
+    pipeline->setInput(DisplayStatePipeline::Screens, QVariantList { QRect(0, 0, 1920, 1080) });
+    pipeline->setInput(DisplayStatePipeline::Primary, "HDMI-0");
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::UpdateRegion], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 2);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+    ASSERT_EQ(pipeline->suppressedCount(), 3);
+
+    // 单独推送一个输出
+    pipeline->setInput(DisplayStatePipeline::DockSize, QVariantList { 60, 40 });
+    pipeline->flush(DisplayStatePipeline::NotifyFrontend);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 3);
+    ASSERT_TRUE(pipeline->isDirty(DisplayStatePipeline::UpdateRegion));
+}
+
+TEST_F(Test_DisplayStatePipeline, chain_test)
+{
+    // 前面的输出更新了后面输出依赖的输入，在同一次推送中完成
+    pipeline->setOutput(DisplayStatePipeline::ResetScreen, DisplayStatePipeline::Screens, [ this ] {
+        ++updates[DisplayStatePipeline::ResetScreen];
+        pipeline->setInput(DisplayStatePipeline::DockedScreen, "HDMI-1");
+    });
+
+    pipeline->setInput(DisplayStatePipeline::Screens, QVariantList { QRect(0, 0, 1920, 1080), QRect(1920, 0, 1920, 1080) });
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::ResetScreen], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+    ASSERT_EQ(pipeline->input(DisplayStatePipeline::DockedScreen).toString(), QString("HDMI-1"));
+
+    // 所在屏幕没有变化时窗管不需要再次通知
+    pipeline->setInput(DisplayStatePipeline::Screens, QVariantList { QRect(0, 0, 1920, 1080), QRect(1920, 0, 2560, 1440) });
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::ResetScreen], 2);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+}
+
+TEST_F(Test_DisplayStatePipeline, delay_test)
+{
+    pipeline->setDelay(50);
+
+    // 延时期间的多次变化合并成一次推送
+    for (int size = 40; size <= 60; size += 5)
+        pipeline->setInput(DisplayStatePipeline::DockSize, QVariantList { size, size });
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 0);
+
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return updates[DisplayStatePipeline::NotifyFrontend] > 0; }, 1000));
+    QTest::qWait(100);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::UpdateRegion], 1);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 0);
+
+    // 全部失效后所有输出都推送一次
+    pipeline->invalidate();
+    pipeline->flush();
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyFrontend], 2);
+    ASSERT_EQ(updates[DisplayStatePipeline::UpdateRegion], 2);
+    ASSERT_EQ(updates[DisplayStatePipeline::NotifyWindowManager], 1);
+}
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "dockanimationcontroller.h"
+
+class Test_DockAnimationController : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    DockAnimationController::Track track(QList<QRect> &rects, const QRect &start, const QRect &end) const;
+
+public:
+    DockAnimationController *controller = nullptr;
+};
+
+void Test_DockAnimationController::SetUp()
+{
+    controller = new DockAnimationController;
+    controller->setFrameInterval(16);
+}
+
+void Test_DockAnimationController::TearDown()
+{
+    delete controller;
+    controller = nullptr;
+}
+
+DockAnimationController::Track Test_DockAnimationController::track(QList<QRect> &rects, const QRect &start, const QRect &end) const
+{
+    DockAnimationController::Track track;
+    track.start = start;
+    track.end = end;
+    track.update = [ &rects ](const QRect &rect) { rects << rect; };
+    return track;
+}
+
+TEST_F(Test_DockAnimationController, play_test)
+{
+    QList<QRect> mainRects;
+    QList<QRect> trayRects;
+    bool finished = false;
+
+    // 两个窗口由同一个时钟驱动
+    DockAnimationController::Stage stage;
+    stage.duration = 100;
+    stage.tracks << track(mainRects, QRect(0, 1080, 1000, 0), QRect(0, 1040, 1000, 40))
+                 << track(trayRects, QRect(1000, 1080, 200, 0), QRect(1000, 1040, 200, 40));
+    stage.finished = [ &finished ] { finished = true; };
+    controller->play("show", { stage });
+    ASSERT_TRUE(controller->isRunning());
+
+    ASSERT_TRUE(QTest::qWaitFor([ &finished ] { return finished; }, 1000));
+    ASSERT_FALSE(controller->isRunning());
+    ASSERT_EQ(mainRects.size(), trayRects.size());
+    ASSERT_EQ(mainRects.last(), QRect(0, 1040, 1000, 40));
+    ASSERT_EQ(trayRects.last(), QRect(1000, 1040, 200, 40));
+
+    const QList<DockAnimationController::Stats> history = controller->history();
+    ASSERT_EQ(history.size(), 1);
+    ASSERT_EQ(history.first().name, QString("show"));
+    ASSERT_EQ(history.first().duration, 100);
+    ASSERT_FALSE(history.first().interrupted);
+    ASSERT_EQ(history.first().intervals.size(), history.first().frames - 1);
+    ASSERT_GE(history.first().elapsed, 100);
+}
+
+TEST_F(Test_DockAnimationController, stage_test)
+{
+    QList<QRect> rects;
+    QStringList steps;
+
+    DockAnimationController::Stage hideStage;
+    hideStage.duration = 50;
+    hideStage.tracks << track(rects, QRect(0, 1040, 1000, 40), QRect(0, 1080, 1000, 0));
+    hideStage.finished = [ &steps, &rects ] { steps << "hide"; rects.clear(); };
+
+    DockAnimationController::Stage showStage;
+    showStage.duration = 0;
+    showStage.tracks << track(rects, QRect(0, 0, 40, 1080), QRect(0, 0, 40, 1080));
+
+    controller->play("position", { hideStage, showStage }, [ &steps ] { steps << "finished"; });
+    ASSERT_TRUE(QTest::qWaitFor([ &steps ] { return steps.contains("finished"); }, 1000));
+
+    // 阶段依次执行，结束时窗口在最终的位置
+    ASSERT_EQ(steps, QStringList() << "hide" << "finished");
+    ASSERT_EQ(rects.last(), QRect(0, 0, 40, 1080));
+    ASSERT_EQ(controller->history().last().duration, 50);
+}
+
+TEST_F(Test_DockAnimationController, history_test)
+{
+    QList<QRect> rects;
+    bool finished = false;
+    controller->setHistorySize(2);
+
+    DockAnimationController::Stage stage;
+    stage.duration = 200;
+    stage.tracks << track(rects, QRect(0, 0, 100, 0), QRect(0, 0, 100, 40));
+    stage.finished = [ &finished ] { finished = true; };
+
+    // 被停止的动画不回调，记录为中断
+    controller->play("show", { stage });
+    controller->stop();
+    ASSERT_FALSE(controller->isRunning());
+    QTest::qWait(250);
+    ASSERT_FALSE(finished);
+    ASSERT_TRUE(controller->history().last().interrupted);
+
+    // 只保留最近的几次
+    stage.duration = 0;
+    controller->play("hide", { stage });
+    controller->play("show", { stage });
+    ASSERT_TRUE(finished);
+    ASSERT_EQ(controller->history().size(), 2);
+    ASSERT_EQ(controller->history().first().name, QString("hide"));
+    ASSERT_EQ(controller->history().last().name, QString("show"));
+}
+
+TEST_F(Test_DockAnimationController, interrupt_test)
+{
+    QList<QRect> rects;
+    QStringList steps;
+
+    DockAnimationController::Stage hideStage;
+    hideStage.duration = 200;
+    hideStage.tracks << track(rects, QRect(0, 1040, 1000, 40), QRect(0, 1080, 1000, 0));
+    hideStage.finished = [ &steps ] { steps << "hide"; };
+
+    DockAnimationController::Stage showStage;
+    showStage.duration = 200;
+    showStage.tracks << track(rects, QRect(0, 0, 40, 1080), QRect(0, 0, 40, 1080));
+    showStage.finished = [ &steps ] { steps << "show"; };
+
+    controller->play("position", { hideStage, showStage }, [ &steps ] { steps << "position"; });
+    QTest::qWait(50);
+    ASSERT_TRUE(steps.isEmpty());
+
+    // 被新的动画打断时，没有调用的结束回调按顺序立即调用
+    DockAnimationController::Stage stage;
+    stage.duration = 0;
+    stage.tracks << track(rects, QRect(0, 1080, 1000, 0), QRect(0, 1040, 1000, 40));
+    stage.finished = [ &steps ] { steps << "finished"; };
+    controller->play("show", { stage });
+    ASSERT_EQ(steps, QStringList() << "hide" << "show" << "position" << "finished");
+    ASSERT_FALSE(controller->isRunning());
+    ASSERT_TRUE(controller->history().first().interrupted);
+
+    // 时长为0的动画同步结束
+    ASSERT_EQ(rects.last(), QRect(0, 1040, 1000, 40));
+    ASSERT_FALSE(controller->history().last().interrupted);
+
+    // 主动结束时同样调用剩下的回调
+    steps.clear();
+    hideStage.duration = 200;
+    controller->play("hide", { hideStage }, [ &steps ] { steps << "finished"; });
+    controller->finish();
+    ASSERT_FALSE(controller->isRunning());
+    ASSERT_EQ(steps, QStringList() << "hide" << "finished");
+}
+
+TEST_F(Test_DockAnimationController, dbus_test)
+{
+    QList<QRect> rects;
+    DockAnimationController::Stage stage;
+    stage.duration = 0;
+    stage.tracks << track(rects, QRect(0, 0, 100, 0), QRect(0, 0, 100, 40));
+    controller->play("show", { stage });
+
+    const QJsonObject statistics = QJsonDocument::fromJson(controller->Statistics().toUtf8()).object();
+    ASSERT_EQ(statistics.value("frameInterval").toInt(), 16);
+    const QJsonArray animations = statistics.value("animations").toArray();
+    ASSERT_EQ(animations.size(), 1);
+    ASSERT_EQ(animations.first().toObject().value("name").toString(), QString("show"));
+
+    controller->Reset();
+    ASSERT_TRUE(controller->history().isEmpty());
+}
+
+TEST_F(Test_DockAnimationController, missed_frame_test)
+{
+    QList<QRect> rects;
+    bool finished = false;
+
+    DockAnimationController::Stage stage;
+    stage.duration = 300;
+    stage.tracks << track(rects, QRect(0, 0, 100, 0), QRect(0, 0, 100, 40));
+    stage.finished = [ &finished ] { finished = true; };
+    controller->play("hide", { stage });
+
+    // 模拟主线程阻塞导致丢帧
+    QTest::qWait(30);
+    QTest::qSleep(100);
+    ASSERT_TRUE(QTest::qWaitFor([ &finished ] { return finished; }, 1000));
+
+    const DockAnimationController::Stats stats = controller->history().last();
+    ASSERT_GE(stats.maxInterval, 100);
+    ASSERT_GE(stats.missedFrames, 5);
+}
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "dockregionset.h"
+
+// 统计注册和注销的次数，代替org.deepin.dde.XEventMonitor1服务
+class CountingRegionMonitor : public RegionMonitor
+{
+public:
+    QString registerAreas(const QList<MonitRect> &areas, int flags) override
+    {
+        Q_UNUSED(areas);
+        Q_UNUSED(flags);
+        ++registerCount;
+        return QString("count-%1").arg(++serial);
+    }
+
+    bool unregisterArea(const QString &key) override
+    {
+        Q_UNUSED(key);
+        ++unregisterCount;
+        return true;
+    }
+
+    int calls() const { return registerCount + unregisterCount; }
+
+    int serial = 0;
+    int registerCount = 0;
+    int unregisterCount = 0;
+};
+
+class Test_DockRegionSet : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    CountingRegionMonitor *monitor = nullptr;
+    DockRegionSet *regionSet = nullptr;
+};
+
+void Test_DockRegionSet::SetUp()
+{
+    monitor = new CountingRegionMonitor;
+    regionSet = new DockRegionSet(monitor);
+
+    // 三个横向排列的屏幕，任务栏在下方
+    regionSet->setScreens({ QRect(0, 0, 1920, 1080), QRect(1920, 0, 1920, 1080), QRect(3840, 0, 1920, 1080) });
+    regionSet->setPosition(Dock::Bottom);
+    regionSet->setThickness(DockRegionSet::Monitor, 15);
+    regionSet->setThickness(DockRegionSet::Extral, 60);
+    regionSet->setThickness(DockRegionSet::Touch, 110);
+}
+
+void Test_DockRegionSet::TearDown()
+{
+    delete regionSet;
+    regionSet = nullptr;
+    delete monitor;
+    monitor = nullptr;
+}
+
+TEST_F(Test_DockRegionSet, edgeAreas_test)
+{
+    const QList<MonitRect> areas = regionSet->areas(DockRegionSet::Monitor);
+    ASSERT_TRUE(areas.isEmpty());
+
+    regionSet->commit(RegionMonitor::Motion);
+    const QList<MonitRect> monitorAreas = regionSet->areas(DockRegionSet::Monitor);
+    ASSERT_EQ(monitorAreas.size(), 3);
+    ASSERT_EQ(monitorAreas.at(1).x1, 1920);
+    ASSERT_EQ(monitorAreas.at(1).y1, 1065);
+    ASSERT_EQ(monitorAreas.at(1).x2, 3840);
+    ASSERT_EQ(monitorAreas.at(1).y2, 1080);
+
+    // 复制模式下重叠的屏幕只监听一次
+    const QList<MonitRect> copyAreas = DockRegionSet::edgeAreas({ QRect(0, 0, 1920, 1080), QRect(0, 0, 1920, 1080) }, Dock::Left, 15);
+    ASSERT_EQ(copyAreas.size(), 1);
+    ASSERT_EQ(copyAreas.first().x2, 15);
+    ASSERT_EQ(copyAreas.first().y2, 1080);
+}
+
+TEST_F(Test_DockRegionSet, dockSize_test)
+{
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion | RegionMonitor::Button), 3);
+    ASSERT_EQ(monitor->calls(), 3);
+
+    const QString monitorKey = regionSet->key(DockRegionSet::Monitor);
+    const QString extralKey = regionSet->key(DockRegionSet::Extral);
+    const QString touchKey = regionSet->key(DockRegionSet::Touch);
+
+    // 修改任务栏大小只影响任务栏内部区域，注销一次注册一次
+    regionSet->setThickness(DockRegionSet::Extral, 70);
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion | RegionMonitor::Button), 2);
+    ASSERT_EQ(monitor->calls(), 5);
+    ASSERT_EQ(regionSet->key(DockRegionSet::Monitor), monitorKey);
+    ASSERT_EQ(regionSet->key(DockRegionSet::Touch), touchKey);
+    ASSERT_NE(regionSet->key(DockRegionSet::Extral), extralKey);
+
+    // 没有变化时不调用
+    regionSet->setThickness(DockRegionSet::Extral, 70);
+    regionSet->setScreens({ QRect(0, 0, 1920, 1080), QRect(1920, 0, 1920, 1080), QRect(3840, 0, 1920, 1080) });
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion | RegionMonitor::Button), 0);
+    ASSERT_EQ(monitor->calls(), 5);
+}
+
+TEST_F(Test_DockRegionSet, position_test)
+{
+    regionSet->commit(RegionMonitor::Motion);
+
+    // 位置变化时三组区域都要更新
+    regionSet->setPosition(Dock::Left);
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion), 6);
+    ASSERT_EQ(monitor->registerCount, 6);
+    ASSERT_EQ(monitor->unregisterCount, 3);
+
+    // 拔掉一个屏幕
+    regionSet->setScreens({ QRect(0, 0, 1920, 1080), QRect(1920, 0, 1920, 1080) });
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion), 6);
+    ASSERT_EQ(regionSet->areas(DockRegionSet::Touch).size(), 2);
+}
+
+TEST_F(Test_DockRegionSet, reset_test)
+{
+    regionSet->commit(RegionMonitor::Motion);
+    const QString monitorKey = regionSet->key(DockRegionSet::Monitor);
+
+    // 监听服务重启后区域没有变化也要重新注册，旧的key已经失效，不需要注销
+    regionSet->reset();
+    ASSERT_TRUE(regionSet->key(DockRegionSet::Monitor).isEmpty());
+    ASSERT_EQ(regionSet->commit(RegionMonitor::Motion), 3);
+    ASSERT_EQ(monitor->registerCount, 6);
+    ASSERT_EQ(monitor->unregisterCount, 0);
+    ASSERT_NE(regionSet->key(DockRegionSet::Monitor), monitorKey);
+}
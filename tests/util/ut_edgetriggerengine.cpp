@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+#include "edgetriggerengine.h"
+
+static MonitRect monitRect(int x1, int y1, int x2, int y2)
+{
+    MonitRect rect;
+    rect.x1 = x1;
+    rect.y1 = y1;
+    rect.x2 = x2;
+    rect.y2 = y2;
+    return rect;
+}
+
+class Test_EdgeTriggerEngine : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    EdgeTriggerEngine *engine = nullptr;
+};
+
+void Test_EdgeTriggerEngine::SetUp()
+{
+    engine = new EdgeTriggerEngine;
+}
+
+void Test_EdgeTriggerEngine::TearDown()
+{
+    delete engine;
+    engine = nullptr;
+}
+
+TEST_F(Test_EdgeTriggerEngine, register_test)
+{
+    const QString key1 = engine->registerAreas({ monitRect(0, 1065, 1920, 1080) }, RegionMonitor::Motion);
+    const QString key2 = engine->registerAreas({ monitRect(0, 1065, 1920, 1080) }, RegionMonitor::Motion);
+    ASSERT_FALSE(key1.isEmpty());
+    ASSERT_NE(key1, key2);
+
+    ASSERT_TRUE(engine->unregisterArea(key1));
+    ASSERT_FALSE(engine->unregisterArea(key1));
+
+    QSignalSpy moveSpy(engine, &RegionMonitor::cursorMove);
+    engine->handleMotion(100, 1070);
+    ASSERT_EQ(moveSpy.count(), 1);
+    ASSERT_EQ(moveSpy.first().at(2).toString(), key2);
+}
+
+// 合成的鼠标轨迹：从屏幕中间移动到底部边缘，沿着边缘移动，再移回屏幕中间
+TEST_F(Test_EdgeTriggerEngine, pointer_trace_test)
+{
+    const QString monitorKey = engine->registerAreas({ monitRect(0, 1065, 1920, 1080), monitRect(1920, 1065, 3840, 1080) },
+                                                     RegionMonitor::Motion | RegionMonitor::Button);
+    const QString extralKey = engine->registerAreas({ monitRect(0, 1000, 1920, 1080) }, RegionMonitor::Motion);
+
+    QSignalSpy intoSpy(engine, &RegionMonitor::cursorInto);
+    QSignalSpy outSpy(engine, &RegionMonitor::cursorOut);
+    QSignalSpy moveSpy(engine, &RegionMonitor::cursorMove);
+
+    for (int y = 540; y <= 1080; y += 20)
+        engine->handleMotion(960, y);
+
+    // 先进入任务栏区域，再进入唤起区域
+    ASSERT_EQ(intoSpy.count(), 2);
+    ASSERT_EQ(intoSpy.at(0).at(2).toString(), extralKey);
+    ASSERT_EQ(intoSpy.at(1).at(2).toString(), monitorKey);
+    ASSERT_EQ(outSpy.count(), 0);
+
+    // 沿着边缘移动到第二个屏幕，一直在唤起区域内，离开了第一个屏幕的任务栏区域
+    moveSpy.clear();
+    for (int x = 960; x <= 2880; x += 240)
+        engine->handleMotion(x, 1075);
+    ASSERT_EQ(intoSpy.count(), 2);
+    ASSERT_EQ(outSpy.count(), 1);
+    ASSERT_EQ(outSpy.first().at(2).toString(), extralKey);
+    int monitorMoves = 0;
+    for (const QList<QVariant> &args : moveSpy) {
+        if (args.at(2).toString() == monitorKey)
+            ++monitorMoves;
+    }
+    ASSERT_EQ(monitorMoves, 9);
+
+    engine->handleMotion(2880, 540);
+    ASSERT_EQ(outSpy.count(), 2);
+    ASSERT_EQ(outSpy.last().at(0).toInt(), 2880);
+    ASSERT_EQ(outSpy.last().at(1).toInt(), 540);
+    ASSERT_EQ(outSpy.last().at(2).toString(), monitorKey);
+}
+
+TEST_F(Test_EdgeTriggerEngine, button_test)
+{
+    const QString buttonKey = engine->registerAreas({ monitRect(0, 1065, 1920, 1080) }, RegionMonitor::Motion | RegionMonitor::Button);
+    engine->registerAreas({ monitRect(0, 1000, 1920, 1080) }, RegionMonitor::Motion);
+
+    QSignalSpy pressSpy(engine, &RegionMonitor::buttonPress);
+    QSignalSpy releaseSpy(engine, &RegionMonitor::buttonRelease);
+
+    // 区域外和没有Button标记的区域不通知
+    engine->handleButton(1, true, 960, 540);
+    engine->handleButton(1, true, 960, 1010);
+    ASSERT_EQ(pressSpy.count(), 0);
+
+    engine->handleButton(1, true, 960, 1070);
+    engine->handleButton(1, false, 960, 1070);
+    ASSERT_EQ(pressSpy.count(), 1);
+    ASSERT_EQ(pressSpy.first().at(0).toInt(), 1);
+    ASSERT_EQ(pressSpy.first().at(3).toString(), buttonKey);
+    ASSERT_EQ(releaseSpy.count(), 1);
+}
+
+// X.h中的核心事件类型，X.h的宏会和Qt的定义冲突
+static const int CoreButtonPress = 4;
+static const int CoreMotionNotify = 6;
+
+TEST_F(Test_EdgeTriggerEngine, touch_motion_test)
+{
+    XRecordPointerSource source;
+    source.setDevices({ 2 }, { 10 });
+
+    QSignalSpy motionSpy(&source, &XRecordPointerSource::motion);
+    QSignalSpy buttonSpy(&source, &XRecordPointerSource::button);
+
+    // 服务器先记录slave设备的事件，再记录核心事件和master设备的事件；触摸屏模拟的移动不通知，按下照常通知
+    source.handleDeviceEvent(10);
+    source.handleRecordEvent(CoreMotionNotify, 0, 100, 1070);
+    source.handleDeviceEvent(2);
+    source.handleDeviceEvent(10);
+    source.handleRecordEvent(CoreButtonPress, 1, 100, 1070);
+    source.handleDeviceEvent(2);
+    QCoreApplication::processEvents();
+    ASSERT_EQ(motionSpy.count(), 0);
+    ASSERT_EQ(buttonSpy.count(), 1);
+
+    // 鼠标的移动照常通知，负坐标打包后不变
+    source.handleDeviceEvent(11);
+    source.handleRecordEvent(CoreMotionNotify, 0, -5, 1075);
+    source.handleDeviceEvent(2);
+    QCoreApplication::processEvents();
+    ASSERT_EQ(motionSpy.count(), 1);
+    ASSERT_EQ(motionSpy.first().at(0).toInt(), -5);
+    ASSERT_EQ(motionSpy.first().at(1).toInt(), 1075);
+}
+
+TEST_F(Test_EdgeTriggerEngine, touch_device_refresh_test)
+{
+    XRecordPointerSource source;
+    source.setDevices({ 2 }, {});
+
+    QSignalSpy motionSpy(&source, &XRecordPointerSource::motion);
+
+    // 触摸屏接入之前，设备10的移动按鼠标处理
+    source.handleDeviceEvent(10);
+    source.handleRecordEvent(CoreMotionNotify, 0, 100, 1070);
+    source.handleDeviceEvent(2);
+    QCoreApplication::processEvents();
+    ASSERT_EQ(motionSpy.count(), 1);
+
+    // 设备列表更新后，触摸屏模拟的移动不再通知
+    source.setDevices({ 2 }, { 10 });
+    source.handleDeviceEvent(10);
+    source.handleRecordEvent(CoreMotionNotify, 0, 100, 1075);
+    source.handleDeviceEvent(2);
+    QCoreApplication::processEvents();
+    ASSERT_EQ(motionSpy.count(), 1);
+
+    // 触摸屏拔出后恢复
+    source.setDevices({ 2 }, {});
+    source.handleDeviceEvent(10);
+    source.handleRecordEvent(CoreMotionNotify, 0, 100, 1080);
+    source.handleDeviceEvent(2);
+    QCoreApplication::processEvents();
+    ASSERT_EQ(motionSpy.count(), 2);
+}
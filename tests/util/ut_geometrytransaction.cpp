@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "geometrytransaction.h"
+#include "multiscreenworker.h"
+#include "windowmanager.h"
+#include "mainwindow.h"
+#include "dragwidget.h"
+#include "displaystatepipeline.h"
+
+class Test_GeometryTransaction : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    GeometryTransaction *transaction = nullptr;
+    QList<int> appliedSizes;
+    QList<int> committedSizes;
+};
+
+void Test_GeometryTransaction::SetUp()
+{
+    transaction = new GeometryTransaction;
+    transaction->setFrameInterval(16);
+    transaction->setApplyFunction([ this ](int size) { appliedSizes << size; });
+    transaction->setCommitFunction([ this ](int size) { committedSizes << size; });
+}
+
+void Test_GeometryTransaction::TearDown()
+{
+    delete transaction;
+    transaction = nullptr;
+}
+
+TEST_F(Test_GeometryTransaction, immediate_test)
+{
+    // 不在事务中时立即更新并提交
+    transaction->update(60);
+    ASSERT_EQ(appliedSizes, QList<int>() << 60);
+    ASSERT_EQ(committedSizes, QList<int>() << 60);
+
+    // 没有变化的事务结束时不提交
+    transaction->begin();
+    transaction->end();
+    ASSERT_EQ(transaction->commitCount(), 1);
+}
+
+TEST_F(Test_GeometryTransaction, frame_test)
+{
+    transaction->begin();
+    transaction->update(50);
+    transaction->update(55);
+    transaction->update(60);
+    ASSERT_TRUE(appliedSizes.isEmpty());
+
+    // 同一帧内的变化合并成一次，使用最后的大小
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return !appliedSizes.isEmpty(); }, 1000));
+    ASSERT_EQ(appliedSizes, QList<int>() << 60);
+
+    // 和上一次相同的大小不再更新
+    transaction->update(60);
+    QTest::qWait(50);
+    ASSERT_EQ(appliedSizes.size(), 1);
+
+    transaction->end();
+    ASSERT_EQ(appliedSizes.size(), 1);
+    ASSERT_EQ(committedSizes, QList<int>() << 60);
+}
+
+TEST_F(Test_GeometryTransaction, idle_test)
+{
+    int timeouts = 0;
+    QObject::connect(transaction, &GeometryTransaction::idleTimeout, [ &timeouts ] { ++timeouts; });
+    transaction->setIdleTimeout(100);
+
+    // 持续更新时不会自动结束
+    transaction->begin();
+    for (int i = 0; i < 4; ++i) {
+        transaction->update(50 + i);
+        QTest::qWait(50);
+    }
+    ASSERT_TRUE(transaction->isActive());
+
+    // 一段时间没有更新后自动结束并提交
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return !transaction->isActive(); }, 1000));
+    ASSERT_EQ(timeouts, 1);
+    ASSERT_EQ(committedSizes, QList<int>() << 53);
+
+    // 正常结束的事务不会再超时
+    transaction->begin();
+    transaction->update(60);
+    transaction->end();
+    QTest::qWait(200);
+    ASSERT_EQ(timeouts, 1);
+    ASSERT_EQ(committedSizes, QList<int>() << 53 << 60);
+}
+
+// 统计注册和注销监听区域的次数，代替org.deepin.dde.XEventMonitor1服务
+class ResizeRegionMonitor : public RegionMonitor
+{
+public:
+    QString registerAreas(const QList<MonitRect> &areas, int flags) override
+    {
+        Q_UNUSED(areas);
+        Q_UNUSED(flags);
+        ++calls;
+        return QString("resize-%1").arg(calls);
+    }
+
+    bool unregisterArea(const QString &key) override
+    {
+        Q_UNUSED(key);
+        ++calls;
+        return true;
+    }
+
+    int calls = 0;
+};
+
+/**
+ * 通过WindowManager::resizeDock和MainWindowBase::onMainWindowSizeChanged拖拽调整大小，
+ * 保存大小(后端)、写入预留区域(窗管)和注册监听区域都替换成计数的对象
+ */
+class Test_DockResize : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    // 执行拖拽结束之后延时的推送
+    void settle();
+    void resetCounts();
+
+public:
+    MultiScreenWorker *worker = nullptr;
+    WindowManager *manager = nullptr;
+    MainWindow *window = nullptr;
+    ResizeRegionMonitor *monitor = nullptr;
+    QList<int> daemonSizes;
+    int strutWrites = 0;
+};
+
+void Test_DockResize::SetUp()
+{
+    worker = new MultiScreenWorker;
+    // 和DockSettings一样，保存之后通知大小变化
+    worker->setDockSizeWriter([ this ](int dockSize) {
+        daemonSizes << dockSize;
+        if (worker->displayMode() == Dock::DisplayMode::Fashion)
+            worker->m_windowFashionSize = uint(dockSize);
+        else
+            worker->m_windowEfficientSize = uint(dockSize);
+        worker->onWindowSizeChanged(uint(dockSize));
+    });
+
+    monitor = new ResizeRegionMonitor;
+    worker->m_regionSet.reset(new DockRegionSet(monitor));
+    worker->m_hideState = Dock::HideState::Show;
+
+    manager = new WindowManager(worker);
+    manager->m_strutManager->setWriter([ this ](const StrutManager::Strut &) {
+        ++strutWrites;
+        return true;
+    });
+    manager->m_resizeTransaction->setFrameInterval(16);
+
+    window = new MainWindow(worker);
+    window->m_resizeTransaction->setFrameInterval(16);
+    manager->addWindow(window);
+
+    // 初始化时的推送不计入拖拽
+    settle();
+    resetCounts();
+}
+
+void Test_DockResize::TearDown()
+{
+    Utils::setIsDraging(false);
+
+    delete window;
+    window = nullptr;
+    delete manager;
+    manager = nullptr;
+    delete worker;
+    worker = nullptr;
+    delete monitor;
+    monitor = nullptr;
+}
+
+void Test_DockResize::settle()
+{
+    QCoreApplication::processEvents();
+    worker->m_displayState->flush();
+    manager->m_strutManager->flush();
+}
+
+void Test_DockResize::resetCounts()
+{
+    daemonSizes.clear();
+    strutWrites = 0;
+    monitor->calls = 0;
+}
+
+// 控制中心拖拽：500次调整大小，每次之间处理一次事件
+TEST_F(Test_DockResize, resizeDock_test)
+{
+    GeometryTransaction *transaction = manager->m_resizeTransaction;
+    const int applyCount = transaction->applyCount();
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    for (int step = 0; step < 500; ++step) {
+        manager->resizeDock(40 + step % 61, true);
+        if (step % 5 == 0)
+            QTest::qWait(1);
+        else
+            QCoreApplication::processEvents();
+    }
+
+    // 拖拽过程中不通知后端、窗管，也不更新监听区域
+    ASSERT_TRUE(transaction->isActive());
+    ASSERT_TRUE(daemonSizes.isEmpty());
+    ASSERT_EQ(strutWrites, 0);
+    ASSERT_EQ(monitor->calls, 0);
+
+    manager->resizeDock(80, false);
+    const qint64 duration = elapsed.elapsed();
+
+    // 每一帧最多更新一次窗口，结束时再更新一次
+    const int applies = transaction->applyCount() - applyCount;
+    ASSERT_LE(applies, duration / 15 + 2);
+    ASSERT_LT(applies, 500);
+    ASSERT_FALSE(transaction->isActive());
+
+    // 后端只在拖拽结束时保存一次最后的大小
+    ASSERT_EQ(daemonSizes, QList<int>() << 80);
+
+    // 大小变化之后窗管最多写入一次，只重新注册任务栏内部区域(注销加注册)
+    settle();
+    ASSERT_LE(strutWrites, 1);
+    ASSERT_LE(monitor->calls, 2);
+
+    // 之后没有新的变化，不再有外部调用
+    resetCounts();
+    QTest::qWait(50);
+    settle();
+    ASSERT_TRUE(daemonSizes.isEmpty());
+    ASSERT_EQ(strutWrites, 0);
+    ASSERT_EQ(monitor->calls, 0);
+}
+
+// 拖拽任务栏边缘：500次鼠标移动，偏移量相对于拖拽开始时的位置
+TEST_F(Test_DockResize, onMainWindowSizeChanged_test)
+{
+    GeometryTransaction *transaction = window->m_resizeTransaction;
+    const int applyCount = transaction->applyCount();
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    for (int step = 0; step < 500; ++step) {
+        const int offset = step % 61 - 30;
+        window->onMainWindowSizeChanged(QPoint(offset, offset));
+        if (step % 5 == 0)
+            QTest::qWait(1);
+        else
+            QCoreApplication::processEvents();
+    }
+
+    // 拖拽过程中不会启动更新拖拽区域的定时器，也没有外部调用
+    ASSERT_TRUE(transaction->isActive());
+    ASSERT_TRUE(window->isDraging());
+    ASSERT_FALSE(window->m_updateDragAreaTimer->isActive());
+    ASSERT_TRUE(daemonSizes.isEmpty());
+    ASSERT_EQ(strutWrites, 0);
+    ASSERT_EQ(monitor->calls, 0);
+
+    Q_EMIT window->m_dragWidget->dragFinished();
+    const qint64 duration = elapsed.elapsed();
+
+    const int applies = transaction->applyCount() - applyCount;
+    ASSERT_LE(applies, duration / 15 + 2);
+    ASSERT_LT(applies, 500);
+    ASSERT_FALSE(transaction->isActive());
+    ASSERT_FALSE(Utils::isDraging());
+
+    // 拖拽结束时按窗口最后的大小保存一次
+    ASSERT_EQ(daemonSizes, QList<int>() << transaction->size());
+
+    settle();
+    ASSERT_LE(strutWrites, 1);
+    ASSERT_LE(monitor->calls, 2);
+
+    resetCounts();
+    QTest::qWait(50);
+    settle();
+    ASSERT_TRUE(daemonSizes.isEmpty());
+    ASSERT_EQ(strutWrites, 0);
+    ASSERT_EQ(monitor->calls, 0);
+}
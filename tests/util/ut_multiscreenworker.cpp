@@ -292,6 +292,21 @@ TEST_F(Test_MultiScreenWorker, onRegionMonitorChanged)
     ASSERT_TRUE(true);
 }
 
+TEST_F(Test_MultiScreenWorker, dockedScreenInput)
+{
+    MainWindow window;
+    MultiScreenWorker *worker = new MultiScreenWorker(&window, DWindowManagerHelper::instance());
+
+    // 所在屏幕的变化都要同步到显示状态的输入
+    worker->updateDockedScreen("screen1");
+    ASSERT_EQ(worker->displayState()->input(DisplayStatePipeline::DockedScreen).toString(), DOCK_SCREEN->current());
+
+    worker->changeDockPosition("screen1", "screen2", Position::Bottom, Position::Bottom);
+    ASSERT_EQ(worker->displayState()->input(DisplayStatePipeline::DockedScreen).toString(), "screen2");
+
+    delete worker;
+}
+
 TEST_F(Test_MultiScreenWorker, dockScreen)
 {
     DockScreen ds("primary");
@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QApplication>
+#include <QFile>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QWidget>
+
+#include <gtest/gtest.h>
+
+#include <dlfcn.h>
+
+#include "dockplugincontroller.h"
+#include "pluginfilewatcher.h"
+#include "pluginsiteminterface.h"
+
+static bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    return file.write(data) == data.size();
+}
+
+class Test_PluginFileWatcher : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    QTemporaryDir *dir = nullptr;
+    PluginFileWatcher *watcher = nullptr;
+};
+
+void Test_PluginFileWatcher::SetUp()
+{
+    dir = new QTemporaryDir;
+    watcher = new PluginFileWatcher;
+    watcher->setSettleDelay(50);
+}
+
+void Test_PluginFileWatcher::TearDown()
+{
+    delete watcher;
+    watcher = nullptr;
+    delete dir;
+    dir = nullptr;
+}
+
+TEST_F(Test_PluginFileWatcher, scan_test)
+{
+    const QString pluginFile = dir->filePath("libfoo.so");
+    ASSERT_TRUE(writeFile(pluginFile, "foo"));
+    watcher->addDirectory(dir->path());
+    ASSERT_EQ(watcher->directories(), QStringList() << dir->path());
+
+    QSignalSpy addedSpy(watcher, &PluginFileWatcher::pluginAdded);
+    QSignalSpy changedSpy(watcher, &PluginFileWatcher::pluginChanged);
+    QSignalSpy removedSpy(watcher, &PluginFileWatcher::pluginRemoved);
+
+    // 没有变化时不通知
+    watcher->rescan();
+    ASSERT_EQ(addedSpy.count() + changedSpy.count() + removedSpy.count(), 0);
+
+    // 不是动态库的文件不处理
+    ASSERT_TRUE(writeFile(dir->filePath("readme.txt"), "readme"));
+    ASSERT_TRUE(writeFile(dir->filePath("libbar.so"), "bar"));
+    ASSERT_TRUE(writeFile(pluginFile, "foo foo"));
+    watcher->rescan();
+    ASSERT_EQ(addedSpy.count(), 1);
+    ASSERT_EQ(addedSpy.first().first().toString(), dir->filePath("libbar.so"));
+    ASSERT_EQ(changedSpy.count(), 1);
+    ASSERT_EQ(changedSpy.first().first().toString(), pluginFile);
+
+    ASSERT_TRUE(QFile::remove(dir->filePath("libbar.so")));
+    watcher->rescan();
+    ASSERT_EQ(removedSpy.count(), 1);
+    ASSERT_EQ(removedSpy.first().first().toString(), dir->filePath("libbar.so"));
+}
+
+TEST_F(Test_PluginFileWatcher, settle_test)
+{
+    const QString pluginFile = dir->filePath("libfoo.so");
+    ASSERT_TRUE(writeFile(pluginFile, "foo"));
+    watcher->addDirectory(dir->path());
+
+    QSignalSpy changedSpy(watcher, &PluginFileWatcher::pluginChanged);
+
+    // 安装过程中文件多次变化，稳定之后只通知一次
+    QByteArray data;
+    for (int i = 0; i < 5; ++i) {
+        data.append("foo");
+        ASSERT_TRUE(writeFile(pluginFile, data));
+        QTest::qWait(10);
+    }
+
+    ASSERT_TRUE(QTest::qWaitFor([ & ] { return changedSpy.count() == 1; }, 3000));
+    QTest::qWait(200);
+    ASSERT_EQ(changedSpy.count(), 1);
+}
+
+#ifdef RELOAD_FIXTURE_PLUGIN
+
+// 插件实例所在的动态库，即dlopen时使用的文件路径
+static QString instanceLibrary(PluginsItemInterface *plugin)
+{
+    QObject *instance = dynamic_cast<QObject *>(plugin);
+    Dl_info info;
+    if (!instance || !dladdr(instance->metaObject(), &info))
+        return QString();
+
+    return QString::fromLocal8Bit(info.dli_fname);
+}
+
+// 模拟任务栏的插件代理，记录插件控制器添加的插件项
+class FixtureProxy : public PluginProxyInterface
+{
+public:
+    void itemAdded(PluginsItemInterface * const, const QString &itemKey) override { items << itemKey; }
+    void itemUpdate(PluginsItemInterface * const, const QString &) override {}
+    void itemRemoved(PluginsItemInterface * const, const QString &itemKey) override { items.remove(itemKey); }
+    void requestWindowAutoHide(PluginsItemInterface * const, const QString &, const bool) override {}
+    void requestRefreshWindowVisible(PluginsItemInterface * const, const QString &) override {}
+    void requestSetAppletVisible(PluginsItemInterface * const, const QString &, const bool) override {}
+    void saveValue(PluginsItemInterface * const, const QString &, const QVariant &) override {}
+    const QVariant getValue(PluginsItemInterface * const, const QString &, const QVariant &fallback) override { return fallback; }
+    void removeValue(PluginsItemInterface * const, const QStringList &) override {}
+
+public:
+    QSet<QString> items;
+};
+
+TEST_F(Test_PluginFileWatcher, reload_fixture_test)
+{
+    const QString pluginFile = dir->filePath("libreload-fixture.so");
+    ASSERT_TRUE(QFile::copy(RELOAD_FIXTURE_PLUGIN, pluginFile));
+
+    const int baseWidgetCount = QApplication::allWidgets().size();
+    FixtureProxy proxy;
+    DockPluginController *controller = new DockPluginController(&proxy);
+    controller->m_fileWatcher->setSettleDelay(50);
+    QSignalSpy insertedSpy(controller, &DockPluginController::pluginInserted);
+
+    controller->loadPluginFile(pluginFile);
+    ASSERT_TRUE(insertedSpy.wait(3000));
+    PluginsItemInterface *plugin = controller->m_registry.pluginByFile(pluginFile);
+    ASSERT_NE(plugin, nullptr);
+    QString library = instanceLibrary(plugin);
+    ASSERT_EQ(library, pluginFile);
+    const int loadCount = controller->getPluginValue(plugin, "loadCount").toInt();
+
+    controller->m_fileWatcher->addDirectory(dir->path());
+    const int reloadTimes = 20;
+    for (int i = 1; i <= reloadTimes; ++i) {
+        // 先删除再复制，和安装包替换文件一样产生新的inode
+        ASSERT_TRUE(QFile::remove(pluginFile));
+        ASSERT_TRUE(QFile::copy(RELOAD_FIXTURE_PLUGIN, pluginFile));
+        ASSERT_TRUE(QTest::qWaitFor([ & ] { return insertedSpy.count() == i + 1; }, 3000));
+
+        // 插件实例来自新的映射，而不是dlclose之后仍然驻留的旧动态库，复制的文件在加载后删除
+        plugin = controller->m_registry.pluginByFile(pluginFile);
+        ASSERT_NE(plugin, nullptr);
+        const QString reloadedLibrary = instanceLibrary(plugin);
+        ASSERT_NE(reloadedLibrary, library);
+        ASSERT_TRUE(reloadedLibrary.endsWith(pluginFile));
+        ASSERT_FALSE(QFile::exists(reloadedLibrary));
+        library = reloadedLibrary;
+
+        // 旧的插件实例在延后的卸载中删除，每次重新加载后只有一个插件项和一个插件窗口
+        ASSERT_EQ(controller->m_registry.itemKeys(plugin).size(), 1);
+        ASSERT_TRUE(QTest::qWaitFor([ & ] { return QApplication::allWidgets().size() == baseWidgetCount + 1; }, 1000));
+    }
+
+    // 配置在重新加载时保留
+    ASSERT_EQ(controller->getPluginValue(plugin, "loadCount").toInt(), loadCount + reloadTimes);
+
+    ASSERT_TRUE(QFile::remove(pluginFile));
+    ASSERT_TRUE(QTest::qWaitFor([ & ] { return !controller->m_registry.pluginByFile(pluginFile); }, 3000));
+    ASSERT_TRUE(QTest::qWaitFor([ & ] { return QApplication::allWidgets().size() == baseWidgetCount; }, 1000));
+
+    delete controller;
+}
+
+#endif
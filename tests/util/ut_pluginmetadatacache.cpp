@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QFile>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include "pluginmetadatacache.h"
+
+class Test_PluginMetaDataCache : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    void writePlugin(const QString &content);
+    PluginMetaDataCache *createCache();
+
+public:
+    QTemporaryDir *tempDir = nullptr;
+    QString pluginFile;
+    QString cacheFile;
+    int readCount = 0;
+};
+
+void Test_PluginMetaDataCache::SetUp()
+{
+    tempDir = new QTemporaryDir;
+    pluginFile = tempDir->filePath("libtest-plugin.so");
+    cacheFile = tempDir->filePath("cache/plugin-metadata.json");
+    readCount = 0;
+
+    writePlugin("version-1");
+}
+
+void Test_PluginMetaDataCache::TearDown()
+{
+    delete tempDir;
+    tempDir = nullptr;
+}
+
+void Test_PluginMetaDataCache::writePlugin(const QString &content)
+{
+    QFile file(pluginFile);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content.toUtf8());
+}
+
+PluginMetaDataCache *Test_PluginMetaDataCache::createCache()
+{
+    PluginMetaDataCache *cache = new PluginMetaDataCache(cacheFile);
+    // 测试文件不是真正的插件，用文件内容模拟元数据
+    cache->setMetaDataReader([ this ](const QString &file) {
+        ++readCount;
+        QFile pluginFile(file);
+        pluginFile.open(QIODevice::ReadOnly);
+        QJsonObject meta;
+        meta["api"] = QString::fromUtf8(pluginFile.readAll());
+        return meta;
+    });
+
+    return cache;
+}
+
+TEST_F(Test_PluginMetaDataCache, hit_test)
+{
+    PluginMetaDataCache *cache = createCache();
+
+    ASSERT_EQ(cache->metaData(pluginFile).value("api").toString(), "version-1");
+    ASSERT_EQ(cache->metaData(pluginFile).value("api").toString(), "version-1");
+    ASSERT_EQ(readCount, 1);
+    ASSERT_TRUE(cache->isDirty());
+
+    delete cache;
+}
+
+TEST_F(Test_PluginMetaDataCache, persist_test)
+{
+    PluginMetaDataCache *cache = createCache();
+    cache->metaData(pluginFile);
+    ASSERT_TRUE(cache->save());
+    ASSERT_FALSE(cache->isDirty());
+    delete cache;
+
+    // 重新创建缓存对象模拟下一次启动，文件未变化时不再读取插件
+    cache = createCache();
+    ASSERT_TRUE(cache->load());
+    QJsonObject meta;
+    ASSERT_TRUE(cache->cachedMetaData(pluginFile, &meta));
+    ASSERT_EQ(meta.value("api").toString(), "version-1");
+    ASSERT_EQ(cache->metaData(pluginFile).value("api").toString(), "version-1");
+    ASSERT_EQ(readCount, 1);
+
+    delete cache;
+}
+
+TEST_F(Test_PluginMetaDataCache, replace_test)
+{
+    PluginMetaDataCache *cache = createCache();
+    cache->metaData(pluginFile);
+    ASSERT_TRUE(cache->save());
+    delete cache;
+
+    // 模拟安装新版本：旧文件移走(保持inode被占用)，在原路径写入新文件
+    ASSERT_TRUE(QFile::rename(pluginFile, pluginFile + ".old"));
+    writePlugin("version-2");
+
+    cache = createCache();
+    ASSERT_TRUE(cache->load());
+    ASSERT_FALSE(cache->cachedMetaData(pluginFile, nullptr));
+    ASSERT_EQ(cache->metaData(pluginFile).value("api").toString(), "version-2");
+    ASSERT_EQ(readCount, 2);
+
+    delete cache;
+}
+
+TEST_F(Test_PluginMetaDataCache, rewrite_test)
+{
+    PluginMetaDataCache *cache = createCache();
+    cache->metaData(pluginFile);
+
+    // 原地重写，inode不变，大小变化
+    writePlugin("version-10");
+    ASSERT_FALSE(cache->cachedMetaData(pluginFile, nullptr));
+    ASSERT_EQ(cache->metaData(pluginFile).value("api").toString(), "version-10");
+    ASSERT_EQ(readCount, 2);
+
+    delete cache;
+}
+
+TEST_F(Test_PluginMetaDataCache, prune_test)
+{
+    PluginMetaDataCache *cache = createCache();
+    cache->metaData(pluginFile);
+    ASSERT_TRUE(cache->save());
+    delete cache;
+
+    // 插件被删除后，下一次启动不会访问它，保存时从缓存中移除
+    QFile::remove(pluginFile);
+    cache = createCache();
+    ASSERT_TRUE(cache->load());
+    ASSERT_TRUE(cache->metaData(pluginFile).isEmpty());
+    cache->pruneUntouched();
+    ASSERT_TRUE(cache->isDirty());
+    ASSERT_TRUE(cache->save());
+    delete cache;
+
+    writePlugin("version-3");
+    cache = createCache();
+    ASSERT_TRUE(cache->load());
+    ASSERT_FALSE(cache->cachedMetaData(pluginFile, nullptr));
+    ASSERT_EQ(readCount, 1);
+
+    delete cache;
+}
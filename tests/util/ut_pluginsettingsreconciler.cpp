@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QJsonObject>
+#include <QSet>
+
+#include <gtest/gtest.h>
+
+#include "pluginsettingsreconciler.h"
+#include "pluginsettingsstore.h"
+
+class Test_PluginSettingsReconciler : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+
+public:
+    PluginSettingsReconciler reconciler;
+    QJsonObject settings;
+    QSet<QString> loadedPlugins;
+    QStringList notified;
+    int addCount = 0;
+    int removeCount = 0;
+};
+
+void Test_PluginSettingsReconciler::SetUp()
+{
+    settings = PluginSettingsStore::parse("{\"sound\":{\"enable\":true,\"pos_sound-item_1\":2},"
+                                          "\"power\":{\"enable\":true,\"pos_power_1\":5},"
+                                          "\"network\":{\"enable\":true,\"pos_network-item-key_1\":3}}");
+    loadedPlugins = { "sound", "power", "network" };
+    notified.clear();
+    addCount = 0;
+    removeCount = 0;
+
+    reconciler.setNotifier([ this ](const QString &pluginName) { notified << pluginName; });
+    reconciler.setItemLoadedChecker([ this ](const QString &pluginName) { return loadedPlugins.contains(pluginName); });
+    reconciler.setItemRemover([ this ](const QString &) { ++removeCount; });
+    reconciler.setItemAdder([ this ](const QString &) { ++addCount; });
+}
+
+static QJsonObject changeValue(QJsonObject settings, const QString &pluginName, const QString &key, const QJsonValue &value)
+{
+    QJsonObject pluginObject = settings.value(pluginName).toObject();
+    pluginObject.insert(key, value);
+    settings.insert(pluginName, pluginObject);
+    return settings;
+}
+
+TEST_F(Test_PluginSettingsReconciler, unchanged_test)
+{
+    ASSERT_EQ(reconciler.reconcile(settings, settings), 0);
+    ASSERT_TRUE(notified.isEmpty());
+    ASSERT_EQ(addCount, 0);
+    ASSERT_EQ(removeCount, 0);
+}
+
+TEST_F(Test_PluginSettingsReconciler, visible_test)
+{
+    // 只修改一个插件的显示状态，只通知该插件，由插件自己处理插件项
+    const QJsonObject &newSettings = changeValue(settings, "sound", "enable", false);
+
+    ASSERT_EQ(reconciler.reconcile(settings, newSettings), 1);
+    ASSERT_EQ(notified, QStringList() << "sound");
+    ASSERT_EQ(addCount, 0);
+    ASSERT_EQ(removeCount, 0);
+}
+
+TEST_F(Test_PluginSettingsReconciler, position_test)
+{
+    // 只修改一个插件的位置，只重新添加该插件的插件项
+    const QJsonObject &newSettings = changeValue(settings, "power", "pos_power_1", 1);
+
+    ASSERT_EQ(reconciler.reconcile(settings, newSettings), 1);
+    ASSERT_EQ(notified, QStringList() << "power");
+    ASSERT_EQ(addCount, 1);
+    ASSERT_EQ(removeCount, 1);
+
+    // 插件项没有加载时不添加
+    loadedPlugins.remove("power");
+    notified.clear();
+    addCount = removeCount = 0;
+    reconciler.reconcile(settings, newSettings);
+    ASSERT_EQ(notified, QStringList() << "power");
+    ASSERT_EQ(addCount, 0);
+    ASSERT_EQ(removeCount, 0);
+}
+
+TEST_F(Test_PluginSettingsReconciler, diff_test)
+{
+    QJsonObject newSettings = changeValue(settings, "sound", "enable", false);
+    newSettings = changeValue(newSettings, "sound", "pos_sound-item_1", 4);
+    newSettings.remove("network");
+
+    const QList<PluginSettingsReconciler::PluginChange> &changes = PluginSettingsReconciler::diff(settings, newSettings);
+    ASSERT_EQ(changes.size(), 2);
+    ASSERT_EQ(changes[0].pluginName, "network");
+    ASSERT_TRUE(changes[0].positionChanged);
+    ASSERT_EQ(changes[1].pluginName, "sound");
+    ASSERT_EQ(changes[1].keys.size(), 2);
+    ASSERT_TRUE(changes[1].positionChanged);
+}
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "pluginsettingsstore.h"
+
+class Test_PluginSettingsStore : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+public:
+    PluginSettingsStore *store = nullptr;
+    QString backend;
+    int writeCount = 0;
+};
+
+void Test_PluginSettingsStore::SetUp()
+{
+    backend = "{\"sound\":{\"volume\":50,\"enable\":true},\"power\":{\"enable\":true}}";
+    writeCount = 0;
+
+    // 用字符串模拟DConfig中的配置项
+    store = new PluginSettingsStore([ this ] { return backend; },
+                                    [ this ](const QString &jsonStr) { ++writeCount; backend = jsonStr; });
+}
+
+void Test_PluginSettingsStore::TearDown()
+{
+    delete store;
+    store = nullptr;
+}
+
+TEST_F(Test_PluginSettingsStore, batch_test)
+{
+    QSignalSpy spy(store, &PluginSettingsStore::valueChanged);
+
+    for (int i = 0; i < 100; ++i)
+        store->setValue("sound", "volume", i);
+
+    // 写入前读取的是内存中的值
+    ASSERT_EQ(store->value("sound", "volume").toInt(), 99);
+    ASSERT_TRUE(store->hasPendingWrite());
+    ASSERT_EQ(writeCount, 0);
+    // 50 -> 0 ... 99，每次都是不同的值
+    ASSERT_EQ(spy.count(), 100);
+
+    store->flush();
+    ASSERT_EQ(writeCount, 1);
+    ASSERT_FALSE(store->hasPendingWrite());
+    ASSERT_EQ(PluginSettingsStore::parse(backend), store->settings());
+
+    // 没有修改时不写入
+    store->flush();
+    ASSERT_EQ(writeCount, 1);
+}
+
+TEST_F(Test_PluginSettingsStore, delay_test)
+{
+    store->setWriteDelay(10);
+    store->setValue("sound", "volume", 10);
+    store->setValue("power", "enable", false);
+
+    QTest::qWait(100);
+    ASSERT_EQ(writeCount, 1);
+    ASSERT_FALSE(PluginSettingsStore::parse(backend).value("power").toObject().value("enable").toBool());
+}
+
+TEST_F(Test_PluginSettingsStore, remove_test)
+{
+    store->remove("sound", QStringList() << "volume");
+    ASSERT_TRUE(store->value("sound", "volume").isUndefined());
+    ASSERT_TRUE(store->value("sound", "enable").toBool());
+
+    store->remove("power");
+    ASSERT_FALSE(store->settings().contains("power"));
+
+    store->flush();
+    ASSERT_EQ(writeCount, 1);
+    ASSERT_FALSE(PluginSettingsStore::parse(backend).contains("power"));
+}
+
+TEST_F(Test_PluginSettingsStore, reload_test)
+{
+    QSignalSpy externalSpy(store, &PluginSettingsStore::externalChanged);
+
+    // 自己写入的配置不会当作外部修改
+    store->setValue("sound", "volume", 10);
+    store->flush();
+    store->reload();
+    ASSERT_EQ(externalSpy.count(), 0);
+
+    // 外部修改和本地未写入的修改同时存在时，本地修改的key保留本地的值
+    store->setValue("sound", "volume", 20);
+    backend = "{\"sound\":{\"volume\":80,\"enable\":false},\"power\":{\"enable\":true}}";
+    store->reload();
+
+    ASSERT_EQ(externalSpy.count(), 1);
+    ASSERT_EQ(store->value("sound", "volume").toInt(), 20);
+    ASSERT_FALSE(store->value("sound", "enable").toBool());
+}
+
+TEST_F(Test_PluginSettingsStore, concurrent_test)
+{
+    // 另一份存储在同一个配置项上写入不同的key，两边的修改都不会丢失
+    PluginSettingsStore other([ this ] { return backend; },
+                              [ this ](const QString &jsonStr) { ++writeCount; backend = jsonStr; });
+
+    store->setValue("sound", "volume", 10);
+    other.setValue("power", "enable", false);
+    other.flush();
+    store->flush();
+
+    const QJsonObject &settings = PluginSettingsStore::parse(backend);
+    ASSERT_EQ(writeCount, 2);
+    ASSERT_EQ(settings.value("sound").toObject().value("volume").toInt(), 10);
+    ASSERT_FALSE(settings.value("power").toObject().value("enable").toBool());
+    ASSERT_EQ(store->settings(), settings);
+}
+
+TEST_F(Test_PluginSettingsStore, changedKeys_test)
+{
+    const QJsonObject &oldSettings = PluginSettingsStore::parse(backend);
+    const QJsonObject &newSettings = PluginSettingsStore::parse("{\"sound\":{\"volume\":60,\"enable\":true},\"network\":{\"enable\":true}}");
+
+    const QList<QPair<QString, QString>> &changes = PluginSettingsStore::changedKeys(oldSettings, newSettings);
+    ASSERT_EQ(changes.size(), 3);
+    ASSERT_TRUE(changes.contains(qMakePair(QString("sound"), QString("volume"))));
+    ASSERT_TRUE(changes.contains(qMakePair(QString("power"), QString("enable"))));
+    ASSERT_TRUE(changes.contains(qMakePair(QString("network"), QString("enable"))));
+}
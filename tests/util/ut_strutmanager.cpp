@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QElapsedTimer>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include "strutmanager.h"
+
+class Test_StrutManager : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+
+    static StrutManager::Strut bottomStrut(int size);
+
+public:
+    StrutManager *manager = nullptr;
+    QList<StrutManager::Strut> writes;
+    bool writable = true;
+    int attempts = 0;
+};
+
+void Test_StrutManager::SetUp()
+{
+    manager = new StrutManager;
+    manager->setDelay(20);
+    manager->setWriter([ this ](const StrutManager::Strut &strut) {
+        ++attempts;
+        if (!writable)
+            return false;
+
+        writes << strut;
+        return true;
+    });
+}
+
+void Test_StrutManager::TearDown()
+{
+    delete manager;
+    manager = nullptr;
+}
+
+StrutManager::Strut Test_StrutManager::bottomStrut(int size)
+{
+    StrutManager::Strut strut;
+    strut.position = Dock::Position::Bottom;
+    strut.size = size;
+    strut.start = 0;
+    strut.end = 1920;
+    return strut;
+}
+
+TEST_F(Test_StrutManager, dedup_test)
+{
+    manager->setStrut(bottomStrut(40));
+    manager->flush();
+    ASSERT_EQ(writes.size(), 1);
+
+    // 相同的区域不再写入
+    manager->setStrut(bottomStrut(40));
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 1);
+
+    // 隐藏模式反复切换，最终没有变化
+    manager->clear();
+    manager->setStrut(bottomStrut(40));
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 1);
+    ASSERT_EQ(manager->writeCount(), 1);
+    ASSERT_GE(manager->suppressedCount(), 2);
+
+    // 不预留的区域都相同
+    manager->clear();
+    manager->flush();
+    StrutManager::Strut strut;
+    strut.position = Dock::Position::Left;
+    manager->setStrut(strut);
+    manager->flush();
+    ASSERT_EQ(writes.size(), 2);
+    ASSERT_TRUE(writes.last().isNull());
+}
+
+TEST_F(Test_StrutManager, batch_test)
+{
+    // 拖拽调整大小时的连续变化合并成一次写入
+    for (int size = 40; size <= 100; ++size)
+        manager->setStrut(bottomStrut(size));
+    ASSERT_TRUE(writes.isEmpty());
+
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return !writes.isEmpty(); }, 1000));
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 1);
+    ASSERT_EQ(writes.last(), bottomStrut(100));
+}
+
+TEST_F(Test_StrutManager, hold_test)
+{
+    manager->setStrut(bottomStrut(40));
+    manager->flush();
+
+    // 切换位置的动画过程中不写入
+    manager->setHold(true);
+    manager->clear();
+    StrutManager::Strut strut;
+    strut.position = Dock::Position::Left;
+    strut.size = 40;
+    strut.start = 0;
+    strut.end = 1080;
+    manager->setStrut(strut);
+    manager->flush();
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 1);
+
+    // 动画结束之后一次写入最终的区域
+    manager->setHold(false);
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return writes.size() > 1; }, 1000));
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 2);
+    ASSERT_EQ(writes.last(), strut);
+
+    // 动画前后区域没有变化时不写入
+    manager->setHold(true);
+    manager->clear();
+    manager->setStrut(strut);
+    manager->setHold(false);
+    QTest::qWait(50);
+    ASSERT_EQ(writes.size(), 2);
+}
+
+TEST_F(Test_StrutManager, retry_test)
+{
+    // 写入失败之后再次请求时重新写入
+    writable = false;
+    manager->setStrut(bottomStrut(40));
+    manager->flush();
+    ASSERT_EQ(manager->writeCount(), 0);
+
+    writable = true;
+    manager->setStrut(bottomStrut(40));
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return !writes.isEmpty(); }, 1000));
+    ASSERT_EQ(manager->writeCount(), 1);
+}
+
+TEST_F(Test_StrutManager, backoff_test)
+{
+    manager->setRetryInterval(20, 80);
+
+    // 写入失败之后不需要再次请求，按加倍的间隔自动重试
+    writable = false;
+    manager->setStrut(bottomStrut(40));
+    manager->flush();
+    ASSERT_EQ(attempts, 1);
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return attempts >= 2; }, 1000));
+
+    // 间隔依次为20、40、80、80毫秒
+    QElapsedTimer timer;
+    timer.start();
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return attempts >= 5; }, 1000));
+    ASSERT_GE(timer.elapsed(), 40 + 80 + 80 - 20);
+
+    writable = true;
+    ASSERT_TRUE(QTest::qWaitFor([ this ] { return !writes.isEmpty(); }, 1000));
+    ASSERT_EQ(writes.last(), bottomStrut(40));
+
+    // 写入成功之后不再重试
+    const int count = attempts;
+    QTest::qWait(200);
+    ASSERT_EQ(attempts, count);
+}
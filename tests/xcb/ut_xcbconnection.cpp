@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <gtest/gtest.h>
+
+#include "xcb_connection.h"
+
+namespace {
+// 代替X请求函数，只记录调用参数
+int lastWindow = 0;
+int fakeRequest(int window)
+{
+    lastWindow = window;
+    return window + 1;
+}
+}
+
+class Test_XcbConnection : public ::testing::Test
+{
+public:
+    virtual void SetUp() override;
+    virtual void TearDown() override;
+};
+
+void Test_XcbConnection::SetUp()
+{
+    XcbConnection::instance()->resetStatistics();
+}
+
+void Test_XcbConnection::TearDown()
+{
+    XcbConnection::instance()->resetStatistics();
+}
+
+TEST_F(Test_XcbConnection, call_test)
+{
+    XcbConnection *connection = XcbConnection::instance();
+
+    // 每次调用请求函数计数一次，并返回请求函数的结果
+    ASSERT_EQ(connection->call(XcbConnection::Tray, fakeRequest, 10), 11);
+    ASSERT_EQ(lastWindow, 10);
+    connection->call(XcbConnection::Tray, fakeRequest, 20);
+    connection->call(XcbConnection::Snapshot, fakeRequest, 30);
+
+    ASSERT_EQ(connection->statistics(XcbConnection::Tray).requests, 2u);
+    ASSERT_EQ(connection->statistics(XcbConnection::Snapshot).requests, 1u);
+    ASSERT_EQ(connection->statistics(XcbConnection::TaskManager).requests, 0u);
+    ASSERT_EQ(connection->statistics(XcbConnection::Platform).requests, 0u);
+}
+
+TEST_F(Test_XcbConnection, error_test)
+{
+    XcbConnection *connection = XcbConnection::instance();
+
+    connection->traceError(XcbConnection::Tray, nullptr);
+    ASSERT_EQ(connection->statistics(XcbConnection::Tray).errors, 1u);
+    ASSERT_EQ(connection->statistics(XcbConnection::Tray).requests, 0u);
+
+    // 超出范围的调用方不计数
+    connection->traceError(XcbConnection::CallerCount, nullptr);
+    ASSERT_EQ(connection->statistics(XcbConnection::Snapshot).errors, 0u);
+}
+
+TEST_F(Test_XcbConnection, dbus_test)
+{
+    XcbConnection *connection = XcbConnection::instance();
+
+    connection->call(XcbConnection::TaskManager, fakeRequest, 1);
+    connection->call(XcbConnection::TaskManager, fakeRequest, 2);
+    connection->traceError(XcbConnection::TaskManager, nullptr);
+
+    const QJsonObject statistics = QJsonDocument::fromJson(connection->Statistics().toUtf8()).object();
+    const QJsonObject taskManager = statistics.value("taskmanager").toObject();
+    ASSERT_EQ(taskManager.value("requests").toInt(), 2);
+    ASSERT_EQ(taskManager.value("errors").toInt(), 1);
+    ASSERT_EQ(statistics.value("tray").toObject().value("requests").toInt(), 0);
+
+    connection->Reset();
+    ASSERT_EQ(connection->statistics(XcbConnection::TaskManager).requests, 0u);
+    ASSERT_EQ(connection->statistics(XcbConnection::TaskManager).errors, 0u);
+}